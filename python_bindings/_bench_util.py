@@ -0,0 +1,106 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""ctypes helpers shared by the benchmark scripts, not part of the bindings in c_accesspoint."""
+
+import functools
+from ctypes import POINTER, Structure, byref, c_char_p, c_double, c_float, c_int, c_void_p, pointer
+
+import numpy as np
+
+
+@functools.lru_cache(maxsize=None)
+def column_matrix_type(c_data_type):
+    #  MATRIX (c_double) or MATRIXF (c_float) of vectorImports.h, one vector per column
+    class _ColumnMatrix(Structure):
+        _fields_ = [
+            ("rows", c_int),
+            ("cols", c_int),
+            ("data", POINTER(POINTER(c_data_type))),
+            ("lambdas", POINTER(c_data_type)),
+            ("skews", POINTER(c_data_type)),
+            ("error_codes", POINTER(c_int)),
+        ]
+
+    return _ColumnMatrix
+
+
+def construct_column_matrix(matrix, c_data_type=c_double):
+    #  copying every column into a vector of its own, the vectors are returned to keep them alive
+    rows, cols = matrix.shape
+    np_data_type = np.float32 if c_data_type is c_float else np.float64
+    columns = [np.array(matrix[:, i], dtype=np_data_type, order="C") for i in range(cols)]
+    data = (POINTER(c_data_type) * cols)(*[column.ctypes.data_as(POINTER(c_data_type)) for column in columns])
+    c_matrix = column_matrix_type(c_data_type)(rows, cols, data, (c_data_type * cols)(), (c_data_type * cols)(),
+                                               (c_int * cols)())
+    return c_matrix, columns
+
+
+def column_operation(library, function_name, interval_parameter_type=c_int, c_data_type=c_double, thread_count=True):
+    #  ci* operation on a MATRIX or MATRIXF: interval, precision or tolerance, matrix, standardize, time stamps and
+    #  the thread count unless the operation runs on the calling thread only
+    function = getattr(library, function_name)
+    function.argtypes = [c_double, c_double, interval_parameter_type, POINTER(column_matrix_type(c_data_type)),
+                         c_int, c_int] + ([c_int] if thread_count else [])
+    function.restype = c_int
+    return function
+
+
+class Stats(Structure):
+    #  lsStats, see lambdaSearch.h
+    _fields_ = [("lambda_", c_double), ("mean", c_double), ("sd", c_double), ("valid", c_int)]
+
+
+class Scratch(Structure):
+    #  lsScratch, see lambdaSearch.h
+    _fields_ = [("zws", c_void_p), ("log_cache", c_void_p), ("capacity", c_int), ("cache_logs", c_int),
+                ("row_parts", c_int), ("lambda_batch", c_int), ("scale", c_double), ("stats", Stats)]
+
+
+class Context(Structure):
+    #  yjContext, see yeoJohnson.h
+    _fields_ = [("yj1", c_double * 2), ("yj3", c_double * 2), ("set", c_int)]
+
+
+def _search_argtypes(interval_parameter_type):
+    #  vector, interval, precision, step or tolerance, rows and the lambda, skew and errnum results of ls* searches
+    return [POINTER(c_double), c_double, c_double, interval_parameter_type, c_int, POINTER(c_double),
+            POINTER(c_double), POINTER(c_int)]
+
+
+def column_search(library, function_name, interval_parameter_type=c_int):
+    #  ls* search of one vector
+    function = getattr(library, function_name)
+    function.argtypes = _search_argtypes(interval_parameter_type)
+    function.restype = c_int
+    return function
+
+
+def scratch_search(library, function_name, interval_parameter_type=c_int):
+    #  ls*Scratch search of one vector on a yjContext and an lsScratch
+    function = getattr(library, function_name)
+    function.argtypes = [POINTER(Context), POINTER(Scratch)] + _search_argtypes(interval_parameter_type)
+    function.restype = c_int
+    return function
+
+
+def import_csv(library, csv_path, thread_count):
+    #  importVectorTableFromCsvParallel, returns the values as 2D array and the throughput measured by the library;
+    #  the matrix is released by freeMatrix of the library, not by a free of another C runtime
+    matrix_type = column_matrix_type(c_double)
+    c_import = library.importVectorTableFromCsvParallel
+    c_import.argtypes = [c_char_p, POINTER(POINTER(matrix_type)), c_int, POINTER(c_double)]
+    c_import.restype = c_int
+    library.freeMatrix.argtypes = [POINTER(matrix_type)]
+    library.freeMatrix.restype = None
+    matrix = matrix_type()
+    throughput = c_double()
+    ret = c_import(str(csv_path).encode(), pointer(pointer(matrix)), thread_count, byref(throughput))
+    if ret != 0:
+        raise RuntimeError(f"{csv_path} could not be imported ({ret}).")
+    data_np = np.empty((matrix.rows, matrix.cols))
+    for j in range(matrix.cols):
+        data_np[:, j] = np.ctypeslib.as_array(matrix.data[j], (matrix.rows,))
+    library.freeMatrix(byref(matrix))
+    return data_np, throughput.value
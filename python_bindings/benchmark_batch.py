@@ -0,0 +1,52 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""Benchmark of the lambda batch size (lsScratchSetLambdaBatch) on tall columns.
+
+usage: python benchmark_batch.py [LIBRARY] [ROWS]
+Batch size 1 is the reference for the speedup and the lambda deviation.
+"""
+
+import sys
+from ctypes import CDLL, POINTER, byref, c_double, c_int
+from time import perf_counter
+
+import numpy as np
+
+import _bench_util
+
+
+def search(library, name, columns, batch):
+    # precision (lsSmartSearchScratch) or interval step (lsLambdaSearchScratch)
+    precision = c_int(14) if name == "lsSmartSearchScratch" else c_double(0.05)
+    function = _bench_util.scratch_search(library, name, type(precision))
+    context, scratch = _bench_util.Context(), _bench_util.Scratch()
+    library.buildBoundaryBoxCtx(byref(context), c_double(-3), c_double(3))
+    library.lsScratchInit(byref(scratch), 1)
+    assert library.lsScratchSetLambdaBatch(byref(scratch), batch) == scratch.lambda_batch == batch
+    lambdas = []
+    start = perf_counter()
+    for vector in columns:
+        result_lambda, result_skew, errnum = c_double(), c_double(), c_int()
+        function(byref(context), byref(scratch), vector.ctypes.data_as(POINTER(c_double)), -3, 3, precision,
+                 len(vector), byref(result_lambda), byref(result_skew), byref(errnum))
+        lambdas.append(result_lambda.value)
+    elapsed = perf_counter() - start
+    library.lsScratchFree(byref(scratch))
+    return elapsed, np.array(lambdas)
+
+
+library = CDLL(sys.argv[1] if len(sys.argv) > 1 else "../x64/bin/comInterface.so")
+rows = int(sys.argv[2]) if len(sys.argv) > 2 else 2_000_000
+rng = np.random.default_rng(0)
+columns = [np.ascontiguousarray(rng.gamma(2.0, 1.5, rows) - 2.0) for _ in range(4)]
+for name in ("lsSmartSearchScratch", "lsLambdaSearchScratch"):
+    reference = None
+    for batch in (1, 2, 4, 8, 16):
+        elapsed, lambdas = min((search(library, name, columns, batch) for _ in range(3)),
+                               key=lambda result: result[0])
+        if reference is None:
+            reference = (elapsed, lambdas)
+        print(f"{name:>21} K={batch:<2}: {elapsed:7.3f} s  speedup {reference[0] / elapsed:5.2f}x"
+              f"  max |dlambda| {np.max(np.abs(lambdas - reference[1])):.1e}")
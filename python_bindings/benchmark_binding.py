@@ -0,0 +1,39 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""Benchmark of the Python binding against the bare C call on the same data.
+
+usage: python benchmark_binding.py [LIBRARY] [ROWS] [COLS]
+The difference is the cost of the binding, which no longer copies the data.
+"""
+
+import sys
+from ctypes import CDLL, POINTER, c_double, c_int, pointer
+from time import perf_counter
+
+import numpy as np
+
+from c_accesspoint import _construct_c_matrix, _StridedMatrix, yeo_johnson_power_transformation
+
+path = sys.argv[1] if len(sys.argv) > 1 else "../x64/bin/comInterface.so"
+rows = int(sys.argv[2]) if len(sys.argv) > 2 else 10_000
+cols = int(sys.argv[3]) if len(sys.argv) > 3 else 1_000
+rng = np.random.default_rng(0)
+data = rng.gamma(2.0, 1.5, (rows, cols)) - 1.0
+
+function = CDLL(path).ciParallelOperationBowleyS
+function.argtypes = [c_double, c_double, c_int, POINTER(_StridedMatrix), c_int, c_int, c_int]
+bare = data.copy()
+lambdas, skews, error_codes = np.zeros(cols), np.zeros(cols), np.zeros(cols, dtype=np.intc)
+start = perf_counter()
+function(-3, 3, 14, pointer(_construct_c_matrix(bare, lambdas, skews, error_codes)), 1, 0, 4)
+c_call = perf_counter() - start
+
+for order in ("C", "F"):
+    bound = np.asarray(data.copy(), order=order)
+    start = perf_counter()
+    result = yeo_johnson_power_transformation(path, bound, number_of_threads=4)
+    binding = perf_counter() - start
+    print(f"{rows}x{cols} {order} order: binding {binding:7.3f} s, bare C call {c_call:7.3f} s,"
+          f" overhead {binding - c_call:+7.3f} s  max |dlambda| {np.max(np.abs(result.lambdas - lambdas)):.1e}")
@@ -0,0 +1,50 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""Benchmark of lsSmartBowleySearch on sorted, tied and random columns of one or more library builds.
+
+usage: python benchmark_bowley.py LIBRARY [LIBRARY ...]
+The first library is the reference for the speedup and the lambda deviation.
+"""
+
+import sys
+from ctypes import CDLL, POINTER, byref, c_double, c_int
+from time import perf_counter
+
+import numpy as np
+
+import _bench_util
+
+
+def search(library, columns):
+    function = _bench_util.column_search(library, "lsSmartBowleySearch")
+    lambdas = []
+    elapsed = 0
+    for column in columns:
+        vector = column.copy()  # older builds sort the column in place
+        result_lambda, result_skew, errnum = c_double(), c_double(), c_int()
+        start = perf_counter()
+        function(vector.ctypes.data_as(POINTER(c_double)), -3, 3, 14, len(vector),
+                 byref(result_lambda), byref(result_skew), byref(errnum))
+        elapsed += perf_counter() - start
+        lambdas.append(result_lambda.value)
+    return elapsed, np.array(lambdas)
+
+
+rows = 20_000  # sorted columns cost the recursive quicksort O(rows^2) and O(rows) stack
+rng = np.random.default_rng(0)
+patterns = {
+    "random": [rng.gamma(2.0, 1.5, rows) for _ in range(8)],
+    "sorted": [np.sort(rng.gamma(2.0, 1.5, rows)) for _ in range(8)],
+    "tied": [rng.poisson(3.0, rows) * (rng.random(rows) < 0.6) + 0.0 for _ in range(8)],
+}
+libraries = [CDLL(path) for path in sys.argv[1:]] or [CDLL("../x64/bin/comInterface.so")]
+for name, columns in patterns.items():
+    reference = None
+    for index, library in enumerate(libraries):
+        elapsed, lambdas = search(library, columns)
+        if reference is None:
+            reference = (elapsed, lambdas)
+        print(f"{name:>8} [{index}]: {elapsed:7.3f} s  speedup {reference[0] / elapsed:6.1f}x"
+              f"  max |dlambda| {np.max(np.abs(lambdas - reference[1])):.1e}")
@@ -0,0 +1,65 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""Benchmark of the Brent root search against the smart search of one library build.
+
+usage: python benchmark_brent.py [LIBRARY]
+The smart search with precision 14 is the reference for the speedup and the lambda deviation.
+"""
+
+import sys
+from ctypes import CDLL, POINTER, byref, c_double, c_int, pointer
+from time import perf_counter
+
+import numpy as np
+
+import _bench_util
+
+
+def interval_parameter(name):
+    # precision (lsSmartSearch, ciParallelOperation) or tolerance (lsBrentSearch, ciParallelOperationBrent)
+    return c_double(1e-6) if "Brent" in name else c_int(14)
+
+
+def search(library, name, data):
+    precision = interval_parameter(name)
+    function = _bench_util.column_search(library, name, type(precision))
+    lambdas, skews = [], []
+    start = perf_counter()
+    for column in data.T:
+        vector = np.ascontiguousarray(column)
+        result_lambda, result_skew, errnum = c_double(), c_double(), c_int()
+        function(vector.ctypes.data_as(POINTER(c_double)), -3, 3, precision, len(vector),
+                 byref(result_lambda), byref(result_skew), byref(errnum))
+        lambdas.append(result_lambda.value)
+        skews.append(result_skew.value)
+    return perf_counter() - start, np.array(lambdas), np.array(skews)
+
+
+def operation(library, name, data):
+    precision = interval_parameter(name)
+    matrix, _ = _bench_util.construct_column_matrix(data)
+    function = _bench_util.column_operation(library, name, type(precision))
+    start = perf_counter()
+    function(-3, 3, precision, pointer(matrix), 0, 0, 4)
+    return (perf_counter() - start, np.array(matrix.lambdas[:matrix.cols]),
+            np.array(matrix.skews[:matrix.cols]))
+
+
+library = CDLL(sys.argv[1] if len(sys.argv) > 1 else "../x64/bin/comInterface.so")
+rng = np.random.default_rng(0)
+data = np.concatenate([rng.gamma(2.0, 1.5, (50_000, 8)) - 2.0,
+                       rng.normal(0, 1, (50_000, 4)),
+                       -rng.exponential(1.0, (50_000, 4))], axis=1)
+for names, run in ((("lsSmartSearch", "lsBrentSearch"), search),
+                   (("ciParallelOperation", "ciParallelOperationBrent"), operation)):
+    reference = None
+    for name in names:
+        elapsed, lambdas, skews = min((run(library, name, data.copy()) for _ in range(3)),
+                                      key=lambda result: result[0])
+        if reference is None:
+            reference = (elapsed, lambdas)
+        print(f"{name:>25}: {elapsed:7.3f} s  speedup {reference[0] / elapsed:5.2f}x"
+              f"  max |dlambda| {np.max(np.abs(lambdas - reference[1])):.1e}"
+              f"  max |skew| {np.max(np.abs(skews)):.1e}")
@@ -0,0 +1,64 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""Benchmark of the memory mapped csv import (importVectorTableFromCsvParallel).
+
+usage: python benchmark_csv_import.py [LIBRARY]
+Writes a csv with ';' as separator and ',' as decimal point and one with ',' as separator, a header and 17 digits like
+x64/data/artificial_20_20.csv, imports them on 1 to n threads and reports the throughput in MB/s measured by the
+library, next to numpy.loadtxt.
+"""
+
+import os
+import sys
+import tempfile
+from time import perf_counter
+
+import numpy as np
+
+import _bench_util
+import c_accesspoint
+
+library = sys.argv[1] if len(sys.argv) > 1 else "../x64/bin/comInterface.so"
+c_library = c_accesspoint._load_library(library)
+
+rows, cols = 200_000, 50
+data = np.random.default_rng(0).normal(0, 100, (rows, cols))
+path = os.path.join(tempfile.gettempdir(), "benchmark_csv_import.csv")
+
+
+def write_semicolon():
+    with open(path, "w") as file:
+        for row in data.tolist():
+            file.write(";".join(f"{value:.6f}".replace(".", ",") for value in row) + "\n")
+    return 1e-6, dict(delimiter=";", converters=lambda field: float(field.replace(",", ".")))
+
+
+def write_comma():
+    with open(path, "w") as file:
+        file.write(",".join(f"bm_{j}" for j in range(cols)) + "\n")
+        for row in data.tolist():
+            file.write(",".join(repr(value) for value in row) + "\n")
+    return 0, dict(delimiter=",", skiprows=1)
+
+
+def import_csv(thread_count):
+    start = perf_counter()
+    columns, throughput = _bench_util.import_csv(c_library, path, thread_count)
+    return columns, perf_counter() - start, throughput
+
+
+for write in (write_semicolon, write_comma):
+    accuracy, loadtxt_arguments = write()
+    size = os.path.getsize(path) / 1e6
+    print(f"{write.__name__[6:]}: {rows}x{cols}, {size:.1f} MB")
+    for thread_count in sorted({1, 2, 4, os.cpu_count() or 1}, reverse=True):
+        columns, elapsed, throughput = min((import_csv(thread_count) for _ in range(3)), key=lambda result: result[1])
+        assert np.abs(columns - data).max() <= accuracy
+        print(f"{thread_count:>3} threads {elapsed * 1e3:8.1f} ms {throughput:8.1f} MB/s")
+    start = perf_counter()
+    np.loadtxt(path, **loadtxt_arguments)
+    elapsed = perf_counter() - start
+    print(f"numpy.loadtxt {elapsed * 1e3:8.1f} ms {size / elapsed:8.1f} MB/s")
+os.remove(path)
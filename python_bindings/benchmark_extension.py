@@ -0,0 +1,64 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""Benchmark of the yeojohnson extension module against the ctypes binding.
+
+usage: python benchmark_extension.py [LIBRARY]
+Build the module with "make extension" first. Prints the time of both bindings on small and
+large matrices and how often a second Python thread got to run during a large transformation.
+"""
+
+import sys
+import threading
+import time
+
+import numpy as np
+
+import c_accesspoint
+import yeojohnson
+
+library = sys.argv[1] if len(sys.argv) > 1 else "../x64/bin/comInterface.so"
+rng = np.random.default_rng(0)
+
+
+def best_of(function, data, repeats):
+    best = None
+    for _ in range(repeats):
+        copy = data.copy()
+        start = time.perf_counter()
+        function(copy)
+        elapsed = time.perf_counter() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best, copy
+
+
+for rows, cols, repeats in ((100, 4, 200), (10_000, 200, 3)):
+    data = rng.gamma(2.0, 1.5, (rows, cols)) - 1.0
+    ctypes_time, ctypes_data = best_of(
+        lambda d: c_accesspoint.yeo_johnson_power_transformation(library, d), data, repeats)
+    module_time, module_data = best_of(lambda d: yeojohnson.transform(d, method="bowley"), data, repeats)
+    print(f"{rows:>6}x{cols:<4} ctypes {ctypes_time * 1e3:8.2f} ms  extension {module_time * 1e3:8.2f} ms"
+          f"  max |dy| {np.max(np.abs(ctypes_data - module_data)):.1e}")
+
+# a ticker thread sleeping 1 ms per tick, it only ticks while the GIL is free
+ticks = 0
+running = True
+
+
+def ticker():
+    global ticks
+    while running:
+        ticks += 1
+        time.sleep(0.001)
+
+
+data = rng.gamma(2.0, 1.5, (20_000, 400)) - 1.0
+thread = threading.Thread(target=ticker)
+thread.start()
+start = time.perf_counter()
+yeojohnson.transform(data)
+elapsed = time.perf_counter() - start
+running = False
+thread.join()
+print(f"20000x400 transform {elapsed:.2f} s, ticker ran {ticks} times (at most {int(elapsed * 1e3)})")
@@ -0,0 +1,42 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""Benchmark of ciParallelOperationf (float32) against ciParallelOperation.
+
+usage: python benchmark_float.py [LIBRARY] [THREADS]
+"""
+
+import sys
+from ctypes import CDLL, c_double, c_float, c_int, pointer
+from time import perf_counter
+
+import numpy as np
+
+import _bench_util
+
+
+def run(library, name, c_data_type, data, threads):
+    matrix, _ = _bench_util.construct_column_matrix(data, c_data_type)
+    function = _bench_util.column_operation(library, name, c_int, c_data_type)
+    start = perf_counter()
+    function(-3, 3, 14, pointer(matrix), 0, 0, threads)
+    elapsed = perf_counter() - start
+    return elapsed, np.array(matrix.lambdas[:matrix.cols]), np.array(matrix.error_codes[:matrix.cols])
+
+
+# Linux
+c_library = CDLL(sys.argv[1] if len(sys.argv) > 1 else "../x64/bin/comInterface.so")
+threads = int(sys.argv[2]) if len(sys.argv) > 2 else 1
+
+rng = np.random.default_rng(0)
+data = rng.lognormal(0, 0.8, (20_000, 32)) * rng.choice([-1.0, 1.0], (20_000, 32))
+
+time_d, lambda_d, err_d = run(c_library, "ciParallelOperation", c_double, data, threads)
+time_f, lambda_f, err_f = run(c_library, "ciParallelOperationf", c_float, data, threads)
+ok = (err_d == 0) & (err_f == 0)
+delta = np.abs(lambda_d[ok] - lambda_f[ok])
+print(f"float64: {time_d:8.3f} s")
+print(f"float32: {time_f:8.3f} s  (speedup {time_d / time_f:.2f}x)")
+print(f"columns without error: {ok.sum()} / {len(ok)}")
+print(f"|lambda64 - lambda32|: max {delta.max():.2e}, mean {delta.mean():.2e}")
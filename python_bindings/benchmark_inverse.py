@@ -0,0 +1,65 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""Benchmark of the vectorized inverse Yeo Johnson transformation (YeoJohnsonModel.inverse_transform).
+
+usage: python benchmark_inverse.py [LIBRARY]
+Compares ciModelInverseTransform per instruction set with the inverse in NumPy, and checks the round trip.
+"""
+
+import sys
+from ctypes import c_int
+from time import perf_counter
+
+import numpy as np
+
+import c_accesspoint
+
+library = sys.argv[1] if len(sys.argv) > 1 else "../x64/bin/comInterface.so"
+rng = np.random.default_rng(0)
+c_library = c_accesspoint._load_library(library)
+c_library.ybSetInstructionSet.argtypes = [c_int]
+best_isa = c_library.ybGetInstructionSet()
+isa_names = ["scalar", "sse2", "avx2", "avx512"]
+
+
+def numpy_inverse(transformed, lambdas):
+    result = np.empty_like(transformed)
+    for j, lmbda in enumerate(lambdas):
+        x = transformed[:, j]
+        positive = x >= 0
+        if lmbda != 0:
+            result[positive, j] = np.power(x[positive] * lmbda + 1, 1 / lmbda) - 1
+        else:
+            result[positive, j] = np.expm1(x[positive])
+        if lmbda != 2:
+            result[~positive, j] = 1 - np.power(-(2 - lmbda) * x[~positive] + 1, 1 / (2 - lmbda))
+        else:
+            result[~positive, j] = -np.expm1(-x[~positive])
+    return result
+
+
+def best_of(function, repeats=3):
+    best = None
+    for _ in range(repeats):
+        start = perf_counter()
+        function()
+        elapsed = perf_counter() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+for rows, cols in ((100_000, 50), (2_000, 2_000)):
+    data = rng.gamma(2.0, 1.5, (rows, cols)) - 1.0
+    model = c_accesspoint.YeoJohnsonModel(library, method="mle", standardize=False)
+    transformed = model.fit_transform(data.copy())
+    numpy_time = best_of(lambda: numpy_inverse(transformed, model.lambdas))
+    print(f"{rows:>6}x{cols:<5} numpy {numpy_time * 1e3:8.1f} ms")
+    for isa in range(best_isa + 1):
+        c_library.ybSetInstructionSet(isa)
+        restored = transformed.copy()
+        elapsed = best_of(lambda: model.inverse_transform(np.copyto(restored, transformed) or restored))
+        print(f"             {isa_names[isa]:>6} {elapsed * 1e3:8.1f} ms  speedup {numpy_time / elapsed:5.1f}x"
+              f"  round trip max |dy| {np.max(np.abs(restored - data) / (1 + np.abs(data))):.1e}")
+    c_library.ybSetInstructionSet(best_isa)
@@ -0,0 +1,81 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""Benchmark of binary matrix files (matrixFile.c) against parsing the csv on every run.
+
+usage: python benchmark_matrix_file.py [LIBRARY]
+Converts a csv with a header into a matrix file once, then compares the csv import with opening the matrix file,
+reading all values of it and a full transformation of both.
+"""
+
+import os
+import sys
+import tempfile
+from time import perf_counter
+
+import numpy as np
+
+import _bench_util
+import c_accesspoint
+
+library = sys.argv[1] if len(sys.argv) > 1 else "../x64/bin/comInterface.so"
+c_library = c_accesspoint._load_library(library)
+threads = os.cpu_count() or 1
+
+rows, cols = 200_000, 50
+data = np.random.default_rng(0).gamma(2.0, 1.5, (rows, cols))
+directory = tempfile.mkdtemp()
+csv_path = os.path.join(directory, "data.csv")
+matrix_path = os.path.join(directory, "data.yjm")
+with open(csv_path, "w") as file:
+    file.write(",".join(f"bm_{j}" for j in range(cols)) + "\n")
+    for row in data.tolist():
+        file.write(",".join(repr(value) for value in row) + "\n")
+
+
+def best_of(function, repeats=5):
+    best = None
+    for _ in range(repeats):
+        start = perf_counter()
+        function()
+        elapsed = perf_counter() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+def import_csv():
+    _bench_util.import_csv(c_library, csv_path, threads)
+
+
+start = perf_counter()
+c_accesspoint.convert_csv_to_matrix_file(library, csv_path, matrix_path, threads, results=True)
+print(f"{rows}x{cols}: csv {os.path.getsize(csv_path) / 1e6:.1f} MB, matrix file "
+      f"{os.path.getsize(matrix_path) / 1e6:.1f} MB, converted in {(perf_counter() - start) * 1e3:.1f} ms")
+
+with c_accesspoint.MatrixFile(library, matrix_path) as matrix_file:
+    assert np.array_equal(matrix_file.data, data)
+    assert matrix_file.column_names == [f"bm_{j}" for j in range(cols)]
+
+
+def open_file(read):
+    with c_accesspoint.MatrixFile(library, matrix_path) as matrix_file:
+        if read:
+            matrix_file.data.sum()
+
+
+print(f"csv import          {best_of(import_csv, 3) * 1e3:8.2f} ms")
+print(f"matrix file open    {best_of(lambda: open_file(False)) * 1e3:8.2f} ms")
+print(f"matrix file + read  {best_of(lambda: open_file(True)) * 1e3:8.2f} ms")
+
+model = c_accesspoint.YeoJohnsonModel(library, number_of_threads=threads)
+with c_accesspoint.MatrixFile(library, matrix_path, update=True) as matrix_file:
+    start = perf_counter()
+    model.fit_transform(matrix_file.data)
+    matrix_file.lambdas[:] = model.lambdas
+    print(f"fit_transform on the mapping {(perf_counter() - start) * 1e3:8.1f} ms, written back to the file")
+with c_accesspoint.MatrixFile(library, matrix_path) as matrix_file:
+    assert np.array_equal(matrix_file.lambdas, model.lambdas)
+os.remove(csv_path)
+os.remove(matrix_path)
+os.rmdir(directory)
@@ -0,0 +1,61 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""Benchmark of the maximum likelihood search against sklearn's PowerTransformer.
+
+usage: python benchmark_mle.py [LIBRARY]
+sklearn is the reference for the speedup and the lambda deviation.
+"""
+
+import sys
+from ctypes import CDLL, POINTER, byref, c_double, c_int, pointer
+from time import perf_counter
+
+import numpy as np
+from sklearn.preprocessing import PowerTransformer
+
+import _bench_util
+
+
+def sklearn(library, data):
+    start = perf_counter()
+    lambdas = PowerTransformer(method="yeo-johnson", standardize=False).fit(data).lambdas_
+    return perf_counter() - start, lambdas
+
+
+def search(library, data):
+    function = _bench_util.column_search(library, "lsMleSearch", c_double)
+    lambdas = []
+    start = perf_counter()
+    for column in data.T:
+        vector = np.ascontiguousarray(column)
+        result_lambda, result_skew, errnum = c_double(), c_double(), c_int()
+        function(vector.ctypes.data_as(POINTER(c_double)), -3, 3, 1.48e-8, len(vector),
+                 byref(result_lambda), byref(result_skew), byref(errnum))
+        lambdas.append(result_lambda.value)
+    return perf_counter() - start, np.array(lambdas)
+
+
+def operation(library, data):
+    matrix, _ = _bench_util.construct_column_matrix(data)
+    function = _bench_util.column_operation(library, "ciParallelOperationMle", c_double)
+    start = perf_counter()
+    function(-3, 3, 1.48e-8, pointer(matrix), 0, 0, 4)
+    return perf_counter() - start, np.array(matrix.lambdas[:matrix.cols])
+
+
+library = CDLL(sys.argv[1] if len(sys.argv) > 1 else "../x64/bin/comInterface.so")
+rng = np.random.default_rng(0)
+data = np.concatenate([rng.gamma(2.0, 1.5, (50_000, 8)) - 2.0,
+                       rng.normal(3, 1, (50_000, 4)),
+                       -rng.lognormal(0, 0.5, (50_000, 4))], axis=1)
+reference = None
+for name, run in (("PowerTransformer", sklearn), ("lsMleSearch", search),
+                  ("ciParallelOperationMle", operation)):
+    elapsed, lambdas = min((run(library, data.copy()) for _ in range(3)),
+                           key=lambda result: result[0])
+    if reference is None:
+        reference = (elapsed, lambdas)
+    print(f"{name:>22}: {elapsed:7.3f} s  speedup {reference[0] / elapsed:5.2f}x"
+          f"  max |dlambda| {np.max(np.abs(lambdas - reference[1])):.1e}")
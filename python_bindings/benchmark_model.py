@@ -0,0 +1,47 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""Benchmark of a fitted YeoJohnsonModel against searching every batch again.
+
+usage: python benchmark_model.py [LIBRARY]
+Fits the model on a training matrix once, then transforms new batches with it (no search) and maps
+them back with inverse_transform, compared to yeo_johnson_power_transformation on every batch.
+"""
+
+import sys
+from time import perf_counter
+
+import numpy as np
+
+import c_accesspoint
+
+library = sys.argv[1] if len(sys.argv) > 1 else "../x64/bin/comInterface.so"
+rng = np.random.default_rng(0)
+
+for rows, cols in ((1_000, 2_000), (20_000, 200)):
+    training = rng.gamma(2.0, 1.5, (rows, cols)) - 1.0
+    batch = rng.gamma(2.0, 1.5, (rows, cols)) - 1.0
+    model = c_accesspoint.YeoJohnsonModel(library, method="bowley")
+    start = perf_counter()
+    model.fit(training)
+    fit_time = perf_counter() - start
+
+    transformed = batch.copy()
+    start = perf_counter()
+    model.transform(transformed)
+    transform_time = perf_counter() - start
+
+    restored = transformed.copy()
+    start = perf_counter()
+    model.inverse_transform(restored)
+    inverse_time = perf_counter() - start
+
+    searched = batch.copy()
+    start = perf_counter()
+    c_accesspoint.yeo_johnson_power_transformation(library, searched)
+    search_time = perf_counter() - start
+
+    print(f"{rows:>6}x{cols:<5} fit {fit_time * 1e3:8.1f} ms  transform {transform_time * 1e3:7.1f} ms"
+          f"  inverse {inverse_time * 1e3:7.1f} ms  search+transform {search_time * 1e3:8.1f} ms"
+          f"  speedup {search_time / transform_time:5.1f}x  round trip max |dy| {np.max(np.abs(restored - batch)):.1e}")
@@ -0,0 +1,82 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""Benchmark of .npy / .npz files mapped by the C library (mfOpen) against loading them with NumPy.
+
+usage: python benchmark_npy_file.py [LIBRARY]
+Compares np.load with opening the mapping of the C library, and np.load followed by a transformation with
+ciParallelOperationFile, which transforms the mapped file without a copy in Python.
+"""
+
+import os
+import sys
+import tempfile
+from time import perf_counter
+
+import numpy as np
+
+import c_accesspoint
+
+library = sys.argv[1] if len(sys.argv) > 1 else "../x64/bin/comInterface.so"
+threads = os.cpu_count() or 1
+
+rows, cols = 200_000, 50
+data = np.random.default_rng(0).gamma(2.0, 1.5, (rows, cols))
+directory = tempfile.mkdtemp()
+npy_path = os.path.join(directory, "data.npy")
+fortran_path = os.path.join(directory, "fortran.npy")
+npz_path = os.path.join(directory, "data.npz")
+output_path = os.path.join(directory, "data.yjm")
+np.save(npy_path, data)
+np.save(fortran_path, np.asfortranarray(data.astype(np.float32)))
+np.savez(npz_path, labels=np.arange(rows, dtype=np.float64), data=data)
+print(f"{rows}x{cols}: .npy {os.path.getsize(npy_path) / 1e6:.1f} MB")
+
+for path, array_name, expected in ((npy_path, None, data), (fortran_path, None, data.astype(np.float32)),
+                                   (npz_path, "data", data)):
+    with c_accesspoint.MatrixFile(library, path, array_name=array_name) as matrix_file:
+        assert matrix_file.data.dtype == expected.dtype
+        assert np.array_equal(matrix_file.data, expected)
+
+
+def best_of(function, repeats=5):
+    best = None
+    for _ in range(repeats):
+        start = perf_counter()
+        function()
+        elapsed = perf_counter() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+def open_file(path, array_name=None):
+    with c_accesspoint.MatrixFile(library, path, array_name=array_name) as matrix_file:
+        matrix_file.data.sum()
+
+
+def transform_loaded():
+    model = c_accesspoint.YeoJohnsonModel(library, method="smart", number_of_threads=threads)
+    model.fit_transform(np.load(npy_path))
+    return model
+
+
+print(f"np.load .npy               {best_of(lambda: np.load(npy_path).sum()) * 1e3:8.2f} ms")
+print(f"mapped .npy + read         {best_of(lambda: open_file(npy_path)) * 1e3:8.2f} ms")
+print(f"np.load .npz member        {best_of(lambda: np.load(npz_path)['data'].sum()) * 1e3:8.2f} ms")
+print(f"mapped .npz member + read  {best_of(lambda: open_file(npz_path, 'data')) * 1e3:8.2f} ms")
+print(f"np.load + fit_transform    {best_of(transform_loaded, 3) * 1e3:8.2f} ms")
+transform_file = best_of(
+    lambda: c_accesspoint.transform_file(library, npy_path, output_path, number_of_threads=threads), 3)
+print(f"ciParallelOperationFile    {transform_file * 1e3:8.2f} ms")
+
+model = transform_loaded()
+with c_accesspoint.MatrixFile(library, output_path) as matrix_file:
+    assert np.array_equal(matrix_file.lambdas, model.lambdas)
+    assert np.allclose(matrix_file.data, model.fit_transform(np.load(npy_path)))
+# in place: the .npy itself holds the transformed values afterwards
+c_accesspoint.transform_file(library, npy_path, number_of_threads=threads)
+assert np.allclose(np.load(npy_path), model.transform(data.copy()))
+for path in (npy_path, fortran_path, npz_path, output_path):
+    os.remove(path)
+os.rmdir(directory)
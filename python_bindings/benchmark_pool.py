@@ -0,0 +1,43 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""Benchmark of many small ciParallelOperation calls of one or more library builds.
+
+usage: python benchmark_pool.py LIBRARY [LIBRARY ...]
+The first library is the reference for the speedup and the lambda deviation.
+"""
+
+import sys
+from ctypes import CDLL, pointer
+from time import perf_counter
+
+import numpy as np
+
+import _bench_util
+
+
+def calls(library, name, data, repeats, thread_count):
+    function = _bench_util.column_operation(library, name)
+    elapsed = 0
+    for _ in range(repeats):
+        matrix, _ = _bench_util.construct_column_matrix(data)
+        start = perf_counter()
+        function(-3, 3, 4, pointer(matrix), 0, 0, thread_count)
+        elapsed += perf_counter() - start
+    return elapsed / repeats, np.array(matrix.lambdas[:matrix.cols])
+
+
+rng = np.random.default_rng(0)
+libraries = [CDLL(path) for path in sys.argv[1:]] or [CDLL("../x64/bin/comInterface.so")]
+for rows, cols in ((50, 4), (200, 8), (2000, 16)):
+    data = rng.gamma(2.0, 1.5, (rows, cols)) - 1.0
+    for name in ("ciParallelOperation", "ciParallelOperationBowley"):
+        reference = None
+        for index, library in enumerate(libraries):
+            elapsed, lambdas = calls(library, name, data, 2000, 4)
+            if reference is None:
+                reference = (elapsed, lambdas)
+            print(f"{rows:>5}x{cols:<3} {name:>26} [{index}]: {elapsed * 1e6:8.1f} us/call"
+                  f"  speedup {reference[0] / elapsed:5.2f}x"
+                  f"  max |dlambda| {np.max(np.abs(lambdas - reference[1])):.1e}")
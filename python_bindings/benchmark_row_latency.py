@@ -0,0 +1,65 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""Latency benchmark of RowTransformer (ybTransformRows) for online inference.
+
+usage: python benchmark_row_latency.py [LIBRARY]
+Prints p50/p99 of single row and micro-batch transformations per instruction set, next to the latency
+of an empty call (the ctypes overhead included in every measurement) and of ciModelTransform on the row.
+"""
+
+import sys
+from ctypes import c_int
+from time import perf_counter_ns
+
+import numpy as np
+
+import c_accesspoint
+
+library = sys.argv[1] if len(sys.argv) > 1 else "../x64/bin/comInterface.so"
+rng = np.random.default_rng(0)
+c_library = c_accesspoint._load_library(library)
+c_library.ybSetInstructionSet.argtypes = [c_int]
+best_isa = c_library.ybGetInstructionSet()
+isa_names = ["scalar", "sse2", "avx2", "avx512"]
+
+
+def percentiles(function, repeats, reset=lambda: None):
+    samples = np.empty(repeats)
+    for i in range(repeats):
+        reset()
+        start = perf_counter_ns()
+        function()
+        samples[i] = perf_counter_ns() - start
+    return np.percentile(samples, 50) / 1e3, np.percentile(samples, 99) / 1e3
+
+
+for cols in (1_000, 5_000, 20_000):
+    training = rng.gamma(2.0, 1.5, (500, cols)) - 1.0
+    model = c_accesspoint.YeoJohnsonModel(library, method="bowley").fit(training)
+    transformer = model.row_transformer()
+    row = rng.gamma(2.0, 1.5, cols) - 1.0
+    batch = rng.gamma(2.0, 1.5, (8, cols)) - 1.0
+    expected = row[None, :].copy()
+    model.transform(expected)
+    check = row.copy()
+    transformer.transform(check)
+    print(f"{cols} features, max |dy| to ciModelTransform {np.max(np.abs(check - expected[0])):.1e}")
+    work_row = row.copy()
+    work_batch = batch.copy()
+    empty = np.empty((0, cols))
+    p50, p99 = percentiles(lambda: transformer.transform(empty), 2000)
+    print(f"  empty call                 p50 {p50:8.2f} us  p99 {p99:8.2f} us")
+    for isa in range(best_isa + 1):
+        c_library.ybSetInstructionSet(isa)
+        p50, p99 = percentiles(lambda: transformer.transform(work_row), 2000,
+                               lambda: np.copyto(work_row, row))
+        print(f"  {isa_names[isa]:>6} 1 row             p50 {p50:8.2f} us  p99 {p99:8.2f} us")
+        p50, p99 = percentiles(lambda: transformer.transform(work_batch), 500,
+                               lambda: np.copyto(work_batch, batch))
+        print(f"  {isa_names[isa]:>6} 8 rows            p50 {p50:8.2f} us  p99 {p99:8.2f} us")
+    c_library.ybSetInstructionSet(best_isa)
+    single = row[None, :].copy()
+    p50, p99 = percentiles(lambda: model.transform(single), 200, lambda: np.copyto(single, row[None, :]))
+    print(f"  ciModelTransform 1 row     p50 {p50:8.2f} us  p99 {p99:8.2f} us")
@@ -0,0 +1,47 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""Benchmark of ciParallelOperation on tall, narrow matrices of one or more library builds.
+
+usage: python benchmark_rows.py LIBRARY [LIBRARY ...]
+The first library is the reference for the speedup and the lambda deviation.
+With fewer columns than threads the rows of every column are split among the threads.
+"""
+
+import sys
+from ctypes import CDLL, pointer
+from time import perf_counter
+
+import numpy as np
+
+import _bench_util
+
+
+def run(library, data, repeats, thread_count):
+    function = _bench_util.column_operation(library, "ciParallelOperation")
+    best = None
+    for _ in range(repeats):
+        matrix, columns = _bench_util.construct_column_matrix(data)
+        start = perf_counter()
+        function(-3, 3, 6, pointer(matrix), 0, 0, thread_count)
+        elapsed = perf_counter() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best, np.array(matrix.lambdas[:matrix.cols]), columns
+
+
+rng = np.random.default_rng(0)
+libraries = [CDLL(path) for path in sys.argv[1:]] or [CDLL("../x64/bin/comInterface.so")]
+for rows, cols in ((1_000_000, 1), (2_000_000, 4), (200_000, 16)):
+    data = rng.gamma(2.0, 1.5, (rows, cols)) - 1.0
+    for thread_count in (1, 8):
+        reference = None
+        for index, library in enumerate(libraries):
+            elapsed, lambdas, columns = run(library, data, 3, thread_count)
+            if reference is None:
+                reference = (elapsed, lambdas, columns)
+            deviation = max(np.max(np.abs(c - r)) for c, r in zip(columns, reference[2]))
+            print(f"{rows:>8}x{cols:<3} threads {thread_count} [{index}]: {elapsed * 1e3:8.1f} ms"
+                  f"  speedup {reference[0] / elapsed:5.2f}x"
+                  f"  max |dlambda| {np.max(np.abs(lambdas - reference[1])):.1e}"
+                  f"  max |dy| {deviation:.1e}")
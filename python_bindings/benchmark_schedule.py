@@ -0,0 +1,89 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""Benchmark of ciParallelOperation on matrices whose columns differ in cost.
+
+Cheap columns hold a value outside the boundary box and abort at once, heavy
+columns are heavy tailed and need the full search. The heavy columns are either
+every thread_count-th column (the worst case of a fixed modulo split) or
+scattered at random.
+
+usage: python benchmark_schedule.py LIBRARY [LIBRARY ...]
+The first library is the reference for the speedup and the lambda deviation.
+The measured latencies need at least thread_count processors; the makespans
+replay both schedules on the single column times of the last library and hold
+on any machine.
+"""
+
+import heapq
+import sys
+from ctypes import CDLL, pointer
+from time import perf_counter
+
+import numpy as np
+
+import _bench_util
+
+
+def mixed(rng, rows, cols, heavy):
+    data = np.empty((rows, cols))
+    for i in range(cols):
+        if heavy[i]:
+            data[:, i] = rng.lognormal(0.0, 1.5, rows) * rng.choice((-1.0, 1.0))
+        else:
+            data[:, i] = rng.normal(0.0, 1.0, rows)
+            data[0, i] = 1e300
+    return data
+
+
+def latencies(library, name, data, repeats, thread_count):
+    function = _bench_util.column_operation(library, name)
+    times = []
+    for _ in range(repeats):
+        matrix, _ = _bench_util.construct_column_matrix(data)
+        start = perf_counter()
+        function(-3, 3, 6, pointer(matrix), 0, 0, thread_count)
+        times.append(perf_counter() - start)
+    return np.array(times), np.array(matrix.lambdas[:matrix.cols])
+
+
+def makespans(column_times, parts):
+    """Finish time of the slowest part for the modulo split and for claimed chunks."""
+    modulo = max(sum(column_times[part::parts]) for part in range(parts))
+    free = [(0.0, part) for part in range(parts)]
+    next_column = 0
+    while next_column < len(column_times):
+        time, part = heapq.heappop(free)
+        chunk = max(1, (len(column_times) - next_column) // (2 * parts))
+        time += sum(column_times[next_column:next_column + chunk])
+        next_column += chunk
+        heapq.heappush(free, (time, part))
+    return modulo, max(time for time, _ in free)
+
+
+rng = np.random.default_rng(0)
+libraries = [CDLL(path) for path in sys.argv[1:]] or [CDLL("../x64/bin/comInterface.so")]
+thread_count = 4
+rows, cols = 20000, 64
+layouts = {
+    "modulo": np.arange(cols) % thread_count == 0,
+    "random": rng.permutation(np.arange(cols) < cols // thread_count),
+}
+for layout, heavy in layouts.items():
+    data = mixed(rng, rows, cols, heavy)
+    for name in ("ciParallelOperation", "ciParallelOperationBowley"):
+        reference = None
+        for index, library in enumerate(libraries):
+            times, lambdas = latencies(library, name, data, 200, thread_count)
+            p50, p99 = np.percentile(times, (50, 99)) * 1e3
+            if reference is None:
+                reference = (p50, p99, lambdas)
+            print(f"{layout:>6} {name:>26} [{index}]: p50 {p50:7.2f} ms  p99 {p99:7.2f} ms"
+                  f"  speedup p50 {reference[0] / p50:4.2f}x p99 {reference[1] / p99:4.2f}x"
+                  f"  max |dlambda| {np.nanmax(np.abs(lambdas - reference[2])):.1e}")
+        column_times = [np.median(latencies(libraries[-1], name, data[:, [i]], 20, 1)[0])
+                        for i in range(cols)]
+        modulo, claimed = makespans(column_times, thread_count)
+        print(f"{layout:>6} {name:>26} makespan of {thread_count} parts: modulo {modulo * 1e3:7.2f} ms"
+              f"  claimed {claimed * 1e3:7.2f} ms  ideal {sum(column_times) / thread_count * 1e3:7.2f} ms")
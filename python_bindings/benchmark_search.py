@@ -0,0 +1,61 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""Benchmark of the lambda search entry points of one or more library builds.
+
+usage: python benchmark_search.py LIBRARY [LIBRARY ...]
+The first library is the reference for the speedup and the lambda deviation.
+"""
+
+import sys
+from ctypes import CDLL, POINTER, byref, c_double, c_int, pointer
+from time import perf_counter
+
+import numpy as np
+
+import _bench_util
+
+
+def search(library, name, data):
+    # precision (lsSmartSearch) or interval step (lsLambdaSearch)
+    precision = c_int(14) if name == "lsSmartSearch" else c_double(0.05)
+    function = _bench_util.column_search(library, name, type(precision))
+    lambdas = []
+    start = perf_counter()
+    for column in data.T:
+        vector = np.ascontiguousarray(column)
+        result_lambda, result_skew, errnum = c_double(), c_double(), c_int()
+        function(vector.ctypes.data_as(POINTER(c_double)), -3, 3, precision, len(vector),
+                 byref(result_lambda), byref(result_skew), byref(errnum))
+        lambdas.append(result_lambda.value)
+    return perf_counter() - start, np.array(lambdas)
+
+
+def operation(library, name, data):
+    matrix, _ = _bench_util.construct_column_matrix(data)
+    # ciSmartOperation runs on the calling thread and takes no thread count
+    threads = (4,) if name == "ciParallelOperation" else ()
+    function = _bench_util.column_operation(library, name, thread_count=bool(threads))
+    start = perf_counter()
+    function(-3, 3, 14, pointer(matrix), 0, 0, *threads)
+    return perf_counter() - start, np.array(matrix.lambdas[:matrix.cols])
+
+
+rng = np.random.default_rng(0)
+data = rng.lognormal(0, 0.8, (50_000, 16)) * rng.choice([-1.0, 1.0], (50_000, 16))
+libraries = [CDLL(path) for path in sys.argv[1:]] or [CDLL("../x64/bin/comInterface.so")]
+benchmarks = [
+    ("lsSmartSearch", search),
+    ("lsLambdaSearch", search),
+    ("ciSmartOperation", operation),
+    ("ciParallelOperation", operation),
+]
+for name, run in benchmarks:
+    reference = None
+    for index, library in enumerate(libraries):
+        elapsed, lambdas = run(library, name, data.copy())
+        if reference is None:
+            reference = (elapsed, lambdas)
+        print(f"{name:>20} [{index}]: {elapsed:7.3f} s  speedup {reference[0] / elapsed:5.2f}x"
+              f"  max |dlambda| {np.max(np.abs(lambdas - reference[1])):.1e}")
@@ -0,0 +1,47 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""Benchmark of the parallel operations with and without standardization of one or more library builds.
+
+usage: python benchmark_standardize.py LIBRARY [LIBRARY ...]
+The first library is the reference for the speedup and the deviation of the standardized values.
+"""
+
+import sys
+from ctypes import CDLL, c_double, c_int, pointer
+from time import perf_counter
+
+import numpy as np
+
+import _bench_util
+
+
+def run(library, name, data, standardize, repeats, thread_count):
+    search = c_double if name in ("ciParallelOperationBrent", "ciParallelOperationMle") else c_int
+    function = _bench_util.column_operation(library, name, search)
+    argument = 1e-9 if search is c_double else 8
+    best = None
+    for _ in range(repeats):
+        matrix, columns = _bench_util.construct_column_matrix(data)
+        start = perf_counter()
+        function(-3, 3, argument, pointer(matrix), standardize, 0, thread_count)
+        elapsed = perf_counter() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best, np.stack(columns, axis=1)
+
+
+rng = np.random.default_rng(0)
+libraries = [CDLL(path) for path in sys.argv[1:]] or [CDLL("../x64/bin/comInterface.so")]
+for rows, cols in ((100_000, 32), (1_000_000, 8)):
+    data = rng.gamma(2.0, 1.5, (rows, cols)) - 1.0
+    for name in ("ciParallelOperation", "ciParallelOperationBrent", "ciParallelOperationMle"):
+        for standardize in (0, 1):
+            reference = None
+            for index, library in enumerate(libraries):
+                elapsed, result = run(library, name, data, standardize, 3, 8)
+                if reference is None:
+                    reference = (elapsed, result)
+                print(f"{rows:>8}x{cols:<3} {name:>25} standardize {standardize} [{index}]:"
+                      f" {elapsed * 1e3:8.1f} ms  speedup {reference[0] / elapsed:5.2f}x"
+                      f"  max |dz| {np.max(np.abs(result - reference[1])):.1e}")
@@ -0,0 +1,85 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""Benchmark of the out of core transformation (yjStream.c) against transforming the whole mapped file.
+
+usage: python benchmark_stream.py [LIBRARY]
+Writes a column major matrix file and transforms it once with ciParallelOperationFile (whole matrix resident) and
+with ysStreamOperation at a few memory budgets, each in a fresh process to measure its peak resident memory
+(Linux, /proc/self/status).
+"""
+
+import os
+import subprocess
+import sys
+import tempfile
+from time import perf_counter
+
+import numpy as np
+
+import c_accesspoint
+
+
+def resident_memory(key):
+    """VmRSS (current) or VmHWM (peak) of this process in MB, Linux only."""
+    with open("/proc/self/status") as status:
+        for line in status:
+            if line.startswith(key + ":"):
+                return int(line.split()[1]) / 1024
+    return 0.0
+
+
+def run(library, mode, path, output_path, budget):
+    """Child process: one transformation, prints time and peak resident memory."""
+    threads = os.cpu_count() or 1
+    # resets VmHWM to the current resident memory, the imports do not count
+    with open("/proc/self/clear_refs", "w") as clear_refs:
+        clear_refs.write("5")
+    before = resident_memory("VmRSS")
+    start = perf_counter()
+    if mode == "file":
+        c_accesspoint.transform_file(library, path, output_path, number_of_threads=threads)
+    else:
+        c_accesspoint.stream_transform_file(library, path, output_path, budget, number_of_threads=threads)
+    elapsed = perf_counter() - start
+    print(f"{elapsed} {before} {resident_memory('VmHWM')}")
+
+
+if len(sys.argv) > 2 and sys.argv[1] == "--child":
+    run(sys.argv[2], sys.argv[3], sys.argv[4], sys.argv[5], int(sys.argv[6]))
+    sys.exit(0)
+
+library = sys.argv[1] if len(sys.argv) > 1 else "../x64/bin/comInterface.so"
+rows, cols = 200_000, 100
+directory = tempfile.mkdtemp()
+path = os.path.join(directory, "data.yjm")
+expected_path = os.path.join(directory, "expected.yjm")
+output_path = os.path.join(directory, "stream.yjm")
+data = np.random.default_rng(0).gamma(2.0, 1.5, (rows, cols))
+c_accesspoint.write_matrix_file(library, path, data, [f"bm_{j}" for j in range(cols)])
+del data
+print(f"{rows}x{cols}: matrix file {os.path.getsize(path) / 1e6:.1f} MB")
+
+
+def child(mode, output, budget=0):
+    result = subprocess.run([sys.executable, __file__, "--child", library, mode, path, output, str(budget)],
+                            capture_output=True, text=True, check=True)
+    elapsed, before, peak = (float(value) for value in result.stdout.split()[-3:])
+    return elapsed, peak - before
+
+
+elapsed, memory = child("file", expected_path)
+print(f"whole file          {elapsed * 1e3:9.1f} ms, peak memory +{memory:7.1f} MB")
+with c_accesspoint.MatrixFile(library, expected_path) as expected:
+    expected_data, expected_lambdas = expected.data.copy(), expected.lambdas.copy()
+for budget in (8 << 20, 32 << 20, 128 << 20):
+    elapsed, memory = child("stream", output_path, budget)
+    print(f"stream {budget >> 20:4d} MB budget {elapsed * 1e3:9.1f} ms, peak memory +{memory:7.1f} MB")
+    with c_accesspoint.MatrixFile(library, output_path) as streamed:
+        assert np.array_equal(streamed.lambdas, expected_lambdas)
+        assert np.array_equal(streamed.data, expected_data)
+        assert streamed.column_names == [f"bm_{j}" for j in range(cols)]
+for file_path in (path, expected_path, output_path):
+    os.remove(file_path)
+os.rmdir(directory)
@@ -0,0 +1,57 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""Benchmark of ciParallelOperationS on a NumPy buffer against ciParallelOperation on copied columns.
+
+usage: python benchmark_strided.py [LIBRARY] [ROWS] [COLS]
+Defaults to 10000 x 5000; the memory of both paths is reported with the time, 10000 x 50000 needs 4 GB per copy.
+"""
+
+import sys
+from ctypes import CDLL, POINTER, c_double, c_int, pointer
+from time import perf_counter
+
+import numpy as np
+
+import _bench_util
+import c_accesspoint
+
+
+def copied(library, data):
+    rows, cols = data.shape
+    function = _bench_util.column_operation(library, "ciParallelOperation")
+    start = perf_counter()
+    matrix, columns = _bench_util.construct_column_matrix(data)
+    copy = perf_counter() - start
+    function(-3, 3, 8, pointer(matrix), 1, 0, 8)
+    total = perf_counter() - start
+    data[:, :] = np.stack(columns, axis=1)
+    return copy, perf_counter() - start, total, rows * cols * 8 + cols * 8
+
+
+def strided(library, data):
+    cols = data.shape[1]
+    function = library.ciParallelOperationS
+    function.argtypes = [c_double, c_double, c_int, POINTER(c_accesspoint._StridedMatrix), c_int, c_int, c_int]
+    lambdas = np.zeros(cols)
+    skews = np.zeros(cols)
+    error_codes = np.zeros(cols, dtype=np.intc)
+    start = perf_counter()
+    matrix = c_accesspoint._construct_c_matrix(data, lambdas, skews, error_codes)
+    function(-3, 3, 8, pointer(matrix), 1, 0, 8)
+    return perf_counter() - start, lambdas
+
+
+library = CDLL(sys.argv[1] if len(sys.argv) > 1 else "../x64/bin/comInterface.so")
+rows = int(sys.argv[2]) if len(sys.argv) > 2 else 10_000
+cols = int(sys.argv[3]) if len(sys.argv) > 3 else 5_000
+rng = np.random.default_rng(0)
+for order in ("C", "F"):
+    data = np.asarray(rng.gamma(2.0, 1.5, (rows, cols)) - 1.0, order=order)
+    reference = data.copy(order=order)
+    copy, with_back, total, memory = copied(library, reference)
+    elapsed, _ = strided(library, data)
+    print(f"{rows}x{cols} {order} order: copied columns {with_back:7.2f} s (copy {copy:5.2f} s, copy back"
+          f" {with_back - total:5.2f} s, {memory / 1e6:8.1f} MB extra) | in place {elapsed:7.2f} s"
+          f"  max |dz| {np.max(np.abs(data - reference)):.1e}")
@@ -0,0 +1,47 @@
+# Copyright (c) 2023 Jerome Brenig, Sigrun May, Ostfalia Hochschule für angewandte Wissenschaften
+# This software is distributed under the terms of the MIT license
+# which is available at https://opensource.org/licenses/MIT
+
+"""Benchmark of yjTransformBy: vectorized kernel against the scalar path."""
+
+import sys
+from ctypes import CDLL, POINTER, byref, c_double, c_int
+from time import perf_counter
+
+import numpy as np
+
+ISA_NAMES = {0: "scalar", 1: "sse2", 2: "avx2", 3: "avx512"}
+
+# Linux
+c_library = CDLL(sys.argv[1] if len(sys.argv) > 1 else "../x64/bin/comInterface.so")
+
+c_library.buildBoundaryBox.argtypes = [c_double, c_double]
+c_library.yjTransformBy.argtypes = [POINTER(POINTER(c_double)), c_double, c_int]
+c_library.ybSetInstructionSet.argtypes = [c_int]
+
+rows = 1_000_000
+repeats = 20
+rng = np.random.default_rng(0)
+data = rng.lognormal(0, 1.5, rows) * rng.choice([-1.0, 1.0], rows)
+c_library.buildBoundaryBox(c_double(-3), c_double(3))
+
+reference = None
+for isa in range(4):
+    used = c_library.ybSetInstructionSet(isa)
+    if used != isa:
+        continue
+    best = float("inf")
+    for _ in range(repeats):
+        vector = data.copy()
+        ptr = vector.ctypes.data_as(POINTER(c_double))
+        start = perf_counter()
+        err = c_library.yjTransformBy(byref(ptr), c_double(0.7), c_int(rows))
+        best = min(best, perf_counter() - start)
+    assert err == 0
+    if reference is None:
+        reference = vector
+    deviation = np.max(np.abs(vector - reference) / np.maximum(np.abs(reference), 1))
+    print(
+        f"{ISA_NAMES[isa]:>7}: {rows / best / 1e6:8.1f} M elements/s"
+        f"  (max deviation to scalar {deviation:.1e})"
+    )
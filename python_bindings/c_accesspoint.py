@@ -2,9 +2,10 @@
 # This software is distributed under the terms of the MIT license
 # which is available at https://opensource.org/licenses/MIT
 
+import functools
 import math
 from collections import namedtuple
-from ctypes import CDLL, POINTER, Structure, c_double, c_int, pointer
+from ctypes import CDLL, POINTER, Structure, c_char, c_char_p, c_double, c_int, c_longlong, c_size_t, c_void_p, pointer
 
 import numpy as np
 
@@ -13,46 +14,385 @@ Result = namedtuple(
     "Result", "unlabeled_transformed_data_np lambdas skews error_codes"
 )
 
+# element types of MATRIXS, see vectorImports.h
+_MATRIX_DTYPES = {np.dtype(np.float64): 0, np.dtype(np.float32): 1}
 
-class _IntermediateResults(Structure):
+# number_of_threads of the functions below is the amount of parts a call is split into, not of threads: the parts
+# run on the library's thread pool, shared by concurrent calls and sized to the online processors unless
+# yeojohnson.init_pool (tpInit) sets it
+
+
+class _StridedMatrix(Structure):
     _fields_ = [
         ("rows", c_int),
         ("cols", c_int),
-        ("data_matrix", POINTER(POINTER(c_double))),
+        ("data", c_void_p),
+        ("row_stride", c_longlong),
+        ("col_stride", c_longlong),
+        ("dtype", c_int),
         ("lambdas", POINTER(c_double)),
         ("skews", POINTER(c_double)),
         ("error_codes", POINTER(c_int)),
     ]
 
 
-def _construct_c_matrix(matrix, c_data_type):
-    #  getting dimensions
-    column_dimension = np.size(matrix, 1)
-    row_dimension = np.size(matrix, 0)
-    #  initialising result vectors
-    ptr_lambdas = (c_data_type * column_dimension)()
-    ptr_skews = (c_data_type * column_dimension)()
-    ptr_error_codes = (c_int * column_dimension)()
-    #  initialising pointer array
-    data_matrix = (POINTER(c_data_type) * column_dimension)()
-    #  filling pointer array with values from unlabeled_data_np
-    for i in range(column_dimension):
-        data_row = (c_data_type * row_dimension)()
-        for j in range(row_dimension):
-            value = matrix[j][i]
-            data_row[j] = c_data_type(value)
-        data_matrix[i] = data_row
-    #  transforming unlabeled_data_np into c format
-    return _IntermediateResults(
-        row_dimension,
-        column_dimension,
-        data_matrix,
-        ptr_lambdas,
-        ptr_skews,
-        ptr_error_codes,
+@functools.lru_cache(maxsize=None)
+def _load_library(path_to_c_library):
+    #  loading the library once per path, not on every call
+    return CDLL(path_to_c_library)
+
+
+def _construct_c_matrix(matrix, lambdas, skews, error_codes):
+    #  wrapping the NumPy buffer and the result arrays, nothing is copied
+    return _StridedMatrix(
+        matrix.shape[0],
+        matrix.shape[1],
+        matrix.ctypes.data,
+        matrix.strides[0],
+        matrix.strides[1],
+        _MATRIX_DTYPES[matrix.dtype],
+        lambdas.ctypes.data_as(POINTER(c_double)),
+        skews.ctypes.data_as(POINTER(c_double)),
+        error_codes.ctypes.data_as(POINTER(c_int)),
     )
 
 
+class _Model(Structure):
+    _fields_ = [
+        ("cols", c_int),
+        ("method", c_int),
+        ("interval_start", c_double),
+        ("interval_end", c_double),
+        ("precision", c_int),
+        ("tolerance", c_double),
+        ("standardize", c_int),
+        ("lambdas", POINTER(c_double)),
+        ("skews", POINTER(c_double)),
+        ("means", POINTER(c_double)),
+        ("sds", POINTER(c_double)),
+        ("error_codes", POINTER(c_int)),
+    ]
+
+
+# searches of YJMODEL, see comInterface.h
+_MODEL_METHODS = {"smart": 0, "bowley": 1, "brent": 2, "mle": 3}
+
+
+class YeoJohnsonModel:
+    """Yeo Johnson transformation fitted once and applied to further batches without searching again.
+
+    fit() keeps the lambda of every column and, with standardize, the mean and standard deviation of the
+    transformed column. transform() and inverse_transform() work in place on float64 / float32 arrays in
+    any order and return them. The fitted arrays are plain NumPy attributes and can be stored and restored.
+    """
+
+    def __init__(self, path_to_c_library, method="bowley", interval_start=-3, interval_end=3, precision=14,
+                 tolerance=1.48e-8, standardize=True, number_of_threads=1):
+        assert method in _MODEL_METHODS
+        assert number_of_threads >= 1
+        self.path_to_c_library = path_to_c_library
+        self.method = method
+        self.interval_start = interval_start
+        self.interval_end = interval_end
+        self.precision = precision
+        self.tolerance = tolerance
+        self.standardize = standardize
+        self.number_of_threads = number_of_threads
+        self.lambdas = None
+        self.skews = None
+        self.means = None
+        self.sds = None
+        self.error_codes = None
+
+    def _c_model(self, cols):
+        if self.lambdas is None or len(self.lambdas) != cols:
+            self.lambdas = np.zeros(cols, dtype=np.float64)
+            self.skews = np.zeros(cols, dtype=np.float64)
+            self.means = np.zeros(cols, dtype=np.float64)
+            self.sds = np.ones(cols, dtype=np.float64)
+            self.error_codes = np.zeros(cols, dtype=np.intc)
+        return _Model(
+            cols,
+            _MODEL_METHODS[self.method],
+            self.interval_start,
+            self.interval_end,
+            self.precision,
+            self.tolerance,
+            self.standardize,
+            self.lambdas.ctypes.data_as(POINTER(c_double)),
+            self.skews.ctypes.data_as(POINTER(c_double)),
+            self.means.ctypes.data_as(POINTER(c_double)),
+            self.sds.ctypes.data_as(POINTER(c_double)),
+            self.error_codes.ctypes.data_as(POINTER(c_int)),
+        )
+
+    def _run(self, function_name, unlabeled_data_np, fitting):
+        assert unlabeled_data_np.ndim == 2
+        if not fitting:
+            assert self.lambdas is not None, "model is not fitted"
+            assert len(self.lambdas) == unlabeled_data_np.shape[1]
+        function = getattr(_load_library(self.path_to_c_library), function_name)
+        function.argtypes = [POINTER(_Model), POINTER(_StridedMatrix), c_int, c_int]
+        function.restype = c_int
+        data_np = unlabeled_data_np
+        if data_np.dtype not in _MATRIX_DTYPES:
+            data_np = data_np.astype(np.float64)
+        data_np = np.require(data_np, requirements=["ALIGNED", "WRITEABLE"])
+        cols = data_np.shape[1]
+        model = self._c_model(cols)
+        lambdas = np.zeros(cols, dtype=np.float64)
+        skews = np.zeros(cols, dtype=np.float64)
+        error_codes = np.zeros(cols, dtype=np.intc)
+        matrix = _construct_c_matrix(data_np, lambdas, skews, error_codes)
+        ret = function(pointer(model), pointer(matrix), 0, self.number_of_threads)
+        assert ret == 0
+        if data_np is not unlabeled_data_np:
+            unlabeled_data_np[...] = data_np
+        return error_codes
+
+    def fit(self, unlabeled_data_np):
+        """Searches the lambdas (and means and standard deviations) of the columns, the data is not changed."""
+        self._run("ciModelFit", unlabeled_data_np, True)
+        return self
+
+    def transform(self, unlabeled_data_np):
+        """Transforms the columns in place with the fitted lambdas, returns the data."""
+        error_codes = self._run("ciModelTransform", unlabeled_data_np, False)
+        if error_codes.max(initial=0) > 0:
+            exception_handling(error_codes)
+            raise Exception("Error in Yeo Johnson transformation.")
+        return unlabeled_data_np
+
+    def inverse_transform(self, unlabeled_data_np):
+        """Maps transformed columns back in place to the original space, returns the data."""
+        error_codes = self._run("ciModelInverseTransform", unlabeled_data_np, False)
+        if error_codes.max(initial=0) > 0:
+            exception_handling(error_codes)
+            raise Exception("Error in inverse Yeo Johnson transformation.")
+        return unlabeled_data_np
+
+    def row_transformer(self):
+        """RowTransformer with the fitted constants, for single rows or small batches of rows."""
+        assert self.lambdas is not None, "model is not fitted"
+        return RowTransformer(self)
+
+    def fit_transform(self, unlabeled_data_np):
+        """fit and transform in one pass over the columns, returns the data."""
+        error_codes = self._run("ciModelFitTransform", unlabeled_data_np, True)
+        if error_codes.max(initial=0) > 0:
+            exception_handling(error_codes)
+            raise Exception("Error in Yeo Johnson transformation.")
+        return unlabeled_data_np
+
+
+class _RowModel(Structure):
+    _fields_ = [
+        ("cols", c_int),
+        ("lambda_pos", POINTER(c_double)),
+        ("lambda_neg", POINTER(c_double)),
+        ("inverse_pos", POINTER(c_double)),
+        ("inverse_neg", POINTER(c_double)),
+        ("mean", POINTER(c_double)),
+        ("inverse_sd", POINTER(c_double)),
+        ("buffer", c_void_p),
+    ]
+
+
+class RowTransformer:
+    """Transforms rows across all features of a fitted YeoJohnsonModel, for online inference.
+
+    The per feature constants are precomputed once (ybRowModelInit); transform() allocates nothing in C and
+    works in place on a float64 row or C order batch of rows.
+    """
+
+    def __init__(self, model):
+        self._library = _load_library(model.path_to_c_library)
+        self._library.ybRowModelInit.argtypes = [POINTER(_RowModel), c_int, POINTER(c_double), POINTER(c_double),
+                                                 POINTER(c_double), POINTER(c_int)]
+        self._library.ybRowModelFree.argtypes = [POINTER(_RowModel)]
+        self._transform = self._library.ybTransformRows
+        self._transform.argtypes = [POINTER(_RowModel), c_void_p, c_int, c_longlong]
+        self._transform.restype = c_int
+        self.cols = len(model.lambdas)
+        self._model = _RowModel()
+        standardize = model.standardize
+        ret = self._library.ybRowModelInit(
+            pointer(self._model),
+            self.cols,
+            model.lambdas.ctypes.data_as(POINTER(c_double)),
+            model.means.ctypes.data_as(POINTER(c_double)) if standardize else None,
+            model.sds.ctypes.data_as(POINTER(c_double)) if standardize else None,
+            model.error_codes.ctypes.data_as(POINTER(c_int)),
+        )
+        assert ret == 0
+        self._model_pointer = pointer(self._model)
+
+    def __del__(self):
+        if getattr(self, "_model", None) is not None:
+            self._library.ybRowModelFree(pointer(self._model))
+            self._model = None
+
+    def transform(self, rows_np):
+        """Transforms a row (1D) or rows (2D, C order) of float64 values in place and returns them."""
+        assert rows_np.dtype == np.float64 and rows_np.flags.c_contiguous and rows_np.flags.writeable
+        assert rows_np.shape[-1] == self.cols
+        row_count = 1 if rows_np.ndim == 1 else rows_np.shape[0]
+        ret = self._transform(self._model_pointer, rows_np.ctypes.data, row_count, self.cols)
+        if ret != 0:
+            raise Exception("Error in Yeo Johnson transformation of a row, a result is not finite.")
+        return rows_np
+
+
+# modes of mfOpen and sections of mfWrite, see matrixFile.h
+_MF_READ, _MF_UPDATE = 0, 1
+_MF_NAMES, _MF_RESULTS = 1, 2
+
+
+class _MatrixFile(Structure):
+    _fields_ = [
+        ("matrix", _StridedMatrix),
+        ("names", POINTER(c_char_p)),
+        ("mapping", c_void_p),
+        ("size", c_size_t),
+        ("copy", c_void_p),
+        ("mode", c_int),
+        ("results_in_file", c_int),
+    ]
+
+
+def _matrix_file_functions(library):
+    library.mfOpen.argtypes = [POINTER(_MatrixFile), c_char_p, c_int]
+    library.mfOpenArray.argtypes = [POINTER(_MatrixFile), c_char_p, c_char_p, c_int]
+    library.mfClose.argtypes = [POINTER(_MatrixFile)]
+    library.mfWrite.argtypes = [c_char_p, POINTER(_StridedMatrix), POINTER(c_char_p), c_int]
+    library.mfConvertCsv.argtypes = [c_char_p, c_char_p, c_int, c_int]
+    return library
+
+
+class MatrixFile:
+    """Binary matrix file (matrixFile.c), .npy file or array of an uncompressed .npz file mapped into memory; opening
+    it reads nothing but the header.
+
+    data is a NumPy view of the mapping in the layout of the file, transformations work on it in place. array_name
+    selects the array of a .npz file, the first one by default. With
+    update=True the values and the lambdas, skews and error_codes are written back to the file, otherwise the
+    file stays unchanged. Close the file (or use it as context manager) only after the last use of the views.
+    """
+
+    def __init__(self, path_to_c_library, path, update=False, array_name=None):
+        self._library = _matrix_file_functions(_load_library(path_to_c_library))
+        self._file = _MatrixFile()
+        ret = self._library.mfOpenArray(pointer(self._file), str(path).encode(),
+                                        array_name.encode() if array_name is not None else None,
+                                        _MF_UPDATE if update else _MF_READ)
+        if ret != 0:
+            self._file = None
+            raise Exception(f"Matrix file {path} could not be opened ({ret}).")
+        matrix = self._file.matrix
+        dtype = np.dtype(np.float64 if matrix.dtype == 0 else np.float32)
+        count = matrix.rows * matrix.cols
+        #  a view of the mapping, nothing is read before it is used
+        values = np.frombuffer((c_char * (count * dtype.itemsize)).from_address(matrix.data), dtype) if count \
+            else np.empty(0, dtype)
+        if matrix.row_stride == values.itemsize:
+            self.data = values.reshape(matrix.cols, matrix.rows).T
+        else:
+            self.data = values.reshape(matrix.rows, matrix.cols)
+        self.lambdas = np.ctypeslib.as_array(matrix.lambdas, (max(matrix.cols, 1),))[: matrix.cols]
+        self.skews = np.ctypeslib.as_array(matrix.skews, (max(matrix.cols, 1),))[: matrix.cols]
+        self.error_codes = np.ctypeslib.as_array(matrix.error_codes, (max(matrix.cols, 1),))[: matrix.cols]
+        names = self._file.names
+        self.column_names = [names[j].decode() for j in range(matrix.cols)] if names else None
+
+    def close(self):
+        if self._file is not None:
+            self.data = self.lambdas = self.skews = self.error_codes = None
+            self._library.mfClose(pointer(self._file))
+            self._file = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exception):
+        self.close()
+
+    def __del__(self):
+        if getattr(self, "_file", None) is not None:
+            self.close()
+
+
+def write_matrix_file(path_to_c_library, path, data_np, column_names=None, results=False):
+    """Writes a 2D float64 or float32 array into a binary matrix file, column major.
+
+    results reserves zeroed lambda, skew and error code sections that MatrixFile(update=True) fills.
+    """
+    if data_np.dtype not in _MATRIX_DTYPES:
+        data_np = data_np.astype(np.float64)
+    cols = data_np.shape[1]
+    lambdas, skews, error_codes = np.zeros(cols), np.zeros(cols), np.zeros(cols, dtype=np.int32)
+    c_matrix = _construct_c_matrix(data_np, lambdas, skews, error_codes)
+    sections = _MF_RESULTS if results else 0
+    names = None
+    if column_names is not None:
+        assert len(column_names) == cols
+        names = (c_char_p * cols)(*(str(name).encode() for name in column_names))
+        sections |= _MF_NAMES
+    library = _matrix_file_functions(_load_library(path_to_c_library))
+    ret = library.mfWrite(str(path).encode(), pointer(c_matrix), names, sections)
+    if ret != 0:
+        raise Exception(f"Matrix file {path} could not be written ({ret}).")
+
+
+def convert_npy_to_matrix_file(path_to_c_library, npy_path, path, column_names=None, results=False):
+    """Converts a 2D .npy file into a binary matrix file, the .npy is mapped and not read as a whole."""
+    write_matrix_file(path_to_c_library, path, np.load(npy_path, mmap_mode="r"), column_names, results)
+
+
+def convert_csv_to_matrix_file(path_to_c_library, csv_path, path, number_of_threads=1, results=False):
+    """Converts a csv (';' or ',' separated, optional header row) into a binary matrix file of float64 values.
+
+    The names of the header row become the column names.
+    """
+    library = _matrix_file_functions(_load_library(path_to_c_library))
+    ret = library.mfConvertCsv(str(csv_path).encode(), str(path).encode(), _MF_NAMES | (_MF_RESULTS if results else 0),
+                               number_of_threads)
+    if ret != 0:
+        raise Exception(f"{csv_path} could not be converted ({ret}).")
+
+
+def transform_file(path_to_c_library, path, output_path=None, interval_start=-3, interval_end=3,
+                   interval_parameter=14, standardize=True, number_of_threads=1):
+    """Yeo-Johnson transformation of a matrix file, .npy or uncompressed .npz file without loading it into Python.
+
+    The file is mapped by the C library and transformed in place, or written to output_path as a matrix file with
+    lambdas, skews and error codes (open it with MatrixFile).
+    """
+    yeo_johnson_c = _load_library(path_to_c_library).ciParallelOperationFile
+    yeo_johnson_c.argtypes = [c_double, c_double, c_int, c_char_p, c_char_p, c_int, c_int, c_int]
+    yeo_johnson_c.restype = c_int
+    ret = yeo_johnson_c(interval_start, interval_end, interval_parameter, str(path).encode(),
+                        str(output_path).encode() if output_path is not None else None, standardize, 0,
+                        number_of_threads)
+    if ret != 0:
+        raise Exception(f"{path} could not be transformed ({ret}).")
+
+
+def stream_transform_file(path_to_c_library, path, output_path, memory_budget=256 << 20, interval_start=-3,
+                          interval_end=3, interval_parameter=14, standardize=True, number_of_threads=1):
+    """Yeo-Johnson transformation of a matrix file, .npy or uncompressed .npz file larger than the memory.
+
+    The columns are streamed in blocks through memory_budget bytes (two block buffers, at least two columns) and
+    written to output_path as a matrix file with lambdas, skews and error codes (open it with MatrixFile).
+    """
+    yeo_johnson_c = _load_library(path_to_c_library).ysStreamOperation
+    yeo_johnson_c.argtypes = [c_double, c_double, c_int, c_char_p, c_char_p, c_int, c_size_t, c_int]
+    yeo_johnson_c.restype = c_int
+    ret = yeo_johnson_c(interval_start, interval_end, interval_parameter, str(path).encode(),
+                        str(output_path).encode(), standardize, memory_budget, number_of_threads)
+    if ret != 0:
+        raise Exception(f"{path} could not be transformed ({ret}).")
+
+
 def yeo_johnson_power_transformation(
     path_to_c_library: str,
     unlabeled_data_np: np.ndarray,
@@ -63,15 +403,15 @@ def yeo_johnson_power_transformation(
     time_stamps: bool = False,
     number_of_threads: int = 1,
 ):
-    #yeo_johnson_c = CDLL(path_to_c_library).ciParallelOperation
-    yeo_johnson_c = CDLL(path_to_c_library).ciParallelOperationBowley
+    #yeo_johnson_c = _load_library(path_to_c_library).ciParallelOperationS
+    yeo_johnson_c = _load_library(path_to_c_library).ciParallelOperationBowleyS
 
     # defining parameters
     yeo_johnson_c.argtypes = [
         c_double,
         c_double,
         c_int,
-        POINTER(_IntermediateResults),
+        POINTER(_StridedMatrix),
         c_int,
         c_int,
         c_int,
@@ -79,13 +419,22 @@ def yeo_johnson_power_transformation(
     # defining return type
     yeo_johnson_c.restype = c_int
 
-    # Returning unlabeled_data_np with adjusted values
+    # float64 and float32 arrays in any order are transformed in place,
+    # everything else in a float64 copy that is written back afterwards
+    assert unlabeled_data_np.ndim == 2
+    data_np = unlabeled_data_np
+    if data_np.dtype not in _MATRIX_DTYPES:
+        data_np = data_np.astype(np.float64)
+    data_np = np.require(data_np, requirements=["ALIGNED", "WRITEABLE"])
+    lambdas = np.zeros(data_np.shape[1], dtype=np.float64)
+    skews = np.zeros(data_np.shape[1], dtype=np.float64)
+    error_codes = np.zeros(data_np.shape[1], dtype=np.intc)
     # constructing c struct
-    temp_matrix = _construct_c_matrix(unlabeled_data_np, c_double)
+    temp_matrix = _construct_c_matrix(data_np, lambdas, skews, error_codes)
 
     assert number_of_threads >= 1
     # call C function
-    yeo_johnson_c(
+    ret = yeo_johnson_c(
         c_double(interval_start),
         c_double(interval_end),
         c_int(interval_parameter),
@@ -94,23 +443,13 @@ def yeo_johnson_power_transformation(
         c_int(time_stamps),
         c_int(number_of_threads),
     )
-    assert temp_matrix.cols == unlabeled_data_np.shape[1]
-    assert temp_matrix.rows == unlabeled_data_np.shape[0]
-
-    # override values
-    for i in range(temp_matrix.cols):
-        for j in range(temp_matrix.rows):
-            unlabeled_data_np[j][i] = temp_matrix.data_matrix[i][j]
-
-    lambdas = []
-    skews = []
-    error_codes = []
-    for i in range(temp_matrix.cols):
-        lambdas.append(temp_matrix.lambdas[i])
-        skews.append(temp_matrix.skews[i])
-        error_codes.append(temp_matrix.error_codes[i])
-
-    if max(error_codes) > 0:
+    assert ret == 0
+
+    # override values, only if the data had to be copied
+    if data_np is not unlabeled_data_np:
+        unlabeled_data_np[...] = data_np
+
+    if error_codes.max(initial=0) > 0:
         exception_handling(error_codes)
         raise Exception('Error in Yeo Johnson transformation. Try automated_yeo_johnson_power_transformation '
                         'for automated parameter search.')
@@ -227,3 +566,5 @@ def exception_handling(error_codes, lambda_interval_tuple=None):
             )
         elif nibble ^ 0x0005 == 0x0000:
             print("         Boundary Box is not set (unknown path #BUG)")
+        elif nibble ^ 0x0006 == 0x0000:
+            print("         Value has no inverse transformation (outside of the range of the transformation)")
@@ -0,0 +1,266 @@
+/****************************************************************
+ * Copyright (c) 2023 Jerome Brenig, Sigrun May
+ * Ostfalia Hochschule für angewandte Wissenschaften
+ *
+ * This software is distributed under the terms of the MIT license
+ * which is available at https://opensource.org/licenses/MIT
+ *
+ * FILENAME : yeojohnson.c
+ *
+ * DESCRIPTION  :
+ *          CPython extension module on the C library, built with
+ *          "make extension". Takes any writable 2-D buffer of float64 or
+ *          float32 values (NumPy arrays, memoryviews, ...) and transforms it
+ *          in place through the strided ci*S operations.
+ *
+ * PUBLIC FUNCTIONS :
+ *          yeojohnson.transform(data, interval_start=-3, interval_end=3,
+ *          method="smart", precision=14, tolerance=1.48e-8,
+ *          standardize=True, threads=1) -> (lambdas, skews, error_codes)
+ *          yeojohnson.init_pool(threads) -> None
+ *
+ * NOTES    :
+ *          transform releases the GIL while the columns are processed, other
+ *          Python threads keep running. The buffer stays exported for the
+ *          call, so it can not be resized meanwhile. threads is the amount
+ *          of parts the columns are split into; the parts run on the
+ *          library's thread pool, one thread per online processor unless
+ *          init_pool sets the size. Calls from several threads share the
+ *          pool and run side by side. The results are memoryviews of
+ *          format 'd' / 'i' that numpy.asarray wraps without copying.
+ *
+ * AUTHOR   :       agent             START DATE    : 16 October 2026
+ *
+ * CHANGES  :
+ *
+ * DATE     WHO     DETAIL
+ *
+ *H*/
+
+/*****************************************************************************
+ *                               INCLUDES
+ *****************************************************************************/
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <string.h>
+
+#include "../x64/src/include/comInterface.h"
+#include "../x64/src/include/threadPool.h"
+#include "../x64/src/include/vectorImports.h"
+
+/*****************************************************************************
+ *                           PRIVATE FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * @brief new memoryview of count values of the given format on a bytearray,
+ * zero filled
+ *
+ * @param count amount of values
+ * @param size size of one value in bytes
+ * @param format struct format of the values, "d" or "i"
+ * @param data receives the address of the first value
+ * @return PyObject* memoryview, NULL with an exception set on failure
+ */
+static PyObject *yj_result_view(Py_ssize_t count, Py_ssize_t size,
+                                const char *format, void **data) {
+  PyObject *bytes = PyByteArray_FromStringAndSize(NULL, count * size);
+  if (bytes == NULL) {
+    return NULL;
+  }
+  *data = PyByteArray_AS_STRING(bytes);
+  memset(*data, 0, count * size);
+  PyObject *view = PyMemoryView_FromObject(bytes);
+  Py_DECREF(bytes);
+  if (view == NULL) {
+    return NULL;
+  }
+  PyObject *cast = PyObject_CallMethod(view, "cast", "s", format);
+  Py_DECREF(view);
+  return cast;
+}
+
+/**
+ * @brief fills a MATRIXS from a 2-D buffer view
+ *
+ * @param view buffer of PyObject_GetBuffer with PyBUF_RECORDS
+ * @param matrix receives the strided matrix, without result arrays
+ * @return int 0, -1 with an exception set if the buffer does not fit
+ */
+static int yj_matrix_from_view(const Py_buffer *view, MATRIXS *matrix) {
+  if (view->ndim != 2) {
+    PyErr_SetString(PyExc_ValueError, "data must be 2-dimensional");
+    return -1;
+  }
+  const char *format = view->format != NULL ? view->format : "B";
+  // native byte order only, "=" and "@" are native as well
+  if (*format == '@' || *format == '=') {
+    format++;
+  }
+  if (strcmp(format, "d") == 0 && view->itemsize == sizeof(double)) {
+    matrix->dtype = MATRIX_FLOAT64;
+  } else if (strcmp(format, "f") == 0 && view->itemsize == sizeof(float)) {
+    matrix->dtype = MATRIX_FLOAT32;
+  } else {
+    PyErr_Format(PyExc_TypeError,
+                 "data must hold float64 or float32 values, not '%s'",
+                 view->format != NULL ? view->format : "B");
+    return -1;
+  }
+  if (view->shape[0] > INT_MAX || view->shape[1] > INT_MAX) {
+    PyErr_SetString(PyExc_ValueError, "data has too many rows or columns");
+    return -1;
+  }
+  matrix->rows = (int)view->shape[0];
+  matrix->cols = (int)view->shape[1];
+  matrix->data = view->buf;
+  matrix->row_stride = view->strides[0];
+  matrix->col_stride = view->strides[1];
+  return 0;
+}
+
+/*****************************************************************************
+ *                           PUBLIC FUNCTIONS
+ *****************************************************************************/
+
+PyDoc_STRVAR(
+    yj_transform_doc,
+    "transform(data, interval_start=-3, interval_end=3, method=\"smart\",\n"
+    "          precision=14, tolerance=1.48e-8, standardize=True, threads=1)\n"
+    "--\n\n"
+    "Searches the lambda of every column of the writable 2-D float64 or\n"
+    "float32 buffer data and transforms (and standardizes) it in place.\n"
+    "method is \"smart\" or \"bowley\" (scan to precision) or \"brent\" or\n"
+    "\"mle\" (search to tolerance). threads parts run on the library's\n"
+    "thread pool (see init_pool). The GIL is released meanwhile.\n"
+    "Returns the memoryviews (lambdas, skews, error_codes).");
+
+static PyObject *yj_transform(PyObject *self, PyObject *args,
+                              PyObject *kwargs) {
+  static char *keywords[] = {"data",      "interval_start", "interval_end",
+                             "method",    "precision",      "tolerance",
+                             "standardize", "threads",      NULL};
+  PyObject *data;
+  double interval_start = -3;
+  double interval_end = 3;
+  const char *method = "smart";
+  int precision = 14;
+  double tolerance = 1.48e-8;
+  int standardize = 1;
+  int threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|ddsidpi", keywords, &data,
+                                   &interval_start, &interval_end, &method,
+                                   &precision, &tolerance, &standardize,
+                                   &threads)) {
+    return NULL;
+  }
+  if (threads < 1) {
+    PyErr_SetString(PyExc_ValueError, "threads must be >= 1");
+    return NULL;
+  }
+  int (*precision_operation)(double, double, int, MATRIXS *, BOOL, BOOL,
+                             int) = NULL;
+  int (*tolerance_operation)(double, double, double, MATRIXS *, BOOL, BOOL,
+                             int) = NULL;
+  if (strcmp(method, "smart") == 0) {
+    precision_operation = ciParallelOperationS;
+  } else if (strcmp(method, "bowley") == 0) {
+    precision_operation = ciParallelOperationBowleyS;
+  } else if (strcmp(method, "brent") == 0) {
+    tolerance_operation = ciParallelOperationBrentS;
+  } else if (strcmp(method, "mle") == 0) {
+    tolerance_operation = ciParallelOperationMleS;
+  } else {
+    PyErr_Format(PyExc_ValueError,
+                 "method must be \"smart\", \"bowley\", \"brent\" or "
+                 "\"mle\", not \"%s\"",
+                 method);
+    return NULL;
+  }
+
+  Py_buffer view;
+  if (PyObject_GetBuffer(data, &view, PyBUF_RECORDS) != 0) {
+    return NULL;
+  }
+  MATRIXS matrix;
+  PyObject *lambdas = NULL;
+  PyObject *skews = NULL;
+  PyObject *error_codes = NULL;
+  PyObject *result = NULL;
+  if (yj_matrix_from_view(&view, &matrix) != 0) {
+    goto done;
+  }
+  lambdas = yj_result_view(matrix.cols, sizeof(double), "d",
+                           (void **)&matrix.lambda);
+  skews = yj_result_view(matrix.cols, sizeof(double), "d",
+                         (void **)&matrix.skew);
+  error_codes =
+      yj_result_view(matrix.cols, sizeof(int), "i", (void **)&matrix.errnum);
+  if (lambdas == NULL || skews == NULL || error_codes == NULL) {
+    goto done;
+  }
+  if (checkMatrixS(&matrix) != 0) {
+    PyErr_SetString(PyExc_ValueError,
+                    "data is not aligned to its element size");
+    goto done;
+  }
+  int ret;
+  Py_BEGIN_ALLOW_THREADS;
+  if (precision_operation != NULL) {
+    ret = precision_operation(interval_start, interval_end, precision, &matrix,
+                              standardize, 0, threads);
+  } else {
+    ret = tolerance_operation(interval_start, interval_end, tolerance, &matrix,
+                              standardize, 0, threads);
+  }
+  Py_END_ALLOW_THREADS;
+  if (ret != 0) {
+    PyErr_Format(PyExc_RuntimeError, "transformation failed with %d", ret);
+    goto done;
+  }
+  result = PyTuple_Pack(3, lambdas, skews, error_codes);
+
+done:
+  Py_XDECREF(lambdas);
+  Py_XDECREF(skews);
+  Py_XDECREF(error_codes);
+  PyBuffer_Release(&view);
+  return result;
+}
+
+PyDoc_STRVAR(yj_init_pool_doc,
+             "init_pool(threads)\n"
+             "--\n\n"
+             "(Re)starts the library's thread pool with threads threads, 0 for\n"
+             "one per processor. Waits for running transformations.");
+
+static PyObject *yj_init_pool(PyObject *self, PyObject *args) {
+  int threads;
+  if (!PyArg_ParseTuple(args, "i", &threads)) {
+    return NULL;
+  }
+  int ret;
+  Py_BEGIN_ALLOW_THREADS;
+  ret = tpInit(threads);
+  Py_END_ALLOW_THREADS;
+  if (ret != 0) {
+    PyErr_SetString(PyExc_RuntimeError, "thread pool could not be started");
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+static PyMethodDef yj_methods[] = {
+    {"transform", (PyCFunction)(void (*)(void))yj_transform,
+     METH_VARARGS | METH_KEYWORDS, yj_transform_doc},
+    {"init_pool", yj_init_pool, METH_VARARGS, yj_init_pool_doc},
+    {NULL, NULL, 0, NULL}};
+
+static struct PyModuleDef yj_module = {
+    PyModuleDef_HEAD_INIT, "yeojohnson",
+    "Yeo Johnson transformation of float buffers in place, without the GIL.",
+    -1, yj_methods};
+
+PyMODINIT_FUNC PyInit_yeojohnson(void) { return PyModule_Create(&yj_module); }
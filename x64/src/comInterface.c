@@ -17,10 +17,46 @@
  *standardize, time_stamps) int ciSmartOperation(interval_start, interval_end,
  *precision, input_matrix, standardize, time_stamps) int
  *ciParallelOperation(interval_start, interval_end, precision, input_matrix,
+ *standardize, time_stamps, thread_count) int
+ *ciParallelOperationf(interval_start, interval_end, precision, input_matrix,
  *standardize, time_stamps, thread_count)
+ * int ciParallelOperationBrent(interval_start, interval_end, tolerance,
+ *input_matrix, standardize, time_stamps, thread_count)
+ * int ciParallelOperationMle(interval_start, interval_end, tolerance,
+ *input_matrix, standardize, time_stamps, thread_count)
+ * int ciParallelOperationS / ciParallelOperationBowleyS /
+ *ciParallelOperationBrentS / ciParallelOperationMleS: the parallel operations
+ *on a strided MATRIXS
+ * int ciParallelOperationFile(interval_start, interval_end, precision,
+ *file_path, output_path, standardize, time_stamps, thread_count)
+ * int ciAllocModel(model, cols, method, interval_start, interval_end,
+ *precision, tolerance, standardize) void ciFreeModel(model)
+ * int ciModelFit / ciModelTransform / ciModelInverseTransform /
+ *ciModelFitTransform(model, input_matrix, time_stamps, thread_count)
  *
  * NOTES    :
- *
+ *          The parallel operations run their parts on the library's thread
+ *          pool (threadPool.c), which lives across calls and is shared by
+ *          concurrent callers; thread_count is the amount of parts, the pool
+ *          size is the number of online processors unless tpInit sets it.
+ *          The parts claim columns in shrinking chunks (tpRangeClaim)
+ *          instead of owning a fixed share, so cheap columns do not leave
+ *          threads idle. With fewer columns than parts, ciParallelOperation
+ *          and the tolerance searches split the rows of every column among
+ *          the parts instead (ci_row_parts).
+ *          The parallel operations standardize every column in the part that
+ *          transformed it; ciParallelOperation and the tolerance searches
+ *          take the mean and standard deviation from the fused moments of
+ *          the search and standardize during the transformation.
+ *          The *S operations take a MATRIXS, one buffer with row and column
+ *          strides such as a NumPy array, and transform it in place; F order
+ *          double columns are searched where they are, other layouts are
+ *          copied a few columns at a time into a buffer of the part.
+ *          ciParallelOperationFile runs ciParallelOperationS on a mapped
+ *          matrix file, .npy or .npz file (mfOpen) without reading it first.
+ *          A YJMODEL splits the operation into a fit, which keeps lambda,
+ *          mean and standard deviation of every column, and transformations
+ *          of later matrices with it that never search again (ciModel*).
  *
  * AUTHOR   :       jbrenig           START DATE    : 14 September 2022
  *
@@ -34,25 +70,81 @@
  *                               INCLUDES
  *****************************************************************************/
 
-#include <pthread.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "include/comInterface.h"
+#include "include/errnumCodes.h"
 #include "include/lambdaSearch.h"
+#include "include/matrixFile.h"
+#include "include/testFramework.h"
+#include "include/threadPool.h"
 #include "include/timeStamps.h"
 #include "include/vectorImports.h"
 #include "include/yeoJohnson.h"
 
+// searches with a tolerance instead of a precision (lsBrentSearchScratch,
+// lsMleSearchScratch)
+typedef int (*ciToleranceSearch)(const yjContext *context, lsScratch *scratch,
+                                 double *vector, double interval_start,
+                                 double interval_end, double tolerance,
+                                 int row_count, double *result_lambda,
+                                 double *result_skew, int *errnum);
+
+// searches with a precision (lsSmartSearchScratch,
+// lsSmartBowleySearchScratch)
+typedef int (*ciPrecisionSearch)(const yjContext *context, lsScratch *scratch,
+                                 double *vector, double interval_start,
+                                 double interval_end, int precision,
+                                 int row_count, double *result_lambda,
+                                 double *result_skew, int *errnum);
+
 typedef struct _TBODY {
   double interval_start;
   double interval_end;
   int precision;
+  double tolerance;
+  ciToleranceSearch search;
+  ciPrecisionSearch precision_search; // strided operations, if search is NULL
   MATRIX *input_matrix;
-  int thread_count;
-  int thread_number;
+  MATRIXF *input_matrixf;
+  MATRIXS *input_matrixs;
+  tpRange columns; // claimed by the parts in chunks
+  int row_parts;   // row blocks of every column, see ci_row_parts
+  BOOL standardize; // by the parts, column by column
+  YJMODEL *model;   // of a model job on input_matrixs, or NULL
+  int steps;        // CI_STEP_* of a model job
 } TBODY;
 
+// steps of a model job (ci_model_column), fit and transform may be combined
+#define CI_STEP_FIT 1
+#define CI_STEP_TRANSFORM 2
+#define CI_STEP_INVERSE 4
+
+// a column transformed in row blocks on the pool (ci_transform)
+typedef struct {
+  const yjContext *context;
+  double *vector;
+  double lambda;
+  int rows;
+  const lsStats *stats;               // standardizes the blocks unless NULL
+  int errnum[LS_MAX_ROW_PARTS];       // result of every block
+  int standardized[LS_MAX_ROW_PARTS]; // standardized leading rows of a block
+} ciRowTransform;
+
+// rows a block of a split column should at least hold (ci_row_parts)
+static const int g_minBlockRows = 1 << 15;
+
+// rows transformed and standardized while they are in the cache
+static const int g_standardizeRows = 2048;
+
+// columns of a strided matrix a part copies at once (a cache line of
+// doubles), and the values such a tile may hold at most
+static const int g_tileColumns = 8;
+static const int g_tileValues = 1 << 20;
+
 /*****************************************************************************
  *                           PRIVATE FUNCTIONS
  *****************************************************************************/
@@ -89,61 +181,877 @@ static int ci_do_standardize(MATRIX *input_matrix) {
 }
 
 /**
- * @brief thread entry function, thread executes function after creation for
- * ciParallelOperation matrix(array of vectors) is divided into modulo-classes,
- * each is handled by one thread
+ * @brief (float) overwrites input vector with standardized vector of input
+ *
+ * @param vector input vector
+ * @param rows row count of vector
+ * @return int error return code
+ */
+static int ci_standardizef(float *vector, int rows) {
+  float avg = 0;
+  float sd = 0;
+  lsAveragef(vector, rows, &avg);
+  lsVariancef(vector, avg, rows, &sd);
+  for (int i = 0; i < rows; i++) {
+    *(vector + i) = (*(vector + i) - avg) / sd;
+  }
+  return 0;
+}
+
+/**
+ * @brief row blocks every column of a matrix is split into: 1 (the columns
+ * are the parts) unless there are fewer columns than thread_count, then as
+ * many blocks of at least g_minBlockRows rows as thread_count allows
+ *
+ * @param cols column count of the matrix
+ * @param rows row count of the matrix
+ * @param thread_count parts requested by the caller
+ * @return int row blocks of every column
+ */
+static int ci_row_parts(int cols, int rows, int thread_count) {
+  if (cols >= thread_count) {
+    return 1;
+  }
+  int row_parts = rows / g_minBlockRows;
+  if (row_parts > thread_count) {
+    row_parts = thread_count;
+  }
+  if (row_parts > LS_MAX_ROW_PARTS) {
+    row_parts = LS_MAX_ROW_PARTS;
+  }
+  return row_parts > 1 ? row_parts : 1;
+}
+
+/**
+ * @brief yjTransformByCtx of rows values; with stats every g_standardizeRows
+ * values are standardized right after their transformation, so the column is
+ * written once
+ *
+ * @param context boundary boxes of the search
+ * @param vector values to be transformed in place
+ * @param lambda transformation parameter
+ * @param rows amount of values
+ * @param stats mean and standard deviation of the transformed column, NULL to
+ * transform only
+ * @param standardized receives the leading rows that were standardized, all
+ * rows unless the transformation failed
+ * @return int error return code
+ */
+static int ci_transform_block(const yjContext *context, double *vector,
+                              double lambda, int rows, const lsStats *stats,
+                              int *standardized) {
+  *standardized = 0;
+  if (stats == NULL) {
+    return yjTransformByCtx(context, &vector, lambda, rows);
+  }
+  for (int begin = 0; begin < rows; begin += g_standardizeRows) {
+    int count =
+        rows - begin < g_standardizeRows ? rows - begin : g_standardizeRows;
+    double *block = vector + begin;
+    int err_num = yjTransformByCtx(context, &block, lambda, count);
+    if (err_num != 0) {
+      return err_num;
+    }
+    for (int i = 0; i < count; i++) {
+      *(block + i) = (*(block + i) - stats->mean) / stats->sd;
+    }
+    *standardized = begin + count;
+  }
+  return 0;
+}
+
+/**
+ * @brief reverts the standardization of ci_transform_block on rows values
+ *
+ * @param vector standardized values
+ * @param rows amount of values
+ * @param stats mean and standard deviation they were standardized with
+ */
+static void ci_unstandardize(double *vector, int rows, const lsStats *stats) {
+  for (int i = 0; i < rows; i++) {
+    *(vector + i) = *(vector + i) * stats->sd + stats->mean;
+  }
+}
+
+/**
+ * @brief part of ci_transform, transforms one row block of the column
+ *
+ * @param args ciRowTransform of the column
+ * @param part index of the block
+ * @param part_count amount of blocks
+ */
+static void ci_transform_rows(void *args, int part, int part_count) {
+  ciRowTransform *rt = (ciRowTransform *)args;
+  int begin = (int)((long long)rt->rows * part / part_count);
+  int end = (int)((long long)rt->rows * (part + 1) / part_count);
+  rt->errnum[part] =
+      ci_transform_block(rt->context, rt->vector + begin, rt->lambda,
+                         end - begin, rt->stats, &rt->standardized[part]);
+}
+
+/**
+ * @brief ci_transform_block of a column, split into row_parts row blocks on
+ * the pool if row_parts > 1
+ *
+ * @param context boundary boxes of the search
+ * @param vector pointer to vector to be transformed in place
+ * @param lambda transformation parameter
+ * @param rows amount of values
+ * @param row_parts row blocks, see ci_row_parts
+ * @param stats standardizes the transformed values unless NULL
+ * @return int error return code, of the first failing block; after a failure
+ * no value is left standardized
+ */
+static int ci_transform(const yjContext *context, double **vector,
+                        double lambda, int rows, int row_parts,
+                        const lsStats *stats) {
+  int err_num = 0;
+  if (row_parts <= 1) {
+    int standardized;
+    err_num = ci_transform_block(context, *vector, lambda, rows, stats,
+                                 &standardized);
+    if (err_num != 0 && stats != NULL) {
+      ci_unstandardize(*vector, standardized, stats);
+    }
+    return err_num;
+  }
+  ciRowTransform rt;
+  rt.context = context;
+  rt.vector = *vector;
+  rt.lambda = lambda;
+  rt.rows = rows;
+  rt.stats = stats;
+  tpRun(ci_transform_rows, &rt, row_parts);
+  for (int part = 0; part < row_parts && err_num == 0; part++) {
+    err_num = rt.errnum[part];
+  }
+  for (int part = 0; err_num != 0 && stats != NULL && part < row_parts;
+       part++) {
+    int begin = (int)((long long)rows * part / row_parts);
+    ci_unstandardize(*vector + begin, rt.standardized[part], stats);
+  }
+  return err_num;
+}
+
+/**
+ * @brief transforms column i of the matrix with its lambda after a search
+ * on the scratch memory and standardizes it if the job asks for it. The mean
+ * and standard deviation come from the fused moments of the search
+ * (lsScratchStats), so transformation and standardization write the column
+ * once; columns without them and columns whose transformation failed (the
+ * standardized blocks are reverted by ci_transform) are standardized from
+ * their values as before.
+ *
+ * @param tb job of the part
+ * @param context boundary boxes of the search
+ * @param scratch scratch memory of the search of the column
+ * @param vector column to be transformed in place
+ * @param rows amount of values
+ * @param lambda result of the search
+ * @param err_num result of the search
+ * @param errnum error code of the column, a failed transformation is ORed
+ * into it (ERR_TRANSFORM)
+ * @return int error return code
+ */
+static int ci_finish_column(const TBODY *tb, const yjContext *context,
+                            lsScratch *scratch, double *vector, int rows,
+                            double lambda, int err_num, int *errnum) {
+  lsStats stats;
+  const lsStats *fused = NULL;
+  if (err_num == 0) {
+    if (tb->standardize &&
+        lsScratchStats(scratch, vector, rows, lambda, &stats.mean,
+                       &stats.sd) == 0) {
+      fused = &stats;
+    }
+    err_num = ci_transform(context, &vector, lambda, rows, tb->row_parts,
+                           fused);
+    if (err_num != 0) {
+      // printf("abort on transformBy\n");
+      *errnum |= ERR_TRANSFORM | err_num;
+      fused = NULL;
+    }
+  }
+  if (tb->standardize && fused == NULL) {
+    ci_standardize(vector, rows);
+  }
+  return err_num;
+}
+
+/**
+ * @brief part of a ciParallelOperation job on the thread pool, the parts
+ * claim chunks of columns of the matrix(array of vectors) until none are left,
+ * so a part that drew cheap columns takes over more of them
  *
  * @param args necessary information for calculation
- * @return void* pointer to thread information
+ * @param part index of this part, unused
+ * @param part_count amount of parts, unused
  */
-static void *threaded_operation(void *args) {
+static void threaded_operation(void *args, int part, int part_count) {
   TBODY *tb = (TBODY *)args;
   int err_num = 0;
-  for (int i = tb->thread_number; i < tb->input_matrix->cols;
-       i += tb->thread_count) {
-    err_num = lsSmartSearch(
-        *(tb->input_matrix->data + i), tb->interval_start, tb->interval_end,
-        tb->precision, tb->input_matrix->rows, &*(tb->input_matrix->lambda + i),
-        &*(tb->input_matrix->skew + i), &*(tb->input_matrix->errnum + i));
-    if (err_num != 0) {
-      // printf("abort on lambda smart search\n");
-    } else {
-      err_num = yjTransformBy(&*(tb->input_matrix->data + i),
-                              *(tb->input_matrix->lambda + i),
-                              tb->input_matrix->rows);
+  yjContext context; // private to this part
+  buildBoundaryBoxCtx(&context, tb->interval_start, tb->interval_end);
+  lsScratch scratch; // reused for every column of this part
+  lsScratchInit(&scratch, 1);
+  lsScratchSetRowParts(&scratch, tb->row_parts);
+  int begin = 0;
+  int end = 0;
+  while (tpRangeClaim(&tb->columns, &begin, &end)) {
+    for (int i = begin; i < end; i++) {
+      err_num = lsSmartSearchScratch(
+          &context, &scratch, *(tb->input_matrix->data + i),
+          tb->interval_start, tb->interval_end, tb->precision,
+          tb->input_matrix->rows, &*(tb->input_matrix->lambda + i),
+          &*(tb->input_matrix->skew + i), &*(tb->input_matrix->errnum + i));
       if (err_num != 0) {
-        // printf("abort on transformBy\n");
+        // printf("abort on lambda smart search\n");
       }
+      ci_finish_column(tb, &context, &scratch, *(tb->input_matrix->data + i),
+                       tb->input_matrix->rows, *(tb->input_matrix->lambda + i),
+                       err_num, &*(tb->input_matrix->errnum + i));
     }
   }
-  free(tb);
-  pthread_exit(NULL);
-  return NULL;
+  lsScratchFree(&scratch);
 }
 
-static void *threaded_operation_bowley(void *args) {
+/**
+ * @brief (float) part of a ciParallelOperationf job, claims columns
+ * like threaded_operation
+ *
+ * @param args necessary information for calculation
+ * @param part index of this part, unused
+ * @param part_count amount of parts, unused
+ */
+static void threaded_operationf(void *args, int part, int part_count) {
   TBODY *tb = (TBODY *)args;
+  MATRIXF *matrix = tb->input_matrixf;
   int err_num = 0;
-  for (int i = tb->thread_number; i < tb->input_matrix->cols;
-       i += tb->thread_count) {
-    err_num = lsSmartBowleySearch(
-        *(tb->input_matrix->data + i), tb->interval_start, tb->interval_end,
-        tb->precision, tb->input_matrix->rows, &*(tb->input_matrix->lambda + i),
-        &*(tb->input_matrix->skew + i), &*(tb->input_matrix->errnum + i));
-    if (err_num != 0) {
-      // printf("abort on lambda smart search\n");
-    } else {
-      err_num = yjTransformBy(&*(tb->input_matrix->data + i),
-                              *(tb->input_matrix->lambda + i),
-                              tb->input_matrix->rows);
+  yjContextf context; // private to this part
+  buildBoundaryBoxCtxf(&context, tb->interval_start, tb->interval_end);
+  lsScratchf scratch; // reused for every column of this part
+  lsScratchInitf(&scratch, 1);
+  int begin = 0;
+  int end = 0;
+  while (tpRangeClaim(&tb->columns, &begin, &end)) {
+    for (int i = begin; i < end; i++) {
+      err_num = lsSmartSearchScratchf(
+          &context, &scratch, *(matrix->data + i), tb->interval_start,
+          tb->interval_end, tb->precision, matrix->rows, &*(matrix->lambda + i),
+          &*(matrix->skew + i), &*(matrix->errnum + i));
       if (err_num != 0) {
-        // printf("abort on transformBy\n");
+        // printf("abort on lambda smart search\n");
+      } else {
+        err_num = yjTransformByCtxf(&context, &*(matrix->data + i),
+                                    *(matrix->lambda + i), matrix->rows);
+        if (err_num != 0) {
+          // printf("abort on transformBy\n");
+          *(matrix->errnum + i) |= ERR_TRANSFORM | err_num;
+        }
+      }
+      if (tb->standardize) {
+        ci_standardizef(*(matrix->data + i), matrix->rows);
+      }
+    }
+  }
+  lsScratchFreef(&scratch);
+}
+
+/**
+ * @brief part of a ciParallelOperationBrent or ciParallelOperationMle job,
+ * claims columns like threaded_operation
+ *
+ * @param args necessary information for calculation
+ * @param part index of this part, unused
+ * @param part_count amount of parts, unused
+ */
+static void threaded_operation_tolerance(void *args, int part,
+                                         int part_count) {
+  TBODY *tb = (TBODY *)args;
+  int err_num = 0;
+  yjContext context; // private to this part
+  buildBoundaryBoxCtx(&context, tb->interval_start, tb->interval_end);
+  lsScratch scratch; // reused for every column of this part
+  lsScratchInit(&scratch, 1);
+  lsScratchSetRowParts(&scratch, tb->row_parts);
+  int begin = 0;
+  int end = 0;
+  while (tpRangeClaim(&tb->columns, &begin, &end)) {
+    for (int i = begin; i < end; i++) {
+      err_num = tb->search(
+          &context, &scratch, *(tb->input_matrix->data + i),
+          tb->interval_start, tb->interval_end, tb->tolerance,
+          tb->input_matrix->rows,
+          &*(tb->input_matrix->lambda + i), &*(tb->input_matrix->skew + i),
+          &*(tb->input_matrix->errnum + i));
+      if (err_num != 0) {
+        // printf("abort on lambda tolerance search\n");
+      }
+      ci_finish_column(tb, &context, &scratch, *(tb->input_matrix->data + i),
+                       tb->input_matrix->rows, *(tb->input_matrix->lambda + i),
+                       err_num, &*(tb->input_matrix->errnum + i));
+    }
+  }
+  lsScratchFree(&scratch);
+}
+
+/**
+ * @brief part of a ciParallelOperationBowley job, claims columns like
+ * threaded_operation
+ *
+ * @param args necessary information for calculation
+ * @param part index of this part, unused
+ * @param part_count amount of parts, unused
+ */
+static void threaded_operation_bowley(void *args, int part, int part_count) {
+  TBODY *tb = (TBODY *)args;
+  int err_num = 0;
+  yjContext context; // private to this part
+  buildBoundaryBoxCtx(&context, tb->interval_start, tb->interval_end);
+  lsScratch scratch; // reused for every column of this part
+  lsScratchInit(&scratch, 0);
+  int begin = 0;
+  int end = 0;
+  while (tpRangeClaim(&tb->columns, &begin, &end)) {
+    for (int i = begin; i < end; i++) {
+      err_num = lsSmartBowleySearchScratch(
+          &context, &scratch, *(tb->input_matrix->data + i),
+          tb->interval_start, tb->interval_end, tb->precision,
+          tb->input_matrix->rows,
+          &*(tb->input_matrix->lambda + i), &*(tb->input_matrix->skew + i),
+          &*(tb->input_matrix->errnum + i));
+      if (err_num != 0) {
+        // printf("abort on lambda smart search\n");
+      } else {
+        err_num = yjTransformByCtx(&context, &*(tb->input_matrix->data + i),
+                                   *(tb->input_matrix->lambda + i),
+                                   tb->input_matrix->rows);
+        if (err_num != 0) {
+          // printf("abort on transformBy\n");
+          *(tb->input_matrix->errnum + i) |= ERR_TRANSFORM | err_num;
+        }
+      }
+      if (tb->standardize) {
+        ci_standardize(*(tb->input_matrix->data + i), tb->input_matrix->rows);
+      }
+    }
+  }
+  lsScratchFree(&scratch);
+}
+
+/**
+ * @brief runs a tolerance search (lsBrentSearchScratch, lsMleSearchScratch)
+ * on the columns of the input matrix like ciParallelOperation
+ *
+ * @param search search of every column
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param tolerance accuracy of the lambdas
+ * @param input_matrix array of vectors
+ * @param standardize bool if standardization is wished
+ * @param time_stamps bool if time for calculation should be measured
+ * @param thread_count count of parts claiming the columns, not of threads:
+ * the parts run on the shared thread pool, sized to the online processors
+ * unless tpInit sets it
+ * @return int error return code
+ */
+static int ci_parallel_tolerance(ciToleranceSearch search,
+                                 double interval_start, double interval_end,
+                                 double tolerance, MATRIX *input_matrix,
+                                 BOOL standardize, BOOL time_stamps,
+                                 int thread_count) {
+  if (time_stamps) {
+    // Starting Timer
+    tsSetTimer();
+  }
+  if (thread_count <= 0) {
+    printf("thread_count must be >= 1\n");
+    return -1;
+  }
+  TBODY tb; // shared by all parts
+  tb.input_matrix = input_matrix;
+  tb.input_matrixf = NULL;
+  tb.interval_start = interval_start;
+  tb.interval_end = interval_end;
+  tb.precision = 0;
+  tb.tolerance = tolerance;
+  tb.search = search;
+  // with fewer columns than threads the columns run one after another, the
+  // rows of each are split among the threads instead
+  tb.row_parts =
+      ci_row_parts(input_matrix->cols, input_matrix->rows, thread_count);
+  int parts = tb.row_parts > 1 ? 1 : thread_count;
+  tb.standardize = standardize;
+  tpRangeInit(&tb.columns, input_matrix->cols, parts);
+  tpRun(threaded_operation_tolerance, &tb, parts);
+  if (time_stamps) {
+    // Stopping Timer
+    tsStopTimer();
+    // printing result time
+    double dt = 0;
+    tsGetTime(&dt);
+    printf("Time elapsed during transformation= %f s\n", dt);
+  }
+  return 0;
+}
+
+/**
+ * @brief 1 if the columns of a strided matrix can be searched in place, i.e.
+ * they hold contiguous doubles (F order MATRIX_FLOAT64)
+ *
+ * @param matrix strided matrix
+ * @return int 1 for in place, 0 if the columns are copied into tiles
+ */
+static int ci_strided_in_place(const MATRIXS *matrix) {
+  return matrix->dtype == MATRIX_FLOAT64 &&
+         matrix->row_stride == (long long)sizeof(double);
+}
+
+/**
+ * @brief copies count columns from first on of a strided matrix into a tile
+ * of contiguous doubles, row by row so that C order rows are read in one go
+ *
+ * @param matrix strided matrix
+ * @param first first column
+ * @param count amount of columns
+ * @param tile receives column first + k at tile + k * rows
+ */
+static void ci_gather(const MATRIXS *matrix, int first, int count,
+                      double *tile) {
+  int rows = matrix->rows;
+  for (int r = 0; r < rows; r++) {
+    const char *row = (const char *)matrix->data + r * matrix->row_stride +
+                      first * matrix->col_stride;
+    for (int k = 0; k < count; k++) {
+      const char *value = row + k * matrix->col_stride;
+      *(tile + (long long)k * rows + r) =
+          matrix->dtype == MATRIX_FLOAT64 ? *(const double *)value
+                                          : *(const float *)value;
+    }
+  }
+}
+
+/**
+ * @brief copies a tile of ci_gather back into the strided matrix
+ *
+ * @param matrix strided matrix
+ * @param first first column
+ * @param count amount of columns
+ * @param tile column first + k at tile + k * rows
+ */
+static void ci_scatter(MATRIXS *matrix, int first, int count,
+                       const double *tile) {
+  int rows = matrix->rows;
+  for (int r = 0; r < rows; r++) {
+    char *row = (char *)matrix->data + r * matrix->row_stride +
+                first * matrix->col_stride;
+    for (int k = 0; k < count; k++) {
+      char *value = row + k * matrix->col_stride;
+      double result = *(tile + (long long)k * rows + r);
+      if (matrix->dtype == MATRIX_FLOAT64) {
+        *(double *)value = result;
+      } else {
+        *(float *)value = (float)result;
+      }
+    }
+  }
+}
+
+/**
+ * @brief mean and standard deviation (n - 1) of a column transformed with
+ * lambda, or of its values if transform is 0, without writing the column;
+ * the values are transformed a block at a time in a buffer on the stack
+ *
+ * @param context boundary boxes of the search
+ * @param vector column
+ * @param rows amount of values
+ * @param lambda transformation parameter
+ * @param transform 0 for the statistics of the values themselves
+ * @param mean receives the mean
+ * @param sd receives the standard deviation
+ * @return int error return code of the transformation
+ */
+static int ci_column_stats(const yjContext *context, const double *vector,
+                           int rows, double lambda, int transform,
+                           double *mean, double *sd) {
+  double block[2048]; // g_standardizeRows
+  int block_rows = (int)(sizeof(block) / sizeof(*block));
+  yjMoments moments = {0, 0, 0, 0};
+  for (int begin = 0; begin < rows; begin += block_rows) {
+    int count = rows - begin < block_rows ? rows - begin : block_rows;
+    memcpy(block, vector + begin, sizeof(double) * count);
+    if (transform) {
+      double *values = block;
+      int err_num = yjTransformByCtx(context, &values, lambda, count);
+      if (err_num != 0) {
+        return err_num;
+      }
+    }
+    for (int i = 0; i < count; i++) {
+      yjMomentsAdd(&moments, block[i]);
+    }
+  }
+  *mean = moments.mean;
+  *sd = rows > 1 ? sqrt(moments.m2 / (rows - 1)) : 0;
+  return 0;
+}
+
+/**
+ * @brief searches the lambda of column i into the model, and its mean and
+ * standard deviation after the transformation if the model standardizes.
+ * They come from the fused moments of the search when it kept them
+ * (lsScratchStats); a failed column keeps those of its values.
+ *
+ * @param tb model job of the part
+ * @param context boundary boxes of the search
+ * @param scratch scratch memory of the part
+ * @param vector column, not written
+ * @param rows amount of values
+ * @param i index of the column
+ */
+static void ci_model_fit(const TBODY *tb, const yjContext *context,
+                         lsScratch *scratch, double *vector, int rows, int i) {
+  YJMODEL *model = tb->model;
+  int err_num = 0;
+  *(model->errnum + i) = 0;
+  if (tb->search != NULL) {
+    err_num = tb->search(context, scratch, vector, tb->interval_start,
+                         tb->interval_end, tb->tolerance, rows,
+                         &*(model->lambda + i), &*(model->skew + i),
+                         &*(model->errnum + i));
+  } else {
+    err_num = tb->precision_search(
+        context, scratch, vector, tb->interval_start, tb->interval_end,
+        tb->precision, rows, &*(model->lambda + i), &*(model->skew + i),
+        &*(model->errnum + i));
+  }
+  if (err_num != 0 && *(model->errnum + i) == 0) {
+    // the search failed without a code, errnum holds ERR_* bits only
+    *(model->errnum + i) = ERR_LAMBDA_SEARCH;
+  }
+  double lambda = *(model->lambda + i);
+  *(model->mean + i) = 0;
+  *(model->sd + i) = 1;
+  if (!model->standardize) {
+    return;
+  }
+  if (*(model->errnum + i) == 0 &&
+      lsScratchStats(scratch, vector, rows, lambda, &*(model->mean + i),
+                     &*(model->sd + i)) == 0) {
+    return;
+  }
+  if (*(model->errnum + i) == 0) {
+    err_num = ci_column_stats(context, vector, rows, lambda, 1,
+                              &*(model->mean + i), &*(model->sd + i));
+    if (err_num == 0) {
+      return;
+    }
+    *(model->errnum + i) = err_num;
+  }
+  ci_column_stats(context, vector, rows, lambda, 0, &*(model->mean + i),
+                  &*(model->sd + i));
+}
+
+/**
+ * @brief transforms column i with the lambda of the model and standardizes
+ * it with the model's mean and standard deviation, in one write
+ * (ci_transform); columns the fit failed on are only standardized
+ *
+ * @param tb model job of the part
+ * @param context boundary boxes of the model's search interval
+ * @param vector column to be transformed in place
+ * @param rows amount of values
+ * @param i index of the column
+ * @return int error return code
+ */
+static int ci_model_transform(const TBODY *tb, const yjContext *context,
+                              double *vector, int rows, int i) {
+  const YJMODEL *model = tb->model;
+  lsStats stats;
+  stats.lambda = *(model->lambda + i);
+  stats.mean = *(model->mean + i);
+  stats.sd = *(model->sd + i);
+  stats.valid = 1;
+  if (*(model->errnum + i) == 0) {
+    return ci_transform(context, &vector, stats.lambda, rows, tb->row_parts,
+                        model->standardize ? &stats : NULL);
+  }
+  if (model->standardize) {
+    for (int r = 0; r < rows; r++) {
+      *(vector + r) = (*(vector + r) - stats.mean) / stats.sd;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief reverts ci_model_transform on column i: undoes the standardization
+ * and the transformation with the lambda of the model (vectorized,
+ * yjInverseTransformBy), g_standardizeRows values at a time so the column is
+ * written once. A value without an inverse stops the inverse transformation,
+ * not the standardization: the column is then unstandardized as a whole, the
+ * values before the failing one are transformed back and the others keep
+ * their transformed value.
+ *
+ * @param tb model job of the part
+ * @param vector column to be transformed back in place
+ * @param rows amount of values
+ * @param i index of the column
+ * @return int error return code, of the first value without an inverse
+ */
+static int ci_model_inverse(const TBODY *tb, double *vector, int rows, int i) {
+  const YJMODEL *model = tb->model;
+  double mean = *(model->mean + i);
+  double sd = *(model->sd + i);
+  int err_num = 0;
+  for (int begin = 0; begin < rows; begin += g_standardizeRows) {
+    int count =
+        rows - begin < g_standardizeRows ? rows - begin : g_standardizeRows;
+    double *block = vector + begin;
+    if (model->standardize) {
+      for (int r = 0; r < count; r++) {
+        *(block + r) = *(block + r) * sd + mean;
+      }
+    }
+    if (*(model->errnum + i) == 0 && err_num == 0) {
+      err_num = yjInverseTransformBy(&block, *(model->lambda + i), count);
+    }
+  }
+  return err_num;
+}
+
+/**
+ * @brief the steps of a model job on column i of the strided matrix. The
+ * matrix receives the lambda and skew of the model and the result of the
+ * transformation, or the error of the fit if the column was not transformed.
+ *
+ * @param tb model job of the part
+ * @param context boundary boxes of the model's search interval
+ * @param scratch scratch memory of the part
+ * @param vector column, transformed in place unless the job only fits
+ * @param rows amount of values
+ * @param i index of the column
+ */
+static void ci_model_column(const TBODY *tb, const yjContext *context,
+                            lsScratch *scratch, double *vector, int rows,
+                            int i) {
+  const YJMODEL *model = tb->model;
+  MATRIXS *matrix = tb->input_matrixs;
+  int err_num = 0;
+  if (tb->steps & CI_STEP_FIT) {
+    ci_model_fit(tb, context, scratch, vector, rows, i);
+  }
+  if (tb->steps & CI_STEP_TRANSFORM) {
+    err_num = ci_model_transform(tb, context, vector, rows, i);
+  } else if (tb->steps & CI_STEP_INVERSE) {
+    err_num = ci_model_inverse(tb, vector, rows, i);
+  }
+  *(matrix->lambda + i) = *(model->lambda + i);
+  *(matrix->skew + i) = *(model->skew + i);
+  *(matrix->errnum + i) =
+      *(model->errnum + i) != 0 ? *(model->errnum + i) : err_num;
+}
+
+/**
+ * @brief part of a ci*S job or a model job on a strided matrix, claims
+ * columns like threaded_operation. F order double columns are searched in
+ * place, all others are copied in tiles of up to g_tileColumns columns into a
+ * buffer of the part and back after the transformation (not after a fit).
+ *
+ * @param args necessary information for calculation
+ * @param part index of this part, unused
+ * @param part_count amount of parts, unused
+ */
+static void threaded_operation_strided(void *args, int part, int part_count) {
+  TBODY *tb = (TBODY *)args;
+  MATRIXS *matrix = tb->input_matrixs;
+  int rows = matrix->rows;
+  int err_num = 0;
+  yjContext context; // private to this part
+  buildBoundaryBoxCtx(&context, tb->interval_start, tb->interval_end);
+  lsScratch scratch; // reused for every column of this part
+  lsScratchInit(&scratch, 1);
+  lsScratchSetRowParts(&scratch, tb->row_parts);
+  int in_place = ci_strided_in_place(matrix);
+  int write = tb->model == NULL || (tb->steps & ~CI_STEP_FIT) != 0;
+  int width = 1;
+  double *tile = NULL;
+  if (!in_place) {
+    width = rows > 0 ? g_tileValues / rows : g_tileColumns;
+    width = width < 1 ? 1 : width > g_tileColumns ? g_tileColumns : width;
+    tile = (double *)malloc(sizeof(double) * (rows > 0 ? rows : 1) * width);
+  }
+  int begin = 0;
+  int end = 0;
+  while (tpRangeClaim(&tb->columns, &begin, &end)) {
+    for (int first = begin; first < end; first += width) {
+      int count = end - first < width ? end - first : width;
+      if (!in_place) {
+        if (tile == NULL) {
+          // printf("Failed to allocate memory for the tile\n");
+          for (int k = 0; k < count; k++) {
+            *(matrix->errnum + first + k) =
+                ERR_LAMBDA_SEARCH | ERR_FAILED_ALLOCATE_MEMORY;
+          }
+          continue;
+        }
+        ci_gather(matrix, first, count, tile);
+      }
+      for (int k = 0; k < count; k++) {
+        int i = first + k;
+        double *vector =
+            in_place
+                ? (double *)((char *)matrix->data + i * matrix->col_stride)
+                : tile + (long long)k * rows;
+        if (tb->model != NULL) {
+          ci_model_column(tb, &context, &scratch, vector, rows, i);
+          continue;
+        }
+        if (tb->search != NULL) {
+          err_num = tb->search(&context, &scratch, vector, tb->interval_start,
+                               tb->interval_end, tb->tolerance, rows,
+                               &*(matrix->lambda + i), &*(matrix->skew + i),
+                               &*(matrix->errnum + i));
+        } else {
+          err_num = tb->precision_search(
+              &context, &scratch, vector, tb->interval_start, tb->interval_end,
+              tb->precision, rows, &*(matrix->lambda + i),
+              &*(matrix->skew + i), &*(matrix->errnum + i));
+        }
+        if (err_num != 0) {
+          // printf("abort on lambda search\n");
+        }
+        ci_finish_column(tb, &context, &scratch, vector, rows,
+                         *(matrix->lambda + i), err_num,
+                         &*(matrix->errnum + i));
+      }
+      if (!in_place && write) {
+        ci_scatter(matrix, first, count, tile);
       }
     }
   }
-  free(tb);
-  pthread_exit(NULL);
-  return NULL;
+  free(tile);
+  lsScratchFree(&scratch);
+}
+
+/**
+ * @brief runs a precision search (search NULL) or a tolerance search on the
+ * columns of a strided matrix like ciParallelOperation, without copying the
+ * matrix
+ *
+ * @param precision_search search of every column if search is NULL
+ * @param search tolerance search of every column, or NULL
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param precision scanning precision of a precision search
+ * @param tolerance accuracy of the lambdas of a tolerance search
+ * @param input_matrix strided matrix, see checkMatrixS
+ * @param standardize bool if standardization is wished
+ * @param time_stamps bool if time for calculation should be measured
+ * @param thread_count count of parts claiming the columns, not of threads:
+ * the parts run on the shared thread pool, sized to the online processors
+ * unless tpInit sets it
+ * @param model model of a model job, NULL for a search and transformation
+ * @param steps CI_STEP_* of a model job
+ * @return int error return code
+ */
+static int ci_parallel_strided(ciPrecisionSearch precision_search,
+                               ciToleranceSearch search, double interval_start,
+                               double interval_end, int precision,
+                               double tolerance, MATRIXS *input_matrix,
+                               BOOL standardize, BOOL time_stamps,
+                               int thread_count, YJMODEL *model, int steps) {
+  if (time_stamps) {
+    // Starting Timer
+    tsSetTimer();
+  }
+  if (thread_count <= 0) {
+    printf("thread_count must be >= 1\n");
+    return -1;
+  }
+  if (checkMatrixS(input_matrix) != 0) {
+    printf("input_matrix is not a valid strided matrix\n");
+    return -2;
+  }
+  TBODY tb; // shared by all parts
+  tb.input_matrix = NULL;
+  tb.input_matrixf = NULL;
+  tb.input_matrixs = input_matrix;
+  tb.interval_start = interval_start;
+  tb.interval_end = interval_end;
+  tb.precision = precision;
+  tb.tolerance = tolerance;
+  tb.search = search;
+  tb.precision_search = precision_search;
+  tb.model = model;
+  tb.steps = steps;
+  // with fewer columns than threads the columns run one after another, the
+  // rows of each are split among the threads instead; the Bowley search
+  // reads quartiles and does not split
+  tb.row_parts =
+      precision_search == lsSmartBowleySearchScratch
+          ? 1
+          : ci_row_parts(input_matrix->cols, input_matrix->rows, thread_count);
+  int parts = tb.row_parts > 1 ? 1 : thread_count;
+  tb.standardize = standardize;
+  tpRangeInit(&tb.columns, input_matrix->cols, parts);
+  tpRun(threaded_operation_strided, &tb, parts);
+  if (time_stamps) {
+    // Stopping Timer
+    tsStopTimer();
+    // printing result time
+    double dt = 0;
+    tsGetTime(&dt);
+    printf("Time elapsed during transformation= %f s\n", dt);
+  }
+  return 0;
+}
+
+/**
+ * @brief runs the steps of a model job on the columns of a strided matrix
+ * like ciParallelOperationS, with the search of the model's method
+ *
+ * @param model fitted model, or the model to be fitted
+ * @param input_matrix strided matrix with model->cols columns
+ * @param steps CI_STEP_* of the job
+ * @param time_stamps bool if time for calculation should be measured
+ * @param thread_count count of parts claiming the columns, not of threads:
+ * the parts run on the shared thread pool, sized to the online processors
+ * unless tpInit sets it
+ * @return int error return code, -2 if input_matrix is not valid, -3 if the
+ * model does not fit it
+ */
+static int ci_parallel_model(YJMODEL *model, MATRIXS *input_matrix, int steps,
+                             BOOL time_stamps, int thread_count) {
+  if (model == NULL || input_matrix == NULL ||
+      model->cols != input_matrix->cols) {
+    printf("model does not match input_matrix\n");
+    return -3;
+  }
+  ciPrecisionSearch precision_search = NULL;
+  ciToleranceSearch search = NULL;
+  switch (model->method) {
+  case CI_METHOD_SMART:
+    precision_search = lsSmartSearchScratch;
+    break;
+  case CI_METHOD_BOWLEY:
+    precision_search = lsSmartBowleySearchScratch;
+    break;
+  case CI_METHOD_BRENT:
+    search = lsBrentSearchScratch;
+    break;
+  case CI_METHOD_MLE:
+    search = lsMleSearchScratch;
+    break;
+  default:
+    printf("unknown method of the model\n");
+    return -3;
+  }
+  return ci_parallel_strided(precision_search, search, model->interval_start,
+                             model->interval_end, model->precision,
+                             model->tolerance, input_matrix,
+                             model->standardize, time_stamps, thread_count,
+                             model, steps);
 }
 
 /*****************************************************************************
@@ -221,25 +1129,33 @@ int ciLambdaOperation(double interval_start, double interval_end,
                       double interval_step, MATRIX *input_matrix,
                       BOOL standardize, BOOL time_stamps) {
   int err_num = 0;
+  yjContext context;
+  buildBoundaryBoxCtx(&context, interval_start, interval_end);
+  lsScratch scratch;
+  lsScratchInit(&scratch, 1);
   if (time_stamps) {
     // Starting Timer
     tsSetTimer();
   }
   for (int i = 0; i < input_matrix->cols; i++) {
-    err_num = lsLambdaSearch(
-        *(input_matrix->data + i), interval_start, interval_end, interval_step,
+    err_num = lsLambdaSearchScratch(
+        &context, &scratch, *(input_matrix->data + i), interval_start,
+        interval_end,
+        interval_step,
         input_matrix->rows, &*(input_matrix->lambda + i),
         &*(input_matrix->skew + i), &*(input_matrix->errnum + i));
     if (err_num != 0) {
       // printf("abort on lambda search\n");
     } else {
-      err_num = yjTransformBy(&*(input_matrix->data + i),
-                              *(input_matrix->lambda + i), input_matrix->rows);
+      err_num = yjTransformByCtx(&context, &*(input_matrix->data + i),
+                                 *(input_matrix->lambda + i),
+                                 input_matrix->rows);
       if (err_num != 0) {
         // printf("abort on transformBy\n");
       }
     }
   }
+  lsScratchFree(&scratch);
   if (standardize) {
     // standardize vector list
     ci_do_standardize(input_matrix);
@@ -271,27 +1187,35 @@ int ciSmartOperation(double interval_start, double interval_end, int precision,
                      MATRIX *input_matrix, BOOL standardize, BOOL time_stamps) {
   int flag = 0;
   int err_num = 0;
+  yjContext context;
+  buildBoundaryBoxCtx(&context, interval_start, interval_end);
+  lsScratch scratch;
+  lsScratchInit(&scratch, 1);
   if (time_stamps) {
     // Starting Timer
     tsSetTimer();
   }
   for (int i = 0; i < input_matrix->cols; i++) {
-    err_num = lsSmartSearch(
-        *(input_matrix->data + i), interval_start, interval_end, precision,
+    err_num = lsSmartSearchScratch(
+        &context, &scratch, *(input_matrix->data + i), interval_start,
+        interval_end,
+        precision,
         input_matrix->rows, &*(input_matrix->lambda + i),
         &*(input_matrix->skew + i), &*(input_matrix->errnum + i));
     if (err_num != 0) {
       // printf("abort on lambda smart search\n");
       flag = 1;
     } else {
-      err_num = yjTransformBy(&*(input_matrix->data + i),
-                              *(input_matrix->lambda + i), input_matrix->rows);
+      err_num = yjTransformByCtx(&context, &*(input_matrix->data + i),
+                                 *(input_matrix->lambda + i),
+                                 input_matrix->rows);
       if (err_num != 0) {
         flag = 1;
         // printf("abort on transformBy\n");
       }
     }
   }
+  lsScratchFree(&scratch);
   if (standardize) {
     // standardize vector list
     ci_do_standardize(input_matrix);
@@ -321,7 +1245,9 @@ int ciSmartOperation(double interval_start, double interval_end, int precision,
  * @param input_matrix array of vectors
  * @param standardize bool if standardization is wished
  * @param time_stamps bool if time for calculation should be measured
- * @param thread_count count of thread to be created
+ * @param thread_count count of parts claiming the columns, not of threads:
+ * the parts run on the shared thread pool, sized to the online processors
+ * unless tpInit sets it
  * @return int error return code
  */
 int ciParallelOperation(double interval_start, double interval_end,
@@ -331,35 +1257,71 @@ int ciParallelOperation(double interval_start, double interval_end,
     // Starting Timer
     tsSetTimer();
   }
-  // Thread instantiation
   if (thread_count <= 0) {
     printf("thread_count must be >= 1\n");
     return -1;
   }
-  pthread_t *th = malloc(sizeof(pthread_t) * thread_count);
-  if (th == NULL) {
-    printf("Not enough memory for thread creation\n");
-    return -1;
+  TBODY tb; // shared by all parts
+  tb.input_matrix = input_matrix;
+  tb.input_matrixf = NULL;
+  tb.interval_start = interval_start;
+  tb.interval_end = interval_end;
+  tb.precision = precision;
+  // with fewer columns than threads the columns run one after another, the
+  // rows of each are split among the threads instead
+  tb.row_parts =
+      ci_row_parts(input_matrix->cols, input_matrix->rows, thread_count);
+  int parts = tb.row_parts > 1 ? 1 : thread_count;
+  tb.standardize = standardize;
+  tpRangeInit(&tb.columns, input_matrix->cols, parts);
+  tpRun(threaded_operation, &tb, parts);
+  if (time_stamps) {
+    // Stopping Timer
+    tsStopTimer();
+    // printing result time
+    double dt = 0;
+    tsGetTime(&dt);
+    printf("Time elapsed during transformation= %f s\n", dt);
   }
+  return 0;
+}
 
-  for (int i = 0; i < thread_count; i++) {
-    TBODY *tb = malloc(sizeof(TBODY));
-    tb->input_matrix = input_matrix;
-    tb->interval_start = interval_start;
-    tb->interval_end = interval_end;
-    tb->precision = precision;
-    tb->thread_count = thread_count;
-    tb->thread_number = i;
-    pthread_create(&th[i], NULL, &threaded_operation, tb);
-  }
-  for (int i = 0; i < thread_count; i++) {
-    pthread_join(
-        th[i], NULL); // no memory leak -> memory is freed in threaded_operation
+/**
+ * @brief (float) single precision variant of ciParallelOperation, halves the
+ * memory traffic and doubles the lanes of the vectorized transformation
+ *
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param precision scanning precision
+ * @param input_matrix array of float vectors
+ * @param standardize bool if standardization is wished
+ * @param time_stamps bool if time for calculation should be measured
+ * @param thread_count count of parts claiming the columns, not of threads:
+ * the parts run on the shared thread pool, sized to the online processors
+ * unless tpInit sets it
+ * @return int error return code
+ */
+int ciParallelOperationf(double interval_start, double interval_end,
+                         int precision, MATRIXF *input_matrix,
+                         BOOL standardize, BOOL time_stamps, int thread_count) {
+  if (time_stamps) {
+    // Starting Timer
+    tsSetTimer();
   }
-  if (standardize) {
-    // standardize vector list
-    ci_do_standardize(input_matrix);
+  if (thread_count <= 0) {
+    printf("thread_count must be >= 1\n");
+    return -1;
   }
+  TBODY tb; // shared by all parts
+  tb.input_matrix = NULL;
+  tb.input_matrixf = input_matrix;
+  tb.interval_start = interval_start;
+  tb.interval_end = interval_end;
+  tb.precision = precision;
+  tb.row_parts = 1;
+  tb.standardize = standardize;
+  tpRangeInit(&tb.columns, input_matrix->cols, thread_count);
+  tpRun(threaded_operationf, &tb, thread_count);
   if (time_stamps) {
     // Stopping Timer
     tsStopTimer();
@@ -378,35 +1340,20 @@ int ciParallelOperationBowley(double interval_start, double interval_end,
     // Starting Timer
     tsSetTimer();
   }
-  // Thread instantiation
   if (thread_count <= 0) {
     printf("thread_count must be >= 1\n");
     return -1;
   }
-  pthread_t *th = malloc(sizeof(pthread_t) * thread_count);
-  if (th == NULL) {
-    printf("Not enough memory for thread creation\n");
-    return -1;
-  }
-
-  for (int i = 0; i < thread_count; i++) {
-    TBODY *tb = malloc(sizeof(TBODY));
-    tb->input_matrix = input_matrix;
-    tb->interval_start = interval_start;
-    tb->interval_end = interval_end;
-    tb->precision = precision;
-    tb->thread_count = thread_count;
-    tb->thread_number = i;
-    pthread_create(&th[i], NULL, &threaded_operation_bowley, tb);
-  }
-  for (int i = 0; i < thread_count; i++) {
-    pthread_join(
-        th[i], NULL); // no memory leak -> memory is freed in threaded_operation
-  }
-  if (standardize) {
-    // standardize vector list
-    ci_do_standardize(input_matrix);
-  }
+  TBODY tb; // shared by all parts
+  tb.input_matrix = input_matrix;
+  tb.input_matrixf = NULL;
+  tb.interval_start = interval_start;
+  tb.interval_end = interval_end;
+  tb.precision = precision;
+  tb.row_parts = 1;
+  tb.standardize = standardize;
+  tpRangeInit(&tb.columns, input_matrix->cols, thread_count);
+  tpRun(threaded_operation_bowley, &tb, thread_count);
   if (time_stamps) {
     // Stopping Timer
     tsStopTimer();
@@ -416,4 +1363,544 @@ int ciParallelOperationBowley(double interval_start, double interval_end,
     printf("Time elapsed during transformation= %f s\n", dt);
   }
   return 0;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief calculates lambda and skew for the input matrix like
+ * ciParallelOperation, but finds the root of skew(lambda) with Brent's method
+ * (lsBrentSearch) instead of scanning, the lambdas stay inside the interval
+ *
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param tolerance accuracy of the lambdas
+ * @param input_matrix array of vectors
+ * @param standardize bool if standardization is wished
+ * @param time_stamps bool if time for calculation should be measured
+ * @param thread_count count of parts claiming the columns, not of threads:
+ * the parts run on the shared thread pool, sized to the online processors
+ * unless tpInit sets it
+ * @return int error return code
+ */
+int ciParallelOperationBrent(double interval_start, double interval_end,
+                             double tolerance, MATRIX *input_matrix,
+                             BOOL standardize, BOOL time_stamps,
+                             int thread_count) {
+  return ci_parallel_tolerance(lsBrentSearchScratch, interval_start,
+                               interval_end, tolerance, input_matrix,
+                               standardize, time_stamps, thread_count);
+}
+
+/**
+ * @brief calculates lambda and skew for the input matrix like
+ * ciParallelOperation, but with the lambdas of maximum likelihood
+ * (lsMleSearch) that sklearn's PowerTransformer would choose inside the
+ * interval
+ *
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param tolerance accuracy of the lambdas
+ * @param input_matrix array of vectors
+ * @param standardize bool if standardization is wished
+ * @param time_stamps bool if time for calculation should be measured
+ * @param thread_count count of parts claiming the columns, not of threads:
+ * the parts run on the shared thread pool, sized to the online processors
+ * unless tpInit sets it
+ * @return int error return code
+ */
+int ciParallelOperationMle(double interval_start, double interval_end,
+                           double tolerance, MATRIX *input_matrix,
+                           BOOL standardize, BOOL time_stamps,
+                           int thread_count) {
+  return ci_parallel_tolerance(lsMleSearchScratch, interval_start,
+                               interval_end, tolerance, input_matrix,
+                               standardize, time_stamps, thread_count);
+}
+
+/**
+ * @brief ciParallelOperation on a strided matrix, e.g. a C or F order NumPy
+ * buffer, transformed in place without copying the matrix
+ *
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param precision scanning precision
+ * @param input_matrix strided matrix, see checkMatrixS
+ * @param standardize bool if standardization is wished
+ * @param time_stamps bool if time for calculation should be measured
+ * @param thread_count count of parts claiming the columns, not of threads:
+ * the parts run on the shared thread pool, sized to the online processors
+ * unless tpInit sets it
+ * @return int error return code, -2 if input_matrix is not valid
+ */
+int ciParallelOperationS(double interval_start, double interval_end,
+                         int precision, MATRIXS *input_matrix,
+                         BOOL standardize, BOOL time_stamps, int thread_count) {
+  return ci_parallel_strided(lsSmartSearchScratch, NULL, interval_start,
+                             interval_end, precision, 0, input_matrix,
+                             standardize, time_stamps, thread_count, NULL, 0);
+}
+
+/**
+ * @brief ciParallelOperationBowley on a strided matrix, see
+ * ciParallelOperationS
+ *
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param precision scanning precision
+ * @param input_matrix strided matrix, see checkMatrixS
+ * @param standardize bool if standardization is wished
+ * @param time_stamps bool if time for calculation should be measured
+ * @param thread_count count of parts claiming the columns, not of threads:
+ * the parts run on the shared thread pool, sized to the online processors
+ * unless tpInit sets it
+ * @return int error return code, -2 if input_matrix is not valid
+ */
+int ciParallelOperationBowleyS(double interval_start, double interval_end,
+                               int precision, MATRIXS *input_matrix,
+                               BOOL standardize, BOOL time_stamps,
+                               int thread_count) {
+  return ci_parallel_strided(lsSmartBowleySearchScratch, NULL, interval_start,
+                             interval_end, precision, 0, input_matrix,
+                             standardize, time_stamps, thread_count, NULL, 0);
+}
+
+/**
+ * @brief ciParallelOperationBrent on a strided matrix, see
+ * ciParallelOperationS
+ *
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param tolerance accuracy of the lambdas
+ * @param input_matrix strided matrix, see checkMatrixS
+ * @param standardize bool if standardization is wished
+ * @param time_stamps bool if time for calculation should be measured
+ * @param thread_count count of parts claiming the columns, not of threads:
+ * the parts run on the shared thread pool, sized to the online processors
+ * unless tpInit sets it
+ * @return int error return code, -2 if input_matrix is not valid
+ */
+int ciParallelOperationBrentS(double interval_start, double interval_end,
+                              double tolerance, MATRIXS *input_matrix,
+                              BOOL standardize, BOOL time_stamps,
+                              int thread_count) {
+  return ci_parallel_strided(NULL, lsBrentSearchScratch, interval_start,
+                             interval_end, 0, tolerance, input_matrix,
+                             standardize, time_stamps, thread_count, NULL, 0);
+}
+
+/**
+ * @brief ciParallelOperationMle on a strided matrix, see ciParallelOperationS
+ *
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param tolerance accuracy of the lambdas
+ * @param input_matrix strided matrix, see checkMatrixS
+ * @param standardize bool if standardization is wished
+ * @param time_stamps bool if time for calculation should be measured
+ * @param thread_count count of parts claiming the columns, not of threads:
+ * the parts run on the shared thread pool, sized to the online processors
+ * unless tpInit sets it
+ * @return int error return code, -2 if input_matrix is not valid
+ */
+int ciParallelOperationMleS(double interval_start, double interval_end,
+                            double tolerance, MATRIXS *input_matrix,
+                            BOOL standardize, BOOL time_stamps,
+                            int thread_count) {
+  return ci_parallel_strided(NULL, lsMleSearchScratch, interval_start,
+                             interval_end, 0, tolerance, input_matrix,
+                             standardize, time_stamps, thread_count, NULL, 0);
+}
+
+/**
+ * @brief ciParallelOperationS on a matrix file, .npy file or .npz array (see
+ * mfOpen), mapped instead of read. Without output_path the file is
+ * transformed in place, otherwise it stays unchanged and the transformed
+ * matrix is written to output_path as a matrix file with its results and
+ * column names.
+ *
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param precision scanning precision
+ * @param file_path matrix file, .npy or .npz file
+ * @param output_path matrix file to write, NULL to update file_path
+ * @param standardize bool if standardization is wished
+ * @param time_stamps bool if time for calculation should be measured
+ * @param thread_count count of parts claiming the columns, not of threads:
+ * the parts run on the shared thread pool, sized to the online processors
+ * unless tpInit sets it
+ * @return int error return code: -1 file_path is null, -2 file can not be
+ * opened, -3 operation failed, -4 output can not be written
+ */
+int ciParallelOperationFile(double interval_start, double interval_end,
+                            int precision, char *file_path, char *output_path,
+                            BOOL standardize, BOOL time_stamps,
+                            int thread_count) {
+  if (file_path == NULL) {
+    return -1;
+  }
+  MATRIXFILE file;
+  if (mfOpen(&file, file_path, output_path == NULL ? MF_UPDATE : MF_READ) !=
+      0) {
+    return -2;
+  }
+  int ret = ciParallelOperationS(interval_start, interval_end, precision,
+                                 &file.matrix, standardize, time_stamps,
+                                 thread_count) != 0
+                ? -3
+                : 0;
+  if (ret == 0 && output_path != NULL &&
+      mfWrite(output_path, &file.matrix, file.names,
+              MF_RESULTS | (file.names != NULL ? MF_NAMES : 0)) != 0) {
+    ret = -4;
+  }
+  mfClose(&file);
+  return ret;
+}
+
+/**
+ * @brief allocates the arrays of a model of cols columns, release with
+ * ciFreeModel. The model is fitted by ciModelFit or ciModelFitTransform.
+ *
+ * @param model receives the model
+ * @param cols amount of columns
+ * @param method CI_METHOD_* search of the fit
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param precision scanning precision of CI_METHOD_SMART and CI_METHOD_BOWLEY
+ * @param tolerance accuracy of the lambdas of CI_METHOD_BRENT and
+ * CI_METHOD_MLE
+ * @param standardize bool if the transformed columns are standardized
+ * @return int error return code
+ */
+int ciAllocModel(YJMODEL *model, int cols, int method, double interval_start,
+                 double interval_end, int precision, double tolerance,
+                 BOOL standardize) {
+  if (model == NULL) {
+    return -1;
+  }
+  memset(model, 0, sizeof(YJMODEL));
+  if (cols < 0) {
+    return -3;
+  }
+  int count = cols > 0 ? cols : 1;
+  model->lambda = (double *)calloc(count, sizeof(double));
+  model->skew = (double *)calloc(count, sizeof(double));
+  model->mean = (double *)calloc(count, sizeof(double));
+  model->sd = (double *)calloc(count, sizeof(double));
+  model->errnum = (int *)calloc(count, sizeof(int));
+  if (model->lambda == NULL || model->skew == NULL || model->mean == NULL ||
+      model->sd == NULL || model->errnum == NULL) {
+    printf("\tFailed to allocate memory for the model.\n");
+    ciFreeModel(model);
+    return -4;
+  }
+  model->cols = cols;
+  model->method = method;
+  model->interval_start = interval_start;
+  model->interval_end = interval_end;
+  model->precision = precision;
+  model->tolerance = tolerance;
+  model->standardize = standardize;
+  return 0;
+}
+
+/**
+ * @brief releases the arrays of ciAllocModel
+ *
+ * @param model model of ciAllocModel
+ */
+void ciFreeModel(YJMODEL *model) {
+  if (model == NULL) {
+    return;
+  }
+  free(model->lambda);
+  free(model->skew);
+  free(model->mean);
+  free(model->sd);
+  free(model->errnum);
+  memset(model, 0, sizeof(YJMODEL));
+}
+
+/**
+ * @brief fits the model to the columns of a strided matrix: searches their
+ * lambdas and, if the model standardizes, the mean and standard deviation of
+ * the transformed columns. The matrix is not written.
+ *
+ * @param model model with input_matrix->cols columns, receives the fit
+ * @param input_matrix strided matrix, see checkMatrixS
+ * @param time_stamps bool if time for calculation should be measured
+ * @param thread_count count of parts claiming the columns, not of threads:
+ * the parts run on the shared thread pool, sized to the online processors
+ * unless tpInit sets it
+ * @return int error return code, -2 if input_matrix is not valid, -3 if the
+ * model does not fit it
+ */
+int ciModelFit(YJMODEL *model, MATRIXS *input_matrix, BOOL time_stamps,
+               int thread_count) {
+  return ci_parallel_model(model, input_matrix, CI_STEP_FIT, time_stamps,
+                           thread_count);
+}
+
+/**
+ * @brief transforms the columns of a strided matrix in place with a fitted
+ * model, without searching; lambdas and skews of the model are copied to
+ * the matrix, its errnum receives the result of every column
+ *
+ * @param model fitted model with input_matrix->cols columns
+ * @param input_matrix strided matrix, see checkMatrixS
+ * @param time_stamps bool if time for calculation should be measured
+ * @param thread_count count of parts claiming the columns, not of threads:
+ * the parts run on the shared thread pool, sized to the online processors
+ * unless tpInit sets it
+ * @return int error return code, -2 if input_matrix is not valid, -3 if the
+ * model does not fit it
+ */
+int ciModelTransform(const YJMODEL *model, MATRIXS *input_matrix,
+                     BOOL time_stamps, int thread_count) {
+  // the transformation only reads the model
+  return ci_parallel_model((YJMODEL *)model, input_matrix, CI_STEP_TRANSFORM,
+                           time_stamps, thread_count);
+}
+
+/**
+ * @brief maps transformed columns of a strided matrix back in place, the
+ * inverse of ciModelTransform; values without an inverse leave errnum set
+ * (ERR_VALUE_NOT_IN_DOMAIN), such a column is unstandardized but transformed
+ * back only up to its first value without an inverse
+ *
+ * @param model fitted model with input_matrix->cols columns
+ * @param input_matrix strided matrix, see checkMatrixS
+ * @param time_stamps bool if time for calculation should be measured
+ * @param thread_count count of parts claiming the columns, not of threads:
+ * the parts run on the shared thread pool, sized to the online processors
+ * unless tpInit sets it
+ * @return int error return code, -2 if input_matrix is not valid, -3 if the
+ * model does not fit it
+ */
+int ciModelInverseTransform(const YJMODEL *model, MATRIXS *input_matrix,
+                            BOOL time_stamps, int thread_count) {
+  // the inverse transformation only reads the model
+  return ci_parallel_model((YJMODEL *)model, input_matrix, CI_STEP_INVERSE,
+                           time_stamps, thread_count);
+}
+
+/**
+ * @brief ciModelFit and ciModelTransform of a strided matrix in one pass
+ * over its columns, the equivalent of ciParallelOperationS that keeps the
+ * fit
+ *
+ * @param model model with input_matrix->cols columns, receives the fit
+ * @param input_matrix strided matrix, see checkMatrixS
+ * @param time_stamps bool if time for calculation should be measured
+ * @param thread_count count of parts claiming the columns, not of threads:
+ * the parts run on the shared thread pool, sized to the online processors
+ * unless tpInit sets it
+ * @return int error return code, -2 if input_matrix is not valid, -3 if the
+ * model does not fit it
+ */
+int ciModelFitTransform(YJMODEL *model, MATRIXS *input_matrix,
+                        BOOL time_stamps, int thread_count) {
+  return ci_parallel_model(model, input_matrix,
+                           CI_STEP_FIT | CI_STEP_TRANSFORM, time_stamps,
+                           thread_count);
+}
+
+/*****************************************************************************
+ *                                TESTS
+ *****************************************************************************/
+#ifdef UNIT_TEST
+
+void test_ci_finish_column(void) {
+  printf("Testing ci_finish_column in comInterface.c\n");
+  int rows = 8192;
+  double *vector = malloc(rows * sizeof(double));
+  TBODY tb;
+  memset(&tb, 0, sizeof(tb));
+  tb.standardize = 1;
+  // the value out of the shrunk boundary box fails the second standardized
+  // chunk of the column, or of its second row block
+  for (int row_parts = 1; row_parts <= 2; row_parts++) {
+    for (int i = 0; i < rows; i++) {
+      *(vector + i) = ((i * 37) % 101) / 10.0 + 0.1;
+    }
+    *(vector + 7000) = 5000;
+    yjContext context;
+    buildBoundaryBoxCtx(&context, -3, 3);
+    lsScratch scratch;
+    lsScratchInit(&scratch, 1);
+    lsScratchSetRowParts(&scratch, row_parts);
+    double lambda = 0;
+    double skew = 0;
+    int errnum = 0;
+    int err_num = lsSmartSearchScratch(&context, &scratch, vector, -3, 3, 14,
+                                       rows, &lambda, &skew, &errnum);
+    assert_int_equals(err_num, 0, "Error: search should execute");
+    context.yj1.upper_limit = 1000;
+    tb.row_parts = row_parts;
+    err_num = ci_finish_column(&tb, &context, &scratch, vector, rows, lambda,
+                               0, &errnum);
+    assert_int_equals((err_num & ERR_TRANSFORM) != 0, 1,
+                      "Error: transformation should fail");
+    assert_int_equals(errnum, err_num,
+                      "Error: failed transformation should be recorded");
+    double average = 0;
+    double sd = 0;
+    lsAverage(vector, rows, &average);
+    lsVariance(vector, average, rows, &sd);
+    is_in_bound(average, 0, 1e-9,
+                "Error: mean, column should be standardized as a whole");
+    is_in_bound(sd, 1, 1e-9,
+                "Error: deviation, column should be standardized as a whole");
+    lsScratchFree(&scratch);
+  }
+  free(vector);
+  printf("...done\n");
+}
+
+void test_ci_model_inverse(void) {
+  printf("Testing ci_model_inverse in comInterface.c\n");
+  int rows = 5000;
+  double *vector = malloc(rows * sizeof(double));
+  double *expected = malloc(rows * sizeof(double));
+  double lambda = -1;
+  double skew = 0;
+  double mean = 0.5;
+  double sd = 2;
+  int errnum = 0;
+  YJMODEL model;
+  memset(&model, 0, sizeof(model));
+  model.cols = 1;
+  model.standardize = 1;
+  model.lambda = &lambda;
+  model.skew = &skew;
+  model.mean = &mean;
+  model.sd = &sd;
+  model.errnum = &errnum;
+  TBODY tb;
+  memset(&tb, 0, sizeof(tb));
+  tb.model = &model;
+  // transformed values of lambda -1 are below 1, the value 2 of row 3000 has
+  // no inverse and stops the inverse transformation in the second block
+  for (int i = 0; i < rows; i++) {
+    double value = i == 3000 ? 2 : (i % 10) * 0.09;
+    *(expected + i) = value;
+    if (i < 3000) {
+      yjInverseCalculation(value, lambda, expected + i);
+    }
+    *(vector + i) = (value - mean) / sd;
+  }
+  int err_num = ci_model_inverse(&tb, vector, rows, 0);
+  assert_int_equals((err_num & ERR_VALUE_NOT_IN_DOMAIN) != 0, 1,
+                    "Error: inverse transformation should fail");
+  for (int i = 0; i < rows; i++) {
+    if (fabs(*(vector + i) - *(expected + i)) > 1e-12) {
+      printf("Error: row %d should be unstandardized, transformed back only "
+             "before the failing value\n",
+             i);
+      break;
+    }
+  }
+  free(vector);
+  free(expected);
+  printf("...done\n");
+}
+
+static double *test_ci_value(const MATRIXS *matrix, int r, int c) {
+  return (double *)((char *)matrix->data + r * matrix->row_stride +
+                    c * matrix->col_stride);
+}
+
+void test_ciModel(void) {
+  printf("Testing ciModelFit, ciModelTransform, ciModelInverseTransform and "
+         "ciModelFitTransform in comInterface.c\n");
+  int rows = 600;
+  int cols = 4;
+  // copies of one C order matrix: 0 the model, 1 ciParallelOperationS, 2
+  // ciModelFitTransform, 3 the original values
+  MATRIXS matrices[4];
+  for (int m = 0; m < 4; m++) {
+    assert_int_equals(allocMatrixS(&matrices[m], rows, cols, MATRIX_FLOAT64, 0),
+                      0, "Error: should allocate");
+    for (int r = 0; r < rows; r++) {
+      for (int c = 0; c < cols; c++) {
+        double value = ((r * 37 + c * 11) % 101) / 10.0 + 0.1;
+        *test_ci_value(&matrices[m], r, c) = pow(value, c + 1) - c;
+      }
+    }
+    // the value out of every boundary box fails the search of column 3
+    *test_ci_value(&matrices[m], 17, 3) = 1e300;
+  }
+  YJMODEL model;
+  YJMODEL fit_transform;
+  assert_int_equals(ciAllocModel(&model, cols, CI_METHOD_SMART, -3, 3, 14, 0,
+                                 1),
+                    0, "Error: should allocate");
+  assert_int_equals(ciAllocModel(&fit_transform, cols, CI_METHOD_SMART, -3,
+                                 3, 14, 0, 1),
+                    0, "Error: should allocate");
+  assert_int_equals(ciModelFit(&model, &matrices[0], 0, 3), 0,
+                    "Error: should fit");
+  assert_int_equals(ciParallelOperationS(-3, 3, 14, &matrices[1], 1, 0, 3), 0,
+                    "Error: should execute");
+  assert_int_equals(ciModelFitTransform(&fit_transform, &matrices[2], 0, 3),
+                    0, "Error: should fit and transform");
+  for (int c = 0; c < 3; c++) {
+    assert_double_equals(*(model.lambda + c), *(matrices[1].lambda + c),
+                         "Error: fit should find the lambda of the search");
+    assert_double_equals(*(fit_transform.lambda + c), *(model.lambda + c),
+                         "Error: fit and transform should find the lambda");
+    assert_int_equals(*(model.errnum + c), 0, "Error: fit should succeed");
+  }
+  assert_int_equals(*(model.errnum + 3) != 0, 1,
+                    "Error: failed fit should be stored in the model");
+  assert_int_equals(*(fit_transform.errnum + 3) != 0, 1,
+                    "Error: failed fit should be stored in the model");
+  assert_int_equals(*(matrices[2].errnum + 3) != 0, 1,
+                    "Error: failed fit should be stored in the matrix");
+  for (int r = 0; r < rows; r++) {
+    for (int c = 0; c < cols; c++) {
+      assert_double_equals(*test_ci_value(&matrices[0], r, c),
+                           *test_ci_value(&matrices[3], r, c),
+                           "Error: fit should not write the matrix");
+    }
+  }
+  // transformed and transformed back with the model
+  assert_int_equals(ciModelTransform(&model, &matrices[0], 0, 3), 0,
+                    "Error: should transform");
+  assert_int_equals(*(matrices[0].errnum + 3) != 0, 1,
+                    "Error: failed fit should be stored in the matrix");
+  for (int r = 0; r < rows; r++) {
+    for (int c = 0; c < 3; c++) {
+      is_in_bound(*test_ci_value(&matrices[0], r, c),
+                  *test_ci_value(&matrices[1], r, c), 1e-9,
+                  "Error: transform should match ciParallelOperationS");
+      is_in_bound(*test_ci_value(&matrices[2], r, c),
+                  *test_ci_value(&matrices[1], r, c), 1e-9,
+                  "Error: fit and transform should match "
+                  "ciParallelOperationS");
+    }
+  }
+  assert_int_equals(ciModelInverseTransform(&model, &matrices[0], 0, 3), 0,
+                    "Error: should transform back");
+  // column 3 is only standardized, its deviation overflows
+  for (int r = 0; r < rows; r++) {
+    for (int c = 0; c < 3; c++) {
+      double value = *test_ci_value(&matrices[3], r, c);
+      is_in_bound(*test_ci_value(&matrices[0], r, c), value,
+                  1e-9 * (fabs(value) > 1 ? fabs(value) : 1),
+                  "Error: round trip should restore the values");
+    }
+  }
+  assert_int_equals(*(matrices[0].errnum + 3) != 0, 1,
+                    "Error: failed fit should be stored in the matrix");
+  matrices[0].cols = 3;
+  assert_int_equals(ciModelTransform(&model, &matrices[0], 0, 3), -3,
+                    "Error: model should not fit the matrix");
+  matrices[0].cols = cols;
+  ciFreeModel(&model);
+  ciFreeModel(&fit_transform);
+  for (int m = 0; m < 4; m++) {
+    freeMatrixS(&matrices[m]);
+  }
+  printf("...done\n");
+}
+#endif
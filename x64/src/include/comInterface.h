@@ -15,6 +15,30 @@
 
 #define BOOL int
 
+// searches of a YJMODEL
+#define CI_METHOD_SMART 0  // lsSmartSearch, to precision
+#define CI_METHOD_BOWLEY 1 // lsSmartBowleySearch, to precision
+#define CI_METHOD_BRENT 2  // lsBrentSearch, to tolerance
+#define CI_METHOD_MLE 3    // lsMleSearch, to tolerance
+
+// Yeo Johnson transformation fitted to the columns of a matrix (ciModelFit),
+// applied to further matrices with the same columns without searching again.
+// The arrays hold cols values each, like those of a MATRIXS.
+typedef struct _YJMODEL {
+  int cols;
+  int method;            // CI_METHOD_*
+  double interval_start; // search interval
+  double interval_end;
+  int precision;         // of CI_METHOD_SMART and CI_METHOD_BOWLEY
+  double tolerance;      // of CI_METHOD_BRENT and CI_METHOD_MLE
+  BOOL standardize;      // columns are standardized with mean and sd
+  double *lambda;
+  double *skew;
+  double *mean; // of the transformed column, if standardize
+  double *sd;
+  int *errnum;  // of the fit, columns != 0 are only standardized
+} YJMODEL;
+
 // public functions
 int ciLambdaOperationOnMatrixFromFileS(char *file_path, double interval_start,
                                        double interval_end,
@@ -33,4 +57,66 @@ int ciParallelOperation(double interval_start, double interval_end,
                         int precision, MATRIX *input_matrix, BOOL standardize,
                         BOOL time_stamps, int thread_count);
 
+int ciParallelOperationf(double interval_start, double interval_end,
+                         int precision, MATRIXF *input_matrix,
+                         BOOL standardize, BOOL time_stamps, int thread_count);
+
+int ciParallelOperationBrent(double interval_start, double interval_end,
+                             double tolerance, MATRIX *input_matrix,
+                             BOOL standardize, BOOL time_stamps,
+                             int thread_count);
+
+int ciParallelOperationMle(double interval_start, double interval_end,
+                           double tolerance, MATRIX *input_matrix,
+                           BOOL standardize, BOOL time_stamps,
+                           int thread_count);
+
+int ciParallelOperationS(double interval_start, double interval_end,
+                         int precision, MATRIXS *input_matrix,
+                         BOOL standardize, BOOL time_stamps, int thread_count);
+
+int ciParallelOperationBowleyS(double interval_start, double interval_end,
+                               int precision, MATRIXS *input_matrix,
+                               BOOL standardize, BOOL time_stamps,
+                               int thread_count);
+
+int ciParallelOperationBrentS(double interval_start, double interval_end,
+                              double tolerance, MATRIXS *input_matrix,
+                              BOOL standardize, BOOL time_stamps,
+                              int thread_count);
+
+int ciParallelOperationMleS(double interval_start, double interval_end,
+                            double tolerance, MATRIXS *input_matrix,
+                            BOOL standardize, BOOL time_stamps,
+                            int thread_count);
+
+int ciParallelOperationFile(double interval_start, double interval_end,
+                            int precision, char *file_path, char *output_path,
+                            BOOL standardize, BOOL time_stamps,
+                            int thread_count);
+
+int ciAllocModel(YJMODEL *model, int cols, int method, double interval_start,
+                 double interval_end, int precision, double tolerance,
+                 BOOL standardize);
+
+void ciFreeModel(YJMODEL *model);
+
+int ciModelFit(YJMODEL *model, MATRIXS *input_matrix, BOOL time_stamps,
+               int thread_count);
+
+int ciModelTransform(const YJMODEL *model, MATRIXS *input_matrix,
+                     BOOL time_stamps, int thread_count);
+
+int ciModelInverseTransform(const YJMODEL *model, MATRIXS *input_matrix,
+                            BOOL time_stamps, int thread_count);
+
+int ciModelFitTransform(YJMODEL *model, MATRIXS *input_matrix,
+                        BOOL time_stamps, int thread_count);
+
+#ifdef UNIT_TEST
+void test_ci_finish_column(void);
+void test_ci_model_inverse(void);
+void test_ciModel(void);
+#endif
+
 #endif /* COMINTERFACE_H */
\ No newline at end of file
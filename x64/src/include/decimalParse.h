@@ -0,0 +1,30 @@
+/****************************************************************
+ * Copyright (c) 2023 Jerome Brenig, Sigrun May
+ * Ostfalia Hochschule für angewandte Wissenschaften
+ *
+ * This software is distributed under the terms of the MIT license
+ * which is available at https://opensource.org/licenses/MIT
+ *
+ *   decimalParse.h
+ */
+
+#ifndef DECIMALPARSE_H
+#define DECIMALPARSE_H
+
+// results of dpParseDouble
+#define DP_NUMBER 0
+#define DP_EMPTY 1         // blanks only, value is 0
+#define DP_NOT_A_NUMBER -1 // value is 0
+
+// longest field the slow path (strtod) parses, in characters
+#define DP_MAX_FIELD_SIZE 1024
+
+// public functions
+int dpParseDouble(const char *begin, const char *end, double *value);
+
+// unit tests
+#ifdef UNIT_TEST
+void test_dpParseDouble(void);
+#endif
+
+#endif /* DECIMALPARSE_H */
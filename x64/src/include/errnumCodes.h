@@ -8,8 +8,8 @@
  *   errnumCodes.h
  */
 
-#ifndef COMINTERFACE_H
-#define COMINTERFACE_H
+#ifndef ERRNUMCODES_H
+#define ERRNUMCODES_H
 
 #define ERR_LAMBDA_SEARCH 0x1000 // error on lambda search
 #define ERR_TRANSFORM 0x2000     // error on transformation
@@ -33,5 +33,6 @@
 #define ERR_VALUE_OVERFLOW 0x0003  // input value would overflow
 #define ERR_VALUE_NOT_IN_BB 0x0004 // input value with lambda would overflow
 #define ERR_BB_NOT_SET 0x0005      // boundary box could not be set
+#define ERR_VALUE_NOT_IN_DOMAIN 0x0006 // value has no inverse transformation
 
 #endif
\ No newline at end of file
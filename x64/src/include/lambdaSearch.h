@@ -11,6 +11,42 @@
 #ifndef LAMBDASEARCH_H
 #define LAMBDASEARCH_H
 
+#include "yeoJohnson.h"
+
+// most row blocks a column's sweeps are split into (lsScratchSetRowParts)
+#define LS_MAX_ROW_PARTS 64
+
+// lambdas per sweep over a validated column of a new scratch memory
+#define LS_DEFAULT_LAMBDA_BATCH 8
+
+// mean and standard deviation of a column transformed with one lambda
+typedef struct {
+  double lambda;
+  double mean;
+  double sd;
+  int valid; // 0 until a search of the current column recorded them
+} lsStats;
+
+// scratch memory of the searches, one per thread, reused across columns
+typedef struct {
+  double *zws;       // transformed column, unless the moments are fused
+  double *log_cache; // log1p(|y|) of the current column
+  int capacity;      // values both buffers can hold
+  int cache_logs;    // 1: evaluate validated columns from log_cache
+  int row_parts;     // row blocks of the fused sweeps, run on the pool
+  int lambda_batch;  // lambdas per fused sweep (lsScratchSetLambdaBatch)
+  double scale;      // of the fused moments of the column, 0 if not fused
+  lsStats stats;     // of the best lambda the fused moments evaluated
+} lsScratch;
+
+typedef struct {
+  float *zws;
+  float *log_cache;
+  int capacity;
+  int cache_logs;
+  int lambda_batch;
+} lsScratchf;
+
 // public functions
 int lsVariance(double *vector, double average, int row_count, double *result);
 
@@ -20,14 +56,136 @@ int lsLambdaSearch(double *vector, double interval_start, double interval_end,
                    double interval_step, int row_count, double *result_lambda,
                    double *result_skew, int *errnum);
 
+int lsLambdaSearchCtx(const yjContext *context, double *vector,
+                      double interval_start, double interval_end,
+                      double interval_step, int row_count,
+                      double *result_lambda, double *result_skew, int *errnum);
+
 int lsSmartSearch(double *vector, double interval_start, double interval_end,
                   int precision, int row_count, double *result_lambda,
                   double *result_skew, int *errnum);
 
+int lsSmartSearchCtx(const yjContext *context, double *vector,
+                     double interval_start, double interval_end, int precision,
+                     int row_count, double *result_lambda, double *result_skew,
+                     int *errnum);
+
+int lsBrentSearch(double *vector, double interval_start, double interval_end,
+                  double tolerance, int row_count, double *result_lambda,
+                  double *result_skew, int *errnum);
+
+int lsBrentSearchCtx(const yjContext *context, double *vector,
+                     double interval_start, double interval_end,
+                     double tolerance, int row_count, double *result_lambda,
+                     double *result_skew, int *errnum);
+
+int lsMleSearch(double *vector, double interval_start, double interval_end,
+                double tolerance, int row_count, double *result_lambda,
+                double *result_skew, int *errnum);
+
+int lsMleSearchCtx(const yjContext *context, double *vector,
+                   double interval_start, double interval_end,
+                   double tolerance, int row_count, double *result_lambda,
+                   double *result_skew, int *errnum);
+
+void lsScratchInit(lsScratch *scratch, int cache_logs);
+
+int lsScratchReserve(lsScratch *scratch, int row_count);
+
+void lsScratchFree(lsScratch *scratch);
+
+int lsScratchSetRowParts(lsScratch *scratch, int row_parts);
+
+int lsScratchSetLambdaBatch(lsScratch *scratch, int lambda_batch);
+
+int lsScratchStats(lsScratch *scratch, double *vector, int row_count,
+                   double lambda, double *mean, double *sd);
+
+int lsLambdaSearchScratch(const yjContext *context, lsScratch *scratch,
+                          double *vector, double interval_start,
+                          double interval_end, double interval_step,
+                          int row_count, double *result_lambda,
+                          double *result_skew, int *errnum);
+
+int lsSmartSearchScratch(const yjContext *context, lsScratch *scratch,
+                         double *vector, double interval_start,
+                         double interval_end, int precision, int row_count,
+                         double *result_lambda, double *result_skew,
+                         int *errnum);
+
+int lsBrentSearchScratch(const yjContext *context, lsScratch *scratch,
+                         double *vector, double interval_start,
+                         double interval_end, double tolerance, int row_count,
+                         double *result_lambda, double *result_skew,
+                         int *errnum);
+
+int lsMleSearchScratch(const yjContext *context, lsScratch *scratch,
+                       double *vector, double interval_start,
+                       double interval_end, double tolerance, int row_count,
+                       double *result_lambda, double *result_skew,
+                       int *errnum);
+
+int lsVarianceU(double *vector, double average, int row_count,
+                double *result);
+
+int lsAverageU(double *vector, int row_count, double *result);
+
+int lsVarianceUf(float *vector, float average, int row_count, float *result);
+
+int lsAverageUf(float *vector, int row_count, float *result);
+
+int lsVariancef(float *vector, float average, int row_count, float *result);
+
+int lsAveragef(float *vector, int row_count, float *result);
+
+int lsLambdaSearchf(float *vector, float interval_start, float interval_end,
+                    float interval_step, int row_count, float *result_lambda,
+                    float *result_skew, int *errnum);
+
+int lsLambdaSearchCtxf(const yjContextf *context, float *vector,
+                       float interval_start, float interval_end,
+                       float interval_step, int row_count, float *result_lambda,
+                       float *result_skew, int *errnum);
+
+int lsSmartSearchf(float *vector, float interval_start, float interval_end,
+                   int precision, int row_count, float *result_lambda,
+                   float *result_skew, int *errnum);
+
+int lsSmartSearchCtxf(const yjContextf *context, float *vector,
+                      float interval_start, float interval_end, int precision,
+                      int row_count, float *result_lambda, float *result_skew,
+                      int *errnum);
+
+void lsScratchInitf(lsScratchf *scratch, int cache_logs);
+
+int lsScratchReservef(lsScratchf *scratch, int row_count);
+
+void lsScratchFreef(lsScratchf *scratch);
+
+int lsScratchSetLambdaBatchf(lsScratchf *scratch, int lambda_batch);
+
+int lsLambdaSearchScratchf(const yjContextf *context, lsScratchf *scratch,
+                           float *vector, float interval_start,
+                           float interval_end, float interval_step,
+                           int row_count, float *result_lambda,
+                           float *result_skew, int *errnum);
+
+int lsSmartSearchScratchf(const yjContextf *context, lsScratchf *scratch,
+                          float *vector, float interval_start,
+                          float interval_end, int precision, int row_count,
+                          float *result_lambda, float *result_skew,
+                          int *errnum);
+
 int lsSmartBowleySearch(double *vector, double interval_start, double interval_end,
                         int precision, int row_count, double *result_lambda,
                         double *result_skew, int *errnum);
 
+int lsSmartBowleySearchScratch(const yjContext *context, lsScratch *scratch,
+                               double *vector, double interval_start,
+                               double interval_end, int precision,
+                               int row_count, double *result_lambda,
+                               double *result_skew, int *errnum);
+
 // unit tests
 #ifdef UNIT_TEST
 void test_lsAverage(void);
@@ -52,6 +210,12 @@ void test_lsLambdaSearch(void);
 void test_lsLambdaSearchf(void);
 void test_lsLambdaSearchU(void);
 void test_lsLambdaSearchUf(void);
+void test_lsLambdaBatch(void);
+void test_lsBrentSearch(void);
+void test_lsMleSearch(void);
+void test_lsRowParts(void);
+void test_lsScratchStats(void);
+void test_lsSmartBowleySearch(void);
 #endif
 
 #endif /* LAMBDASEARCH_H */
\ No newline at end of file
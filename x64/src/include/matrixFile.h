@@ -0,0 +1,96 @@
+/****************************************************************
+ * Copyright (c) 2023 Jerome Brenig, Sigrun May
+ * Ostfalia Hochschule für angewandte Wissenschaften
+ *
+ * This software is distributed under the terms of the MIT license
+ * which is available at https://opensource.org/licenses/MIT
+ *
+ *   matrixFile.h
+ */
+
+#ifndef MATRIXFILE_H
+#define MATRIXFILE_H
+
+#include <stddef.h>
+
+#include "vectorImports.h"
+
+// first bytes of a matrix file and its version
+#define MF_MAGIC "YJMATRIX"
+#define MF_VERSION 1
+
+// layouts of the data section
+#define MF_ROW_MAJOR 0
+#define MF_COLUMN_MAJOR 1
+
+// modes of mfOpen
+#define MF_READ 0   // private mapping, writes stay in memory (copy on write)
+#define MF_UPDATE 1 // shared mapping, writes go to the file
+
+// optional sections of mfWrite
+#define MF_NAMES 1   // column names
+#define MF_RESULTS 2 // lambda, skew and errnum of every column
+
+// header at offset 0 of a matrix file, native byte order. Sections start at
+// multiples of MATRIX_ALIGNMENT bytes, an offset of 0 marks a missing one.
+typedef struct _MFHEADER {
+  char magic[8];      // MF_MAGIC without terminator
+  int version;        // MF_VERSION
+  int dtype;          // MATRIX_FLOAT64 or MATRIX_FLOAT32
+  long long rows;
+  long long cols;
+  int layout;         // MF_COLUMN_MAJOR as written by mfWrite
+  int reserved;
+  long long data_offset;
+  long long names_offset; // cols names, each terminated by '\0'
+  long long names_size;   // bytes
+  long long lambda_offset; // cols doubles
+  long long skew_offset;   // cols doubles
+  long long errnum_offset; // cols ints
+  long long file_size;
+} MFHEADER;
+
+// matrix file mapped into memory by mfOpen
+typedef struct _MATRIXFILE {
+  MATRIXS matrix; // data and the results, if the file has them, in the mapping
+  char **names;   // cols column names in the mapping, NULL without names
+  void *mapping;
+  size_t size;
+  void *copy;          // values of an unaligned .npz array, NULL if mapped
+  int mode;            // MF_READ or MF_UPDATE
+  int results_in_file; // lambda, skew and errnum point into the mapping
+} MATRIXFILE;
+
+// column source of mfWriteColumns, returns column col contiguous, either in
+// buffer (room for rows values) or elsewhere
+typedef const void *(*mfColumn)(void *source, int col, void *buffer);
+
+// public functions
+int mfWrite(const char *file_path, const MATRIXS *matrix, char *const *names,
+            int sections);
+
+int mfWriteColumns(const char *file_path, int rows, int cols, int dtype,
+                   mfColumn column, void *source, char *const *names,
+                   int sections, const double *lambda, const double *skew,
+                   const int *errnum);
+
+int mfOpenArray(MATRIXFILE *file, const char *file_path,
+                const char *array_name, int mode);
+
+int mfOpen(MATRIXFILE *file, const char *file_path, int mode);
+
+void mfDiscard(const MATRIXFILE *file, const void *address, size_t size);
+
+void mfClose(MATRIXFILE *file);
+
+int mfConvertCsv(char *csv_path, const char *file_path, int sections,
+                 int thread_count);
+
+// unit tests
+#ifdef UNIT_TEST
+void test_mfWrite(void);
+void test_mfConvertCsv(void);
+void test_mfOpenArray(void);
+#endif
+
+#endif /* MATRIXFILE_H */
@@ -16,6 +16,12 @@
 void test_super_yj(void);
 void test_super_vi(void);
 void test_super_ls(void);
+void test_super_yb(void);
+void test_super_tp(void);
+void test_super_dp(void);
+void test_super_mf(void);
+void test_super_ys(void);
+void test_super_ci(void);
 #endif
 
 #endif /* LAMBDASEARCH_H */
\ No newline at end of file
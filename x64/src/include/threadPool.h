@@ -0,0 +1,43 @@
+/****************************************************************
+ * Copyright (c) 2023 Jerome Brenig, Sigrun May
+ * Ostfalia Hochschule für angewandte Wissenschaften
+ *
+ * This software is distributed under the terms of the MIT license
+ * which is available at https://opensource.org/licenses/MIT
+ *
+ *   threadPool.h
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+// one part of a job, part in [0, part_count), all parts share args
+typedef void (*tpTask)(void *args, int part, int part_count);
+
+// indices [0, count) that the parts of a job claim in chunks
+typedef struct _tpRange {
+  int next;  // first unclaimed index, claimed atomically
+  int count; // end of the range
+  int parts; // parts sharing the range
+} tpRange;
+
+// public functions
+int tpInit(int thread_count);
+
+void tpShutdown(void);
+
+int tpGetSize(void);
+
+int tpRun(tpTask task, void *args, int part_count);
+
+void tpRangeInit(tpRange *range, int count, int parts);
+
+int tpRangeClaim(tpRange *range, int *begin, int *end);
+
+// unit tests
+#ifdef UNIT_TEST
+void test_tpRun(void);
+void test_tpRangeClaim(void);
+#endif
+
+#endif /* THREADPOOL_H */
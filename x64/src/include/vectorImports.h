@@ -18,6 +18,13 @@
 #define EOL 10
 #define MAX_STRING_SIZE 1024
 
+// element types of a MATRIXS
+#define MATRIX_FLOAT64 0
+#define MATRIX_FLOAT32 1
+
+// alignment of the buffer of allocMatrixS in bytes
+#define MATRIX_ALIGNMENT 64
+
 // structs
 typedef struct _MATRIX {
   int rows;
@@ -28,16 +35,52 @@ typedef struct _MATRIX {
   int *errnum;
 } MATRIX;
 
+typedef struct _MATRIXF {
+  int rows;
+  int cols;
+  float **data;
+  float *lambda;
+  float *skew;
+  int *errnum;
+} MATRIXF;
+
+// matrix in one buffer, value (r, c) at data + r * row_stride + c * col_stride
+// bytes, like a NumPy array; C order has col_stride == element size, F order
+// row_stride == element size
+typedef struct _MATRIXS {
+  int rows;
+  int cols;
+  void *data;           // value (0, 0), aligned to its element size
+  long long row_stride; // bytes, may be negative
+  long long col_stride; // bytes, may be negative
+  int dtype;            // MATRIX_FLOAT64 or MATRIX_FLOAT32
+  double *lambda;       // one per column, also for MATRIX_FLOAT32
+  double *skew;
+  int *errnum;
+} MATRIXS;
+
 // public functions
 int importVectorTableFromCsv(char *file_path, MATRIX **vector);
 
+int importVectorTableFromCsvParallel(char *file_path, MATRIX **vector_list,
+                                     int thread_count, double *throughput);
+
+int importColumnNamesFromCsv(char *file_path, char ***names, int *count);
+
+void freeMatrix(MATRIX *matrix);
+
+int allocMatrixS(MATRIXS *matrix, int rows, int cols, int dtype,
+                 int column_major);
+
+void freeMatrixS(MATRIXS *matrix);
+
+int checkMatrixS(const MATRIXS *matrix);
+
 // unit tests
 #ifdef UNIT_TEST
-void test_getMatrixSizeFromCsv(void);
-void test_fillMatrixFromCsv(void);
-void test_fillMatrixFromCsvf(void);
 void test_importVectorTableFromCsv(void);
-void test_importVectorTableFromCsvf(void);
+void test_importVectorTableFromCsvParallel(void);
+void test_allocMatrixS(void);
 #endif
 
 #endif /* VECTORIMPORTS_H */
\ No newline at end of file
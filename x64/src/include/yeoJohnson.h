@@ -18,13 +18,114 @@ typedef struct {
   double lower_limit;
 } boundaryBox;
 
+// boundary boxes of one lambda search, one instance per search/thread
+typedef struct {
+  boundaryBox yj1;
+  boundaryBox yj3;
+  int set;
+} yjContext;
+
+typedef struct {
+  float upper_limit;
+  float lower_limit;
+} boundaryBoxf;
+
+typedef struct {
+  boundaryBoxf yj1;
+  boundaryBoxf yj3;
+  int set;
+} yjContextf;
+
+// streaming moments of a transformed column (count, mean and the central
+// sums M2, M3), always accumulated in double
+typedef struct {
+  double count;
+  double mean;
+  double m2;
+  double m3;
+} yjMoments;
+
+// lambdas that yjMomentsCachedBatch evaluates per sweep over a column
+#define YJ_MAX_LAMBDA_BATCH 16
+
 // public functions
 void buildBoundaryBox(double lower_lambda, double upper_lambda);
 
+void buildBoundaryBoxCtx(yjContext *context, double lower_lambda,
+                         double upper_lambda);
+
 int yjCalculation(double y, double lambda, double *result);
 
+int yjCalculationCtx(const yjContext *context, double y, double lambda,
+                     double *result);
+
+int yjCalculationU(double y, double lambda, double *result);
+
+int yjValidateColumnCtx(const yjContext *context, const double *vector,
+                        int rows, double lower_lambda, double upper_lambda,
+                        int *safe, double *bound);
+
+int yjLogCache(const double *vector, int rows, double *log_cache);
+
+int yjSignedLogSum(const double *vector, const double *log_cache, int rows,
+                   double *result);
+
+int yjTransformCached(const double *vector, const double *log_cache, int rows,
+                      double lambda, double *result);
+
+void yjMomentsAdd(yjMoments *moments, double value);
+
+void yjMomentsMerge(yjMoments *moments, const yjMoments *other);
+
+int yjMomentsCached(const double *vector, const double *log_cache, int rows,
+                    double lambda, double scale, yjMoments *moments);
+
+int yjMomentsCachedBatch(const double *vector, const double *log_cache,
+                         int rows, const double *lambdas, int lambda_count,
+                         double scale, yjMoments *moments);
+
 int yjTransformBy(double **vector, double lambda, int rows);
 
+int yjTransformByCtx(const yjContext *context, double **vector, double lambda,
+                     int rows);
+
+int yjInverseCalculation(double x, double lambda, double *result);
+
+int yjInverseTransformBy(double **vector, double lambda, int rows);
+
+void buildBoundaryBoxf(float lower_lambda, float upper_lambda);
+
+void buildBoundaryBoxCtxf(yjContextf *context, float lower_lambda,
+                          float upper_lambda);
+
+int yjCalculationf(float y, float lambda, float *result);
+
+int yjCalculationCtxf(const yjContextf *context, float y, float lambda,
+                      float *result);
+
+int yjCalculationUf(float y, float lambda, float *result);
+
+int yjValidateColumnCtxf(const yjContextf *context, const float *vector,
+                         int rows, float lower_lambda, float upper_lambda,
+                         int *safe, float *bound);
+
+int yjLogCachef(const float *vector, int rows, float *log_cache);
+
+int yjTransformCachedf(const float *vector, const float *log_cache, int rows,
+                       float lambda, float *result);
+
+int yjMomentsCachedf(const float *vector, const float *log_cache, int rows,
+                     float lambda, double scale, yjMoments *moments);
+
+int yjMomentsCachedBatchf(const float *vector, const float *log_cache,
+                          int rows, const float *lambdas, int lambda_count,
+                          double scale, yjMoments *moments);
+
+int yjTransformByf(float **vector, float lambda, int rows);
+
+int yjTransformByCtxf(const yjContextf *context, float **vector, float lambda,
+                      int rows);
+
 // unit tests
 #ifdef UNIT_TEST
 void test_yj1(void);
@@ -53,6 +154,13 @@ void test_yjCalculation(void);
 void test_yjCalculationf(void);
 void test_yjCalculationU(void);
 void test_yjCalculationUf(void);
+
+void test_yjCalculationCtx(void);
+void test_yjInverseCalculation(void);
+void test_yjValidateColumnCtx(void);
+void test_yjTransformCached(void);
+void test_yjMomentsCached(void);
+void test_yjMomentsCachedBatch(void);
 #endif
 
 #endif /* YEOJOHNSON_H */
\ No newline at end of file
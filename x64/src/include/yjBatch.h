@@ -0,0 +1,85 @@
+/****************************************************************
+ * Copyright (c) 2023 Jerome Brenig, Sigrun May
+ * Ostfalia Hochschule für angewandte Wissenschaften
+ *
+ * This software is distributed under the terms of the MIT license
+ * which is available at https://opensource.org/licenses/MIT
+ *
+ *   yjBatch.h
+ */
+
+#ifndef YJBATCH_H
+#define YJBATCH_H
+
+#include "yeoJohnson.h"
+
+// instruction sets of the batch kernel
+#define YB_ISA_SCALAR 0
+#define YB_ISA_SSE2 1
+#define YB_ISA_AVX2 2
+#define YB_ISA_AVX512 3
+
+// widest vector register of the kernel in doubles / floats
+#define YB_BLOCK_SIZE 8
+#define YB_BLOCK_SIZEF 16
+
+// lane state of the moments kernel
+#define YB_MOMENT_LANES (2 * YB_BLOCK_SIZE)
+
+// per feature constants of a fitted transformation (ybRowModelInit), for
+// transformations of whole rows across the features (ybTransformRows)
+typedef struct {
+  int cols;
+  double *lambda_pos;  // lambda, exponent for y >= 0; 1 passes y unchanged
+  double *lambda_neg;  // 2 - lambda, exponent for y < 0
+  double *inverse_pos; // 1 / lambda, 0 for lambda == 0 (logarithm)
+  double *inverse_neg; // 1 / (2 - lambda), 0 for lambda == 2 (logarithm)
+  double *mean;        // subtracted after the transformation
+  double *inverse_sd;  // multiplied after the transformation
+  void *buffer;        // one aligned allocation for all arrays
+} ybRowModel;
+
+// public functions
+int ybTransform(double *vector, int rows, double lambda,
+                const boundaryBox *yj1, const boundaryBox *yj3);
+
+int ybTransformf(float *vector, int rows, float lambda,
+                 const boundaryBoxf *yj1, const boundaryBoxf *yj3);
+
+int ybTransformCached(const double *vector, const double *log_cache, int rows,
+                      double lambda, double *result);
+
+int ybTransformCachedf(const float *vector, const float *log_cache, int rows,
+                       float lambda, float *result);
+
+int ybMomentsCached(const double *vector, const double *log_cache, int rows,
+                    double lambda, double scale, yjMoments *lanes);
+
+int ybMomentsCachedf(const float *vector, const float *log_cache, int rows,
+                     float lambda, double scale, yjMoments *lanes);
+
+void ybMomentsLanes(const yjMoments *lanes, yjMoments *moments);
+
+int ybInverseTransform(double *vector, int rows, double lambda);
+
+int ybRowModelInit(ybRowModel *model, int cols, const double *lambda,
+                   const double *mean, const double *sd, const int *errnum);
+
+void ybRowModelFree(ybRowModel *model);
+
+int ybTransformRows(const ybRowModel *model, double *rows, int row_count,
+                    long long row_stride);
+
+int ybGetInstructionSet(void);
+
+int ybSetInstructionSet(int isa);
+
+// unit tests
+#ifdef UNIT_TEST
+void test_ybTransform(void);
+void test_ybTransformf(void);
+void test_ybTransformRows(void);
+void test_ybInverseTransform(void);
+#endif
+
+#endif /* YJBATCH_H */
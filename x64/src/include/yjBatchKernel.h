@@ -0,0 +1,678 @@
+/****************************************************************
+ * Copyright (c) 2023 Jerome Brenig, Sigrun May
+ * Ostfalia Hochschule für angewandte Wissenschaften
+ *
+ * This software is distributed under the terms of the MIT license
+ * which is available at https://opensource.org/licenses/MIT
+ *
+ *   yjBatchKernel.h
+ *
+ * Kernel template of yjBatch.c, included once per instruction set.
+ * No include guard on purpose. Expects:
+ *   YB_LANES        doubles per vector register
+ *   YB_SUFFIX       name suffix of the instantiation
+ *   YB_TARGET       target attribute of the instantiation (may be empty)
+ *   YB_ANY(mask)    nonzero if any lane of the integer mask is set
+ *   YB_ANYF(mask)   same for the 32 bit masks of the float kernel
+ */
+
+#define YB_CAT_(name, suffix) name##_##suffix
+#define YB_CAT(name, suffix) YB_CAT_(name, suffix)
+#define YB_FN(name) YB_CAT(name, YB_SUFFIX)
+#define YB_VD YB_FN(vd)
+#define YB_VL YB_FN(vl)
+#define YB_VU YB_FN(vu)
+#define YB_VF YB_FN(vf)
+#define YB_VI YB_FN(vi)
+#define YB_VUI YB_FN(vui)
+#define YB_VH YB_FN(vh)
+#define YB_INLINE static inline __attribute__((always_inline)) YB_TARGET
+
+typedef double YB_VD __attribute__((vector_size(YB_LANES * 8)));
+typedef long long YB_VL __attribute__((vector_size(YB_LANES * 8)));
+typedef unsigned long long YB_VU __attribute__((vector_size(YB_LANES * 8)));
+typedef float YB_VF __attribute__((vector_size(YB_LANES * 8)));
+typedef int YB_VI __attribute__((vector_size(YB_LANES * 8)));
+typedef unsigned int YB_VUI __attribute__((vector_size(YB_LANES * 8)));
+typedef float YB_VH __attribute__((vector_size(YB_LANES * 4)));
+
+/**
+ * @brief broadcasts a scalar to all lanes
+ */
+YB_INLINE YB_VD YB_FN(yb_set)(double value) {
+  YB_VD zero = {0};
+  return zero + value;
+}
+
+/**
+ * @brief selects a where mask is set, b otherwise
+ */
+YB_INLINE YB_VD YB_FN(yb_select)(YB_VL mask, YB_VD a, YB_VD b) {
+  return (YB_VD)(((YB_VL)a & mask) | ((YB_VL)b & ~mask));
+}
+
+/**
+ * @brief (double) natural logarithm of 1+a for finite a>=0, or a>-1 as long
+ * as 1+a is a normal number (inverse transformation)
+ */
+YB_INLINE YB_VD YB_FN(yb_log1p)(YB_VD a) {
+  YB_VD one = YB_FN(yb_set)(1.0);
+  YB_VD u = one + a;
+  // rounding error of 1+a, restores log1p precision for small a
+  YB_VD correction = (a - (u - one)) / u;
+
+  YB_VU bits = (YB_VU)u;
+  YB_VU exponent_bits = bits >> 52;
+  YB_VU mantissa_bits = (bits & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL;
+  YB_VD m = (YB_VD)mantissa_bits;
+  // exponent as double without int64->double conversion instructions
+  YB_VD k = (YB_VD)(exponent_bits | 0x4330000000000000ULL) - 0x1p52 - 1023.0;
+  YB_VL shift = m > M_SQRT2;
+  m = YB_FN(yb_select)(shift, m * 0.5, m);
+  k = YB_FN(yb_select)(shift, k + 1.0, k);
+
+  YB_VD f = m - one;
+  YB_VD s = f / (2.0 + f);
+  YB_VD z = s * s;
+  YB_VD w = z * z;
+  YB_VD t1 = w * (g_lg2 + w * (g_lg4 + w * g_lg6));
+  YB_VD t2 = z * (g_lg1 + w * (g_lg3 + w * (g_lg5 + w * g_lg7)));
+  YB_VD r = t2 + t1;
+  YB_VD hfsq = 0.5 * f * f;
+  return k * g_ln2_hi -
+         ((hfsq - (s * (hfsq + r) + (k * g_ln2_lo + correction))) - f);
+}
+
+/**
+ * @brief (double) exponential function for |x| <= g_max_exponent
+ */
+YB_INLINE YB_VD YB_FN(yb_exp)(YB_VD x) {
+  YB_VD magic = YB_FN(yb_set)(0x1.8p52);
+  YB_VD shifted = x * g_inv_ln2 + magic;
+  YB_VD k = shifted - magic;
+  YB_VL k_int = (YB_VL)shifted - (YB_VL)magic;
+
+  YB_VD hi = x - k * g_ln2_hi;
+  YB_VD lo = k * g_ln2_lo;
+  YB_VD r = hi - lo;
+  YB_VD rr = r * r;
+  YB_VD c =
+      r - rr * (g_p1 + rr * (g_p2 + rr * (g_p3 + rr * (g_p4 + rr * g_p5))));
+  YB_VD y = 1.0 - ((lo - (r * c) / (2.0 - c)) - hi);
+  return (YB_VD)((YB_VU)y + ((YB_VU)k_int << 52));
+}
+
+/**
+ * @brief (double) exp(x) - 1 for |x| <= g_max_exponent, the reduced form
+ * x + x*c/(2-c) of yb_exp keeps full precision for |x| < ln2/2
+ */
+YB_INLINE YB_VD YB_FN(yb_expm1)(YB_VD x) {
+  YB_VD magic = YB_FN(yb_set)(0x1.8p52);
+  YB_VD shifted = x * g_inv_ln2 + magic;
+  YB_VD k = shifted - magic;
+  YB_VL k_int = (YB_VL)shifted - (YB_VL)magic;
+
+  YB_VD hi = x - k * g_ln2_hi;
+  YB_VD lo = k * g_ln2_lo;
+  YB_VD r = hi - lo;
+  YB_VD rr = r * r;
+  YB_VD c =
+      r - rr * (g_p1 + rr * (g_p2 + rr * (g_p3 + rr * (g_p4 + rr * g_p5))));
+  YB_VD e = hi - (lo - (r * c) / (2.0 - c));
+  YB_VD y = (YB_VD)((YB_VU)(e + 1.0) + ((YB_VU)k_int << 52));
+  return YB_FN(yb_select)(k_int == 0, e, y - 1.0);
+}
+
+/**
+ * @brief (double) transformation of one block of a validated column from its
+ * cached log1p(|y|), overflow is set where the exponent is above g_max_exponent
+ */
+YB_INLINE YB_VD YB_FN(yb_cached_value)(YB_VD y, YB_VD log_a, double lambda,
+                                       YB_VL *overflow) {
+  YB_VD zero = YB_FN(yb_set)(0.0);
+  YB_VD one = YB_FN(yb_set)(1.0);
+  YB_VD low = YB_FN(yb_set)(-g_max_exponent);
+  YB_VL positive = y >= zero;
+  YB_VD p = YB_FN(yb_select)(positive, YB_FN(yb_set)(lambda),
+                             YB_FN(yb_set)(2 - lambda));
+  YB_VD x = p * log_a;
+  // expm1 is -1 far below -g_max_exponent, above it libm takes over
+  *overflow = x > g_max_exponent;
+  x = YB_FN(yb_select)(x < low, low, x);
+  YB_VL log_only = p == zero;
+  YB_VD safe_p = YB_FN(yb_select)(log_only, one, p);
+  YB_VD power = YB_FN(yb_expm1)(x) / safe_p;
+  YB_VD value = YB_FN(yb_select)(log_only, log_a, power);
+  return YB_FN(yb_select)(positive, value, -value);
+}
+
+/**
+ * @brief adds one value per lane to the streaming moments of the lanes
+ * (Welford/Terriberry update), count is the amount of values per lane
+ * including this one
+ */
+YB_INLINE void YB_FN(yb_moments_add)(YB_VD value, double count, YB_VD *mean,
+                                     YB_VD *m2, YB_VD *m3) {
+  double inverse = 1.0 / count;
+  YB_VD delta = value - *mean;
+  YB_VD delta_n = delta * inverse;
+  YB_VD term = delta * delta_n * (count - 1);
+  *mean += delta_n;
+  *m3 += term * delta_n * (count - 2) - 3.0 * delta_n * *m2;
+  *m2 += term;
+}
+
+/**
+ * @brief reads the moments of every lane from lanes
+ */
+YB_INLINE void YB_FN(yb_moments_load)(const yjMoments *lanes, double *count,
+                                      YB_VD *mean, YB_VD *m2, YB_VD *m3) {
+  *count = lanes[0].count;
+  for (int lane = 0; lane < YB_LANES; lane++) {
+    (*mean)[lane] = lanes[lane].mean;
+    (*m2)[lane] = lanes[lane].m2;
+    (*m3)[lane] = lanes[lane].m3;
+  }
+}
+
+/**
+ * @brief writes the moments of every lane to lanes
+ */
+YB_INLINE void YB_FN(yb_moments_store)(double count, YB_VD mean, YB_VD m2,
+                                       YB_VD m3, yjMoments *lanes) {
+  for (int lane = 0; lane < YB_LANES; lane++) {
+    lanes[lane].count = count;
+    lanes[lane].mean = mean[lane];
+    lanes[lane].m2 = m2[lane];
+    lanes[lane].m3 = m3[lane];
+  }
+}
+
+/**
+ * @brief (double) transforms full blocks of a validated column from its cached
+ * log1p(|y|), stops in front of a block with an exponent above g_max_exponent
+ *
+ * @param vector values of the column
+ * @param log_cache log1p(|y|) of every value
+ * @param rows amount of values
+ * @param lambda transformation parameter
+ * @param result receives the transformed values
+ * @return int amount of values transformed
+ */
+static YB_TARGET int YB_FN(yb_transform_cached)(const double *vector,
+                                                const double *log_cache,
+                                                int rows, double lambda,
+                                                double *result) {
+  int i = 0;
+  for (; i + YB_LANES <= rows; i += YB_LANES) {
+    YB_VD y;
+    YB_VD log_a;
+    YB_VL overflow;
+    memcpy(&y, vector + i, sizeof(y));
+    memcpy(&log_a, log_cache + i, sizeof(log_a));
+    YB_VD value = YB_FN(yb_cached_value)(y, log_a, lambda, &overflow);
+    if (YB_ANY(overflow)) {
+      break;
+    }
+    memcpy(result + i, &value, sizeof(value));
+  }
+  return i;
+}
+
+/**
+ * @brief (double) adds the transformed full blocks of a validated column to
+ * the moments of the lanes without storing them, two sets of lanes take turns
+ * to shorten the dependency chain of the update; stops like
+ * yb_transform_cached
+ *
+ * @param vector values of the column
+ * @param log_cache log1p(|y|) of every value
+ * @param rows amount of values
+ * @param lambda transformation parameter
+ * @param scale factor applied to every transformed value
+ * @param lanes moments of 2 * YB_LANES lanes, updated in place
+ * @return int amount of values accumulated
+ */
+static YB_TARGET int YB_FN(yb_moments_cached)(const double *vector,
+                                              const double *log_cache,
+                                              int rows, double lambda,
+                                              double scale, yjMoments *lanes) {
+  YB_VD mean0, m20, m30;
+  YB_VD mean1, m21, m31;
+  double count0;
+  double count1;
+  YB_FN(yb_moments_load)(lanes, &count0, &mean0, &m20, &m30);
+  YB_FN(yb_moments_load)(lanes + YB_LANES, &count1, &mean1, &m21, &m31);
+  int i = 0;
+  for (; i + 2 * YB_LANES <= rows; i += 2 * YB_LANES) {
+    YB_VD y0, y1;
+    YB_VD log_a0, log_a1;
+    YB_VL overflow0, overflow1;
+    memcpy(&y0, vector + i, sizeof(y0));
+    memcpy(&y1, vector + i + YB_LANES, sizeof(y1));
+    memcpy(&log_a0, log_cache + i, sizeof(log_a0));
+    memcpy(&log_a1, log_cache + i + YB_LANES, sizeof(log_a1));
+    YB_VD value0 = YB_FN(yb_cached_value)(y0, log_a0, lambda, &overflow0);
+    YB_VD value1 = YB_FN(yb_cached_value)(y1, log_a1, lambda, &overflow1);
+    if (YB_ANY(overflow0 | overflow1)) {
+      break;
+    }
+    count0 += 1;
+    count1 += 1;
+    YB_FN(yb_moments_add)(value0 * scale, count0, &mean0, &m20, &m30);
+    YB_FN(yb_moments_add)(value1 * scale, count1, &mean1, &m21, &m31);
+  }
+  if (i + YB_LANES <= rows) {
+    YB_VD y;
+    YB_VD log_a;
+    YB_VL overflow;
+    memcpy(&y, vector + i, sizeof(y));
+    memcpy(&log_a, log_cache + i, sizeof(log_a));
+    YB_VD value = YB_FN(yb_cached_value)(y, log_a, lambda, &overflow);
+    if (!YB_ANY(overflow)) {
+      count0 += 1;
+      YB_FN(yb_moments_add)(value * scale, count0, &mean0, &m20, &m30);
+      i += YB_LANES;
+    }
+  }
+  YB_FN(yb_moments_store)(count0, mean0, m20, m30, lanes);
+  YB_FN(yb_moments_store)(count1, mean1, m21, m31, lanes + YB_LANES);
+  return i;
+}
+
+/**
+ * @brief (double) transforms full blocks of the vector until a block needs the
+ * checked scalar path
+ *
+ * @param vector values to be transformed in place
+ * @param rows amount of values
+ * @param limits per call constants
+ * @return int amount of values transformed
+ */
+static YB_TARGET int YB_FN(yb_transform)(double *vector, int rows,
+                                         const ybLimits *limits) {
+  YB_VD zero = YB_FN(yb_set)(0.0);
+  YB_VD one = YB_FN(yb_set)(1.0);
+  YB_VD lambda_pos = YB_FN(yb_set)(limits->lambda_pos);
+  YB_VD lambda_neg = YB_FN(yb_set)(limits->lambda_neg);
+  int i = 0;
+  for (; i + YB_LANES <= rows; i += YB_LANES) {
+    YB_VD y;
+    memcpy(&y, vector + i, sizeof(y));
+    YB_VL positive = y >= zero;
+    YB_VD a = YB_FN(yb_select)(positive, y, -y);
+    YB_VD p = YB_FN(yb_select)(positive, lambda_pos, lambda_neg);
+
+    // every check of yjFormular1..4, plus NaN/inf
+    YB_VL reject =
+        ~(a <= __DBL_MAX__) |
+        (positive & ((y < limits->pos_lower) | (y > limits->pos_upper) |
+                     (y == limits->pos_sentinel))) |
+        (~positive & ((y < limits->neg_lower) | (y > limits->neg_upper) |
+                      (y == limits->neg_sentinel)));
+    YB_VD log_a = YB_FN(yb_log1p)(a);
+    YB_VD x = p * log_a;
+    reject |= (x > g_max_exponent) | (x < -g_max_exponent);
+    if (YB_ANY(reject)) {
+      break;
+    }
+
+    YB_VL log_only = p == zero;
+    YB_VD safe_p = YB_FN(yb_select)(log_only, one, p);
+    YB_VD power = (YB_FN(yb_exp)(x) - one) / safe_p;
+    YB_VD result = YB_FN(yb_select)(log_only, log_a, power);
+    result = YB_FN(yb_select)(positive, result, -result);
+    memcpy(vector + i, &result, sizeof(result));
+  }
+  return i;
+}
+
+/**
+ * @brief (double) inverse transformation of full blocks of the vector,
+ * y = sign(x) * expm1(log1p(p * |x|) / p) with p = lambda for x >= 0 and
+ * 2 - lambda for x < 0 (expm1(|x|) for p == 0); stops in front of a block
+ * that needs the checked scalar path (no inverse, overflow, NaN/inf)
+ *
+ * @param vector values to be transformed back in place
+ * @param rows amount of values
+ * @param lambda transformation parameter of the forward transformation
+ * @return int amount of values transformed
+ */
+static YB_TARGET int YB_FN(yb_inverse_transform)(double *vector, int rows,
+                                                 double lambda) {
+  YB_VD zero = YB_FN(yb_set)(0.0);
+  YB_VD one = YB_FN(yb_set)(1.0);
+  YB_VD low = YB_FN(yb_set)(-g_max_exponent);
+  YB_VD lambda_pos = YB_FN(yb_set)(lambda);
+  YB_VD lambda_neg = YB_FN(yb_set)(2 - lambda);
+  int i = 0;
+  for (; i + YB_LANES <= rows; i += YB_LANES) {
+    YB_VD x;
+    memcpy(&x, vector + i, sizeof(x));
+    YB_VL positive = x >= zero;
+    YB_VD a = YB_FN(yb_select)(positive, x, -x);
+    YB_VD p = YB_FN(yb_select)(positive, lambda_pos, lambda_neg);
+    YB_VD pa = p * a;
+    YB_VL log_only = p == zero;
+    // 1 + p * |x| must be a normal positive number for yb_log1p
+    YB_VL reject = ~(a <= __DBL_MAX__) |
+                   (~log_only & ~(pa + one >= __DBL_MIN__)) |
+                   ~(pa <= __DBL_MAX__);
+    YB_VD safe_p = YB_FN(yb_select)(log_only, one, p);
+    YB_VD exponent = YB_FN(yb_select)(log_only, a,
+                                      YB_FN(yb_log1p)(pa) / safe_p);
+    reject |= exponent > g_max_exponent;
+    if (YB_ANY(reject)) {
+      break;
+    }
+    // expm1 is -1 far below -g_max_exponent
+    exponent = YB_FN(yb_select)(exponent < low, low, exponent);
+    YB_VD result = YB_FN(yb_expm1)(exponent);
+    result = YB_FN(yb_select)(positive, result, -result);
+    memcpy(vector + i, &result, sizeof(result));
+  }
+  return i;
+}
+
+/**
+ * @brief (double) transforms and standardizes the features of one row with the
+ * per feature constants of a ybRowModel, full blocks from begin on; stops in
+ * front of a block that needs the scalar path (NaN/inf or an exponent above
+ * g_max_exponent)
+ *
+ * @param row values of the row, transformed in place
+ * @param begin first feature
+ * @param cols amount of features
+ * @param model per feature constants
+ * @return int first feature not transformed
+ */
+static YB_TARGET int YB_FN(yb_transform_row)(double *row, int begin, int cols,
+                                             const ybRowModel *model) {
+  YB_VD zero = YB_FN(yb_set)(0.0);
+  YB_VD one = YB_FN(yb_set)(1.0);
+  YB_VD low = YB_FN(yb_set)(-g_max_exponent);
+  int j = begin;
+  for (; j + YB_LANES <= cols; j += YB_LANES) {
+    YB_VD y, lambda_pos, lambda_neg, inverse_pos, inverse_neg, mean, inverse_sd;
+    memcpy(&y, row + j, sizeof(y));
+    memcpy(&lambda_pos, model->lambda_pos + j, sizeof(lambda_pos));
+    memcpy(&lambda_neg, model->lambda_neg + j, sizeof(lambda_neg));
+    memcpy(&inverse_pos, model->inverse_pos + j, sizeof(inverse_pos));
+    memcpy(&inverse_neg, model->inverse_neg + j, sizeof(inverse_neg));
+    memcpy(&mean, model->mean + j, sizeof(mean));
+    memcpy(&inverse_sd, model->inverse_sd + j, sizeof(inverse_sd));
+    YB_VL positive = y >= zero;
+    YB_VD a = YB_FN(yb_select)(positive, y, -y);
+    YB_VD p = YB_FN(yb_select)(positive, lambda_pos, lambda_neg);
+    YB_VD inverse = YB_FN(yb_select)(positive, inverse_pos, inverse_neg);
+    YB_VD log_a = YB_FN(yb_log1p)(a);
+    YB_VD x = p * log_a;
+    YB_VL reject = ~(a <= __DBL_MAX__) | (x > g_max_exponent);
+    if (YB_ANY(reject)) {
+      break;
+    }
+    // expm1 is -1 far below -g_max_exponent
+    x = YB_FN(yb_select)(x < low, low, x);
+    // branch classes: log (inverse 0), power, and identity (lambda 1)
+    YB_VD power = YB_FN(yb_expm1)(x) * inverse;
+    YB_VD value = YB_FN(yb_select)(inverse == zero, log_a, power);
+    value = YB_FN(yb_select)(positive, value, -value);
+    value = YB_FN(yb_select)(lambda_pos == one, y, value);
+    value = (value - mean) * inverse_sd;
+    memcpy(row + j, &value, sizeof(value));
+  }
+  return j;
+}
+
+/**
+ * @brief broadcasts a scalar to all float lanes
+ */
+YB_INLINE YB_VF YB_FN(yb_setf)(float value) {
+  YB_VF zero = {0};
+  return zero + value;
+}
+
+/**
+ * @brief selects a where mask is set, b otherwise (float lanes)
+ */
+YB_INLINE YB_VF YB_FN(yb_selectf)(YB_VI mask, YB_VF a, YB_VF b) {
+  return (YB_VF)(((YB_VI)a & mask) | ((YB_VI)b & ~mask));
+}
+
+/**
+ * @brief (float) natural logarithm of 1+a for finite a>=0
+ */
+YB_INLINE YB_VF YB_FN(yb_log1pf)(YB_VF a) {
+  YB_VF one = YB_FN(yb_setf)(1.0f);
+  YB_VF u = one + a;
+  // rounding error of 1+a, restores log1p precision for small a
+  YB_VF correction = (a - (u - one)) / u;
+
+  YB_VUI bits = (YB_VUI)u;
+  YB_VUI exponent_bits = bits >> 23;
+  YB_VF m = (YB_VF)((bits & 0x007FFFFFU) | 0x3F800000U);
+  YB_VF e = (YB_VF)(exponent_bits | 0x4B000000U) - 0x1p23f - 127.0f;
+  YB_VI shift = m > (float)M_SQRT2;
+  m = YB_FN(yb_selectf)(shift, m * 0.5f, m);
+  e = YB_FN(yb_selectf)(shift, e + 1.0f, e);
+
+  YB_VF x = m - one;
+  YB_VF z = x * x;
+  YB_VF y = YB_FN(yb_setf)(g_logf_p0);
+  y = y * x + g_logf_p1;
+  y = y * x + g_logf_p2;
+  y = y * x + g_logf_p3;
+  y = y * x + g_logf_p4;
+  y = y * x + g_logf_p5;
+  y = y * x + g_logf_p6;
+  y = y * x + g_logf_p7;
+  y = y * x + g_logf_p8;
+  y = y * x * z;
+  y += e * g_ln2f_lo;
+  y += -0.5f * z;
+  return x + y + correction + e * g_ln2f_hi;
+}
+
+/**
+ * @brief (float) exponential function for |x| <= g_max_exponentf
+ */
+YB_INLINE YB_VF YB_FN(yb_expf)(YB_VF x) {
+  YB_VF magic = YB_FN(yb_setf)(0x1.8p23f);
+  YB_VF shifted = x * (float)M_LOG2E + magic;
+  YB_VF k = shifted - magic;
+  YB_VI k_int = (YB_VI)shifted - (YB_VI)magic;
+
+  YB_VF r = x - k * g_ln2f_hi - k * g_ln2f_lo;
+  YB_VF y = YB_FN(yb_setf)(g_expf_p0);
+  y = y * r + g_expf_p1;
+  y = y * r + g_expf_p2;
+  y = y * r + g_expf_p3;
+  y = y * r + g_expf_p4;
+  y = y * r + g_expf_p5;
+  y = y * r * r + r + 1.0f;
+  return (YB_VF)((YB_VUI)y + ((YB_VUI)k_int << 23));
+}
+
+/**
+ * @brief (float) exp(x) - 1 for |x| <= g_max_exponentf, the reduced form
+ * r + r*r*poly(r) of yb_expf keeps full precision for |x| < ln2/2
+ */
+YB_INLINE YB_VF YB_FN(yb_expm1f)(YB_VF x) {
+  YB_VF magic = YB_FN(yb_setf)(0x1.8p23f);
+  YB_VF shifted = x * (float)M_LOG2E + magic;
+  YB_VF k = shifted - magic;
+  YB_VI k_int = (YB_VI)shifted - (YB_VI)magic;
+
+  YB_VF r = x - k * g_ln2f_hi - k * g_ln2f_lo;
+  YB_VF y = YB_FN(yb_setf)(g_expf_p0);
+  y = y * r + g_expf_p1;
+  y = y * r + g_expf_p2;
+  y = y * r + g_expf_p3;
+  y = y * r + g_expf_p4;
+  y = y * r + g_expf_p5;
+  YB_VF e = y * r * r + r;
+  y = (YB_VF)((YB_VUI)(e + 1.0f) + ((YB_VUI)k_int << 23));
+  return YB_FN(yb_selectf)(k_int == 0, e, y - 1.0f);
+}
+
+/**
+ * @brief (float) transformation of one block of a validated column from its
+ * cached log1pf(|y|), see yb_cached_value
+ */
+YB_INLINE YB_VF YB_FN(yb_cached_valuef)(YB_VF y, YB_VF log_a, float lambda,
+                                        YB_VI *overflow) {
+  YB_VF zero = YB_FN(yb_setf)(0.0f);
+  YB_VF one = YB_FN(yb_setf)(1.0f);
+  YB_VF low = YB_FN(yb_setf)(-g_max_exponentf);
+  YB_VI positive = y >= zero;
+  YB_VF p = YB_FN(yb_selectf)(positive, YB_FN(yb_setf)(lambda),
+                              YB_FN(yb_setf)(2 - lambda));
+  YB_VF x = p * log_a;
+  *overflow = x > g_max_exponentf;
+  x = YB_FN(yb_selectf)(x < low, low, x);
+  YB_VI log_only = p == zero;
+  YB_VF safe_p = YB_FN(yb_selectf)(log_only, one, p);
+  YB_VF power = YB_FN(yb_expm1f)(x) / safe_p;
+  YB_VF value = YB_FN(yb_selectf)(log_only, log_a, power);
+  return YB_FN(yb_selectf)(positive, value, -value);
+}
+
+/**
+ * @brief (float) transforms full blocks of a validated column from its cached
+ * log1pf(|y|), stops in front of a block with an exponent above
+ * g_max_exponentf
+ *
+ * @param vector values of the column
+ * @param log_cache log1pf(|y|) of every value
+ * @param rows amount of values
+ * @param lambda transformation parameter
+ * @param result receives the transformed values
+ * @return int amount of values transformed
+ */
+static YB_TARGET int YB_FN(yb_transform_cachedf)(const float *vector,
+                                                 const float *log_cache,
+                                                 int rows, float lambda,
+                                                 float *result) {
+  int i = 0;
+  for (; i + 2 * YB_LANES <= rows; i += 2 * YB_LANES) {
+    YB_VF y;
+    YB_VF log_a;
+    YB_VI overflow;
+    memcpy(&y, vector + i, sizeof(y));
+    memcpy(&log_a, log_cache + i, sizeof(log_a));
+    YB_VF value = YB_FN(yb_cached_valuef)(y, log_a, lambda, &overflow);
+    if (YB_ANYF(overflow)) {
+      break;
+    }
+    memcpy(result + i, &value, sizeof(value));
+  }
+  return i;
+}
+
+/**
+ * @brief (float) adds the transformed full blocks of a validated column to the
+ * moments of the lanes, every block is widened to two double vectors that feed
+ * one set of lanes each; stops like yb_transform_cachedf
+ *
+ * @param vector values of the column
+ * @param log_cache log1pf(|y|) of every value
+ * @param rows amount of values
+ * @param lambda transformation parameter
+ * @param scale factor applied to every transformed value
+ * @param lanes moments of 2 * YB_LANES lanes, updated in place
+ * @return int amount of values accumulated
+ */
+static YB_TARGET int YB_FN(yb_moments_cachedf)(const float *vector,
+                                               const float *log_cache,
+                                               int rows, float lambda,
+                                               double scale,
+                                               yjMoments *lanes) {
+  YB_VD mean0, m20, m30;
+  YB_VD mean1, m21, m31;
+  double count;
+  YB_FN(yb_moments_load)(lanes, &count, &mean0, &m20, &m30);
+  YB_FN(yb_moments_load)(lanes + YB_LANES, &count, &mean1, &m21, &m31);
+  int i = 0;
+  for (; i + 2 * YB_LANES <= rows; i += 2 * YB_LANES) {
+    YB_VF y;
+    YB_VF log_a;
+    YB_VI overflow;
+    memcpy(&y, vector + i, sizeof(y));
+    memcpy(&log_a, log_cache + i, sizeof(log_a));
+    YB_VF value = YB_FN(yb_cached_valuef)(y, log_a, lambda, &overflow);
+    if (YB_ANYF(overflow)) {
+      break;
+    }
+    YB_VH half0;
+    YB_VH half1;
+    memcpy(&half0, &value, sizeof(half0));
+    memcpy(&half1, (const char *)&value + sizeof(half0), sizeof(half1));
+    count += 1;
+    YB_FN(yb_moments_add)(__builtin_convertvector(half0, YB_VD) * scale, count,
+                          &mean0, &m20, &m30);
+    YB_FN(yb_moments_add)(__builtin_convertvector(half1, YB_VD) * scale, count,
+                          &mean1, &m21, &m31);
+  }
+  YB_FN(yb_moments_store)(count, mean0, m20, m30, lanes);
+  YB_FN(yb_moments_store)(count, mean1, m21, m31, lanes + YB_LANES);
+  return i;
+}
+
+/**
+ * @brief (float) transforms full blocks of the vector until a block needs the
+ * checked scalar path
+ *
+ * @param vector values to be transformed in place
+ * @param rows amount of values
+ * @param limits per call constants
+ * @return int amount of values transformed
+ */
+static YB_TARGET int YB_FN(yb_transformf)(float *vector, int rows,
+                                          const ybLimitsf *limits) {
+  YB_VF zero = YB_FN(yb_setf)(0.0f);
+  YB_VF one = YB_FN(yb_setf)(1.0f);
+  YB_VF lambda_pos = YB_FN(yb_setf)(limits->lambda_pos);
+  YB_VF lambda_neg = YB_FN(yb_setf)(limits->lambda_neg);
+  int i = 0;
+  for (; i + 2 * YB_LANES <= rows; i += 2 * YB_LANES) {
+    YB_VF y;
+    memcpy(&y, vector + i, sizeof(y));
+    YB_VI positive = y >= zero;
+    YB_VF a = YB_FN(yb_selectf)(positive, y, -y);
+    YB_VF p = YB_FN(yb_selectf)(positive, lambda_pos, lambda_neg);
+
+    // every check of yjFormular1f..4f, plus NaN/inf
+    YB_VI reject =
+        ~(a <= __FLT_MAX__) |
+        (positive & ((y < limits->pos_lower) | (y > limits->pos_upper) |
+                     (y == limits->pos_sentinel))) |
+        (~positive & ((y < limits->neg_lower) | (y > limits->neg_upper) |
+                      (y == limits->neg_sentinel)));
+    YB_VF log_a = YB_FN(yb_log1pf)(a);
+    YB_VF x = p * log_a;
+    reject |= (x > g_max_exponentf) | (x < -g_max_exponentf);
+    if (YB_ANYF(reject)) {
+      break;
+    }
+
+    YB_VI log_only = p == zero;
+    YB_VF safe_p = YB_FN(yb_selectf)(log_only, one, p);
+    YB_VF power = (YB_FN(yb_expf)(x) - one) / safe_p;
+    YB_VF result = YB_FN(yb_selectf)(log_only, log_a, power);
+    result = YB_FN(yb_selectf)(positive, result, -result);
+    memcpy(vector + i, &result, sizeof(result));
+  }
+  return i;
+}
+
+#undef YB_CAT_
+#undef YB_CAT
+#undef YB_FN
+#undef YB_VD
+#undef YB_VL
+#undef YB_VU
+#undef YB_VF
+#undef YB_VI
+#undef YB_VUI
+#undef YB_VH
+#undef YB_INLINE
@@ -0,0 +1,32 @@
+/****************************************************************
+ * Copyright (c) 2023 Jerome Brenig, Sigrun May
+ * Ostfalia Hochschule für angewandte Wissenschaften
+ *
+ * This software is distributed under the terms of the MIT license
+ * which is available at https://opensource.org/licenses/MIT
+ *
+ *   yjStream.h
+ */
+
+#ifndef YJSTREAM_H
+#define YJSTREAM_H
+
+#include <stddef.h>
+
+#include "comInterface.h"
+
+// memory budget of the block buffers when the caller has no better one
+#define YS_DEFAULT_BUDGET ((size_t)256 << 20)
+
+// public functions
+int ysStreamOperation(double interval_start, double interval_end,
+                      int precision, const char *input_path,
+                      const char *output_path, BOOL standardize,
+                      size_t memory_budget, int thread_count);
+
+// unit tests
+#ifdef UNIT_TEST
+void test_ysStreamOperation(void);
+#endif
+
+#endif /* YJSTREAM_H */
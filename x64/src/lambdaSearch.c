@@ -15,6 +15,27 @@
  *          int lsLambdaSearch ( double *, double, double, double, int, double*,
  *double * ) int lsLambdaSearchf ( double *, double, double, double, int, double
  **, double * )
+ *          int lsLambdaSearchCtx / lsSmartSearchCtx: same searches with a
+ *          caller owned yjContext, safe to run concurrently
+ *          float variants of the searches and statistics (suffix f)
+ *          int lsAverageU / lsVarianceU: statistics without the per element
+ *          overflow check, for columns validated once before the search
+ *          int lsLambdaSearchScratch / lsSmartSearchScratch: searches with
+ *          caller owned scratch memory (lsScratchInit/Reserve/Free), reused
+ *          across columns; validated columns are evaluated from a log1p cache
+ *          in one fused transform-and-moments pass per lambda
+ *          int lsScratchSetLambdaBatch: lambdas evaluated per cache
+ *          blocked sweep over a validated column, per scratch memory
+ *          int lsBrentSearch / lsBrentSearchCtx / lsBrentSearchScratch: root
+ *          of skew(lambda) by Brent's method to a tolerance, smallest |skew|
+ *          if the skew does not change its sign
+ *          int lsMleSearch / lsMleSearchCtx / lsMleSearchScratch: lambda of
+ *          maximum likelihood (sklearn/scipy objective), bounded Brent
+ *          int lsScratchSetRowParts: splits the log cache and the fused sweeps
+ *          of a column into row blocks on the thread pool, for matrices with
+ *          fewer columns than threads
+ *          int lsScratchStats: mean and standard deviation of the searched
+ *          column transformed with a lambda, from the fused moments
  *
  * NOTES    :
  *          These functions are used inside the lambdaSearch function
@@ -42,6 +63,7 @@
 #include "include/errnumCodes.h"
 #include "include/lambdaSearch.h"
 #include "include/testFramework.h"
+#include "include/threadPool.h"
 #include "include/yeoJohnson.h"
 
 
@@ -50,6 +72,16 @@
  *****************************************************************************/
 
 static const double g_maxHighDouble = __DBL_MAX__;
+static const float g_maxHighFloat = __FLT_MAX__;
+
+// deviation relative to the average below which the fused moments give way
+// to the three pass skew (constant columns, rounding noise of the values
+// dominates the skew there)
+static const double g_minFusedDeviation = 1e-12;
+static const double g_minFusedDeviationf = 1e-6;
+
+// safety limit of the iterations of lsBrentSearch, each evaluates one lambda
+static const int g_maxBrentIterations = 100;
 
 /*****************************************************************************
  *                           PRIVATE FUNCTIONS
@@ -158,6 +190,68 @@ static int lsSkew(double *vector, double average, double variance,
   return 0;
 }
 
+/**
+ * @brief (double) lsAverage without the per element overflow check, only for
+ * columns accepted by lsValidateColumn
+ *
+ * @param vector containing all values
+ * @param row_count the amount of contained values
+ * @param result average
+ * @return int error return code
+ */
+int lsAverageU(double *vector, int row_count, double *result) {
+  *result = 0;
+  for (int i = 0; i < row_count; i++) {
+    *result += *(vector + i);
+  }
+  *result /= row_count;
+  return 0;
+}
+
+/**
+ * @brief (double) lsVariance without the per element overflow check
+ *
+ * @param vector containing all values
+ * @param average average of the given vector
+ * @param row_count the amount of contained values
+ * @param result variance of the given vector
+ * @return int error return code
+ */
+int lsVarianceU(double *vector, double average, int row_count,
+                double *result) {
+  *result = 0;
+  for (int i = 0; i < row_count; i++) {
+    double component = *(vector + i);
+    *result += (component - average) * (component - average);
+  }
+  *result /= row_count - 1;
+  *result = sqrt(*result);
+  return 0;
+}
+
+/**
+ * @brief (double) lsSkew without the per element overflow check
+ *
+ * @param vector containing all values
+ * @param average average of the given vector
+ * @param variance variance of the given vector
+ * @param row_count the amount of contained values
+ * @param result skew of the given vector
+ * @return int error return code
+ */
+static int lsSkewU(double *vector, double average, double variance,
+                   int row_count, double *result) {
+  *result = 0;
+  for (int i = 0; i < row_count; i++) {
+    double component = *(vector + i);
+    *result += ((component - average) / variance) *
+               ((component - average) / variance) *
+               ((component - average) / variance);
+  }
+  *result /= row_count;
+  return 0;
+}
+
 /**
  * @brief (double) Measures the distance of two values to 0.
  *
@@ -225,26 +319,36 @@ static int lsSkewIntervalStep(double *vector, int row_count, double *skew,
 }
 
 /**
- * @brief (double) calculates the bowley skewness of three given parameters
- * 
- * @param q1 first quantil
- * @param q2 seconde quantil (median)
- * @param q3 third quantil
- * @param skew result variable for skewness
+ * @brief (double) lsSkewIntervalStep for a column accepted by lsValidateColumn.
+ * The limits of lsAverage and lsVariance are covered by the validation, the
+ * limit of lsSkew scales with the deviation and is checked once per call.
+ *
+ * @param vector    containing all values
+ * @param row_count amount of contained values
+ * @param bound largest absolute value of the vector
+ * @param skew  given skew
  * @param result 1 if the new skew is closer to 0, 0 otherwise
- * @return int error code
+ * @return int error return code
  */
-static int lsBowleySkewnessStep(double q1, double q2, double q3, double  *skew, int *result) {
+static int lsSkewIntervalStepU(double *vector, int row_count, double bound,
+                               double *skew, int *result) {
   *result = 0;
-  if (q3-q1==0) {
-    return ERR_SKEW_BOWLEY;
+  double average;
+  lsAverageU(vector, row_count, &average);
+  double sd;
+  lsVarianceU(vector, average, row_count, &sd);
+  double new_skew;
+  int errnum;
+  if (4 * bound <= cbrt(g_maxHighDouble / row_count) * sd) {
+    errnum = lsSkewU(vector, average, sd, row_count, &new_skew);
+  } else {
+    errnum = lsSkew(vector, average, sd, row_count, &new_skew);
   }
-  double new_skew = (q3+q1-2*q2)/(q3-q1);
-  int compare_flag;
-  int errnum = lsIsCloserToZero(*skew, new_skew, &compare_flag);
-  if (errnum != 0) { // Vergleich mit vorheriger Schiefe
-    return ERR_CLOSER_TO_ZERO | errnum;
+  if (errnum != 0) {
+    return ERR_SKEW | errnum;
   }
+  int compare_flag;
+  lsIsCloserToZero(*skew, new_skew, &compare_flag);
   if (compare_flag) {
     *skew = new_skew;
     *result = 1;
@@ -252,122 +356,2047 @@ static int lsBowleySkewnessStep(double q1, double q2, double q3, double  *skew,
   return 0;
 }
 
+// one column split into row blocks for the pool (lsScratch.row_parts)
+typedef struct {
+  const double *vector;
+  double *log_cache;
+  int row_count;
+  const double *lambdas;
+  int lambda_count;
+  double scale;
+  yjMoments (*moments)[YJ_MAX_LAMBDA_BATCH]; // moments of every block
+} lsRowJob;
+
+/**
+ * @brief rows [begin, end) of block part of part_count blocks of a column
+ *
+ * @param row_count amount of values of the column
+ * @param part index of the block
+ * @param part_count amount of blocks
+ * @param begin first row of the block
+ * @param end row after the last row of the block
+ */
+static void lsRowBlock(int row_count, int part, int part_count, int *begin,
+                       int *end) {
+  *begin = (int)((long long)row_count * part / part_count);
+  *end = (int)((long long)row_count * (part + 1) / part_count);
+}
+
+/**
+ * @brief (double) part of lsLogCache, logarithms of one row block
+ *
+ * @param args lsRowJob of the column
+ * @param part index of the block
+ * @param part_count amount of blocks
+ */
+static void lsLogCacheRows(void *args, int part, int part_count) {
+  lsRowJob *job = (lsRowJob *)args;
+  int begin, end;
+  lsRowBlock(job->row_count, part, part_count, &begin, &end);
+  yjLogCache(job->vector + begin, end - begin, job->log_cache + begin);
+}
+
+/**
+ * @brief (double) part of lsMoments, moments of one row block
+ *
+ * @param args lsRowJob of the column
+ * @param part index of the block
+ * @param part_count amount of blocks
+ */
+static void lsMomentsRows(void *args, int part, int part_count) {
+  lsRowJob *job = (lsRowJob *)args;
+  int begin, end;
+  lsRowBlock(job->row_count, part, part_count, &begin, &end);
+  yjMomentsCachedBatch(job->vector + begin, job->log_cache + begin,
+                       end - begin, job->lambdas, job->lambda_count,
+                       job->scale, job->moments[part]);
+}
+
+/**
+ * @brief (double) fills the log cache of the scratch memory (yjLogCache),
+ * split into scratch->row_parts row blocks on the pool
+ *
+ * @param scratch scratch memory with room for row_count values
+ * @param vector column to be searched
+ * @param row_count amount of contained values
+ */
+static void lsLogCache(const lsScratch *scratch, const double *vector,
+                       int row_count) {
+  if (scratch->row_parts <= 1) {
+    yjLogCache(vector, row_count, scratch->log_cache);
+    return;
+  }
+  lsRowJob job;
+  job.vector = vector;
+  job.log_cache = scratch->log_cache;
+  job.row_count = row_count;
+  tpRun(lsLogCacheRows, &job, scratch->row_parts);
+}
+
+/**
+ * @brief (double) yjMomentsCachedBatch over the log cache of the scratch
+ * memory; with scratch->row_parts > 1 every row block is swept on the pool
+ * and the moments of the blocks are merged in row order (yjMomentsMerge),
+ * which may round differently from one sweep in the last bits only
+ *
+ * @param scratch scratch memory with the log cache of the column
+ * @param vector column to be searched
+ * @param row_count amount of contained values
+ * @param lambdas transformation parameters
+ * @param lambda_count amount of lambdas, at most YJ_MAX_LAMBDA_BATCH
+ * @param scale factor applied to every transformed value
+ * @param moments receives the moments of every lambda
+ */
+static void lsMoments(const lsScratch *scratch, const double *vector,
+                      int row_count, const double *lambdas, int lambda_count,
+                      double scale, yjMoments *moments) {
+  if (scratch->row_parts <= 1) {
+    yjMomentsCachedBatch(vector, scratch->log_cache, row_count, lambdas,
+                         lambda_count, scale, moments);
+    return;
+  }
+  yjMoments blocks[LS_MAX_ROW_PARTS][YJ_MAX_LAMBDA_BATCH];
+  lsRowJob job;
+  job.vector = vector;
+  job.log_cache = scratch->log_cache;
+  job.row_count = row_count;
+  job.lambdas = lambdas;
+  job.lambda_count = lambda_count;
+  job.scale = scale;
+  job.moments = blocks;
+  tpRun(lsMomentsRows, &job, scratch->row_parts);
+  for (int k = 0; k < lambda_count; k++) {
+    *(moments + k) = blocks[0][k];
+    for (int part = 1; part < scratch->row_parts; part++) {
+      yjMomentsMerge(moments + k, &blocks[part][k]);
+    }
+  }
+}
+
+/**
+ * @brief (double) decides once per column whether a search may use the
+ * unchecked functions for every lambda in [lower_lambda, upper_lambda] and
+ * fills the log cache of the scratch memory for such columns
+ *
+ * @param context boundary boxes of the search
+ * @param scratch scratch memory with room for row_count values
+ * @param vector column to be searched
+ * @param row_count amount of contained values
+ * @param lower_lambda lowest lambda the search may evaluate
+ * @param upper_lambda highest lambda the search may evaluate
+ * @param unchecked 1 if the unchecked path is safe, 0 otherwise
+ * @param bound largest absolute transformed value of the column
+ * @return int error return code
+ */
+static int lsPrepareColumn(const yjContext *context, lsScratch *scratch,
+                           double *vector, int row_count, double lower_lambda,
+                           double upper_lambda, int *unchecked,
+                           double *bound) {
+  *unchecked = 0;
+  if (row_count <= 2) {
+    return 0;
+  }
+  int safe;
+  yjValidateColumnCtx(context, vector, row_count, lower_lambda, upper_lambda,
+                      &safe, bound);
+  // limits of lsAverage and lsVariance, with the average inside +-bound
+  *unchecked = safe && *bound <= g_maxHighDouble / row_count &&
+               4 * *bound <= sqrt(g_maxHighDouble / row_count);
+  if (*unchecked && scratch->cache_logs) {
+    lsLogCache(scratch, vector, row_count);
+    if (*bound >= DBL_MIN) {
+      scratch->scale = ldexp(1, -ilogb(*bound));
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief (double) transforms the column with one lambda into the scratch
+ * memory and compares its skew with the best skew so far
+ *
+ * @param context boundary boxes of the search
+ * @param scratch scratch memory prepared by lsPrepareColumn
+ * @param vector column to be searched
+ * @param row_count amount of contained values
+ * @param lambda transformation parameter
+ * @param unchecked result of lsPrepareColumn
+ * @param bound result of lsPrepareColumn
+ * @param skew best skew so far
+ * @param skew_test_flag 1 if the skew of lambda is closer to 0
+ * @param errnum error mask of the column
+ * @return int 0, -2 on a transformation error, -3 on a skew error
+ */
+static int lsEvaluateLambda(const yjContext *context, lsScratch *scratch,
+                            double *vector, int row_count, double lambda,
+                            int unchecked, double bound, double *skew,
+                            int *skew_test_flag, int *errnum) {
+  double *zws = scratch->zws;
+  if (unchecked) {
+    if (scratch->cache_logs) {
+      yjTransformCached(vector, scratch->log_cache, row_count, lambda, zws);
+    } else {
+      for (int i = 0; i < row_count; i++) {
+        yjCalculationU(*(vector + i), lambda, zws + i);
+      }
+    }
+    *errnum |=
+        lsSkewIntervalStepU(zws, row_count, bound, skew, skew_test_flag);
+  } else {
+    for (int i = 0; i < row_count; i++) {
+      *errnum |= yjCalculationCtx(context, *(vector + i), lambda, zws + i);
+      if (*errnum != 0) {
+        *errnum |= ERR_LAMBDA_SEARCH | ERR_ABORT_YEO_JOHNSON;
+        // printf("\texception occured during yeoJohnson\n");
+        return -2;
+      }
+    }
+    *errnum |= lsSkewIntervalStep(zws, row_count, skew, skew_test_flag);
+  }
+  if (*errnum != 0) {
+    *errnum |= ERR_LAMBDA_SEARCH | ERR_SKEW_TEST;
+    // printf("\texception occured during skewTest\n");
+    return -3;
+  }
+  return 0;
+}
+
+/**
+ * @brief (double) compares the skew of one lambda, given by the fused moments
+ * of yjMomentsCachedBatch, with the best skew so far. The skew m3/n/sd^3 needs
+ * no overflow check as the moments are scaled by a power of two near 1/bound.
+ * With m the largest absolute transformed value of lambda, the skew is within
+ * about 1e-15 * m / sd of the exact skew of the transformed values and differs
+ * from the three pass result by less than 1e-15 * row_count * m / sd, the
+ * rounding error of the three pass average. Nearly constant columns
+ * (g_minFusedDeviation) and columns beyond the limit of lsSkew are evaluated
+ * by lsEvaluateLambda instead, with its error codes.
+ *
+ * @param context boundary boxes of the search
+ * @param scratch scratch memory prepared by lsPrepareColumn
+ * @param vector column to be searched
+ * @param row_count amount of contained values
+ * @param lambda transformation parameter
+ * @param bound result of lsPrepareColumn
+ * @param scale factor the moments were accumulated with
+ * @param moments moments of the scaled transformed values of lambda
+ * @param skew best skew so far
+ * @param skew_test_flag 1 if the skew of lambda is closer to 0
+ * @param errnum error mask of the column
+ * @return int 0, -3 on a skew error
+ */
+static int lsEvaluateMoments(const yjContext *context, lsScratch *scratch,
+                             double *vector, int row_count, double lambda,
+                             double bound, double scale,
+                             const yjMoments *moments, double *skew,
+                             int *skew_test_flag, int *errnum) {
+  double sd = sqrt(moments->m2 / (row_count - 1));
+  if (!(sd > g_minFusedDeviation * fabs(moments->mean)) ||
+      4 * bound > cbrt(g_maxHighDouble / row_count) * (sd / scale)) {
+    return lsEvaluateLambda(context, scratch, vector, row_count, lambda, 1,
+                            bound, skew, skew_test_flag, errnum);
+  }
+  double new_skew = moments->m3 / row_count / (sd * sd * sd);
+  lsIsCloserToZero(*skew, new_skew, skew_test_flag);
+  if (*skew_test_flag) {
+    *skew = new_skew;
+    // kept for the standardization of the transformed column
+    scratch->stats.lambda = lambda;
+    scratch->stats.mean = moments->mean / scale;
+    scratch->stats.sd = sd / scale;
+    scratch->stats.valid = 1;
+  }
+  return 0;
+}
+
+/**
+ * @brief (double) evaluates the lambdas start + step * i, i = 0..steps, in
+ * order and keeps the one with the skew closest to 0. Validated columns with
+ * a log cache get the moments of scratch->lambda_batch lambdas per sweep over
+ * the column (yjMomentsCachedBatch), everything else goes through
+ * lsEvaluateLambda one lambda at a time.
+ *
+ * @param context boundary boxes of the search
+ * @param scratch scratch memory prepared by lsPrepareColumn
+ * @param vector column to be searched
+ * @param row_count amount of contained values
+ * @param start first lambda
+ * @param step distance of the lambdas
+ * @param steps index of the last lambda
+ * @param unchecked result of lsPrepareColumn
+ * @param bound result of lsPrepareColumn
+ * @param skew best skew so far
+ * @param result_lambda lambda of the best skew so far
+ * @param errnum error mask of the column
+ * @return int 0, -2 on a transformation error, -3 on a skew error
+ */
+static int lsScanLambdas(const yjContext *context, lsScratch *scratch,
+                         double *vector, int row_count, double start,
+                         double step, int steps, int unchecked, double bound,
+                         double *skew, double *result_lambda, int *errnum) {
+  int fused = unchecked && scratch->cache_logs && bound >= DBL_MIN;
+  double scale = fused ? ldexp(1, -ilogb(bound)) : 1;
+  int batch = fused ? scratch->lambda_batch : 1;
+  double lambdas[YJ_MAX_LAMBDA_BATCH];
+  yjMoments moments[YJ_MAX_LAMBDA_BATCH];
+  for (int first = 0; first <= steps; first += batch) {
+    int count = steps + 1 - first < batch ? steps + 1 - first : batch;
+    for (int k = 0; k < count; k++) {
+      lambdas[k] = start + (step * (first + k));
+    }
+    if (fused) {
+      lsMoments(scratch, vector, row_count, lambdas, count, scale, moments);
+    }
+    for (int k = 0; k < count; k++) {
+      int skew_test_flag;
+      int ret;
+      if (fused) {
+        ret = lsEvaluateMoments(context, scratch, vector, row_count,
+                                lambdas[k], bound, scale, moments + k, skew,
+                                &skew_test_flag, errnum);
+      } else {
+        ret = lsEvaluateLambda(context, scratch, vector, row_count, lambdas[k],
+                               unchecked, bound, skew, &skew_test_flag, errnum);
+      }
+      if (ret != 0) {
+        return ret;
+      }
+      if (skew_test_flag) {
+        *result_lambda = lambdas[k];
+      }
+    }
+  }
+  return 0;
+}
+
+// column of a root or minimum search, prepared once by lsColumnInit
+typedef struct {
+  const yjContext *context;
+  lsScratch *scratch;
+  double *vector;
+  int row_count;
+  int unchecked; // result of lsPrepareColumn
+  double bound;  // result of lsPrepareColumn
+  int fused;     // 1: moments from lsMoments, scaled by scale
+  double scale;
+  double log_sum; // sum of sign(y) * log1p(|y|), lsMleSearch only
+} lsColumn;
+
+// objective of lsBrentMinimum, value to minimize and skew of one lambda
+typedef int (*lsObjective)(const lsColumn *column, double lambda,
+                           double *value, double *skew, int *errnum);
+
+/**
+ * @brief (double) prepares a column for the evaluation of single lambdas in
+ * [lower_lambda, upper_lambda], see lsPrepareColumn
+ *
+ * @param column receives the prepared column
+ * @param context boundary boxes of the search
+ * @param scratch scratch memory with room for row_count values
+ * @param vector column to be searched
+ * @param row_count amount of contained values
+ * @param lower_lambda lowest lambda the search may evaluate
+ * @param upper_lambda highest lambda the search may evaluate
+ */
+static void lsColumnInit(lsColumn *column, const yjContext *context,
+                         lsScratch *scratch, double *vector, int row_count,
+                         double lower_lambda, double upper_lambda) {
+  column->context = context;
+  column->scratch = scratch;
+  column->vector = vector;
+  column->row_count = row_count;
+  lsPrepareColumn(context, scratch, vector, row_count, lower_lambda,
+                  upper_lambda, &column->unchecked, &column->bound);
+  column->fused =
+      column->unchecked && scratch->cache_logs && column->bound >= DBL_MIN;
+  column->scale = column->fused ? ldexp(1, -ilogb(column->bound)) : 1;
+  column->log_sum = 0;
+}
+
+/**
+ * @brief (double) skew of the column transformed with one lambda, through the
+ * fused moments where lsScanLambdas would use them
+ *
+ * @param column column prepared by lsColumnInit
+ * @param lambda transformation parameter
+ * @param skew skew of lambda, g_maxHighDouble if it is not a number
+ * @param errnum error mask of the column
+ * @return int 0, -2 on a transformation error, -3 on a skew error
+ */
+static int lsSkewOfLambda(const lsColumn *column, double lambda,
+                          double *skew, int *errnum) {
+  int skew_test_flag;
+  *skew = g_maxHighDouble;
+  if (column->fused) {
+    yjMoments moments;
+    lsMoments(column->scratch, column->vector, column->row_count, &lambda, 1,
+              column->scale, &moments);
+    return lsEvaluateMoments(column->context, column->scratch, column->vector,
+                             column->row_count, lambda, column->bound,
+                             column->scale, &moments, skew, &skew_test_flag,
+                             errnum);
+  }
+  return lsEvaluateLambda(column->context, column->scratch, column->vector,
+                          column->row_count, lambda, column->unchecked,
+                          column->bound, skew, &skew_test_flag, errnum);
+}
+
+/**
+ * @brief (double) Brent's method for the root of skew(lambda) in a bracket
+ * [lower, upper] whose skews have opposite signs. Combines bisection with
+ * secant and inverse quadratic interpolation steps and stops once the root
+ * is enclosed by an interval of about tolerance.
+ *
+ * @param column column prepared by lsColumnInit
+ * @param lower lower end of the bracket
+ * @param lower_skew skew of lower
+ * @param upper upper end of the bracket
+ * @param upper_skew skew of upper
+ * @param tolerance width of the final bracket
+ * @param result_lambda end of the final bracket with the skew closest to 0
+ * @param result_skew skew of result_lambda
+ * @param errnum error mask of the column
+ * @return int 0, -2 on a transformation error, -3 on a skew error
+ */
+static int lsBrentRoot(const lsColumn *column, double lower,
+                       double lower_skew, double upper, double upper_skew,
+                       double tolerance, double *result_lambda,
+                       double *result_skew, int *errnum) {
+  double a = lower, fa = lower_skew;
+  double b = upper, fb = upper_skew;
+  double c = a, fc = fa;
+  double d = b - a, e = d;
+  for (int iteration = 0; iteration < g_maxBrentIterations; iteration++) {
+    if ((fb > 0) == (fc > 0)) {
+      // c is the end of the bracket opposite to b
+      c = a;
+      fc = fa;
+      d = e = b - a;
+    }
+    if (fabs(fc) < fabs(fb)) {
+      a = b;
+      b = c;
+      c = a;
+      fa = fb;
+      fb = fc;
+      fc = fa;
+    }
+    double tol = 2 * DBL_EPSILON * fabs(b) + tolerance / 2;
+    double half = (c - b) / 2;
+    if (fabs(half) <= tol || fb == 0) {
+      break;
+    }
+    if (fabs(e) >= tol && fabs(fa) > fabs(fb)) {
+      double p, q;
+      double s = fb / fa;
+      if (a == c) { // secant
+        p = 2 * half * s;
+        q = 1 - s;
+      } else { // inverse quadratic interpolation
+        double r = fb / fc;
+        q = fa / fc;
+        p = s * (2 * half * q * (q - r) - (b - a) * (r - 1));
+        q = (q - 1) * (r - 1) * (s - 1);
+      }
+      if (p > 0) {
+        q = -q;
+      } else {
+        p = -p;
+      }
+      if (2 * p < fmin(3 * half * q - fabs(tol * q), fabs(e * q))) {
+        e = d;
+        d = p / q;
+      } else { // interpolation too slow, bisection
+        d = half;
+        e = d;
+      }
+    } else {
+      d = half;
+      e = d;
+    }
+    a = b;
+    fa = fb;
+    b += fabs(d) > tol ? d : copysign(tol, half);
+    int ret = lsSkewOfLambda(column, b, &fb, errnum);
+    if (ret != 0) {
+      return ret;
+    }
+  }
+  *result_lambda = b;
+  *result_skew = fb;
+  return 0;
+}
+
+/**
+ * @brief (double) objective of lsBrentSearch without a sign change, |skew|
+ *
+ * @param column column prepared by lsColumnInit
+ * @param lambda transformation parameter
+ * @param value |skew| of lambda
+ * @param skew skew of lambda
+ * @param errnum error mask of the column
+ * @return int 0, -2 on a transformation error, -3 on a skew error
+ */
+static int lsAbsSkewOfLambda(const lsColumn *column, double lambda,
+                             double *value, double *skew, int *errnum) {
+  int ret = lsSkewOfLambda(column, lambda, skew, errnum);
+  *value = fabs(*skew);
+  return ret;
+}
+
+/**
+ * @brief (double) objective of lsMleSearch, the negative Yeo Johnson profile
+ * log likelihood n / 2 * log(variance) - (lambda - 1) * column->log_sum of
+ * sklearn/scipy, with the population variance of the transformed values.
+ * Variances below DBL_MIN are rejected with g_maxHighDouble like in scipy.
+ *
+ * @param column column prepared by lsColumnInit, with log_sum
+ * @param lambda transformation parameter
+ * @param value negative log likelihood of lambda
+ * @param skew skew of lambda
+ * @param errnum error mask of the column
+ * @return int 0, -2 on a transformation error, -3 on a skew error
+ */
+static int lsNegLogLikelihood(const lsColumn *column, double lambda,
+                              double *value, double *skew, int *errnum) {
+  int n = column->row_count;
+  double log_variance;
+  int ret;
+  if (column->fused) {
+    int skew_test_flag;
+    yjMoments moments;
+    lsMoments(column->scratch, column->vector, n, &lambda, 1, column->scale,
+              &moments);
+    *skew = g_maxHighDouble;
+    ret = lsEvaluateMoments(column->context, column->scratch, column->vector,
+                            n, lambda, column->bound, column->scale, &moments,
+                            skew, &skew_test_flag, errnum);
+    log_variance = log(moments.m2 / n) - 2 * log(column->scale);
+  } else {
+    ret = lsSkewOfLambda(column, lambda, skew, errnum);
+    if (ret != 0) {
+      return ret;
+    }
+    // the transformed values are left in zws and passed lsVariance
+    double average, sd;
+    lsAverageU(column->scratch->zws, n, &average);
+    lsVarianceU(column->scratch->zws, average, n, &sd);
+    log_variance = 2 * log(sd) + log((n - 1) / (double)n);
+  }
+  if (!(log_variance >= log(DBL_MIN))) {
+    *value = g_maxHighDouble;
+  } else {
+    *value = n / 2.0 * log_variance - (lambda - 1) * column->log_sum;
+  }
+  return ret;
+}
+
+/**
+ * @brief (double) Brent's method for the minimum of an objective in
+ * [lower, upper], golden section steps accelerated by parabolic
+ * interpolation (the algorithm of scipy.optimize.fminbound)
+ *
+ * @param column column prepared by lsColumnInit
+ * @param objective function to minimize
+ * @param lower lower end of the interval
+ * @param upper upper end of the interval
+ * @param tolerance accuracy of the minimum
+ * @param result_lambda lambda of the smallest value found
+ * @param result_value value of result_lambda
+ * @param result_skew skew of result_lambda
+ * @param errnum error mask of the column
+ * @return int 0, -2 on a transformation error, -3 on a skew error
+ */
+static int lsBrentMinimum(const lsColumn *column, lsObjective objective,
+                          double lower, double upper, double tolerance,
+                          double *result_lambda, double *result_value,
+                          double *result_skew, int *errnum) {
+  const double golden = 0.3819660112501051; // (3 - sqrt(5)) / 2
+  double a = lower, b = upper;
+  double x = a + golden * (b - a);
+  double fx, skew_x;
+  int ret = objective(column, x, &fx, &skew_x, errnum);
+  if (ret != 0) {
+    return ret;
+  }
+  double w = x, fw = fx, v = x, fv = fx;
+  double d = 0, e = 0;
+  for (int iteration = 0; iteration < g_maxBrentIterations; iteration++) {
+    double middle = (a + b) / 2;
+    double tol = sqrt(DBL_EPSILON) * fabs(x) + tolerance / 3;
+    if (fabs(x - middle) <= 2 * tol - (b - a) / 2) {
+      break;
+    }
+    int golden_step = 1;
+    if (fabs(e) > tol) { // parabola through x, w and v
+      double r = (x - w) * (fx - fv);
+      double q = (x - v) * (fx - fw);
+      double p = (x - v) * q - (x - w) * r;
+      q = 2 * (q - r);
+      if (q > 0) {
+        p = -p;
+      } else {
+        q = -q;
+      }
+      if (fabs(p) < fabs(q * e / 2) && p > q * (a - x) && p < q * (b - x)) {
+        e = d;
+        d = p / q;
+        double u = x + d;
+        if (u - a < 2 * tol || b - u < 2 * tol) {
+          d = copysign(tol, middle - x);
+        }
+        golden_step = 0;
+      }
+    }
+    if (golden_step) {
+      e = x >= middle ? a - x : b - x;
+      d = golden * e;
+    }
+    double u = fabs(d) >= tol ? x + d : x + copysign(tol, d);
+    double fu, skew_u;
+    ret = objective(column, u, &fu, &skew_u, errnum);
+    if (ret != 0) {
+      return ret;
+    }
+    if (fu <= fx) {
+      if (u >= x) {
+        a = x;
+      } else {
+        b = x;
+      }
+      v = w;
+      fv = fw;
+      w = x;
+      fw = fx;
+      x = u;
+      fx = fu;
+      skew_x = skew_u;
+    } else {
+      if (u < x) {
+        a = u;
+      } else {
+        b = u;
+      }
+      if (fu <= fw || w == x) {
+        v = w;
+        fv = fw;
+        w = u;
+        fw = fu;
+      } else if (fu <= fv || v == x || v == w) {
+        v = u;
+        fv = fu;
+      }
+    }
+  }
+  *result_lambda = x;
+  *result_value = fx;
+  *result_skew = skew_x;
+  return 0;
+}
+
+/**
+ * @brief (float) Calculating the average over the values of the given vector,
+ * accumulates in double.
+ *
+ * @param vector containing all values
+ * @param row_count the amount of contained values
+ * @param result average
+ * @return int error return code
+ */
+int lsAveragef(float *vector, int row_count, float *result) {
+  *result = 0;
+  if (vector == NULL) {
+    return ERR_VECTOR_IS_NULL;
+  }
+  if (row_count <= 0) {
+    return ERR_NOT_ENOUGH_ROWS;
+  }
+  float limit = g_maxHighFloat / row_count;
+  double sum = 0;
+  for (int i = 0; i < row_count; i++) {
+    float component = *(vector + i);
+    if (component > limit || component < -limit) {
+      return ERR_VALUE_OVERFLOW;
+    }
+    sum += component;
+  }
+  *result = (float)(sum / row_count);
+  return 0;
+}
+
+/**
+ * @brief (float) Calculating the standard deviation over the values of the
+ * given vector, accumulates in double.
+ *
+ * @param vector containing all values
+ * @param average average of the given vector
+ * @param row_count the amount of contained values
+ * @param result standard deviation of the given vector
+ * @return int error return code
+ */
+int lsVariancef(float *vector, float average, int row_count, float *result) {
+  *result = 0;
+  if (vector == NULL) {
+    return ERR_VECTOR_IS_NULL;
+  }
+  if (row_count <= 1) {
+    return ERR_NOT_ENOUGH_ROWS;
+  }
+  float limit = sqrtf(g_maxHighFloat / row_count) + average;
+  double sum = 0;
+  for (int i = 0; i < row_count; i++) {
+    float component = *(vector + i);
+    if (component > limit || component < -limit) {
+      return ERR_VALUE_OVERFLOW;
+    }
+    sum += (double)(component - average) * (component - average);
+  }
+  *result = (float)sqrt(sum / (row_count - 1));
+  return 0;
+}
+
+/**
+ * @brief (float) Calculating the skew over the values of the given vector,
+ * accumulates in double.
+ *
+ * @param vector containing all values
+ * @param average average of the given vector
+ * @param variance standard deviation of the given vector
+ * @param row_count the amount of contained values
+ * @param result skew of the given vector
+ * @return int error return code
+ */
+static int lsSkewf(float *vector, float average, float variance, int row_count,
+                   float *result) {
+  *result = 0;
+  if (vector == NULL) {
+    return ERR_VECTOR_IS_NULL;
+  }
+  if (row_count <= 2) {
+    return ERR_NOT_ENOUGH_ROWS;
+  }
+  float limit = cbrtf(g_maxHighFloat / row_count) * variance + average;
+  double sum = 0;
+  for (int i = 0; i < row_count; i++) {
+    float component = *(vector + i);
+    if (component > limit || component < -limit) {
+      return ERR_VALUE_OVERFLOW;
+    }
+    double standardized = (component - average) / variance;
+    sum += standardized * standardized * standardized;
+  }
+  *result = (float)(sum / row_count);
+  return 0;
+}
+
+/**
+ * @brief (float) lsAveragef without the per element overflow check
+ *
+ * @param vector containing all values
+ * @param row_count the amount of contained values
+ * @param result average
+ * @return int error return code
+ */
+int lsAverageUf(float *vector, int row_count, float *result) {
+  double sum = 0;
+  for (int i = 0; i < row_count; i++) {
+    sum += *(vector + i);
+  }
+  *result = (float)(sum / row_count);
+  return 0;
+}
+
+/**
+ * @brief (float) lsVariancef without the per element overflow check
+ *
+ * @param vector containing all values
+ * @param average average of the given vector
+ * @param row_count the amount of contained values
+ * @param result standard deviation of the given vector
+ * @return int error return code
+ */
+int lsVarianceUf(float *vector, float average, int row_count, float *result) {
+  double sum = 0;
+  for (int i = 0; i < row_count; i++) {
+    float component = *(vector + i);
+    sum += (double)(component - average) * (component - average);
+  }
+  *result = (float)sqrt(sum / (row_count - 1));
+  return 0;
+}
+
+/**
+ * @brief (float) lsSkewf without the per element overflow check
+ *
+ * @param vector containing all values
+ * @param average average of the given vector
+ * @param variance standard deviation of the given vector
+ * @param row_count the amount of contained values
+ * @param result skew of the given vector
+ * @return int error return code
+ */
+static int lsSkewUf(float *vector, float average, float variance,
+                    int row_count, float *result) {
+  double sum = 0;
+  for (int i = 0; i < row_count; i++) {
+    double standardized = (*(vector + i) - average) / variance;
+    sum += standardized * standardized * standardized;
+  }
+  *result = (float)(sum / row_count);
+  return 0;
+}
+
+/**
+ * @brief (float) Measures the distance of two values to 0.
+ *
+ * @param value0 first value
+ * @param value1 second value
+ * @param result 1 if the first value is further away from 0 then the second
+ * value, otherwise 0
+ * @return int error return code
+ */
+static int lsIsCloserToZerof(float value0, float value1, int *result) {
+  *result = fabsf(value0) > fabsf(value1);
+  return 0;
+}
+
+/**
+ * @brief (float) Calculates the skew of the given vector and compares if a
+ * given skew is closer to zero.
+ *
+ * @param vector    containing all values
+ * @param row_count amount of contained values
+ * @param skew  given skew
+ * @param result 1 if the new skew is closer to 0, 0 otherwise
+ * @return int error return code
+ */
+static int lsSkewIntervalStepf(float *vector, int row_count, float *skew,
+                               int *result) {
+  *result = 0;
+  float average;
+  int errnum = lsAveragef(vector, row_count, &average);
+  if (errnum != 0) {
+    return ERR_AVERAGE | errnum;
+  }
+  float sd;
+  errnum = lsVariancef(vector, average, row_count, &sd);
+  if (errnum != 0) {
+    return ERR_DEVIATION | errnum;
+  }
+  float new_skew;
+  errnum = lsSkewf(vector, average, sd, row_count, &new_skew);
+  if (errnum != 0) {
+    return ERR_SKEW | errnum;
+  }
+  int compare_flag;
+  errnum = lsIsCloserToZerof(*skew, new_skew, &compare_flag);
+  if (errnum != 0) {
+    return ERR_CLOSER_TO_ZERO | errnum;
+  }
+  if (compare_flag) {
+    *skew = new_skew;
+    *result = 1;
+  }
+  return 0;
+}
+
+/**
+ * @brief (float) lsSkewIntervalStepf for a column accepted by
+ * lsValidateColumnf, see lsSkewIntervalStepU
+ *
+ * @param vector    containing all values
+ * @param row_count amount of contained values
+ * @param bound largest absolute value of the vector
+ * @param skew  given skew
+ * @param result 1 if the new skew is closer to 0, 0 otherwise
+ * @return int error return code
+ */
+static int lsSkewIntervalStepUf(float *vector, int row_count, float bound,
+                                float *skew, int *result) {
+  *result = 0;
+  float average;
+  lsAverageUf(vector, row_count, &average);
+  float sd;
+  lsVarianceUf(vector, average, row_count, &sd);
+  float new_skew;
+  int errnum;
+  if (4 * bound <= cbrtf(g_maxHighFloat / row_count) * sd) {
+    errnum = lsSkewUf(vector, average, sd, row_count, &new_skew);
+  } else {
+    errnum = lsSkewf(vector, average, sd, row_count, &new_skew);
+  }
+  if (errnum != 0) {
+    return ERR_SKEW | errnum;
+  }
+  int compare_flag;
+  lsIsCloserToZerof(*skew, new_skew, &compare_flag);
+  if (compare_flag) {
+    *skew = new_skew;
+    *result = 1;
+  }
+  return 0;
+}
+
+/**
+ * @brief (float) decides once per column whether a search may use the
+ * unchecked functions, see lsPrepareColumn
+ *
+ * @param context boundary boxes of the search
+ * @param scratch scratch memory with room for row_count values
+ * @param vector column to be searched
+ * @param row_count amount of contained values
+ * @param lower_lambda lowest lambda the search may evaluate
+ * @param upper_lambda highest lambda the search may evaluate
+ * @param unchecked 1 if the unchecked path is safe, 0 otherwise
+ * @param bound largest absolute transformed value of the column
+ * @return int error return code
+ */
+static int lsPrepareColumnf(const yjContextf *context, lsScratchf *scratch,
+                            float *vector, int row_count, float lower_lambda,
+                            float upper_lambda, int *unchecked, float *bound) {
+  *unchecked = 0;
+  if (row_count <= 2) {
+    return 0;
+  }
+  int safe;
+  yjValidateColumnCtxf(context, vector, row_count, lower_lambda, upper_lambda,
+                       &safe, bound);
+  *unchecked = safe && *bound <= g_maxHighFloat / row_count &&
+               4 * *bound <= sqrtf(g_maxHighFloat / row_count);
+  if (*unchecked && scratch->cache_logs) {
+    yjLogCachef(vector, row_count, scratch->log_cache);
+  }
+  return 0;
+}
+
+/**
+ * @brief (float) transforms the column with one lambda and compares its skew,
+ * see lsEvaluateLambda
+ *
+ * @param context boundary boxes of the search
+ * @param scratch scratch memory prepared by lsPrepareColumnf
+ * @param vector column to be searched
+ * @param row_count amount of contained values
+ * @param lambda transformation parameter
+ * @param unchecked result of lsPrepareColumnf
+ * @param bound result of lsPrepareColumnf
+ * @param skew best skew so far
+ * @param skew_test_flag 1 if the skew of lambda is closer to 0
+ * @param errnum error mask of the column
+ * @return int 0, -2 on a transformation error, -3 on a skew error
+ */
+static int lsEvaluateLambdaf(const yjContextf *context, lsScratchf *scratch,
+                             float *vector, int row_count, float lambda,
+                             int unchecked, float bound, float *skew,
+                             int *skew_test_flag, int *errnum) {
+  float *zws = scratch->zws;
+  if (unchecked) {
+    if (scratch->cache_logs) {
+      yjTransformCachedf(vector, scratch->log_cache, row_count, lambda, zws);
+    } else {
+      for (int i = 0; i < row_count; i++) {
+        yjCalculationUf(*(vector + i), lambda, zws + i);
+      }
+    }
+    *errnum |=
+        lsSkewIntervalStepUf(zws, row_count, bound, skew, skew_test_flag);
+  } else {
+    for (int i = 0; i < row_count; i++) {
+      *errnum |= yjCalculationCtxf(context, *(vector + i), lambda, zws + i);
+      if (*errnum != 0) {
+        *errnum |= ERR_LAMBDA_SEARCH | ERR_ABORT_YEO_JOHNSON;
+        return -2;
+      }
+    }
+    *errnum |= lsSkewIntervalStepf(zws, row_count, skew, skew_test_flag);
+  }
+  if (*errnum != 0) {
+    *errnum |= ERR_LAMBDA_SEARCH | ERR_SKEW_TEST;
+    return -3;
+  }
+  return 0;
+}
+
+/**
+ * @brief (float) compares the skew of one lambda, given by the fused moments
+ * of yjMomentsCachedBatchf, with the best skew so far, see lsEvaluateMoments
+ *
+ * @param context boundary boxes of the search
+ * @param scratch scratch memory prepared by lsPrepareColumnf
+ * @param vector column to be searched
+ * @param row_count amount of contained values
+ * @param lambda transformation parameter
+ * @param bound result of lsPrepareColumnf
+ * @param scale factor the moments were accumulated with
+ * @param moments moments of the scaled transformed values of lambda
+ * @param skew best skew so far
+ * @param skew_test_flag 1 if the skew of lambda is closer to 0
+ * @param errnum error mask of the column
+ * @return int 0, -3 on a skew error
+ */
+static int lsEvaluateMomentsf(const yjContextf *context, lsScratchf *scratch,
+                              float *vector, int row_count, float lambda,
+                              float bound, double scale,
+                              const yjMoments *moments, float *skew,
+                              int *skew_test_flag, int *errnum) {
+  double sd = sqrt(moments->m2 / (row_count - 1));
+  if (!(sd > g_minFusedDeviationf * fabs(moments->mean)) ||
+      4 * bound > cbrtf(g_maxHighFloat / row_count) * (float)(sd / scale)) {
+    return lsEvaluateLambdaf(context, scratch, vector, row_count, lambda, 1,
+                             bound, skew, skew_test_flag, errnum);
+  }
+  float new_skew = (float)(moments->m3 / row_count / (sd * sd * sd));
+  lsIsCloserToZerof(*skew, new_skew, skew_test_flag);
+  if (*skew_test_flag) {
+    *skew = new_skew;
+  }
+  return 0;
+}
+
+/**
+ * @brief (float) evaluates the lambdas start + step * i, i = 0..steps, in
+ * order and keeps the one with the skew closest to 0, see lsScanLambdas
+ *
+ * @param context boundary boxes of the search
+ * @param scratch scratch memory prepared by lsPrepareColumnf
+ * @param vector column to be searched
+ * @param row_count amount of contained values
+ * @param start first lambda
+ * @param step distance of the lambdas
+ * @param steps index of the last lambda
+ * @param unchecked result of lsPrepareColumnf
+ * @param bound result of lsPrepareColumnf
+ * @param skew best skew so far
+ * @param result_lambda lambda of the best skew so far
+ * @param errnum error mask of the column
+ * @return int 0, -2 on a transformation error, -3 on a skew error
+ */
+static int lsScanLambdasf(const yjContextf *context, lsScratchf *scratch,
+                          float *vector, int row_count, float start,
+                          float step, int steps, int unchecked, float bound,
+                          float *skew, float *result_lambda, int *errnum) {
+  int fused = unchecked && scratch->cache_logs && bound >= FLT_MIN;
+  double scale = fused ? ldexp(1, -ilogb(bound)) : 1;
+  int batch = fused ? scratch->lambda_batch : 1;
+  float lambdas[YJ_MAX_LAMBDA_BATCH];
+  yjMoments moments[YJ_MAX_LAMBDA_BATCH];
+  for (int first = 0; first <= steps; first += batch) {
+    int count = steps + 1 - first < batch ? steps + 1 - first : batch;
+    for (int k = 0; k < count; k++) {
+      lambdas[k] = start + (step * (first + k));
+    }
+    if (fused) {
+      yjMomentsCachedBatchf(vector, scratch->log_cache, row_count, lambdas,
+                            count, scale, moments);
+    }
+    for (int k = 0; k < count; k++) {
+      int skew_test_flag;
+      int ret;
+      if (fused) {
+        ret = lsEvaluateMomentsf(context, scratch, vector, row_count,
+                                 lambdas[k], bound, scale, moments + k, skew,
+                                 &skew_test_flag, errnum);
+      } else {
+        ret = lsEvaluateLambdaf(context, scratch, vector, row_count,
+                                lambdas[k], unchecked, bound, skew,
+                                &skew_test_flag, errnum);
+      }
+      if (ret != 0) {
+        return ret;
+      }
+      if (skew_test_flag) {
+        *result_lambda = lambdas[k];
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief (double) calculates the bowley skewness of three given parameters
+ * 
+ * @param q1 first quantil
+ * @param q2 seconde quantil (median)
+ * @param q3 third quantil
+ * @param skew result variable for skewness
+ * @param result 1 if the new skew is closer to 0, 0 otherwise
+ * @return int error code
+ */
+static int lsBowleySkewnessStep(double q1, double q2, double q3, double  *skew, int *result) {
+  *result = 0;
+  if (q3-q1==0) {
+    return ERR_SKEW_BOWLEY;
+  }
+  double new_skew = (q3+q1-2*q2)/(q3-q1);
+  int compare_flag;
+  int errnum = lsIsCloserToZero(*skew, new_skew, &compare_flag);
+  if (errnum != 0) { // Vergleich mit vorheriger Schiefe
+    return ERR_CLOSER_TO_ZERO | errnum;
+  }
+  if (compare_flag) {
+    *skew = new_skew;
+    *result = 1;
+  }
+  return 0;
+}
+
+/**
+ * @brief sorts an array
+ * 
+ * @param vector array to be sorted
+ * @param size size of the array
+ * @return int error code
+ */
+// static int lsSortVector(double *vector, int size) {
+//     double sort_arr[2][size];
+//     int pointer_arr = 0;
+//     memset(sort_arr[0], 0, size * sizeof(double));
+//     memset(sort_arr[1], 0, size * sizeof(double));
+
+//     for (int i = 0; i < size; i++) {
+//         int j = 0;
+//         int flag = 1;
+//         while ((j < i) && flag) {
+//             if (sort_arr[pointer_arr][j] <= vector[i]) {
+//                 j++;
+//             } else {
+//                 for (int k = 0; k < j; k++) {
+//                     sort_arr[getFlipped(pointer_arr)][k] = sort_arr[pointer_arr][k];
+//                 }
+//                 sort_arr[getFlipped(pointer_arr)][j] = vector[i];
+//                 for (int k = j; k < i; k++) {
+//                     sort_arr[getFlipped(pointer_arr)][k+1] = sort_arr[pointer_arr][k];
+//                 }
+//                 pointer_arr = getFlipped(pointer_arr);
+//                 flag = 0;
+//             }
+//         }
+//         if (j == i) sort_arr[pointer_arr][i] = vector[i];
+//     }
+//     for (int i = 0; i < size; i++) {
+//         vector[i] = sort_arr[pointer_arr][i];
+//     }
+//     return 0;
+// }
+
+/**
+ * @brief restores the max heap property below index root
+ *
+ * @param vector heap
+ * @param root index to sift down
+ * @param size amount of entries of the heap
+ */
+static void lsSiftDown(double *vector, int root, int size) {
+  double value = vector[root];
+  int child;
+  while ((child = 2 * root + 1) < size) {
+    if (child + 1 < size && vector[child + 1] > vector[child]) {
+      child++;
+    }
+    if (!(vector[child] > value)) {
+      break;
+    }
+    vector[root] = vector[child];
+    root = child;
+  }
+  vector[root] = value;
+}
+
+/**
+ * @brief sorts an array in O(n log n) without recursion, the fallback of
+ * lsSelectRanks
+ *
+ * @param vector array to be sorted
+ * @param size size of the array
+ */
+static void lsHeapSort(double *vector, int size) {
+  for (int i = size / 2 - 1; i >= 0; i--) {
+    lsSiftDown(vector, i, size);
+  }
+  for (int i = size - 1; i > 0; i--) {
+    double save = vector[0];
+    vector[0] = vector[i];
+    vector[i] = save;
+    lsSiftDown(vector, 0, i);
+  }
+}
+
+/**
+ * @brief introselect for several ranks at once: afterwards vector[rank] holds
+ * the value it would hold in the sorted array, for every rank in ranks. Each
+ * step partitions [left, right] three ways around the median of three values,
+ * so ties end up in the middle part and no longer cost a step each; sorted
+ * input picks the exact median. Ranks on both sides are handled by one
+ * recursion per side. Ranges that need more than depth steps are heap sorted,
+ * so the worst case is O(n log n) and the stack depth O(log n).
+ *
+ * @param vector array to be reordered
+ * @param left first index of the range
+ * @param right last index of the range
+ * @param ranks ascending ranks inside [left, right]
+ * @param rank_count amount of ranks
+ * @param depth remaining partition steps
+ */
+static void lsSelectRanks(double *vector, int left, int right,
+                          const int *ranks, int rank_count, int depth) {
+  while (rank_count > 0 && left < right) {
+    if (depth-- == 0) {
+      lsHeapSort(vector + left, right - left + 1);
+      return;
+    }
+    double a = vector[left];
+    double b = vector[left + (right - left) / 2];
+    double c = vector[right];
+    double pivot = a < b ? (b < c ? b : (a < c ? c : a))
+                         : (a < c ? a : (b < c ? c : b));
+    // [left, lower) < pivot, [lower, i) == pivot, (upper, right] > pivot
+    int lower = left;
+    int upper = right;
+    int i = left;
+    while (i <= upper) {
+      double value = vector[i];
+      if (value < pivot) {
+        vector[i++] = vector[lower];
+        vector[lower++] = value;
+      } else if (value > pivot) {
+        vector[i] = vector[upper];
+        vector[upper--] = value;
+      } else {
+        i++;
+      }
+    }
+    int below = 0;
+    while (below < rank_count && ranks[below] < lower) {
+      below++;
+    }
+    int above = below;
+    while (above < rank_count && ranks[above] <= upper) {
+      above++;
+    }
+    // recurse into the side with fewer ranks, loop on the other
+    if (below < rank_count - above) {
+      lsSelectRanks(vector, left, lower - 1, ranks, below, depth);
+      left = upper + 1;
+      ranks += above;
+      rank_count -= above;
+    } else {
+      lsSelectRanks(vector, upper + 1, right, ranks + above,
+                    rank_count - above, depth);
+      right = lower - 1;
+      rank_count = below;
+    }
+  }
+}
+
+/**
+ * @brief gets the first, second and third quantil from a vector with a specific size
+ * by selection instead of sorting
+ * 
+ * @param vector set of data, reordered
+ * @param size amount of entries
+ * @param q1 first quantil
+ * @param q2 second quantil (median)
+ * @param q3 third quantil
+ * @return int error code
+ */
+static int lsGetQuantils(double *vector, int size, double *q1, double *q2, double *q3) {
+  if (size < 4) {
+    return ERR_NOT_ENOUGH_ROWS;
+  }
+  // ranks of the first quarter, both halves of the median and the last quarter
+  int ranks[4] = {size / 4 - 1, size / 2 - 1, size / 2, size - size / 4};
+  int depth = 2;
+  for (int n = size; n > 1; n /= 2) {
+    depth += 2;
+  }
+  lsSelectRanks(vector, 0, size - 1, ranks, 4, depth);
+  *q1 = vector[ranks[0]];
+  *q2 = (vector[ranks[1]] + vector[ranks[2]]) / 2;
+  *q3 = vector[ranks[3]];
+  return 0;
+}
+
+/**
+ * @brief clamps a lambda batch size to [1, YJ_MAX_LAMBDA_BATCH]
+ *
+ * @param lambda_batch requested lambdas per sweep
+ * @return int batch size to use
+ */
+static int lsClampLambdaBatch(int lambda_batch) {
+  if (lambda_batch < 1) {
+    return 1;
+  }
+  if (lambda_batch > YJ_MAX_LAMBDA_BATCH) {
+    return YJ_MAX_LAMBDA_BATCH;
+  }
+  return lambda_batch;
+}
+/*****************************************************************************
+ *                           PUBLIC FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * @brief (double) prepares empty scratch memory for the searches
+ *
+ * @param scratch scratch memory, owned by the caller
+ * @param cache_logs 1 to evaluate validated columns from cached logarithms
+ */
+void lsScratchInit(lsScratch *scratch, int cache_logs) {
+  scratch->zws = NULL;
+  scratch->log_cache = NULL;
+  scratch->capacity = 0;
+  scratch->cache_logs = cache_logs;
+  scratch->row_parts = 1;
+  scratch->lambda_batch = LS_DEFAULT_LAMBDA_BATCH;
+  scratch->scale = 0;
+  scratch->stats.valid = 0;
+}
+
+/**
+ * @brief (double) grows the scratch memory to at least row_count values, keeps
+ * it if it is already large enough; forgets the stats of the previous column
+ *
+ * @param scratch scratch memory of lsScratchInit
+ * @param row_count amount of values of the next column
+ * @return int error return code
+ */
+int lsScratchReserve(lsScratch *scratch, int row_count) {
+  scratch->scale = 0;
+  scratch->stats.valid = 0;
+  if (row_count <= scratch->capacity) {
+    return 0;
+  }
+  double *zws = (double *)realloc(scratch->zws, sizeof(double) * row_count);
+  if (zws == NULL) {
+    return ERR_FAILED_ALLOCATE_MEMORY;
+  }
+  scratch->zws = zws;
+  double *log_cache =
+      (double *)realloc(scratch->log_cache, sizeof(double) * row_count);
+  if (log_cache == NULL) {
+    return ERR_FAILED_ALLOCATE_MEMORY;
+  }
+  scratch->log_cache = log_cache;
+  scratch->capacity = row_count;
+  return 0;
+}
+
+/**
+ * @brief (double) releases the scratch memory
+ *
+ * @param scratch scratch memory of lsScratchInit
+ */
+void lsScratchFree(lsScratch *scratch) {
+  int row_parts = scratch->row_parts;
+  int lambda_batch = scratch->lambda_batch;
+  free(scratch->zws);
+  free(scratch->log_cache);
+  lsScratchInit(scratch, scratch->cache_logs);
+  scratch->row_parts = row_parts;
+  scratch->lambda_batch = lambda_batch;
+}
+
+/**
+ * @brief (double) splits the log cache and the fused sweeps over a column
+ * into row_parts row blocks that run on the thread pool (tpRun), for columns
+ * too few to keep the pool busy. Has no effect inside a part of a pool job,
+ * the blocks then run one after another.
+ *
+ * @param scratch scratch memory of lsScratchInit
+ * @param row_parts row blocks, clamped to [1, LS_MAX_ROW_PARTS]
+ * @return int row blocks in use afterwards
+ */
+int lsScratchSetRowParts(lsScratch *scratch, int row_parts) {
+  if (row_parts < 1) {
+    row_parts = 1;
+  }
+  if (row_parts > LS_MAX_ROW_PARTS) {
+    row_parts = LS_MAX_ROW_PARTS;
+  }
+  scratch->row_parts = row_parts;
+  return row_parts;
+}
+
+/**
+ * @brief (double) sets how many lambdas the searches on this scratch memory
+ * evaluate per sweep over a validated column; larger batches read tall
+ * columns from memory less often, 1 evaluates one lambda at a time. Results
+ * do not depend on the batch size. Kept by lsScratchFree.
+ *
+ * @param scratch scratch memory of lsScratchInit
+ * @param lambda_batch lambdas per sweep, clamped to [1, YJ_MAX_LAMBDA_BATCH]
+ * @return int batch size in use afterwards
+ */
+int lsScratchSetLambdaBatch(lsScratch *scratch, int lambda_batch) {
+  scratch->lambda_batch = lsClampLambdaBatch(lambda_batch);
+  return scratch->lambda_batch;
+}
+
+/**
+ * @brief (double) mean and standard deviation (n - 1) of the column
+ * transformed with lambda, from the fused moments of the last search on the
+ * scratch memory. Searches keep them for their best lambda; any other lambda
+ * costs one sweep over the log cache, which writes nothing.
+ *
+ * @param scratch scratch memory of the last search of the column
+ * @param vector column of the last search
+ * @param row_count amount of contained values
+ * @param lambda transformation parameter, usually the search result
+ * @param mean receives the mean of the transformed column
+ * @param sd receives the standard deviation of the transformed column
+ * @return int 0, -1 if the search did not fuse the moments of the column or
+ * the column is nearly constant (standardize it from its values instead)
+ */
+int lsScratchStats(lsScratch *scratch, double *vector, int row_count,
+                   double lambda, double *mean, double *sd) {
+  if (!scratch->stats.valid || scratch->stats.lambda != lambda) {
+    if (scratch->scale == 0 || row_count <= 2) {
+      return -1;
+    }
+    yjMoments moments;
+    lsMoments(scratch, vector, row_count, &lambda, 1, scratch->scale,
+              &moments);
+    double deviation = sqrt(moments.m2 / (row_count - 1));
+    if (!(deviation > g_minFusedDeviation * fabs(moments.mean))) {
+      return -1;
+    }
+    scratch->stats.lambda = lambda;
+    scratch->stats.mean = moments.mean / scratch->scale;
+    scratch->stats.sd = deviation / scratch->scale;
+    scratch->stats.valid = 1;
+  }
+  *mean = scratch->stats.mean;
+  *sd = scratch->stats.sd;
+  return 0;
+}
+
+/**
+ * @brief (double) Searching a lambda resulting in the skew closest to zero,
+ * with caller owned scratch memory.
+ *
+ * @param context boundary boxes of this search (see buildBoundaryBoxCtx)
+ * @param scratch scratch memory, reused across columns (see lsScratchInit)
+ * @param vector containing all values
+ * @param interval_start start value of the search
+ * @param interval_end end value of the search
+ * @param interval_step steps inside the interval
+ * @param row_count amount of contained values
+ * @param result_lambda lambda resulting in the skew closest to zero
+ * @param result_skew skew which can be achieved with result_lambda
+ * @return int error return code
+ */
+int lsLambdaSearchScratch(const yjContext *context, lsScratch *scratch,
+                          double *vector, double interval_start,
+                          double interval_end, double interval_step,
+                          int row_count, double *result_lambda,
+                          double *result_skew, int *errnum) {
+  *result_skew = g_maxHighDouble;
+  if (lsScratchReserve(scratch, row_count) != 0) {
+    *errnum |= ERR_LAMBDA_SEARCH |
+               ERR_FAILED_ALLOCATE_MEMORY; // memory allocation error
+    // printf("\tFailed to allocate memory.\n");
+    return -1;
+  }
+  if (row_count > 0) { // zws is NULL for an empty column
+    memset(scratch->zws, 0,
+           sizeof(double) * row_count); // is unsecure -> does not matter
+                                        // is overwritten in yjCalculation
+  }
+  *result_lambda = interval_start;
+  int steps = ceil((interval_end - interval_start) / interval_step);
+  double last_lambda = interval_start + interval_step * steps;
+  int unchecked;
+  double bound;
+  lsPrepareColumn(context, scratch, vector, row_count,
+                  fmin(interval_start, last_lambda),
+                  fmax(interval_start, last_lambda), &unchecked, &bound);
+  return lsScanLambdas(context, scratch, vector, row_count, interval_start,
+                       interval_step, steps, unchecked, bound, result_skew,
+                       result_lambda, errnum);
+}
+
+/**
+ * @brief (double) Searching a lambda resulting in the skew closest to zero.
+ *
+ * @param context boundary boxes of this search (see buildBoundaryBoxCtx)
+ * @param vector containing all values
+ * @param interval_start start value of the search
+ * @param interval_end end value of the search
+ * @param interval_step steps inside the interval
+ * @param row_count amount of contained values
+ * @param result_lambda lambda resulting in the skew closest to zero
+ * @param result_skew skew which can be achieved with result_lambda
+ * @return int error return code
+ */
+int lsLambdaSearchCtx(const yjContext *context, double *vector,
+                      double interval_start, double interval_end,
+                      double interval_step, int row_count,
+                      double *result_lambda, double *result_skew,
+                      int *errnum) {
+  lsScratch scratch;
+  lsScratchInit(&scratch, 1);
+  int ret = lsLambdaSearchScratch(context, &scratch, vector, interval_start,
+                                  interval_end, interval_step, row_count,
+                                  result_lambda, result_skew, errnum);
+  lsScratchFree(&scratch);
+  return ret;
+}
+
+/**
+ * @brief (double) Searching a lambda resulting in the skew closest to zero,
+ * boundary boxes are private to this call.
+ *
+ * @param vector containing all values
+ * @param interval_start start value of the search
+ * @param interval_end end value of the search
+ * @param interval_step steps inside the interval
+ * @param row_count amount of contained values
+ * @param result_lambda lambda resulting in the skew closest to zero
+ * @param result_skew skew which can be achieved with result_lambda
+ * @return int error return code
+ */
+int lsLambdaSearch(double *vector, double interval_start, double interval_end,
+                   double interval_step, int row_count, double *result_lambda,
+                   double *result_skew, int *errnum) {
+  yjContext context;
+  buildBoundaryBoxCtx(&context, interval_start, interval_end);
+  return lsLambdaSearchCtx(&context, vector, interval_start, interval_end,
+                           interval_step, row_count, result_lambda,
+                           result_skew, errnum);
+}
+
+/**
+ * @brief Searching a lambda resulting in the skew closest to zero by scanning
+ * with precision instead of incremental steps, with caller owned scratch
+ * memory
+ *
+ * @param context boundary boxes of this search (see buildBoundaryBoxCtx)
+ * @param scratch scratch memory, reused across columns (see lsScratchInit)
+ * @param vector input vector
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param precision scanning precision
+ * @param row_count row count of vector
+ * @param result_lambda lambda with skew closest to 0
+ * @param result_skew resulting skew with calculated lambda
+ * @return int error return code
+ */
+int lsSmartSearchScratch(const yjContext *context, lsScratch *scratch,
+                         double *vector, double interval_start,
+                         double interval_end, int precision, int row_count,
+                         double *result_lambda, double *result_skew,
+                         int *errnum) {
+  if (lsScratchReserve(scratch, row_count) != 0) {
+    *errnum |= ERR_LAMBDA_SEARCH | ERR_FAILED_ALLOCATE_MEMORY;
+    // printf("\tFailed to allocate memory.\n");
+    return -1;
+  }
+  double interval_step = 1;
+  // the refinement may leave [interval_start, interval_end] by less than
+  // 1 + 1/2 + 1/4 + ... on both sides, the first scan by one more step above
+  int unchecked;
+  double bound;
+  lsPrepareColumn(context, scratch, vector, row_count, interval_start - 2,
+                  interval_end + 3, &unchecked, &bound);
+  for (int s = 0; s <= precision; s++) {
+    if (row_count > 0) { // zws is NULL for an empty column
+      memset(scratch->zws, 0,
+             sizeof(double) * row_count); // not secure -> does not matter
+                                          // is overwritten yjCalculation
+    }
+    *result_lambda = interval_start;
+    *result_skew = g_maxHighDouble;
+    int steps = ceil((interval_end - interval_start) / interval_step);
+    int ret = lsScanLambdas(context, scratch, vector, row_count,
+                            interval_start, interval_step, steps, unchecked,
+                            bound, result_skew, result_lambda, errnum);
+    if (ret != 0) {
+      return ret;
+    }
+    interval_start = *result_lambda - interval_step;
+    interval_end = *result_lambda + interval_step;
+    interval_step /= 2;
+  }
+  *errnum = 0;
+  return 0;
+}
+
+/**
+ * @brief Searching a lambda resulting in the skew closest to zero by scanning
+ * with precision instead of incremental steps
+ *
+ * @param context boundary boxes of this search (see buildBoundaryBoxCtx)
+ * @param vector input vector
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param precision scanning precision
+ * @param row_count row count of vector
+ * @param result_lambda lambda with skew closest to 0
+ * @param result_skew resulting skew with calculated lambda
+ * @return int error return code
+ */
+int lsSmartSearchCtx(const yjContext *context, double *vector,
+                     double interval_start, double interval_end, int precision,
+                     int row_count, double *result_lambda, double *result_skew,
+                     int *errnum) {
+  lsScratch scratch;
+  lsScratchInit(&scratch, 1);
+  int ret = lsSmartSearchScratch(context, &scratch, vector, interval_start,
+                                 interval_end, precision, row_count,
+                                 result_lambda, result_skew, errnum);
+  lsScratchFree(&scratch);
+  return ret;
+}
+
+/**
+ * @brief Searching a lambda resulting in the skew closest to zero by scanning
+ * with precision instead of incremental steps, boundary boxes are private to
+ * this call.
+ *
+ * @param vector input vector
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param precision scanning precision
+ * @param row_count row count of vector
+ * @param result_lambda lambda with skew closest to 0
+ * @param result_skew resulting skew with calculated lambda
+ * @return int error return code
+ */
+int lsSmartSearch(double *vector, double interval_start, double interval_end,
+                  int precision, int row_count, double *result_lambda,
+                  double *result_skew, int *errnum) {
+  yjContext context;
+  buildBoundaryBoxCtx(&context, interval_start, interval_end);
+  return lsSmartSearchCtx(&context, vector, interval_start, interval_end,
+                          precision, row_count, result_lambda, result_skew,
+                          errnum);
+}
+
+/**
+ * @brief (double) Searching the lambda with a skew of zero by root finding
+ * instead of scanning, with caller owned scratch memory. The skews of the
+ * interval ends, and if they share a sign the skews of the lambdas in between
+ * with a distance of 1, bracket the first sign change, which Brent's method
+ * narrows down to tolerance. Without a sign change the smallest |skew| around
+ * the best of these lambdas is searched instead. Unlike lsSmartSearch the
+ * result stays inside [interval_start, interval_end].
+ *
+ * @param context boundary boxes of this search (see buildBoundaryBoxCtx)
+ * @param scratch scratch memory, reused across columns (see lsScratchInit)
+ * @param vector input vector
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param tolerance accuracy of the resulting lambda
+ * @param row_count row count of vector
+ * @param result_lambda lambda with skew closest to 0
+ * @param result_skew resulting skew with calculated lambda
+ * @return int error return code
+ */
+int lsBrentSearchScratch(const yjContext *context, lsScratch *scratch,
+                         double *vector, double interval_start,
+                         double interval_end, double tolerance, int row_count,
+                         double *result_lambda, double *result_skew,
+                         int *errnum) {
+  if (lsScratchReserve(scratch, row_count) != 0) {
+    *errnum |= ERR_LAMBDA_SEARCH | ERR_FAILED_ALLOCATE_MEMORY;
+    // printf("\tFailed to allocate memory.\n");
+    return -1;
+  }
+  lsColumn column;
+  lsColumnInit(&column, context, scratch, vector, row_count, interval_start,
+               interval_end);
+  int steps = ceil(interval_end - interval_start);
+  double lower = interval_start;
+  double lower_skew;
+  int ret = lsSkewOfLambda(&column, lower, &lower_skew, errnum);
+  if (ret != 0) {
+    return ret;
+  }
+  *result_lambda = lower;
+  *result_skew = lower_skew;
+  if (lower_skew == 0 || steps <= 0) {
+    return 0;
+  }
+  double upper = interval_end;
+  double upper_skew;
+  ret = lsSkewOfLambda(&column, upper, &upper_skew, errnum);
+  if (ret != 0) {
+    return ret;
+  }
+  // upper ends at the first lambda whose skew has the other sign
+  for (int i = 1;
+       i < steps && upper_skew != 0 && (upper_skew > 0) == (lower_skew > 0);
+       i++) {
+    if (fabs(lower_skew) < fabs(*result_skew)) {
+      *result_lambda = lower;
+      *result_skew = lower_skew;
+    }
+    double lambda = interval_start + i;
+    double skew;
+    ret = lsSkewOfLambda(&column, lambda, &skew, errnum);
+    if (ret != 0) {
+      return ret;
+    }
+    if ((skew > 0) == (lower_skew > 0) && skew != 0) {
+      lower = lambda;
+      lower_skew = skew;
+    } else {
+      upper = lambda;
+      upper_skew = skew;
+    }
+  }
+  if (fabs(lower_skew) < fabs(*result_skew)) {
+    *result_lambda = lower;
+    *result_skew = lower_skew;
+  }
+  if ((upper_skew > 0) != (lower_skew > 0) || upper_skew == 0) {
+    return lsBrentRoot(&column, lower, lower_skew, upper, upper_skew,
+                       tolerance, result_lambda, result_skew, errnum);
+  }
+  if (fabs(upper_skew) < fabs(*result_skew)) {
+    *result_lambda = upper;
+    *result_skew = upper_skew;
+  }
+  double best_lambda = *result_lambda;
+  double best_skew = *result_skew;
+  double abs_skew;
+  ret = lsBrentMinimum(&column, lsAbsSkewOfLambda,
+                       fmax(interval_start, best_lambda - 1),
+                       fmin(interval_end, best_lambda + 1), tolerance,
+                       result_lambda, &abs_skew, result_skew, errnum);
+  if (ret == 0 && fabs(best_skew) <= fabs(*result_skew)) {
+    // the minimum lies on one of the scanned lambdas, e.g. an interval end
+    *result_lambda = best_lambda;
+    *result_skew = best_skew;
+  }
+  return ret;
+}
+
+/**
+ * @brief (double) Searching the lambda with a skew of zero by root finding,
+ * see lsBrentSearchScratch
+ *
+ * @param context boundary boxes of this search (see buildBoundaryBoxCtx)
+ * @param vector input vector
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param tolerance accuracy of the resulting lambda
+ * @param row_count row count of vector
+ * @param result_lambda lambda with skew closest to 0
+ * @param result_skew resulting skew with calculated lambda
+ * @return int error return code
+ */
+int lsBrentSearchCtx(const yjContext *context, double *vector,
+                     double interval_start, double interval_end,
+                     double tolerance, int row_count, double *result_lambda,
+                     double *result_skew, int *errnum) {
+  lsScratch scratch;
+  lsScratchInit(&scratch, 1);
+  int ret = lsBrentSearchScratch(context, &scratch, vector, interval_start,
+                                 interval_end, tolerance, row_count,
+                                 result_lambda, result_skew, errnum);
+  lsScratchFree(&scratch);
+  return ret;
+}
+
+/**
+ * @brief (double) Searching the lambda with a skew of zero by root finding,
+ * boundary boxes are private to this call.
+ *
+ * @param vector input vector
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param tolerance accuracy of the resulting lambda
+ * @param row_count row count of vector
+ * @param result_lambda lambda with skew closest to 0
+ * @param result_skew resulting skew with calculated lambda
+ * @return int error return code
+ */
+int lsBrentSearch(double *vector, double interval_start, double interval_end,
+                  double tolerance, int row_count, double *result_lambda,
+                  double *result_skew, int *errnum) {
+  yjContext context;
+  buildBoundaryBoxCtx(&context, interval_start, interval_end);
+  return lsBrentSearchCtx(&context, vector, interval_start, interval_end,
+                          tolerance, row_count, result_lambda, result_skew,
+                          errnum);
+}
+
+/**
+ * @brief (double) Searching the lambda of maximum likelihood, the objective
+ * of sklearn.preprocessing.PowerTransformer and scipy.stats.yeojohnson, with
+ * caller owned scratch memory. The sum of sign(y) * log1p(|y|) is taken once
+ * per column, the variance of every lambda from the fused moments where the
+ * scans would use them. A bounded Brent minimization of the negative log
+ * likelihood in [interval_start, interval_end] finds the lambda to tolerance,
+ * scipy uses 1.48e-8.
+ *
+ * @param context boundary boxes of this search (see buildBoundaryBoxCtx)
+ * @param scratch scratch memory, reused across columns (see lsScratchInit)
+ * @param vector input vector
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param tolerance accuracy of the resulting lambda
+ * @param row_count row count of vector
+ * @param result_lambda lambda of maximum likelihood
+ * @param result_skew skew of the column transformed with result_lambda
+ * @return int error return code
+ */
+int lsMleSearchScratch(const yjContext *context, lsScratch *scratch,
+                       double *vector, double interval_start,
+                       double interval_end, double tolerance, int row_count,
+                       double *result_lambda, double *result_skew,
+                       int *errnum) {
+  if (lsScratchReserve(scratch, row_count) != 0) {
+    *errnum |= ERR_LAMBDA_SEARCH | ERR_FAILED_ALLOCATE_MEMORY;
+    // printf("\tFailed to allocate memory.\n");
+    return -1;
+  }
+  lsColumn column;
+  lsColumnInit(&column, context, scratch, vector, row_count, interval_start,
+               interval_end);
+  // lsPrepareColumn fills the log cache of the columns it accepts
+  yjSignedLogSum(vector,
+                 column.unchecked && scratch->cache_logs ? scratch->log_cache
+                                                         : NULL,
+                 row_count, &column.log_sum);
+  *result_lambda = interval_start;
+  *result_skew = g_maxHighDouble;
+  double log_likelihood;
+  return lsBrentMinimum(&column, lsNegLogLikelihood, interval_start,
+                        interval_end, tolerance, result_lambda,
+                        &log_likelihood, result_skew, errnum);
+}
+
+/**
+ * @brief (double) Searching the lambda of maximum likelihood, see
+ * lsMleSearchScratch
+ *
+ * @param context boundary boxes of this search (see buildBoundaryBoxCtx)
+ * @param vector input vector
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param tolerance accuracy of the resulting lambda
+ * @param row_count row count of vector
+ * @param result_lambda lambda of maximum likelihood
+ * @param result_skew skew of the column transformed with result_lambda
+ * @return int error return code
+ */
+int lsMleSearchCtx(const yjContext *context, double *vector,
+                   double interval_start, double interval_end,
+                   double tolerance, int row_count, double *result_lambda,
+                   double *result_skew, int *errnum) {
+  lsScratch scratch;
+  lsScratchInit(&scratch, 1);
+  int ret = lsMleSearchScratch(context, &scratch, vector, interval_start,
+                               interval_end, tolerance, row_count,
+                               result_lambda, result_skew, errnum);
+  lsScratchFree(&scratch);
+  return ret;
+}
+
+/**
+ * @brief (double) Searching the lambda of maximum likelihood, boundary boxes
+ * are private to this call.
+ *
+ * @param vector input vector
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param tolerance accuracy of the resulting lambda
+ * @param row_count row count of vector
+ * @param result_lambda lambda of maximum likelihood
+ * @param result_skew skew of the column transformed with result_lambda
+ * @return int error return code
+ */
+int lsMleSearch(double *vector, double interval_start, double interval_end,
+                double tolerance, int row_count, double *result_lambda,
+                double *result_skew, int *errnum) {
+  yjContext context;
+  buildBoundaryBoxCtx(&context, interval_start, interval_end);
+  return lsMleSearchCtx(&context, vector, interval_start, interval_end,
+                        tolerance, row_count, result_lambda, result_skew,
+                        errnum);
+}
+
+/**
+ * @brief Searching a lambda resulting in the Bowley skew closest to zero by
+ * scanning with precision, with caller owned scratch memory. The quartiles
+ * are selected once from a copy of the column in the scratch memory, the
+ * column itself is left untouched.
+ *
+ * @param context boundary boxes of this search (see buildBoundaryBoxCtx)
+ * @param scratch scratch memory, reused across columns (see lsScratchInit)
+ * @param vector input vector
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param precision scanning precision
+ * @param row_count row count of vector
+ * @param result_lambda lambda with Bowley skew closest to 0
+ * @param result_skew resulting Bowley skew with calculated lambda
+ * @return int error return code
+ */
+int lsSmartBowleySearchScratch(const yjContext *context, lsScratch *scratch,
+                               double *vector, double interval_start,
+                               double interval_end, int precision,
+                               int row_count, double *result_lambda,
+                               double *result_skew, int *errnum) {
+  double q1, q2, q3;
+  double q1t, q2t, q3t;
+  double interval_step = 1;
+  if (lsScratchReserve(scratch, row_count) != 0) {
+    *errnum |= ERR_LAMBDA_SEARCH | ERR_FAILED_ALLOCATE_MEMORY;
+    // printf("\tFailed to allocate memory.\n");
+    return -1;
+  }
+  if (row_count > 0) {
+    memcpy(scratch->zws, vector, sizeof(double) * row_count);
+  }
+  *errnum |= lsGetQuantils(scratch->zws, row_count, &q1, &q2, &q3);
+  if (*errnum != 0) {
+    *errnum |= ERR_LAMBDA_SEARCH | ERR_SKEW_TEST;
+    return -3;
+  }
+  for (int s = 0; s <= precision; s++) {
+    *result_lambda = interval_start;
+    *result_skew = g_maxHighDouble;
+    int steps = ceil((interval_end - interval_start) / interval_step);
+    for (int i = 0; i <= steps; i++) {
+      double lambda_i = interval_start + (interval_step * i);
+      *errnum |= yjCalculationCtx(context, q1, lambda_i, &q1t);
+      if (*errnum != 0) {
+        *errnum |= ERR_LAMBDA_SEARCH | ERR_ABORT_YEO_JOHNSON;
+        return -2;
+      }
+      *errnum |= yjCalculationCtx(context, q2, lambda_i, &q2t);
+      if (*errnum != 0) {
+        *errnum |= ERR_LAMBDA_SEARCH | ERR_ABORT_YEO_JOHNSON;
+        return -2;
+      }
+      *errnum |= yjCalculationCtx(context, q3, lambda_i, &q3t);
+      if (*errnum != 0) {
+        *errnum |= ERR_LAMBDA_SEARCH | ERR_ABORT_YEO_JOHNSON;
+        return -2;
+      }
+      int skew_test_flag;
+      *errnum |=
+          lsBowleySkewnessStep(q1t, q2t, q3t, result_skew, &skew_test_flag);
+      if (*errnum != 0) {
+        *errnum |= ERR_LAMBDA_SEARCH | ERR_SKEW_TEST;
+        return -3;
+      }
+      if (skew_test_flag) {
+        *result_lambda = lambda_i;
+      }
+    }
+    interval_start = *result_lambda - interval_step;
+    interval_end = *result_lambda + interval_step;
+    interval_step /= 2;
+  }
+  return 0;
+}
+
+/**
+ * @brief Searching a lambda resulting in the Bowley skew closest to zero by
+ * scanning with precision, boundary boxes and scratch memory are private to
+ * this call.
+ *
+ * @param vector input vector, left untouched
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param precision scanning precision
+ * @param row_count row count of vector
+ * @param result_lambda lambda with Bowley skew closest to 0
+ * @param result_skew resulting Bowley skew with calculated lambda
+ * @return int error return code
+ */
+int lsSmartBowleySearch(double *vector, double interval_start, double interval_end,
+                        int precision, int row_count, double *result_lambda,
+                        double *result_skew, int *errnum) {
+  yjContext context;
+  buildBoundaryBoxCtx(&context, interval_start, interval_end);
+  lsScratch scratch;
+  lsScratchInit(&scratch, 0);
+  int ret = lsSmartBowleySearchScratch(&context, &scratch, vector,
+                                       interval_start, interval_end, precision,
+                                       row_count, result_lambda, result_skew,
+                                       errnum);
+  lsScratchFree(&scratch);
+  return ret;
+}
+
 /**
- * @brief sorts an array
- * 
- * @param vector array to be sorted
- * @param size size of the array
- * @return int error code
+ * @brief (float) prepares empty scratch memory for the searches
+ *
+ * @param scratch scratch memory, owned by the caller
+ * @param cache_logs 1 to evaluate validated columns from cached logarithms
  */
-// static int lsSortVector(double *vector, int size) {
-//     double sort_arr[2][size];
-//     int pointer_arr = 0;
-//     memset(sort_arr[0], 0, size * sizeof(double));
-//     memset(sort_arr[1], 0, size * sizeof(double));
-
-//     for (int i = 0; i < size; i++) {
-//         int j = 0;
-//         int flag = 1;
-//         while ((j < i) && flag) {
-//             if (sort_arr[pointer_arr][j] <= vector[i]) {
-//                 j++;
-//             } else {
-//                 for (int k = 0; k < j; k++) {
-//                     sort_arr[getFlipped(pointer_arr)][k] = sort_arr[pointer_arr][k];
-//                 }
-//                 sort_arr[getFlipped(pointer_arr)][j] = vector[i];
-//                 for (int k = j; k < i; k++) {
-//                     sort_arr[getFlipped(pointer_arr)][k+1] = sort_arr[pointer_arr][k];
-//                 }
-//                 pointer_arr = getFlipped(pointer_arr);
-//                 flag = 0;
-//             }
-//         }
-//         if (j == i) sort_arr[pointer_arr][i] = vector[i];
-//     }
-//     for (int i = 0; i < size; i++) {
-//         vector[i] = sort_arr[pointer_arr][i];
-//     }
-//     return 0;
-// }
-
-static int divide(double *vector, int left, int right) {
-  int i = left;
-  int j = right - 1;
-  double pivot = vector[right];
+void lsScratchInitf(lsScratchf *scratch, int cache_logs) {
+  scratch->zws = NULL;
+  scratch->log_cache = NULL;
+  scratch->capacity = 0;
+  scratch->cache_logs = cache_logs;
+  scratch->lambda_batch = LS_DEFAULT_LAMBDA_BATCH;
+}
 
-  while ( i < j ) {
-    while (i < j && vector[i] <= pivot) i++;
-    while (j > i && vector[j] > pivot) j--;
-    if (vector[i] > vector[j]) {
-      double save = vector[i];
-      vector[i] = vector[j];
-      vector[j] = save;
-    }
+/**
+ * @brief (float) grows the scratch memory to at least row_count values, keeps
+ * it if it is already large enough
+ *
+ * @param scratch scratch memory of lsScratchInitf
+ * @param row_count amount of values of the next column
+ * @return int error return code
+ */
+int lsScratchReservef(lsScratchf *scratch, int row_count) {
+  if (row_count <= scratch->capacity) {
+    return 0;
   }
-
-  if (vector[i] > pivot) {
-    double save = vector[i];
-    vector[i] = vector[right];
-    vector[right] = save;
-  } else {
-    i = right;
+  float *zws = (float *)realloc(scratch->zws, sizeof(float) * row_count);
+  if (zws == NULL) {
+    return ERR_FAILED_ALLOCATE_MEMORY;
   }
-  return i;
-}
-
-static void quickSort(double *vector, int left, int right) {
-  if (left < right) {
-    int divider = divide(vector, left, right);
-    quickSort(vector, left, divider-1);
-    quickSort(vector, divider+1, right);
+  scratch->zws = zws;
+  float *log_cache =
+      (float *)realloc(scratch->log_cache, sizeof(float) * row_count);
+  if (log_cache == NULL) {
+    return ERR_FAILED_ALLOCATE_MEMORY;
   }
+  scratch->log_cache = log_cache;
+  scratch->capacity = row_count;
+  return 0;
 }
 
-static int lsQuickSortVector(double *vector, int size) {
-  quickSort(vector, 0, size-1);
-  return 0;
+/**
+ * @brief (float) releases the scratch memory
+ *
+ * @param scratch scratch memory of lsScratchInitf
+ */
+void lsScratchFreef(lsScratchf *scratch) {
+  int lambda_batch = scratch->lambda_batch;
+  free(scratch->zws);
+  free(scratch->log_cache);
+  lsScratchInitf(scratch, scratch->cache_logs);
+  scratch->lambda_batch = lambda_batch;
 }
 
 /**
- * @brief gets the first, second and third quantil from a vector with a specific size
- * 
- * @param vector set of data (sorted)
- * @param size amount of entries
- * @param q1 first quantil
- * @param q2 second quantil (median)
- * @param q3 third quantil
- * @return int error code
+ * @brief (float) sets how many lambdas the searches on this scratch memory
+ * evaluate per sweep over a validated column (see lsScratchSetLambdaBatch)
+ *
+ * @param scratch scratch memory of lsScratchInitf
+ * @param lambda_batch lambdas per sweep, clamped to [1, YJ_MAX_LAMBDA_BATCH]
+ * @return int batch size in use afterwards
  */
-static int lsGetQuantils(double *vector, int size, double *q1, double *q2, double *q3) {
-  double middle = size/2+0.5-1;
-  double first_quarter = size/4-1;
-  double last_quarter = size-first_quarter-1;
-  // Getting median
-  if (fmod(middle, 1)==0) {
-    int pos = middle;
-    *q2 = vector[pos];
-  } else {
-    int pos = middle-0.5;
-    *q2 = (vector[pos] + vector[pos + 1])/2;
-  }
-  // Getting first quantil
-  double leftover = fmod(first_quarter, 1);
-  int pos = first_quarter-leftover;
-  *q1 = vector[pos] * (1-leftover) + vector[pos + 1] * leftover;
-  // Getting last quantil
-  leftover = fmod(first_quarter, 1);
-  pos = last_quarter-leftover;
-  *q3 = vector[pos] * (1-leftover) + vector[pos + 1] * leftover;
-  return 0;
+int lsScratchSetLambdaBatchf(lsScratchf *scratch, int lambda_batch) {
+  scratch->lambda_batch = lsClampLambdaBatch(lambda_batch);
+  return scratch->lambda_batch;
 }
-/*****************************************************************************
- *                           PUBLIC FUNCTIONS
- *****************************************************************************/
 
 /**
- * @brief (double) Searching a lambda resulting in the skew closest to zero.
+ * @brief (float) Searching a lambda resulting in the skew closest to zero,
+ * with caller owned scratch memory.
  *
+ * @param context boundary boxes of this search (see buildBoundaryBoxCtxf)
+ * @param scratch scratch memory, reused across columns (see lsScratchInitf)
  * @param vector containing all values
  * @param interval_start start value of the search
  * @param interval_end end value of the search
@@ -377,54 +2406,93 @@ static int lsGetQuantils(double *vector, int size, double *q1, double *q2, doubl
  * @param result_skew skew which can be achieved with result_lambda
  * @return int error return code
  */
-int lsLambdaSearch(double *vector, double interval_start, double interval_end,
-                   double interval_step, int row_count, double *result_lambda,
-                   double *result_skew, int *errnum) {
-  *result_skew = g_maxHighDouble;
-  double *zws = (double *)malloc(sizeof(double) * row_count);
-  if (zws == NULL) {
+int lsLambdaSearchScratchf(const yjContextf *context, lsScratchf *scratch,
+                          float *vector, float interval_start,
+                          float interval_end, float interval_step,
+                          int row_count, float *result_lambda,
+                          float *result_skew, int *errnum) {
+  *result_skew = g_maxHighFloat;
+  if (lsScratchReservef(scratch, row_count) != 0) {
     *errnum |= ERR_LAMBDA_SEARCH |
                ERR_FAILED_ALLOCATE_MEMORY; // memory allocation error
     // printf("\tFailed to allocate memory.\n");
     return -1;
   }
-  memset(zws, 0, sizeof(double) * row_count); // is unsecure -> does not matter
-                                              // is overwritten in yjCalculation
-  *result_lambda = interval_start;
-  buildBoundaryBox(interval_start, interval_end);
-  int steps = ceil((interval_end - interval_start) / interval_step);
-  for (int i = 0; i <= steps; i++) {
-    double lambda_i = interval_start + (interval_step * i);
-    for (int i = 0; i < row_count; i++) {
-      *errnum |= yjCalculation(*(vector + i), lambda_i, zws + i);
-      if (*errnum != 0) {
-        *errnum |= ERR_LAMBDA_SEARCH | ERR_ABORT_YEO_JOHNSON;
-        // printf("\texception occured during yeoJohnson\n");
-        free(zws);
-        return -2;
-      }
-    }
-    int skew_test_flag;
-    *errnum |=
-        lsSkewIntervalStep(zws, row_count, &(*result_skew), &skew_test_flag);
-    if (*errnum != 0) {
-      *errnum |= ERR_LAMBDA_SEARCH | ERR_SKEW_TEST;
-      // printf("\texception occured during skewTest\n");
-      free(zws);
-      return -3;
-    }
-    if (skew_test_flag) {
-      *result_lambda = lambda_i;
-    }
+  if (row_count > 0) { // zws is NULL for an empty column
+    memset(scratch->zws, 0,
+           sizeof(float) * row_count); // is unsecure -> does not matter
+                                       // is overwritten in yjCalculation
   }
-  free(zws);
-  return 0;
+  *result_lambda = interval_start;
+  int steps = ceilf((interval_end - interval_start) / interval_step);
+  float last_lambda = interval_start + interval_step * steps;
+  int unchecked;
+  float bound;
+  lsPrepareColumnf(context, scratch, vector, row_count,
+                  fminf(interval_start, last_lambda),
+                  fmaxf(interval_start, last_lambda), &unchecked, &bound);
+  return lsScanLambdasf(context, scratch, vector, row_count, interval_start,
+                        interval_step, steps, unchecked, bound, result_skew,
+                        result_lambda, errnum);
 }
 
 /**
- * @brief Searching a lambda resulting in the skew closest to zero by scanning
- * with precision instead of incremental steps
+ * @brief (float) Searching a lambda resulting in the skew closest to zero.
+ *
+ * @param context boundary boxes of this search (see buildBoundaryBoxCtxf)
+ * @param vector containing all values
+ * @param interval_start start value of the search
+ * @param interval_end end value of the search
+ * @param interval_step steps inside the interval
+ * @param row_count amount of contained values
+ * @param result_lambda lambda resulting in the skew closest to zero
+ * @param result_skew skew which can be achieved with result_lambda
+ * @return int error return code
+ */
+int lsLambdaSearchCtxf(const yjContextf *context, float *vector,
+                      float interval_start, float interval_end,
+                      float interval_step, int row_count,
+                      float *result_lambda, float *result_skew,
+                      int *errnum) {
+  lsScratchf scratch;
+  lsScratchInitf(&scratch, 1);
+  int ret = lsLambdaSearchScratchf(context, &scratch, vector, interval_start,
+                                  interval_end, interval_step, row_count,
+                                  result_lambda, result_skew, errnum);
+  lsScratchFreef(&scratch);
+  return ret;
+}
+
+/**
+ * @brief (float) Searching a lambda resulting in the skew closest to zero,
+ * boundary boxes are private to this call.
+ *
+ * @param vector containing all values
+ * @param interval_start start value of the search
+ * @param interval_end end value of the search
+ * @param interval_step steps inside the interval
+ * @param row_count amount of contained values
+ * @param result_lambda lambda resulting in the skew closest to zero
+ * @param result_skew skew which can be achieved with result_lambda
+ * @return int error return code
+ */
+int lsLambdaSearchf(float *vector, float interval_start, float interval_end,
+                   float interval_step, int row_count, float *result_lambda,
+                   float *result_skew, int *errnum) {
+  yjContextf context;
+  buildBoundaryBoxCtxf(&context, interval_start, interval_end);
+  return lsLambdaSearchCtxf(&context, vector, interval_start, interval_end,
+                           interval_step, row_count, result_lambda,
+                           result_skew, errnum);
+}
+
+/**
+ * @brief (float) Searching a lambda resulting in the skew closest to zero by scanning
+ * with precision instead of incremental steps, with caller owned scratch
+ * memory
  *
+ * @param context boundary boxes of this search (see buildBoundaryBoxCtxf)
+ * @param scratch scratch memory, reused across columns (see lsScratchInitf)
  * @param vector input vector
  * @param interval_start start of interval
  * @param interval_end end of interval
@@ -434,103 +2502,97 @@ int lsLambdaSearch(double *vector, double interval_start, double interval_end,
  * @param result_skew resulting skew with calculated lambda
  * @return int error return code
  */
-int lsSmartSearch(double *vector, double interval_start, double interval_end,
-                  int precision, int row_count, double *result_lambda,
-                  double *result_skew, int *errnum) {
-  double *zws = (double *)malloc(sizeof(double) * row_count);
-  if (zws == NULL) {
+int lsSmartSearchScratchf(const yjContextf *context, lsScratchf *scratch,
+                         float *vector, float interval_start,
+                         float interval_end, int precision, int row_count,
+                         float *result_lambda, float *result_skew,
+                         int *errnum) {
+  if (lsScratchReservef(scratch, row_count) != 0) {
     *errnum |= ERR_LAMBDA_SEARCH | ERR_FAILED_ALLOCATE_MEMORY;
     // printf("\tFailed to allocate memory.\n");
     return -1;
   }
-  buildBoundaryBox(interval_start, interval_end);
-  double interval_step = 1;
+  float interval_step = 1;
+  // the refinement may leave [interval_start, interval_end] by less than
+  // 1 + 1/2 + 1/4 + ... on both sides, the first scan by one more step above
+  int unchecked;
+  float bound;
+  lsPrepareColumnf(context, scratch, vector, row_count, interval_start - 2,
+                  interval_end + 3, &unchecked, &bound);
   for (int s = 0; s <= precision; s++) {
-    memset(zws, 0, sizeof(double) * row_count); // not secure -> does not matter
-                                                // is overwritten yjCalculation
+    if (row_count > 0) { // zws is NULL for an empty column
+      memset(scratch->zws, 0,
+             sizeof(float) * row_count); // not secure -> does not matter
+                                         // is overwritten yjCalculation
+    }
     *result_lambda = interval_start;
-    *result_skew = g_maxHighDouble;
-    int steps = ceil((interval_end - interval_start) / interval_step);
-    for (int i = 0; i <= steps; i++) {
-      double lambda_i = interval_start + (interval_step * i);
-      for (int i = 0; i < row_count; i++) {
-        *errnum |= yjCalculation(*(vector + i), lambda_i, zws + i);
-        if (*errnum != 0) {
-          *errnum |= ERR_LAMBDA_SEARCH | ERR_ABORT_YEO_JOHNSON;
-          // printf("\texception occured during yeoJohnson\n");
-          free(zws);
-          return -2;
-        }
-      }
-      int skew_test_flag;
-      *errnum |=
-          lsSkewIntervalStep(zws, row_count, &(*result_skew), &skew_test_flag);
-      if (*errnum != 0) {
-        *errnum |= ERR_LAMBDA_SEARCH | ERR_SKEW_TEST;
-        // printf("\texception occured during skewTest\n");
-        free(zws);
-        return -3;
-      }
-      if (skew_test_flag) {
-        *result_lambda = lambda_i;
-      }
+    *result_skew = g_maxHighFloat;
+    int steps = ceilf((interval_end - interval_start) / interval_step);
+    int ret = lsScanLambdasf(context, scratch, vector, row_count,
+                             interval_start, interval_step, steps, unchecked,
+                             bound, result_skew, result_lambda, errnum);
+    if (ret != 0) {
+      return ret;
     }
     interval_start = *result_lambda - interval_step;
     interval_end = *result_lambda + interval_step;
     interval_step /= 2;
   }
-  free(zws);
   *errnum = 0;
   return 0;
 }
 
-int lsSmartBowleySearch(double *vector, double interval_start, double interval_end,
-                        int precision, int row_count, double *result_lambda,
-double *result_skew, int *errnum) {
-  double q1, q2, q3;
-  double q1t, q2t, q3t;
-  buildBoundaryBox(interval_start, interval_end);
-  double interval_step = 1;
-  lsQuickSortVector(vector, row_count);  // sort vector
-  lsGetQuantils(vector, row_count, &q1, &q2, &q3); // get q1, q2, q3   
-  for (int s = 0; s <= precision; s++) {
-    *result_lambda = interval_start;
-    *result_skew = g_maxHighDouble;
-    int steps = ceil((interval_end - interval_start) / interval_step);
-    for (int i = 0; i <= steps; i++) {
-      double lambda_i = interval_start + (interval_step * i);
-      *errnum |= yjCalculation(q1, lambda_i, &q1t);
-      if (*errnum != 0) {
-        *errnum |= ERR_LAMBDA_SEARCH | ERR_ABORT_YEO_JOHNSON;
-        return -2;
-      }
-      *errnum |= yjCalculation(q2, lambda_i, &q2t);
-      if (*errnum != 0) {
-        *errnum |= ERR_LAMBDA_SEARCH | ERR_ABORT_YEO_JOHNSON;
-        return -2;
-      }
-      *errnum |= yjCalculation(q3, lambda_i, &q3t);
-      if (*errnum != 0) {
-        *errnum |= ERR_LAMBDA_SEARCH | ERR_ABORT_YEO_JOHNSON;
-        return -2;
-      }
-      int skew_test_flag;
-      *errnum |=
-          lsBowleySkewnessStep(q1t, q2t, q3t, result_skew, &skew_test_flag);
-      if (*errnum != 0) {
-        *errnum |= ERR_LAMBDA_SEARCH | ERR_SKEW_TEST;
-        return -3;
-      }
-      if (skew_test_flag) {
-        *result_lambda = lambda_i;
-      }
-    }
-    interval_start = *result_lambda - interval_step;
-    interval_end = *result_lambda + interval_step;
-    interval_step /= 2;
-  }
-  return 0;        
+/**
+ * @brief (float) Searching a lambda resulting in the skew closest to zero by scanning
+ * with precision instead of incremental steps
+ *
+ * @param context boundary boxes of this search (see buildBoundaryBoxCtxf)
+ * @param vector input vector
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param precision scanning precision
+ * @param row_count row count of vector
+ * @param result_lambda lambda with skew closest to 0
+ * @param result_skew resulting skew with calculated lambda
+ * @return int error return code
+ */
+int lsSmartSearchCtxf(const yjContextf *context, float *vector,
+                     float interval_start, float interval_end, int precision,
+                     int row_count, float *result_lambda, float *result_skew,
+                     int *errnum) {
+  lsScratchf scratch;
+  lsScratchInitf(&scratch, 1);
+  int ret = lsSmartSearchScratchf(context, &scratch, vector, interval_start,
+                                 interval_end, precision, row_count,
+                                 result_lambda, result_skew, errnum);
+  lsScratchFreef(&scratch);
+  return ret;
+}
+
+/**
+ * @brief (float) Searching a lambda resulting in the skew closest to zero by scanning
+ * with precision instead of incremental steps, boundary boxes are private to
+ * this call.
+ *
+ * @param vector input vector
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param precision scanning precision
+ * @param row_count row count of vector
+ * @param result_lambda lambda with skew closest to 0
+ * @param result_skew resulting skew with calculated lambda
+ * @return int error return code
+ */
+int lsSmartSearchf(float *vector, float interval_start, float interval_end,
+                  int precision, int row_count, float *result_lambda,
+                  float *result_skew, int *errnum) {
+  yjContextf context;
+  buildBoundaryBoxCtxf(&context, interval_start, interval_end);
+  return lsSmartSearchCtxf(&context, vector, interval_start, interval_end,
+                          precision, row_count, result_lambda, result_skew,
+                          errnum);
 }
+
 /*****************************************************************************
  *                               TESTS
  *****************************************************************************/
@@ -541,11 +2603,11 @@ void test_lsAverage(void) {
   printf("Testing lsAverage in lambdaSearch.c\n");
   double result;
   double vector[4] = {g_maxHighDouble, 1, 2, 3};
-  assert_int_equals(lsAverage(NULL, 1, &result), -1,
+  assert_int_equals(lsAverage(NULL, 1, &result), ERR_VECTOR_IS_NULL,
                     "Error: vector is null, should abort");
-  assert_int_equals(lsAverage(vector, 0, &result), -2,
+  assert_int_equals(lsAverage(vector, 0, &result), ERR_NOT_ENOUGH_ROWS,
                     "Error: row_count is <=0, should abort");
-  assert_int_equals(lsAverage(vector, 4, &result), -3,
+  assert_int_equals(lsAverage(vector, 4, &result), ERR_VALUE_OVERFLOW,
                     "Error: first value is too big, should abort");
   vector[0] = 0;
   assert_int_equals(lsAverage(vector, 4, &result), 0, "Error: should execute");
@@ -557,11 +2619,11 @@ void test_lsAveragef(void) {
   printf("Testing lsAveragef in lambdaSearch.c\n");
   float result;
   float vector[4] = {g_maxHighFloat, 1, 2, 3};
-  assert_int_equals(lsAveragef(NULL, 1, &result), -1,
+  assert_int_equals(lsAveragef(NULL, 1, &result), ERR_VECTOR_IS_NULL,
                     "Error: vector is null, should abort");
-  assert_int_equals(lsAveragef(vector, 0, &result), -2,
+  assert_int_equals(lsAveragef(vector, 0, &result), ERR_NOT_ENOUGH_ROWS,
                     "Error: row_count is <=0, should abort");
-  assert_int_equals(lsAveragef(vector, 4, &result), -3,
+  assert_int_equals(lsAveragef(vector, 4, &result), ERR_VALUE_OVERFLOW,
                     "Error: first value is too big, should abort");
   vector[0] = 0;
   assert_int_equals(lsAveragef(vector, 4, &result), 0, "Error: should execute");
@@ -573,7 +2635,7 @@ void test_lsAverageU(void) {
   printf("Testing lsAverageU in lambdaSearch.c\n");
   double result;
   double vector[4] = {0, 1, 2, 3};
-  assert_int_equals(lsAverage(vector, 4, &result), 0, "Error: should execute");
+  assert_int_equals(lsAverageU(vector, 4, &result), 0, "Error: should execute");
   assert_double_equals(result, 1.5, "Error: result should be 1.5");
   printf("...done\n");
 }
@@ -582,7 +2644,7 @@ void test_lsAverageUf(void) {
   printf("Testing lsAverageUf in lambdaSearch.c\n");
   float result;
   float vector[4] = {0, 1, 2, 3};
-  assert_int_equals(lsAveragef(vector, 4, &result), 0, "Error: should execute");
+  assert_int_equals(lsAverageUf(vector, 4, &result), 0, "Error: should execute");
   assert_float_equals(result, 1.5, "Error: result should be 1.5");
   printf("...done\n");
 }
@@ -591,11 +2653,11 @@ void test_lsVariance(void) {
   printf("Testing lsVariance in lambdaSearch.c\n");
   double result;
   double vector[4] = {g_maxHighDouble, 1, 2, 3};
-  assert_int_equals(lsVariance(NULL, 1.5, 1, &result), -1,
+  assert_int_equals(lsVariance(NULL, 1.5, 1, &result), ERR_VECTOR_IS_NULL,
                     "Error: vector is null, should abort");
-  assert_int_equals(lsVariance(vector, 1.5, 1, &result), -2,
+  assert_int_equals(lsVariance(vector, 1.5, 1, &result), ERR_NOT_ENOUGH_ROWS,
                     "Error: row_count is <=1, should abort");
-  assert_int_equals(lsVariance(vector, 1.5, 4, &result), -3,
+  assert_int_equals(lsVariance(vector, 1.5, 4, &result), ERR_VALUE_OVERFLOW,
                     "Error: first value is too big, should abort");
   vector[0] = 0;
   assert_int_equals(lsVariance(vector, 1.5, 4, &result), 0,
@@ -609,11 +2671,11 @@ void test_lsVariancef(void) {
   printf("Testing lsVariancef in lambdaSearch.c\n");
   float result;
   float vector[4] = {g_maxHighFloat, 1, 2, 3};
-  assert_int_equals(lsVariancef(NULL, 1.5, 1, &result), -1,
+  assert_int_equals(lsVariancef(NULL, 1.5, 1, &result), ERR_VECTOR_IS_NULL,
                     "Error: vector is null, should abort");
-  assert_int_equals(lsVariancef(vector, 1.5, 1, &result), -2,
+  assert_int_equals(lsVariancef(vector, 1.5, 1, &result), ERR_NOT_ENOUGH_ROWS,
                     "Error: row_count is <=1, should abort");
-  assert_int_equals(lsVariancef(vector, 1.5, 4, &result), -3,
+  assert_int_equals(lsVariancef(vector, 1.5, 4, &result), ERR_VALUE_OVERFLOW,
                     "Error: first value is too big, should abort");
   vector[0] = 0;
   assert_int_equals(lsVariancef(vector, 1.5, 4, &result), 0,
@@ -627,7 +2689,7 @@ void test_lsVarianceU(void) {
   printf("Testing lsVarianceU in lambdaSearch.c\n");
   double result;
   double vector[4] = {0, 1, 2, 3};
-  assert_int_equals(lsVariance(vector, 1.5, 4, &result), 0,
+  assert_int_equals(lsVarianceU(vector, 1.5, 4, &result), 0,
                     "Error: should execute");
   assert_double_equals(result, sqrt((2.25 + 0.25 + 0.25 + 2.25) / 3),
                        "Error: result is not equal to expected");
@@ -638,7 +2700,7 @@ void test_lsVarianceUf(void) {
   printf("Testing lsVarianceUf in lambdaSearch.c\n");
   float result;
   float vector[4] = {0, 1, 2, 3};
-  assert_int_equals(lsVariancef(vector, 1.5, 4, &result), 0,
+  assert_int_equals(lsVarianceUf(vector, 1.5, 4, &result), 0,
                     "Error: should execute");
   assert_float_equals(result, sqrtf((2.25 + 0.25 + 0.25 + 2.25) / 3),
                       "Error: result is not equal to expected");
@@ -651,11 +2713,11 @@ void test_lsSkew(void) {
   double average = 1.5;
   double variance = sqrt((2.25 + 0.25 + 0.25 + 2.25) / 3);
   double vector[4] = {g_maxHighDouble, 1, 2, 3};
-  assert_int_equals(lsSkew(NULL, average, variance, 1, &result), -1,
+  assert_int_equals(lsSkew(NULL, average, variance, 1, &result), ERR_VECTOR_IS_NULL,
                     "Error: vector is null, should abort");
-  assert_int_equals(lsSkew(vector, average, variance, 1, &result), -2,
+  assert_int_equals(lsSkew(vector, average, variance, 1, &result), ERR_NOT_ENOUGH_ROWS,
                     "Error: row_count is <=1, should abort");
-  assert_int_equals(lsSkew(vector, average, variance, 4, &result), -3,
+  assert_int_equals(lsSkew(vector, average, variance, 4, &result), ERR_VALUE_OVERFLOW,
                     "Error: first value is too big, should abort");
   vector[0] = 0;
   assert_int_equals(lsSkew(vector, average, variance, 4, &result), 0,
@@ -681,11 +2743,11 @@ void test_lsSkewf(void) {
   float average = 1.5;
   float variance = sqrtf((2.25 + 0.25 + 0.25 + 2.25) / 3);
   float vector[4] = {g_maxHighFloat, 1, 2, 3};
-  assert_int_equals(lsSkewf(NULL, average, variance, 1, &result), -1,
+  assert_int_equals(lsSkewf(NULL, average, variance, 1, &result), ERR_VECTOR_IS_NULL,
                     "Error: vector is null, should abort");
-  assert_int_equals(lsSkewf(vector, average, variance, 1, &result), -2,
+  assert_int_equals(lsSkewf(vector, average, variance, 1, &result), ERR_NOT_ENOUGH_ROWS,
                     "Error: row_count is <=1, should abort");
-  assert_int_equals(lsSkewf(vector, average, variance, 4, &result), -3,
+  assert_int_equals(lsSkewf(vector, average, variance, 4, &result), ERR_VALUE_OVERFLOW,
                     "Error: first value is too big, should abort");
   vector[0] = 0;
   assert_int_equals(lsSkewf(vector, average, variance, 4, &result), 0,
@@ -712,7 +2774,7 @@ void test_lsSkewU(void) {
   double average = 1.5;
   double variance = sqrt((2.25 + 0.25 + 0.25 + 2.25) / 3);
   double vector[4] = {0, 1, 2, 3};
-  assert_int_equals(lsSkew(vector, average, variance, 4, &result), 0,
+  assert_int_equals(lsSkewU(vector, average, variance, 4, &result), 0,
                     "Error: should execute");
   double first_value = (0 - average) / variance * (0 - average) / variance *
                        (0 - average) / variance;
@@ -735,7 +2797,7 @@ void test_lsSkewUf(void) {
   float average = 1.5;
   float variance = sqrtf((2.25 + 0.25 + 0.25 + 2.25) / 3);
   float vector[4] = {0, 1, 2, 3};
-  assert_int_equals(lsSkewf(vector, average, variance, 4, &result), 0,
+  assert_int_equals(lsSkewUf(vector, average, variance, 4, &result), 0,
                     "Error: should execute");
   float first_value = (0 - average) / variance * (0 - average) / variance *
                       (0 - average) / variance;
@@ -785,11 +2847,11 @@ void test_lsSkewIntervalStep(void) {
   double vector[4] = {0, 1, 2, 3};
   double skew = 10;
   int result = 0;
-  assert_int_equals(lsSkewIntervalStep(vector, 0, &skew, &result), -1,
+  assert_int_equals(lsSkewIntervalStep(vector, 0, &skew, &result), ERR_AVERAGE | ERR_NOT_ENOUGH_ROWS,
                     "Error: should abort during lsAverage");
-  assert_int_equals(lsSkewIntervalStep(vector, 1, &skew, &result), -2,
+  assert_int_equals(lsSkewIntervalStep(vector, 1, &skew, &result), ERR_DEVIATION | ERR_NOT_ENOUGH_ROWS,
                     "Error: should abort during lsVariance");
-  assert_int_equals(lsSkewIntervalStep(vector, 2, &skew, &result), -3,
+  assert_int_equals(lsSkewIntervalStep(vector, 2, &skew, &result), ERR_SKEW | ERR_NOT_ENOUGH_ROWS,
                     "Error: should abort during lsSkew");
   // assert_int_equals(lsSkewIntervalStep(vector, 0, &skew, &result), -4,
   // "Error: should abort during lsIsCloserToZero"); // no error possible
@@ -805,11 +2867,11 @@ void test_lsSkewIntervalStepf(void) {
   float vector[4] = {0, 1, 2, 3};
   float skew = 10;
   int result = 0;
-  assert_int_equals(lsSkewIntervalStepf(vector, 0, &skew, &result), -1,
+  assert_int_equals(lsSkewIntervalStepf(vector, 0, &skew, &result), ERR_AVERAGE | ERR_NOT_ENOUGH_ROWS,
                     "Error: should abort during lsAveragef");
-  assert_int_equals(lsSkewIntervalStepf(vector, 1, &skew, &result), -2,
+  assert_int_equals(lsSkewIntervalStepf(vector, 1, &skew, &result), ERR_DEVIATION | ERR_NOT_ENOUGH_ROWS,
                     "Error: should abort during lsVariancef");
-  assert_int_equals(lsSkewIntervalStepf(vector, 2, &skew, &result), -3,
+  assert_int_equals(lsSkewIntervalStepf(vector, 2, &skew, &result), ERR_SKEW | ERR_NOT_ENOUGH_ROWS,
                     "Error: should abort during lsSkewf");
   // assert_int_equals(lsSkewIntervalStepf(vector, 0, &skew, &result), -4,
   // "Error: should abort during lsIsCloserToZerof"); // no error possible
@@ -825,7 +2887,7 @@ void test_lsSkewIntervalStepU(void) {
   double vector[4] = {0, 1, 2, 3};
   double skew = 10;
   int result = 0;
-  assert_int_equals(lsSkewIntervalStep(vector, 4, &skew, &result), 0,
+  assert_int_equals(lsSkewIntervalStepU(vector, 4, 3, &skew, &result), 0,
                     "Error: should execute");
   assert_double_equals(result, 1,
                        "Error: skew should be swapped and result should be 1");
@@ -837,7 +2899,7 @@ void test_lsSkewIntervalStepUf(void) {
   float vector[4] = {0, 1, 2, 3};
   float skew = 10;
   int result = 0;
-  assert_int_equals(lsSkewIntervalStepf(vector, 4, &skew, &result), 0,
+  assert_int_equals(lsSkewIntervalStepUf(vector, 4, 3, &skew, &result), 0,
                     "Error: should execute");
   assert_float_equals(result, 1,
                       "Error: skew should be swapped and result should be 1");
@@ -849,16 +2911,26 @@ void test_lsLambdaSearch(void) {
   double vector[4] = {g_maxHighDouble, 1, 2, 3};
   double result_lambda = 0;
   double result_skew = 10;
-  assert_int_equals(
-      lsLambdaSearch(vector, -1, 1, 1, 4, &result_lambda, &result_skew), -2,
-      "Error: yjCalculation completed, should abort");
-  assert_int_equals(
-      lsLambdaSearch(vector, -1, 1, 1, 0, &result_lambda, &result_skew), -3,
-      "Error: skewTest completed, should abort");
+  int errnum = 0;
+  assert_int_equals(lsLambdaSearch(vector, -1, 1, 1, 4, &result_lambda,
+                                   &result_skew, &errnum),
+                    -2, "Error: yjCalculation completed, should abort");
+  assert_int_equals(errnum & (ERR_LAMBDA_SEARCH | ERR_ABORT_YEO_JOHNSON),
+                    ERR_LAMBDA_SEARCH | ERR_ABORT_YEO_JOHNSON,
+                    "Error: errnum of the failed transformation");
+  errnum = 0;
+  assert_int_equals(lsLambdaSearch(vector, -1, 1, 1, 0, &result_lambda,
+                                   &result_skew, &errnum),
+                    -3, "Error: skewTest completed, should abort");
+  assert_int_equals(errnum & (ERR_LAMBDA_SEARCH | ERR_SKEW_TEST),
+                    ERR_LAMBDA_SEARCH | ERR_SKEW_TEST,
+                    "Error: errnum of the failed skew test");
   vector[0] = 0;
-  assert_int_equals(
-      lsLambdaSearch(vector, -1, 1, 1, 4, &result_lambda, &result_skew), 0,
-      "Error: should execute");
+  errnum = 0;
+  assert_int_equals(lsLambdaSearch(vector, -1, 1, 1, 4, &result_lambda,
+                                   &result_skew, &errnum),
+                    0, "Error: should execute");
+  assert_int_equals(errnum, 0, "Error: errnum set without an error");
   printf("...done\n");
 }
 
@@ -867,16 +2939,26 @@ void test_lsLambdaSearchf(void) {
   float vector[4] = {g_maxHighFloat, 1, 2, 3};
   float result_lambda = 0;
   float result_skew = 10;
-  assert_int_equals(
-      lsLambdaSearchf(vector, -1, 1, 1, 4, &result_lambda, &result_skew), -2,
-      "Error: yjCalculation completed, should abort");
-  assert_int_equals(
-      lsLambdaSearchf(vector, -1, 1, 1, 0, &result_lambda, &result_skew), -3,
-      "Error: skewTest completed, should abort");
+  int errnum = 0;
+  assert_int_equals(lsLambdaSearchf(vector, -1, 1, 1, 4, &result_lambda,
+                                    &result_skew, &errnum),
+                    -2, "Error: yjCalculationf completed, should abort");
+  assert_int_equals(errnum & (ERR_LAMBDA_SEARCH | ERR_ABORT_YEO_JOHNSON),
+                    ERR_LAMBDA_SEARCH | ERR_ABORT_YEO_JOHNSON,
+                    "Error: errnum of the failed transformation");
+  errnum = 0;
+  assert_int_equals(lsLambdaSearchf(vector, -1, 1, 1, 0, &result_lambda,
+                                    &result_skew, &errnum),
+                    -3, "Error: skewTest completed, should abort");
+  assert_int_equals(errnum & (ERR_LAMBDA_SEARCH | ERR_SKEW_TEST),
+                    ERR_LAMBDA_SEARCH | ERR_SKEW_TEST,
+                    "Error: errnum of the failed skew test");
   vector[0] = 0;
-  assert_int_equals(
-      lsLambdaSearchf(vector, -1, 1, 1, 4, &result_lambda, &result_skew), 0,
-      "Error: should execute");
+  errnum = 0;
+  assert_int_equals(lsLambdaSearchf(vector, -1, 1, 1, 4, &result_lambda,
+                                    &result_skew, &errnum),
+                    0, "Error: should execute");
+  assert_int_equals(errnum, 0, "Error: errnum set without an error");
   printf("...done\n");
 }
 
@@ -885,9 +2967,10 @@ void test_lsLambdaSearchU(void) {
   double vector[4] = {0, 1, 2, 3};
   double result_lambda = 0;
   double result_skew = 10;
-  assert_int_equals(
-      lsLambdaSearch(vector, -1, 1, 1, 4, &result_lambda, &result_skew), 0,
-      "Error: should execute");
+  int errnum = 0;
+  assert_int_equals(lsLambdaSearch(vector, -1, 1, 1, 4, &result_lambda,
+                                   &result_skew, &errnum),
+                    0, "Error: should execute");
   printf("...done\n");
 }
 
@@ -896,10 +2979,267 @@ void test_lsLambdaSearchUf(void) {
   float vector[4] = {0, 1, 2, 3};
   float result_lambda = 0;
   float result_skew = 10;
+  int errnum = 0;
+  assert_int_equals(lsLambdaSearchf(vector, -1, 1, 1, 4, &result_lambda,
+                                    &result_skew, &errnum),
+                    0, "Error: should execute");
+  printf("...done\n");
+}
+
+void test_lsLambdaBatch(void) {
+  printf("Testing lsScratchSetLambdaBatch in lambdaSearch.c\n");
+  static double vector[5000];
+  double lambda[2];
+  double skew[2];
+  int errnum = 0;
+  yjContext context;
+  lsScratch scratch;
+  lsScratchf scratchf;
+  buildBoundaryBoxCtx(&context, -3, 3);
+  lsScratchInit(&scratch, 1);
+  lsScratchInitf(&scratchf, 1);
+  for (int i = 0; i < 5000; i++) {
+    vector[i] = (i % 7) * 0.5 + (i % 3 ? 0 : i * 1e-3) - 1;
+  }
+  assert_int_equals(scratch.lambda_batch, LS_DEFAULT_LAMBDA_BATCH,
+                    "Error: wrong default batch");
+  assert_int_equals(lsScratchSetLambdaBatch(&scratch, 0), 1,
+                    "Error: batch should be clamped");
+  assert_int_equals(lsScratchSetLambdaBatch(&scratch, 1000),
+                    YJ_MAX_LAMBDA_BATCH, "Error: batch should be clamped");
+  assert_int_equals(lsScratchSetLambdaBatchf(&scratchf, 0), 1,
+                    "Error: batch should be clamped");
+  for (int k = 0; k < 2; k++) {
+    lsScratchSetLambdaBatch(&scratch, k ? YJ_MAX_LAMBDA_BATCH : 1);
+    assert_int_equals(lsLambdaSearchScratch(&context, &scratch, vector, -3, 3,
+                                            0.1, 5000, lambda + k, skew + k,
+                                            &errnum),
+                      0, "Error: should execute");
+  }
+  // the moments of every lambda do not depend on the batch size
+  is_in_bound(lambda[1], lambda[0], 1e-15, "Error: lambda differs by batch");
+  is_in_bound(skew[1], skew[0], 1e-15, "Error: skew differs by batch");
+  lsScratchFree(&scratch);
+  lsScratchFreef(&scratchf);
+  assert_int_equals(scratch.lambda_batch, YJ_MAX_LAMBDA_BATCH,
+                    "Error: free should keep the batch");
+  assert_int_equals(scratchf.lambda_batch, 1,
+                    "Error: free should keep the batch");
+  printf("...done\n");
+}
+
+void test_lsBrentSearch(void) {
+  printf("Testing lsBrentSearch in lambdaSearch.c\n");
+  static double vector[1000];
+  double lambda, skew, grid_lambda, grid_skew;
+  int errnum = 0;
+  for (int i = 0; i < 1000; i++) {
+    vector[i] = exp((i % 37) * 0.05) - 1; // right skewed
+  }
+  assert_int_equals(lsBrentSearch(vector, -3, 3, 1e-6, 1000, &lambda, &skew,
+                                  &errnum),
+                    0, "Error: should execute");
+  assert_int_equals(lsSmartSearch(vector, -3, 3, 14, 1000, &grid_lambda,
+                                  &grid_skew, &errnum),
+                    0, "Error: should execute");
+  is_in_bound(lambda, grid_lambda, 1e-4, "Error: root differs from the scan");
+  is_in_bound(skew, 0, 1e-6, "Error: skew of the root should be 0");
+  // no sign change in [-3, -1.5], smallest |skew| at the upper end
+  assert_int_equals(lsBrentSearch(vector, -3, -1.5, 1e-6, 1000, &lambda,
+                                  &skew, &errnum),
+                    0, "Error: should execute");
+  assert_int_equals(lsLambdaSearch(vector, -3, -1.5, 0.5, 1000, &grid_lambda,
+                                   &grid_skew, &errnum),
+                    0, "Error: should execute");
+  assert_double_equals(lambda, -1.5, "Error: minimum should be the upper end");
+  assert_double_equals(skew, grid_skew, "Error: skew of the upper end");
+  vector[0] = g_maxHighDouble;
+  assert_int_equals(lsBrentSearch(vector, -1, 1, 1e-6, 1000, &lambda, &skew,
+                                  &errnum),
+                    -2, "Error: yjCalculation completed, should abort");
+  printf("...done\n");
+}
+
+void test_lsMleSearch(void) {
+  printf("Testing lsMleSearch in lambdaSearch.c\n");
+  static double vector[1000];
+  double lambda, skew, checked_lambda, checked_skew;
+  int errnum = 0;
+  for (int i = 0; i < 1000; i++) {
+    vector[i] = exp((i % 37) * 0.05) - 1.5;
+  }
+  assert_int_equals(lsMleSearch(vector, -3, 3, 1e-9, 1000, &lambda, &skew,
+                                &errnum),
+                    0, "Error: should execute");
+  // scipy.stats.yeojohnson_normmax of the same values
+  is_in_bound(lambda, 0.18902348, 1e-6, "Error: lambda differs from scipy");
+  // the same search without the log cache and the fused moments
+  yjContext context;
+  buildBoundaryBoxCtx(&context, -3, 3);
+  lsScratch scratch;
+  lsScratchInit(&scratch, 0);
+  assert_int_equals(lsMleSearchScratch(&context, &scratch, vector, -3, 3, 1e-9,
+                                       1000, &checked_lambda, &checked_skew,
+                                       &errnum),
+                    0, "Error: should execute");
+  lsScratchFree(&scratch);
+  is_in_bound(checked_lambda, lambda, 1e-6, "Error: paths differ");
+  is_in_bound(checked_skew, skew, 1e-6, "Error: paths differ");
+  printf("...done\n");
+}
+
+void test_lsRowParts(void) {
+  printf("Testing lsScratchSetRowParts in lambdaSearch.c\n");
+  static double vector[100003];
+  double lambda, skew, split_lambda, split_skew;
+  int errnum = 0;
+  for (int i = 0; i < 100003; i++) {
+    vector[i] = exp((i % 101) * 0.03) - 2.5;
+  }
+  yjContext context;
+  buildBoundaryBoxCtx(&context, -3, 3);
+  lsScratch scratch, split;
+  lsScratchInit(&scratch, 1);
+  lsScratchInit(&split, 1);
+  assert_int_equals(lsScratchSetRowParts(&split, 0), 1,
+                    "Error: should clamp to 1");
+  assert_int_equals(lsScratchSetRowParts(&split, 1000), LS_MAX_ROW_PARTS,
+                    "Error: should clamp to LS_MAX_ROW_PARTS");
+  assert_int_equals(lsScratchSetRowParts(&split, 5), 5, "Error: should set");
+  lsSmartSearchScratch(&context, &scratch, vector, -3, 3, 12, 100003, &lambda,
+                       &skew, &errnum);
+  assert_int_equals(lsSmartSearchScratch(&context, &split, vector, -3, 3, 12,
+                                         100003, &split_lambda, &split_skew,
+                                         &errnum),
+                    0, "Error: should execute");
+  is_in_bound(split_lambda, lambda, 1e-12, "Error: row blocks differ");
+  is_in_bound(split_skew, skew, 1e-12, "Error: row blocks differ");
+  lsBrentSearchScratch(&context, &scratch, vector, -3, 3, 1e-9, 100003,
+                       &lambda, &skew, &errnum);
+  lsBrentSearchScratch(&context, &split, vector, -3, 3, 1e-9, 100003,
+                       &split_lambda, &split_skew, &errnum);
+  is_in_bound(split_lambda, lambda, 1e-8, "Error: row blocks differ");
+  lsMleSearchScratch(&context, &scratch, vector, -3, 3, 1e-9, 100003, &lambda,
+                     &skew, &errnum);
+  lsMleSearchScratch(&context, &split, vector, -3, 3, 1e-9, 100003,
+                     &split_lambda, &split_skew, &errnum);
+  is_in_bound(split_lambda, lambda, 1e-6, "Error: row blocks differ");
+  // fewer rows than blocks, the empty blocks add nothing
+  lsScratchSetRowParts(&split, LS_MAX_ROW_PARTS);
+  lsSmartSearchScratch(&context, &scratch, vector, -3, 3, 8, 20, &lambda,
+                       &skew, &errnum);
+  lsSmartSearchScratch(&context, &split, vector, -3, 3, 8, 20, &split_lambda,
+                       &split_skew, &errnum);
+  is_in_bound(split_lambda, lambda, 1e-12, "Error: row blocks differ");
+  lsScratchFree(&scratch);
+  lsScratchFree(&split);
+  assert_int_equals(split.row_parts, LS_MAX_ROW_PARTS,
+                    "Error: free should keep the row blocks");
+  tpShutdown();
+  printf("...done\n");
+}
+
+void test_lsScratchStats(void) {
+  printf("Testing lsScratchStats in lambdaSearch.c\n");
+  static double vector[1000];
+  static double transformed[1000];
+  double lambda, skew, mean, sd, average, deviation;
+  int errnum = 0;
+  for (int i = 0; i < 1000; i++) {
+    vector[i] = exp((i % 37) * 0.05) - 1.5;
+  }
+  yjContext context;
+  buildBoundaryBoxCtx(&context, -3, 3);
+  lsScratch scratch;
+  lsScratchInit(&scratch, 1);
+  assert_int_equals(lsScratchStats(&scratch, vector, 1000, 0, &mean, &sd), -1,
+                    "Error: no search yet, should abort");
+  lsSmartSearchScratch(&context, &scratch, vector, -3, 3, 10, 1000, &lambda,
+                       &skew, &errnum);
+  assert_int_equals(scratch.stats.valid && scratch.stats.lambda == lambda, 1,
+                    "Error: should keep the stats of the result");
+  double lambdas[3] = {lambda, 0.7, -2};
+  for (int k = 0; k < 3; k++) {
+    assert_int_equals(
+        lsScratchStats(&scratch, vector, 1000, lambdas[k], &mean, &sd), 0,
+        "Error: should execute");
+    memcpy(transformed, vector, sizeof(transformed));
+    double *column = transformed;
+    yjTransformByCtx(&context, &column, lambdas[k], 1000);
+    lsAverage(transformed, 1000, &average);
+    lsVariance(transformed, average, 1000, &deviation);
+    is_in_bound(mean, average, 1e-12 * deviation, "Error: mean differs");
+    is_in_bound(sd, deviation, 1e-12 * deviation, "Error: sd differs");
+  }
+  lsBrentSearchScratch(&context, &scratch, vector, -3, 3, 1e-9, 1000, &lambda,
+                       &skew, &errnum);
   assert_int_equals(
-      lsLambdaSearchf(vector, -1, 1, 1, 4, &result_lambda, &result_skew), 0,
+      lsScratchStats(&scratch, vector, 1000, lambda, &mean, &sd), 0,
       "Error: should execute");
+  // the next search forgets the stats, the scans without log cache keep none
+  lsScratchFree(&scratch);
+  lsScratchInit(&scratch, 0);
+  lsSmartSearchScratch(&context, &scratch, vector, -3, 3, 10, 1000, &lambda,
+                       &skew, &errnum);
+  assert_int_equals(lsScratchStats(&scratch, vector, 1000, lambda, &mean, &sd),
+                    -1, "Error: moments were not fused, should abort");
+  lsScratchFree(&scratch);
+  printf("...done\n");
+}
+
+static int test_compare(const void *a, const void *b) {
+  double x = *(const double *)a;
+  double y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+void test_lsSmartBowleySearch(void) {
+  printf("Testing lsSmartBowleySearch in lambdaSearch.c\n");
+  static double vector[1001];
+  static double copy[1001];
+  static double sorted[1001];
+  double q1, q2, q3;
+  for (int pattern = 0; pattern < 4; pattern++) {
+    for (int size = 4; size <= 1001; size += 199) {
+      for (int i = 0; i < size; i++) {
+        switch (pattern) {
+        case 0: // ascending
+          vector[i] = i;
+          break;
+        case 1: // descending
+          vector[i] = size - i;
+          break;
+        case 2: // zero inflated counts
+          vector[i] = i % 5 == 0 ? i % 3 : 0;
+          break;
+        default: // scrambled
+          vector[i] = (i * 7919) % size - size / 3.0;
+        }
+        sorted[i] = vector[i];
+      }
+      qsort(sorted, size, sizeof(double), test_compare);
+      assert_int_equals(lsGetQuantils(vector, size, &q1, &q2, &q3), 0,
+                        "Error: should execute");
+      assert_double_equals(q1, sorted[size / 4 - 1], "Error: wrong q1");
+      assert_double_equals(q2, (sorted[size / 2 - 1] + sorted[size / 2]) / 2,
+                           "Error: wrong q2");
+      assert_double_equals(q3, sorted[size - size / 4], "Error: wrong q3");
+    }
+  }
+  assert_int_equals(lsGetQuantils(vector, 3, &q1, &q2, &q3),
+                    ERR_NOT_ENOUGH_ROWS, "Error: should abort");
+  for (int i = 0; i < 1001; i++) {
+    vector[i] = exp((i % 37) * 0.05);
+    copy[i] = vector[i];
+  }
+  double lambda, skew;
+  int errnum = 0;
+  assert_int_equals(lsSmartBowleySearch(vector, -3, 3, 10, 1001, &lambda,
+                                        &skew, &errnum),
+                    0, "Error: should execute");
+  assert_int_equals(memcmp(vector, copy, sizeof(copy)), 0,
+                    "Error: column should be untouched");
   printf("...done\n");
 }
 
-#endif
\ No newline at end of file
+#endif
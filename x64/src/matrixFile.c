@@ -0,0 +1,1271 @@
+/****************************************************************
+ * Copyright (c) 2023 Jerome Brenig, Sigrun May
+ * Ostfalia Hochschule für angewandte Wissenschaften
+ *
+ * This software is distributed under the terms of the MIT license
+ * which is available at https://opensource.org/licenses/MIT
+ *
+ * FILENAME : matrixFile.c
+ *
+ * DESCRIPTION  :
+ *          Binary matrix files that are mapped into a MATRIXS instead of
+ *          parsed, for repeated jobs on the same data.
+ *
+ * PUBLIC FUNCTIONS :
+ *          int mfWrite(const char *file_path, const MATRIXS *matrix,
+ *                      char *const *names, int sections)
+ *          int mfWriteColumns(file_path, rows, cols, dtype, column, source,
+ *                             names, sections, lambda, skew, errnum)
+ *          int mfOpenArray(MATRIXFILE *file, const char *file_path,
+ *                          const char *array_name, int mode)
+ *          int mfOpen(MATRIXFILE *file, const char *file_path, int mode)
+ *          void mfDiscard(const MATRIXFILE *file, const void *address,
+ *                         size_t size)
+ *          void mfClose(MATRIXFILE *file)
+ *          int mfConvertCsv(char *csv_path, const char *file_path,
+ *                           int sections, int thread_count)
+ *
+ * NOTES    :
+ *          Layout of a file: MFHEADER, the optional column names, the values
+ *          column after column and the optional lambda, skew and errnum
+ *          arrays, every section aligned to MATRIX_ALIGNMENT bytes. mfOpen
+ *          maps the file and points the MATRIXS into the mapping, nothing is
+ *          read or copied until the values are used. MF_READ maps the file
+ *          copy on write, so the ci*S operations can transform it in place
+ *          without touching the file; MF_UPDATE writes the transformed
+ *          values and the results back. Files are in native byte order.
+ *          mfOpen maps .npy files and the arrays of uncompressed .npz files
+ *          (numpy.save / numpy.savez) the same way, C and Fortran order, from
+ *          the header dict of the .npy format and the central directory of
+ *          the zip archive. Only .npz arrays that are not aligned to their
+ *          element size are copied.
+ *          On Windows the file is read into memory instead, MF_UPDATE is
+ *          not available there.
+ *
+ * AUTHOR   :       agent             START DATE    : 16 October 2026
+ *
+ * CHANGES  :
+ *
+ * DATE     WHO     DETAIL
+ *
+ *H*/
+
+/*****************************************************************************
+ *                               INCLUDES
+ *****************************************************************************/
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "include/matrixFile.h"
+#include "include/testFramework.h"
+
+/*****************************************************************************
+ *                           PRIVATE FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * @brief rounds an offset up to the next multiple of MATRIX_ALIGNMENT
+ *
+ * @param offset offset in bytes
+ * @return long long aligned offset
+ */
+static long long mf_align(long long offset) {
+  return (offset + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT * MATRIX_ALIGNMENT;
+}
+
+/**
+ * @brief size of one value in bytes
+ *
+ * @param dtype MATRIX_FLOAT64 or MATRIX_FLOAT32
+ * @return int size in bytes, 0 for an unknown dtype
+ */
+static int mf_element_size(int dtype) {
+  return dtype == MATRIX_FLOAT64   ? (int)sizeof(double)
+         : dtype == MATRIX_FLOAT32 ? (int)sizeof(float)
+                                   : 0;
+}
+
+/**
+ * @brief writes zeros up to offset
+ *
+ * @param file destination
+ * @param position bytes written so far, updated
+ * @param offset start of the next section
+ * @return int 0, -1 if the file can not be written
+ */
+static int mf_pad(FILE *file, long long *position, long long offset) {
+  static const char zeros[MATRIX_ALIGNMENT];
+  while (*position < offset) {
+    size_t count = offset - *position < MATRIX_ALIGNMENT
+                       ? (size_t)(offset - *position)
+                       : MATRIX_ALIGNMENT;
+    if (fwrite(zeros, 1, count, file) != count) {
+      return -1;
+    }
+    *position += count;
+  }
+  return 0;
+}
+
+/**
+ * @brief writes a section at offset
+ *
+ * @param file destination
+ * @param position bytes written so far, updated
+ * @param offset start of the section
+ * @param data content, zeros if NULL
+ * @param size bytes
+ * @return int 0, -1 if the file can not be written
+ */
+static int mf_section(FILE *file, long long *position, long long offset,
+                      const void *data, long long size) {
+  if (mf_pad(file, position, offset) != 0) {
+    return -1;
+  }
+  if (data == NULL) {
+    return mf_pad(file, position, offset + size);
+  }
+  if (size > 0 && fwrite(data, 1, (size_t)size, file) != (size_t)size) {
+    return -1;
+  }
+  *position += size;
+  return 0;
+}
+
+/**
+ * @brief mfColumn of a MATRIXS, copies strided columns into buffer
+ */
+static const void *mf_strided_column(void *source, int col, void *buffer) {
+  const MATRIXS *matrix = (const MATRIXS *)source;
+  int size = mf_element_size(matrix->dtype);
+  const char *value = (const char *)matrix->data + col * matrix->col_stride;
+  if (matrix->row_stride == size) {
+    return value;
+  }
+  for (int row = 0; row < matrix->rows; row++) {
+    memcpy((char *)buffer + (size_t)row * size, value, size);
+    value += matrix->row_stride;
+  }
+  return buffer;
+}
+
+/**
+ * @brief mfColumn of a MATRIX, its columns are contiguous already
+ */
+static const void *mf_table_column(void *source, int col, void *buffer) {
+  return ((const MATRIX *)source)->data[col];
+}
+
+/**
+ * @brief writes a matrix file, values column after column
+ *
+ * @param file_path destination, replaced
+ * @param rows amount of rows
+ * @param cols amount of columns
+ * @param dtype MATRIX_FLOAT64 or MATRIX_FLOAT32
+ * @param column source of the columns
+ * @param source argument of column
+ * @param names cols column names, NULL for none
+ * @param results 1 for the lambda, skew and errnum sections
+ * @param lambda cols lambdas, NULL for zeros
+ * @param skew cols skews, NULL for zeros
+ * @param errnum cols error codes, NULL for zeros
+ * @return int 0, -2 if the file can not be written, -3 allocation failed
+ */
+static int mf_write(const char *file_path, int rows, int cols, int dtype,
+                    mfColumn column, void *source, char *const *names,
+                    int results, const double *lambda, const double *skew,
+                    const int *errnum) {
+  int size = mf_element_size(dtype);
+  MFHEADER header;
+  memset(&header, 0, sizeof(MFHEADER));
+  memcpy(header.magic, MF_MAGIC, sizeof(header.magic));
+  header.version = MF_VERSION;
+  header.dtype = dtype;
+  header.rows = rows;
+  header.cols = cols;
+  header.layout = MF_COLUMN_MAJOR;
+  long long end = sizeof(MFHEADER);
+  if (names != NULL) {
+    header.names_offset = mf_align(end);
+    for (int col = 0; col < cols; col++) {
+      header.names_size += strlen(names[col]) + 1;
+    }
+    end = header.names_offset + header.names_size;
+  }
+  header.data_offset = mf_align(end);
+  end = header.data_offset + (long long)rows * cols * size;
+  if (results) {
+    header.lambda_offset = mf_align(end);
+    header.skew_offset = mf_align(header.lambda_offset + cols * 8LL);
+    header.errnum_offset = mf_align(header.skew_offset + cols * 8LL);
+    end = header.errnum_offset + cols * (long long)sizeof(int);
+  }
+  header.file_size = end;
+
+  void *buffer = malloc(rows > 0 ? (size_t)rows * size : 1);
+  if (buffer == NULL) {
+    printf("\tFailed to allocate memory for a column.\n");
+    return -3;
+  }
+  FILE *file = fopen(file_path, "wb");
+  if (file == NULL) {
+    printf("\t\"%s\" can not be written.\n", file_path);
+    free(buffer);
+    return -2;
+  }
+  long long position = 0;
+  int ret = mf_section(file, &position, 0, &header, sizeof(MFHEADER));
+  for (int col = 0; ret == 0 && names != NULL && col < cols; col++) {
+    long long offset = col == 0 ? header.names_offset : position;
+    ret = mf_section(file, &position, offset, names[col],
+                     strlen(names[col]) + 1);
+  }
+  for (int col = 0; ret == 0 && col < cols; col++) {
+    ret = mf_section(file, &position,
+                     header.data_offset + (long long)col * rows * size,
+                     column(source, col, buffer), (long long)rows * size);
+  }
+  if (ret == 0 && results) {
+    ret = mf_section(file, &position, header.lambda_offset, lambda,
+                     cols * 8LL);
+    ret |= mf_section(file, &position, header.skew_offset, skew, cols * 8LL);
+    ret |= mf_section(file, &position, header.errnum_offset, errnum,
+                      cols * (long long)sizeof(int));
+  }
+  free(buffer);
+  if (fclose(file) != 0 || ret != 0) {
+    printf("\t\"%s\" can not be written.\n", file_path);
+    return -2;
+  }
+  return 0;
+}
+
+/**
+ * @brief maps a file writable, shared (MF_UPDATE) or copy on write (MF_READ);
+ * read into memory aligned to MATRIX_ALIGNMENT where mmap is not available
+ *
+ * @param file_path file to be mapped
+ * @param mode MF_READ or MF_UPDATE
+ * @param mapping receives the content
+ * @param size receives the size in bytes
+ * @return int 0, -1 if the file can not be opened or mapped
+ */
+static int mf_map(const char *file_path, int mode, void **mapping,
+                  size_t *size) {
+  *mapping = NULL;
+  *size = 0;
+#ifdef _WIN32
+  if (mode == MF_UPDATE) {
+    return -1;
+  }
+  FILE *file = fopen(file_path, "rb");
+  if (file == NULL) {
+    return -1;
+  }
+  if (_fseeki64(file, 0, SEEK_END) != 0) {
+    fclose(file);
+    return -1;
+  }
+  long long length = _ftelli64(file);
+  rewind(file);
+  *mapping = _aligned_malloc(length > 0 ? (size_t)length : 1,
+                             MATRIX_ALIGNMENT);
+  if (length < 0 || *mapping == NULL ||
+      fread(*mapping, 1, (size_t)length, file) != (size_t)length) {
+    _aligned_free(*mapping);
+    *mapping = NULL;
+    fclose(file);
+    return -1;
+  }
+  *size = (size_t)length;
+  fclose(file);
+#else
+  int file = open(file_path, mode == MF_UPDATE ? O_RDWR : O_RDONLY);
+  if (file < 0) {
+    return -1;
+  }
+  struct stat status;
+  if (fstat(file, &status) != 0 || status.st_size == 0) {
+    close(file);
+    return -1;
+  }
+  void *map = mmap(NULL, (size_t)status.st_size, PROT_READ | PROT_WRITE,
+                   mode == MF_UPDATE ? MAP_SHARED : MAP_PRIVATE, file, 0);
+  close(file);
+  if (map == MAP_FAILED) {
+    return -1;
+  }
+  *mapping = map;
+  *size = (size_t)status.st_size;
+#endif
+  return 0;
+}
+
+/**
+ * @brief releases a mapping of mf_map
+ *
+ * @param mapping content of mf_map
+ * @param size size of mf_map
+ */
+static void mf_unmap(void *mapping, size_t size) {
+#ifdef _WIN32
+  _aligned_free(mapping);
+#else
+  if (mapping != NULL) {
+    munmap(mapping, size);
+  }
+#endif
+}
+
+/**
+ * @brief checks that a section lies inside the file and is aligned
+ *
+ * @param offset start of the section, 0 for a missing one
+ * @param count amount of elements, not negative
+ * @param size element size in bytes
+ * @param alignment required alignment of offset in bytes
+ * @param file_size size of the file
+ * @return int 1 if the section is valid
+ */
+static int mf_valid_section(long long offset, long long count, long long size,
+                            int alignment, long long file_size) {
+  if (count < 0 || offset <= 0 || offset % alignment != 0 ||
+      offset > file_size) {
+    return 0;
+  }
+  return count <= (file_size - offset) / size;
+}
+
+/**
+ * @brief points the column names into the mapping
+ *
+ * @param file file with a valid names section
+ * @param header header of the file
+ * @return int 0, -3 if the names do not match cols, -4 allocation failed
+ */
+static int mf_names(MATRIXFILE *file, const MFHEADER *header) {
+  if (header->names_size <= 0) {
+    return header->cols == 0 ? 0 : -3;
+  }
+  char *name = (char *)file->mapping + header->names_offset;
+  char *end = name + header->names_size;
+  if (end[-1] != '\0') {
+    return header->cols == 0 ? 0 : -3;
+  }
+  file->names = (char **)malloc(sizeof(char *) * header->cols);
+  if (file->names == NULL) {
+    return -4;
+  }
+  for (long long col = 0; col < header->cols; col++) {
+    if (name >= end) {
+      return -3;
+    }
+    file->names[col] = name;
+    name += strlen(name) + 1;
+  }
+  return name == end ? 0 : -3;
+}
+
+/**
+ * @brief lambda, skew and errnum of a file without result sections
+ *
+ * @param file opened file with cols set
+ * @return int 0, -4 allocation failed
+ */
+static int mf_alloc_results(MATRIXFILE *file) {
+  MATRIXS *matrix = &file->matrix;
+  size_t cols = matrix->cols > 0 ? (size_t)matrix->cols : 1;
+  matrix->lambda = (double *)calloc(cols, sizeof(double));
+  matrix->skew = (double *)calloc(cols, sizeof(double));
+  matrix->errnum = (int *)calloc(cols, sizeof(int));
+  if (matrix->lambda == NULL || matrix->skew == NULL ||
+      matrix->errnum == NULL) {
+    return -4;
+  }
+  return 0;
+}
+
+/**
+ * @brief points the MATRIXS of a mapped matrix file into the mapping
+ *
+ * @param file file with the mapping of a matrix file
+ * @return int 0, -3 not a valid matrix file, -4 allocation failed
+ */
+static int mf_open_matrix(MATRIXFILE *file) {
+  MFHEADER header;
+  long long file_size = (long long)file->size;
+  if (file->size < sizeof(MFHEADER)) {
+    return -3;
+  }
+  memcpy(&header, file->mapping, sizeof(MFHEADER));
+  int size = mf_element_size(header.dtype);
+  if (header.version != MF_VERSION || size == 0 ||
+      (header.layout != MF_ROW_MAJOR && header.layout != MF_COLUMN_MAJOR) ||
+      header.rows < 0 || header.rows > INT_MAX || header.cols < 0 ||
+      header.cols > INT_MAX || header.file_size > file_size ||
+      (header.rows > 0 && header.cols > 0 &&
+       !mf_valid_section(header.data_offset, header.rows,
+                         (long long)size * header.cols, size, file_size))) {
+    return -3;
+  }
+  if (header.names_offset != 0) {
+    int ret = mf_valid_section(header.names_offset, header.names_size, 1, 1,
+                               file_size)
+                  ? mf_names(file, &header)
+                  : -3;
+    if (ret != 0) {
+      return ret;
+    }
+  }
+  MATRIXS *matrix = &file->matrix;
+  matrix->rows = (int)header.rows;
+  matrix->cols = (int)header.cols;
+  matrix->dtype = header.dtype;
+  matrix->data = (char *)file->mapping + header.data_offset;
+  matrix->row_stride =
+      header.layout == MF_COLUMN_MAJOR ? size : (long long)size * header.cols;
+  matrix->col_stride =
+      header.layout == MF_COLUMN_MAJOR ? (long long)size * header.rows : size;
+  file->results_in_file =
+      mf_valid_section(header.lambda_offset, header.cols, 8, 8, file_size) &&
+      mf_valid_section(header.skew_offset, header.cols, 8, 8, file_size) &&
+      mf_valid_section(header.errnum_offset, header.cols, sizeof(int),
+                       sizeof(int), file_size);
+  if (!file->results_in_file) {
+    return mf_alloc_results(file);
+  }
+  matrix->lambda = (double *)((char *)file->mapping + header.lambda_offset);
+  matrix->skew = (double *)((char *)file->mapping + header.skew_offset);
+  matrix->errnum = (int *)((char *)file->mapping + header.errnum_offset);
+  return 0;
+}
+
+/**
+ * @brief little endian integers of the zip format
+ */
+static unsigned int mf_u16(const unsigned char *bytes) {
+  return bytes[0] | (unsigned int)bytes[1] << 8;
+}
+
+static unsigned int mf_u32(const unsigned char *bytes) {
+  return mf_u16(bytes) | (unsigned int)mf_u16(bytes + 2) << 16;
+}
+
+static unsigned long long mf_u64(const unsigned char *bytes) {
+  return mf_u32(bytes) | (unsigned long long)mf_u32(bytes + 4) << 32;
+}
+
+/**
+ * @brief value of a key of the header dict of a .npy file
+ *
+ * @param header header text
+ * @param end behind the header
+ * @param key key with quotes, e.g. "'shape'"
+ * @return const char* first character of the value, NULL if the key is missing
+ */
+static const char *mf_npy_value(const char *header, const char *end,
+                                const char *key) {
+  size_t length = strlen(key);
+  for (const char *c = header; c + length <= end; c++) {
+    if (memcmp(c, key, length) == 0) {
+      for (c += length; c < end && (*c == ' ' || *c == ':'); c++) {
+      }
+      return c;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief points the MATRIXS at the array of a .npy file in the mapping; a
+ * copy is made only if the array is not aligned to its element size (possible
+ * inside .npz files)
+ *
+ * @param file file with the mapping
+ * @param offset start of the .npy content in the mapping
+ * @param length bytes of the .npy content
+ * @return int 0, -3 not a valid .npy file, -4 allocation failed, -5 dtype or
+ * dimensions not supported, -6 unaligned array in MF_UPDATE mode
+ */
+static int mf_open_npy(MATRIXFILE *file, size_t offset, size_t length) {
+  const unsigned char *npy = (const unsigned char *)file->mapping + offset;
+  if (length < 10 || memcmp(npy, "\x93NUMPY", 6) != 0) {
+    return -3;
+  }
+  // version 1 has a 2 byte header length, versions 2 and 3 a 4 byte one
+  size_t header_offset = npy[6] == 1 ? 10 : 12;
+  if (npy[6] < 1 || npy[6] > 3 || length < header_offset) {
+    return -3;
+  }
+  size_t header_length = npy[6] == 1 ? mf_u16(npy + 8) : mf_u32(npy + 8);
+  if (header_length > length - header_offset) {
+    return -3;
+  }
+  const char *header = (const char *)npy + header_offset;
+  const char *end = header + header_length;
+  const char *descr = mf_npy_value(header, end, "'descr'");
+  const char *fortran = mf_npy_value(header, end, "'fortran_order'");
+  const char *shape = mf_npy_value(header, end, "'shape'");
+  if (descr == NULL || fortran == NULL || shape == NULL || end - descr < 5) {
+    return -3;
+  }
+  // native byte order only, '|' does not occur for floats
+  const unsigned short probe = 1;
+  char native = *(const char *)&probe == 1 ? '<' : '>';
+  int dtype;
+  if ((descr[1] != native && descr[1] != '=') || descr[2] != 'f' ||
+      descr[4] != descr[0]) {
+    return -5;
+  }
+  if (descr[3] == '8') {
+    dtype = MATRIX_FLOAT64;
+  } else if (descr[3] == '4') {
+    dtype = MATRIX_FLOAT32;
+  } else {
+    return -5;
+  }
+  int column_major = end - fortran >= 4 && memcmp(fortran, "True", 4) == 0;
+  // (rows,) or (rows, cols)
+  long long dimensions[2] = {1, 1};
+  int ndim = 0;
+  const char *c = shape;
+  if (c >= end || *c++ != '(') {
+    return -3;
+  }
+  for (;;) {
+    while (c < end && *c == ' ') {
+      c++;
+    }
+    if (c < end && *c == ')') {
+      break;
+    }
+    if (ndim == 2 || c >= end || *c < '0' || *c > '9') {
+      return ndim == 2 ? -5 : -3;
+    }
+    long long dimension = 0;
+    for (; c < end && *c >= '0' && *c <= '9'; c++) {
+      dimension = dimension * 10 + *c - '0';
+      if (dimension > INT_MAX) {
+        return -5;
+      }
+    }
+    dimensions[ndim++] = dimension;
+    while (c < end && (*c == ' ' || *c == ',')) {
+      c++;
+    }
+  }
+  if (ndim == 0) {
+    return -5;
+  }
+  int size = mf_element_size(dtype);
+  MATRIXS *matrix = &file->matrix;
+  matrix->rows = (int)dimensions[0];
+  matrix->cols = (int)dimensions[1];
+  matrix->dtype = dtype;
+  size_t data_offset = header_offset + header_length;
+  if (matrix->rows > 0 && matrix->cols > 0 &&
+      (long long)matrix->rows >
+          (long long)((length - data_offset) / size / matrix->cols)) {
+    return -3;
+  }
+  matrix->data = (char *)npy + data_offset;
+  if ((size_t)matrix->data % size != 0) {
+    if (file->mode == MF_UPDATE) {
+      return -6;
+    }
+    size_t bytes = (size_t)matrix->rows * matrix->cols * size;
+    file->copy = malloc(bytes > 0 ? bytes : 1);
+    if (file->copy == NULL) {
+      return -4;
+    }
+    memcpy(file->copy, matrix->data, bytes);
+    matrix->data = file->copy;
+  }
+  matrix->row_stride = column_major ? size : (long long)size * matrix->cols;
+  matrix->col_stride = column_major ? (long long)size * matrix->rows : size;
+  return mf_alloc_results(file);
+}
+
+/**
+ * @brief finds the .npy of an array in a .npz file (a zip archive) through its
+ * central directory, zip64 included
+ *
+ * @param zip mapping of the .npz file
+ * @param size bytes of the file
+ * @param array_name name of the array (the member without ".npy"), NULL for
+ * the first one
+ * @param offset receives the start of the .npy content
+ * @param length receives its length
+ * @return int 0, -3 not a valid zip archive or no such array, -5 the array is
+ * compressed (numpy.savez_compressed)
+ */
+static int mf_npz_member(const unsigned char *zip, size_t size,
+                         const char *array_name, size_t *offset,
+                         size_t *length) {
+  // end of central directory record, followed by a comment of <= 65535 bytes
+  const unsigned char *record = NULL;
+  for (size_t i = size >= 22 ? size - 22 : 0;
+       size >= 22 && i + 65535 + 22 >= size; i--) {
+    if (mf_u32(zip + i) == 0x06054b50) {
+      record = zip + i;
+      break;
+    }
+    if (i == 0) {
+      break;
+    }
+  }
+  if (record == NULL) {
+    return -3;
+  }
+  unsigned long long entries = mf_u16(record + 10);
+  unsigned long long directory = mf_u32(record + 16);
+  if ((entries == 0xFFFF || directory == 0xFFFFFFFF) && record - zip >= 20 &&
+      mf_u32(record - 20) == 0x07064b50) {
+    unsigned long long record64 = mf_u64(record - 20 + 8);
+    if (size < 56 || record64 > size - 56 || mf_u32(zip + record64) != 0x06064b50) {
+      return -3;
+    }
+    entries = mf_u64(zip + record64 + 32);
+    directory = mf_u64(zip + record64 + 48);
+  }
+  if (directory > size) {
+    return -3;
+  }
+  size_t name_length = array_name != NULL ? strlen(array_name) : 0;
+  const unsigned char *entry = zip + directory;
+  for (unsigned long long i = 0; i < entries; i++) {
+    if ((size_t)(entry - zip) + 46 > size ||
+        mf_u32(entry) != 0x02014b50) {
+      return -3;
+    }
+    unsigned int method = mf_u16(entry + 10);
+    unsigned long long compressed = mf_u32(entry + 20);
+    unsigned long long local = mf_u32(entry + 42);
+    unsigned int file_name_length = mf_u16(entry + 28);
+    unsigned int extra_length = mf_u16(entry + 30);
+    const char *file_name = (const char *)entry + 46;
+    const unsigned char *extra = entry + 46 + file_name_length;
+    const unsigned char *next = extra + extra_length + mf_u16(entry + 32);
+    if ((size_t)(next - zip) > size) {
+      return -3;
+    }
+    int match = file_name_length >= 4 &&
+                memcmp(file_name + file_name_length - 4, ".npy", 4) == 0 &&
+                (array_name == NULL ||
+                 (file_name_length == name_length + 4 &&
+                  memcmp(file_name, array_name, name_length) == 0));
+    if (match) {
+      if (method != 0) {
+        return -5;
+      }
+      // zip64 extra field: the sizes and the offset that do not fit, every
+      // value read inside the declared size of its field
+      for (const unsigned char *field = extra;
+           field + 4 <= extra + extra_length;
+           field += 4 + mf_u16(field + 2)) {
+        const unsigned char *field_end = field + 4 + mf_u16(field + 2);
+        if (field_end > extra + extra_length) {
+          return -3;
+        }
+        if (mf_u16(field) != 0x0001) {
+          continue;
+        }
+        const unsigned char *value = field + 4;
+        if (mf_u32(entry + 24) == 0xFFFFFFFF) {
+          value += 8; // uncompressed size, the same for stored members
+        }
+        if (compressed == 0xFFFFFFFF) {
+          if (value + 8 > field_end) {
+            return -3;
+          }
+          compressed = mf_u64(value);
+          value += 8;
+        }
+        if (local == 0xFFFFFFFF) {
+          if (value + 8 > field_end) {
+            return -3;
+          }
+          local = mf_u64(value);
+        }
+      }
+      if (size < 30 || local > size - 30 ||
+          mf_u32(zip + local) != 0x04034b50) {
+        return -3;
+      }
+      *offset = local + 30 + mf_u16(zip + local + 26) +
+                mf_u16(zip + local + 28);
+      if (*offset > size || compressed > size - *offset) {
+        return -3;
+      }
+      *length = compressed;
+      return 0;
+    }
+    entry = next;
+  }
+  return -3;
+}
+
+/*****************************************************************************
+ *                           PUBLIC FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * @brief writes a strided matrix into a matrix file, column major
+ *
+ * @param file_path destination, replaced
+ * @param matrix values, and the results with MF_RESULTS
+ * @param names cols column names, used with MF_NAMES
+ * @param sections MF_NAMES | MF_RESULTS, or 0
+ * @return int error return code: -1 invalid argument, -2 file can not be
+ * written, -3 allocation failed
+ */
+int mfWrite(const char *file_path, const MATRIXS *matrix, char *const *names,
+            int sections) {
+  if (file_path == NULL || checkMatrixS(matrix) != 0 ||
+      ((sections & MF_NAMES) && names == NULL)) {
+    return -1;
+  }
+  return mf_write(file_path, matrix->rows, matrix->cols, matrix->dtype,
+                  mf_strided_column, (void *)matrix,
+                  (sections & MF_NAMES) ? names : NULL,
+                  (sections & MF_RESULTS) != 0, matrix->lambda, matrix->skew,
+                  matrix->errnum);
+}
+
+/**
+ * @brief writes a matrix file from a column source, e.g. columns produced
+ * block by block that never exist as a whole matrix
+ *
+ * @param file_path destination, replaced
+ * @param rows amount of rows
+ * @param cols amount of columns
+ * @param dtype MATRIX_FLOAT64 or MATRIX_FLOAT32
+ * @param column called for col = 0, 1, ... cols - 1 in this order
+ * @param source argument of column
+ * @param names cols column names, used with MF_NAMES
+ * @param sections MF_NAMES | MF_RESULTS, or 0
+ * @param lambda cols lambdas of MF_RESULTS, read after the last column
+ * @param skew cols skews of MF_RESULTS, read after the last column
+ * @param errnum cols error codes of MF_RESULTS, read after the last column
+ * @return int error return code: -1 invalid argument, -2 file can not be
+ * written, -3 allocation failed
+ */
+int mfWriteColumns(const char *file_path, int rows, int cols, int dtype,
+                   mfColumn column, void *source, char *const *names,
+                   int sections, const double *lambda, const double *skew,
+                   const int *errnum) {
+  if (file_path == NULL || column == NULL || rows < 0 || cols < 0 ||
+      mf_element_size(dtype) == 0 || ((sections & MF_NAMES) && names == NULL) ||
+      ((sections & MF_RESULTS) &&
+       (lambda == NULL || skew == NULL || errnum == NULL))) {
+    return -1;
+  }
+  return mf_write(file_path, rows, cols, dtype, column, source,
+                  (sections & MF_NAMES) ? names : NULL,
+                  (sections & MF_RESULTS) != 0, lambda, skew, errnum);
+}
+
+/**
+ * @brief maps a matrix file, .npy file or array of an uncompressed .npz file
+ * (numpy.save / numpy.savez) into a MATRIXS without copying the values.
+ * Results of files without result sections are allocated.
+ *
+ * @param file receives the matrix and the names, release with mfClose
+ * @param file_path file of mfWrite or mfConvertCsv, .npy or .npz of float64
+ * or float32 arrays with one or two dimensions, C or Fortran order
+ * @param array_name array of a .npz file, NULL for the first one
+ * @param mode MF_READ (transformations stay in memory) or MF_UPDATE (they
+ * are written to the file)
+ * @return int error return code: -1 invalid argument, -2 file can not be
+ * mapped, -3 not a valid matrix, .npy or .npz file, -4 allocation failed, -5
+ * dtype, dimensions or compression not supported, -6 unaligned .npz array
+ * can not be updated
+ */
+int mfOpenArray(MATRIXFILE *file, const char *file_path,
+                const char *array_name, int mode) {
+  if (file == NULL) {
+    return -1;
+  }
+  memset(file, 0, sizeof(MATRIXFILE));
+  if (file_path == NULL || (mode != MF_READ && mode != MF_UPDATE)) {
+    return -1;
+  }
+  if (mf_map(file_path, mode, &file->mapping, &file->size) != 0) {
+    printf("\t\"%s\" can not be mapped.\n", file_path);
+    return -2;
+  }
+  file->mode = mode;
+  const unsigned char *bytes = (const unsigned char *)file->mapping;
+  int ret = -3;
+  if (file->size >= 8 && memcmp(bytes, MF_MAGIC, 8) == 0) {
+    ret = mf_open_matrix(file);
+  } else if (file->size >= 6 && memcmp(bytes, "\x93NUMPY", 6) == 0) {
+    ret = mf_open_npy(file, 0, file->size);
+  } else if (file->size >= 4 && mf_u32(bytes) == 0x04034b50) {
+    size_t offset, length;
+    ret = mf_npz_member(bytes, file->size, array_name, &offset, &length);
+    if (ret == 0) {
+      ret = mf_open_npy(file, offset, length);
+    }
+  }
+  if (ret != 0) {
+    printf("\t\"%s\" can not be opened (%d).\n", file_path, ret);
+    mfClose(file);
+  }
+  return ret;
+}
+
+/**
+ * @brief maps a matrix file, .npy file or the first array of a .npz file, see
+ * mfOpenArray
+ *
+ * @param file receives the matrix and the names, release with mfClose
+ * @param file_path file origin
+ * @param mode MF_READ or MF_UPDATE
+ * @return int error return code of mfOpenArray
+ */
+int mfOpen(MATRIXFILE *file, const char *file_path, int mode) {
+  return mfOpenArray(file, file_path, NULL, mode);
+}
+
+/**
+ * @brief drops the pages of a range of an MF_READ mapping from the memory of
+ * the process, they are read from the file again on the next access. Changes
+ * to pages that overlap the range are lost.
+ *
+ * @param file file of mfOpen
+ * @param address first byte of the range
+ * @param size bytes of the range
+ */
+void mfDiscard(const MATRIXFILE *file, const void *address, size_t size) {
+#ifndef _WIN32
+  if (file == NULL || file->mode != MF_READ || file->copy != NULL ||
+      (const char *)address < (const char *)file->mapping ||
+      (const char *)address + size > (const char *)file->mapping + file->size) {
+    return;
+  }
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  size_t begin = (size_t)address / page * page;
+  size_t end = ((size_t)address + size + page - 1) / page * page;
+  if (begin < end) {
+    madvise((void *)begin, end - begin, MADV_DONTNEED);
+  }
+#endif
+}
+
+/**
+ * @brief unmaps a file of mfOpen, with MF_UPDATE the changes stay in the file
+ *
+ * @param file file of mfOpen
+ */
+void mfClose(MATRIXFILE *file) {
+  if (file == NULL) {
+    return;
+  }
+  if (!file->results_in_file) {
+    free(file->matrix.lambda);
+    free(file->matrix.skew);
+    free(file->matrix.errnum);
+  }
+  free(file->names);
+  free(file->copy);
+  mf_unmap(file->mapping, file->size);
+  memset(file, 0, sizeof(MATRIXFILE));
+}
+
+/**
+ * @brief converts a csv (see importVectorTableFromCsvParallel) into a matrix
+ * file of doubles
+ *
+ * @param csv_path csv origin
+ * @param file_path destination, replaced
+ * @param sections MF_NAMES for the names of the csv header, if it has one;
+ * MF_RESULTS for zeroed lambda, skew and errnum sections that MF_UPDATE fills
+ * @param thread_count amount of parts parsing the csv, run on the shared
+ * thread pool (see importVectorTableFromCsvParallel)
+ * @return int error return code: -1 invalid argument, -2 file can not be
+ * written, -3 allocation failed, -4 csv can not be imported
+ */
+int mfConvertCsv(char *csv_path, const char *file_path, int sections,
+                 int thread_count) {
+  if (csv_path == NULL || file_path == NULL) {
+    return -1;
+  }
+  MATRIX table;
+  MATRIX *vector_list = &table;
+  if (importVectorTableFromCsvParallel(csv_path, &vector_list, thread_count,
+                                       NULL) != 0) {
+    return -4;
+  }
+  char **names = NULL;
+  int count = 0;
+  if ((sections & MF_NAMES) &&
+      importColumnNamesFromCsv(csv_path, &names, &count) != 0) {
+    count = -1;
+  }
+  int ret = -4;
+  if (count == 0 || count == table.cols) {
+    ret = mf_write(file_path, table.rows, table.cols, MATRIX_FLOAT64,
+                   mf_table_column, &table, names,
+                   (sections & MF_RESULTS) != 0, NULL, NULL, NULL);
+  } else if (count > 0) {
+    printf("\t%d column names for %d columns.\n", count, table.cols);
+  }
+  free(names);
+  freeMatrix(&table);
+  return ret;
+}
+
+/*****************************************************************************
+ *                                TESTS
+ *****************************************************************************/
+#ifdef UNIT_TEST
+
+void test_mfWrite(void) {
+  printf("Testing mfWrite in matrixFile.c\n");
+  char *file_path = "./matrix_file.yjm";
+  MATRIXS matrix;
+  allocMatrixS(&matrix, 5, 3, MATRIX_FLOAT64, 0);
+  for (int row = 0; row < 5; row++) {
+    for (int col = 0; col < 3; col++) {
+      ((double *)matrix.data)[row * 3 + col] = row * 10 + col;
+    }
+  }
+  for (int col = 0; col < 3; col++) {
+    matrix.lambda[col] = col + 0.5;
+    matrix.errnum[col] = col;
+  }
+  char *names[] = {"bm_0", "bm_1", ""};
+  assert_int_equals(mfWrite(file_path, NULL, names, 0), -1,
+                    "Error: matrix is null, should abort");
+  assert_int_equals(mfWrite(file_path, &matrix, NULL, MF_NAMES), -1,
+                    "Error: names are null, should abort");
+  assert_int_equals(mfWrite(file_path, &matrix, names, MF_NAMES | MF_RESULTS),
+                    0, "Error: should execute");
+  freeMatrixS(&matrix);
+
+  MATRIXFILE file;
+  assert_int_equals(mfOpen(&file, "./no_such_file.yjm", MF_READ), -2,
+                    "Error: file does not exist, should abort");
+  assert_int_equals(mfOpen(&file, file_path, MF_UPDATE), 0,
+                    "Error: should open");
+  assert_int_equals(file.matrix.rows, 5, "Error: rows");
+  assert_int_equals(file.matrix.cols, 3, "Error: cols");
+  assert_int_equals(file.matrix.row_stride, sizeof(double),
+                    "Error: file should be column major");
+  assert_int_equals((size_t)file.matrix.data % MATRIX_ALIGNMENT, 0,
+                    "Error: data is not aligned");
+  assert_int_equals(checkMatrixS(&file.matrix), 0, "Error: invalid matrix");
+  assert_double_equals(((double *)file.matrix.data)[2 * 5 + 4], 42,
+                       "Error: value (4, 2)");
+  assert_double_equals(file.matrix.lambda[2], 2.5, "Error: lambda section");
+  assert_int_equals(file.matrix.errnum[1], 1, "Error: errnum section");
+  assert_int_equals(strcmp(file.names[1], "bm_1"), 0, "Error: names");
+  assert_int_equals(strcmp(file.names[2], ""), 0, "Error: empty name");
+  // MF_UPDATE writes through, MF_READ does not
+  file.matrix.lambda[0] = -1;
+  mfClose(&file);
+  assert_int_equals(mfOpen(&file, file_path, MF_READ), 0,
+                    "Error: should open again");
+  assert_double_equals(file.matrix.lambda[0], -1, "Error: update is lost");
+  file.matrix.lambda[0] = 7;
+  ((double *)file.matrix.data)[0] = 7;
+  mfClose(&file);
+  mfOpen(&file, file_path, MF_READ);
+  assert_double_equals(file.matrix.lambda[0], -1,
+                       "Error: MF_READ changed the file");
+  assert_double_equals(((double *)file.matrix.data)[0], 0,
+                       "Error: MF_READ changed the values");
+  mfClose(&file);
+
+  FILE *wrong = fopen(file_path, "wb");
+  char garbage[sizeof(MFHEADER)] = "YJMATRIY";
+  fwrite(garbage, 1, sizeof(garbage), wrong);
+  fclose(wrong);
+  assert_int_equals(mfOpen(&file, file_path, MF_READ), -3,
+                    "Error: wrong magic, should abort");
+  remove(file_path);
+  printf("...done\n");
+}
+
+void test_mfConvertCsv(void) {
+  printf("Testing mfConvertCsv in matrixFile.c\n");
+  char *csv_path = "./matrix_file.csv";
+  char *file_path = "./matrix_file.yjm";
+  FILE *csv = fopen(csv_path, "w");
+  fprintf(csv, "label,\"bm_0\", bm_1\r\n1.0,2.5,-4\r\n0.0,1e-3,3\r\n");
+  fclose(csv);
+  assert_int_equals(mfConvertCsv(NULL, file_path, 0, 1), -1,
+                    "Error: csv path is null, should abort");
+  assert_int_equals(mfConvertCsv("./no_such_file.csv", file_path, 0, 1), -4,
+                    "Error: csv does not exist, should abort");
+  assert_int_equals(mfConvertCsv(csv_path, file_path, MF_NAMES, 2), 0,
+                    "Error: should execute");
+  MATRIXFILE file;
+  assert_int_equals(mfOpen(&file, file_path, MF_READ), 0,
+                    "Error: should open");
+  assert_int_equals(file.matrix.rows, 2, "Error: rows");
+  assert_int_equals(file.matrix.cols, 3, "Error: cols");
+  assert_int_equals(file.results_in_file, 0, "Error: no result sections");
+  assert_double_equals(((double *)file.matrix.data)[2 * 2], -4,
+                       "Error: value (0, 2)");
+  assert_int_equals(strcmp(file.names[0], "label"), 0, "Error: 1st name");
+  assert_int_equals(strcmp(file.names[1], "bm_0"), 0, "Error: quoted name");
+  assert_int_equals(strcmp(file.names[2], "bm_1"), 0, "Error: blank name");
+  mfClose(&file);
+  remove(csv_path);
+  remove(file_path);
+  printf("...done\n");
+}
+
+/**
+ * @brief appends a .npy file of the values row * 10 + col to buffer
+ *
+ * @return size_t bytes appended
+ */
+static size_t mf_test_npy(char *buffer, const char *descr, int fortran,
+                          const char *shape, int rows, int cols) {
+  char header[128];
+  int length = snprintf(header, sizeof(header),
+                        "{'descr': '%s', 'fortran_order': %s, 'shape': %s, }",
+                        descr, fortran ? "True" : "False", shape);
+  // numpy pads the header with blanks to a multiple of 64 bytes
+  while ((10 + length + 1) % 64 != 0) {
+    header[length++] = ' ';
+  }
+  header[length++] = '\n';
+  memcpy(buffer, "\x93NUMPY\x01\x00", 8);
+  buffer[8] = (char)length;
+  buffer[9] = 0;
+  memcpy(buffer + 10, header, length);
+  size_t size = 10 + length;
+  for (int i = 0; i < rows * cols; i++) {
+    int row = fortran ? i % rows : i / cols;
+    int col = fortran ? i / rows : i % cols;
+    if (descr[2] == '4') {
+      float value = (float)(row * 10 + col);
+      memcpy(buffer + size, &value, sizeof(float));
+      size += sizeof(float);
+    } else {
+      double value = row * 10 + col;
+      memcpy(buffer + size, &value, sizeof(double));
+      size += sizeof(double);
+    }
+  }
+  return size;
+}
+
+static void mf_test_put(unsigned char *bytes, unsigned long long value,
+                        int count) {
+  for (int i = 0; i < count; i++) {
+    bytes[i] = (unsigned char)(value >> (8 * i));
+  }
+}
+
+static void mf_test_write(const char *file_path, const char *buffer,
+                          size_t size) {
+  FILE *file = fopen(file_path, "wb");
+  fwrite(buffer, 1, size, file);
+  fclose(file);
+}
+
+void test_mfOpenArray(void) {
+  printf("Testing mfOpenArray in matrixFile.c\n");
+  char *npy_path = "./matrix_file.npy";
+  char *npz_path = "./matrix_file.npz";
+  char *yjm_path = "./matrix_file.yjm";
+  static char buffer[4096];
+  MATRIXFILE file;
+
+  // crafted header of a matrix file: a negative size of the names section
+  MATRIXS matrix;
+  allocMatrixS(&matrix, 2, 3, MATRIX_FLOAT64, 1);
+  char *names[] = {"bm_0", "bm_1", "bm_2"};
+  mfWrite(yjm_path, &matrix, names, MF_NAMES);
+  freeMatrixS(&matrix);
+  FILE *yjm = fopen(yjm_path, "r+b");
+  long long names_size = -(1LL << 40);
+  fseek(yjm, offsetof(MFHEADER, names_size), SEEK_SET);
+  fwrite(&names_size, sizeof(names_size), 1, yjm);
+  fclose(yjm);
+  assert_int_equals(mfOpen(&file, yjm_path, MF_READ), -3,
+                    "Error: negative names size, should abort");
+  remove(yjm_path);
+
+  size_t size = mf_test_npy(buffer, "<f8", 0, "(2, 3)", 2, 3);
+  mf_test_write(npy_path, buffer, size);
+  assert_int_equals(mfOpenArray(NULL, npy_path, NULL, MF_READ), -1,
+                    "Error: file is null, should abort");
+  assert_int_equals(mfOpen(&file, npy_path, MF_UPDATE), 0,
+                    "Error: should open C order .npy");
+  assert_int_equals(file.matrix.rows, 2, "Error: rows");
+  assert_int_equals(file.matrix.cols, 3, "Error: cols");
+  assert_int_equals(file.matrix.col_stride, sizeof(double),
+                    "Error: .npy should be row major");
+  assert_int_equals(file.copy == NULL, 1, "Error: .npy should be mapped");
+  assert_int_equals(checkMatrixS(&file.matrix), 0, "Error: invalid matrix");
+  assert_double_equals(((double *)file.matrix.data)[1 * 3 + 2], 12,
+                       "Error: value (1, 2)");
+  ((double *)file.matrix.data)[0] = -1;
+  mfClose(&file);
+  mfOpen(&file, npy_path, MF_READ);
+  assert_double_equals(((double *)file.matrix.data)[0], -1,
+                       "Error: update of the .npy is lost");
+  mfClose(&file);
+
+  size = mf_test_npy(buffer, "<f4", 1, "(3,)", 3, 1);
+  mf_test_write(npy_path, buffer, size);
+  assert_int_equals(mfOpen(&file, npy_path, MF_READ), 0,
+                    "Error: should open 1d float32 .npy");
+  assert_int_equals(file.matrix.rows, 3, "Error: rows of 1d array");
+  assert_int_equals(file.matrix.cols, 1, "Error: cols of 1d array");
+  assert_int_equals(file.matrix.dtype, MATRIX_FLOAT32, "Error: dtype");
+  assert_double_equals(((float *)file.matrix.data)[2], 20,
+                       "Error: value (2, 0)");
+  mfClose(&file);
+
+  size = mf_test_npy(buffer, ">f8", 0, "(2, 3)", 2, 3);
+  mf_test_write(npy_path, buffer, size);
+  assert_int_equals(mfOpen(&file, npy_path, MF_READ), -5,
+                    "Error: foreign byte order, should abort");
+  size = mf_test_npy(buffer, "<f8", 0, "(1, 2, 3)", 0, 0);
+  mf_test_write(npy_path, buffer, size);
+  assert_int_equals(mfOpen(&file, npy_path, MF_READ), -5,
+                    "Error: three dimensions, should abort");
+  size = mf_test_npy(buffer, "<f8", 0, "(4, 3)", 2, 3);
+  mf_test_write(npy_path, buffer, size);
+  assert_int_equals(mfOpen(&file, npy_path, MF_READ), -3,
+                    "Error: truncated .npy, should abort");
+
+  // stored .npz with the members a.npy, bm.npy and a compressed c.npy
+  const char *members[] = {"a.npy", "bm.npy", "c.npy"};
+  size_t offsets[3];
+  size_t lengths[3];
+  static char npy[1024];
+  size = 0;
+  for (int i = 0; i < 3; i++) {
+    lengths[i] = i == 1 ? mf_test_npy(npy, "<f8", 1, "(2, 3)", 2, 3)
+                        : mf_test_npy(npy, "<f4", 0, "(2, 3)", 2, 3);
+    unsigned char *local = (unsigned char *)buffer + size;
+    memset(local, 0, 30);
+    mf_test_put(local, 0x04034b50, 4);
+    mf_test_put(local + 18, lengths[i], 4);
+    mf_test_put(local + 22, lengths[i], 4);
+    mf_test_put(local + 26, strlen(members[i]), 2);
+    memcpy(local + 30, members[i], strlen(members[i]));
+    offsets[i] = size;
+    size += 30 + strlen(members[i]);
+    memcpy(buffer + size, npy, lengths[i]);
+    size += lengths[i];
+  }
+  size_t directory = size;
+  for (int i = 0; i < 3; i++) {
+    unsigned char *entry = (unsigned char *)buffer + size;
+    memset(entry, 0, 46);
+    mf_test_put(entry, 0x02014b50, 4);
+    mf_test_put(entry + 10, i == 2 ? 8 : 0, 2);
+    mf_test_put(entry + 20, lengths[i], 4);
+    mf_test_put(entry + 24, lengths[i], 4);
+    mf_test_put(entry + 28, strlen(members[i]), 2);
+    mf_test_put(entry + 42, offsets[i], 4);
+    memcpy(entry + 46, members[i], strlen(members[i]));
+    size += 46 + strlen(members[i]);
+  }
+  unsigned char *record = (unsigned char *)buffer + size;
+  memset(record, 0, 22);
+  mf_test_put(record, 0x06054b50, 4);
+  mf_test_put(record + 8, 3, 2);
+  mf_test_put(record + 10, 3, 2);
+  mf_test_put(record + 12, size - directory, 4);
+  mf_test_put(record + 16, directory, 4);
+  mf_test_write(npz_path, buffer, size + 22);
+
+  assert_int_equals(mfOpenArray(&file, npz_path, "bm", MF_READ), 0,
+                    "Error: should open .npz array");
+  assert_int_equals(file.matrix.row_stride, sizeof(double),
+                    "Error: Fortran order should be column major");
+  assert_int_equals(checkMatrixS(&file.matrix), 0, "Error: invalid matrix");
+  assert_double_equals(((double *)file.matrix.data)[2 * 2 + 1], 12,
+                       "Error: .npz value (1, 2)");
+  mfClose(&file);
+  assert_int_equals(mfOpen(&file, npz_path, MF_READ), 0,
+                    "Error: should open the first .npz array");
+  assert_int_equals(file.matrix.dtype, MATRIX_FLOAT32, "Error: first array");
+  assert_int_equals(file.copy != NULL, 1,
+                    "Error: unaligned array should be copied");
+  assert_double_equals(((float *)file.matrix.data)[1 * 3 + 2], 12,
+                       "Error: first array value (1, 2)");
+  mfClose(&file);
+  assert_int_equals(mfOpen(&file, npz_path, MF_UPDATE), -6,
+                    "Error: unaligned array can not be updated");
+  assert_int_equals(mfOpenArray(&file, npz_path, "b", MF_READ), -3,
+                    "Error: no such array, should abort");
+  assert_int_equals(mfOpenArray(&file, npz_path, "c", MF_READ), -5,
+                    "Error: compressed array, should abort");
+
+  // one member with its size and offset in a zip64 extra field: valid, with
+  // an offset that overflows the bounds check (2^64 - 10), and declared with
+  // 8 bytes, too short for both values
+  for (int variant = 0; variant < 3; variant++) {
+    int declared = variant == 2 ? 8 : 16;
+    lengths[0] = mf_test_npy(npy, "<f8", 0, "(2, 3)", 2, 3);
+    unsigned char *local = (unsigned char *)buffer;
+    memset(local, 0, 30);
+    mf_test_put(local, 0x04034b50, 4);
+    mf_test_put(local + 26, 5, 2);
+    memcpy(local + 30, "z.npy", 5);
+    memcpy(buffer + 35, npy, lengths[0]);
+    directory = 35 + lengths[0];
+    unsigned char *entry = (unsigned char *)buffer + directory;
+    memset(entry, 0, 46 + 5 + 4 + 16);
+    mf_test_put(entry, 0x02014b50, 4);
+    mf_test_put(entry + 20, 0xFFFFFFFF, 4);
+    mf_test_put(entry + 24, lengths[0], 4);
+    mf_test_put(entry + 28, 5, 2);
+    mf_test_put(entry + 30, 4 + declared, 2);
+    mf_test_put(entry + 42, 0xFFFFFFFF, 4);
+    memcpy(entry + 46, "z.npy", 5);
+    mf_test_put(entry + 51, 0x0001, 2);
+    mf_test_put(entry + 53, declared, 2);
+    mf_test_put(entry + 55, lengths[0], 4); // 64 bit compressed size
+    if (variant == 1) {
+      mf_test_put(entry + 63, 0xFFFFFFFFFFFFFFF6ULL, 8); // local offset
+    }
+    size = directory + 46 + 5 + 4 + declared;
+    record = (unsigned char *)buffer + size;
+    memset(record, 0, 22);
+    mf_test_put(record, 0x06054b50, 4);
+    mf_test_put(record + 8, 1, 2);
+    mf_test_put(record + 10, 1, 2);
+    mf_test_put(record + 12, size - directory, 4);
+    mf_test_put(record + 16, directory, 4);
+    mf_test_write(npz_path, buffer, size + 22);
+    if (variant == 0) {
+      assert_int_equals(mfOpenArray(&file, npz_path, "z", MF_READ), 0,
+                        "Error: should open zip64 .npz array");
+      assert_double_equals(((double *)file.matrix.data)[1 * 3 + 2], 12,
+                           "Error: zip64 value (1, 2)");
+      mfClose(&file);
+    } else if (variant == 1) {
+      assert_int_equals(mfOpenArray(&file, npz_path, "z", MF_READ), -3,
+                        "Error: zip64 offset out of the file, should abort");
+    } else {
+      assert_int_equals(mfOpenArray(&file, npz_path, "z", MF_READ), -3,
+                        "Error: zip64 field too short, should abort");
+    }
+  }
+  remove(npy_path);
+  remove(npz_path);
+  printf("...done\n");
+}
+#endif
@@ -27,10 +27,16 @@
 /*****************************************************************************
  *                               INCLUDES
  *****************************************************************************/
+#include "include/comInterface.h"
+#include "include/decimalParse.h"
 #include "include/lambdaSearch.h"
+#include "include/matrixFile.h"
 #include "include/testFramework.h"
+#include "include/threadPool.h"
 #include "include/vectorImports.h"
 #include "include/yeoJohnson.h"
+#include "include/yjBatch.h"
+#include "include/yjStream.h"
 
 /*****************************************************************************
  *                                TESTS
@@ -67,6 +73,12 @@ void test_super_yj(void) {
   test_yjCalculationf();
   test_yjCalculationU();
   test_yjCalculationUf();
+  test_yjCalculationCtx();
+  test_yjInverseCalculation();
+  test_yjValidateColumnCtx();
+  test_yjTransformCached();
+  test_yjMomentsCached();
+  test_yjMomentsCachedBatch();
 }
 
 /**
@@ -74,11 +86,9 @@ void test_super_yj(void) {
  *
  */
 void test_super_vi(void) {
-  test_getMatrixSizeFromCsv();
-  test_fillMatrixFromCsv();
-  test_fillMatrixFromCsvf();
   test_importVectorTableFromCsv();
-  test_importVectorTableFromCsvf();
+  test_importVectorTableFromCsvParallel();
+  test_allocMatrixS();
 }
 
 /**
@@ -113,5 +123,63 @@ void test_super_ls(void) {
   test_lsLambdaSearchf();
   test_lsLambdaSearchU();
   test_lsLambdaSearchUf();
+  test_lsLambdaBatch();
+  test_lsBrentSearch();
+  test_lsMleSearch();
+  test_lsRowParts();
+  test_lsScratchStats();
+  test_lsSmartBowleySearch();
 }
-#endif
\ No newline at end of file
+
+/**
+ * @brief super test for yjBatch.c, tests all functions in yjBatch.c
+ *
+ */
+void test_super_yb(void) {
+  test_ybTransform();
+  test_ybTransformf();
+  test_ybTransformRows();
+  test_ybInverseTransform();
+}
+
+/**
+ * @brief super test for threadPool.c, tests all functions in threadPool.c
+ *
+ */
+void test_super_tp(void) {
+  test_tpRun();
+  test_tpRangeClaim();
+}
+
+/**
+ * @brief super test for decimalParse.c, tests all functions in decimalParse.c
+ *
+ */
+void test_super_dp(void) { test_dpParseDouble(); }
+
+/**
+ * @brief super test for matrixFile.c, tests all functions in matrixFile.c
+ *
+ */
+void test_super_mf(void) {
+  test_mfWrite();
+  test_mfConvertCsv();
+  test_mfOpenArray();
+}
+
+/**
+ * @brief super test for yjStream.c, tests all functions in yjStream.c
+ *
+ */
+void test_super_ys(void) { test_ysStreamOperation(); }
+
+/**
+ * @brief super test for comInterface.c, tests all functions in comInterface.c
+ *
+ */
+void test_super_ci(void) {
+  test_ci_finish_column();
+  test_ci_model_inverse();
+  test_ciModel();
+}
+#endif
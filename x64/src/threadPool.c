@@ -0,0 +1,560 @@
+/****************************************************************
+ * Copyright (c) 2023 Jerome Brenig, Sigrun May
+ * Ostfalia Hochschule für angewandte Wissenschaften
+ *
+ * This software is distributed under the terms of the MIT license
+ * which is available at https://opensource.org/licenses/MIT
+ *
+ * FILENAME : threadPool.c
+ *
+ * DESCRIPTION  :
+ *          Library owned worker threads that live across calls, shared by
+ *          the threaded ci* entry points.
+ *
+ * PUBLIC FUNCTIONS :
+ *          int tpInit(int thread_count)
+ *          void tpShutdown(void)
+ *          int tpGetSize(void)
+ *          int tpRun(tpTask task, void *args, int part_count)
+ *          void tpRangeInit(tpRange *range, int count, int parts)
+ *          int tpRangeClaim(tpRange *range, int *begin, int *end)
+ *
+ * NOTES    :
+ *          A pool of size n runs a job on n - 1 workers and the calling
+ *          thread. tpRun splits a job into part_count parts that the threads
+ *          claim one after another, so a job may have more or fewer parts
+ *          than the pool has threads. The pool starts with the default size
+ *          (online processors) on the first tpRun unless tpInit was called.
+ *          Jobs of concurrent callers run side by side: the workers help
+ *          with the oldest job that has unclaimed parts and every caller
+ *          claims parts of its own job, so a caller never waits for the
+ *          job of another one to finish. tpRun from inside a part runs the
+ *          nested job on the current thread.
+ *          Parts that share a tpRange pull their indices from it instead of
+ *          owning a fixed share, a part that finishes early claims more.
+ *
+ * AUTHOR   :       agent             START DATE    : 16 October 2026
+ *
+ * CHANGES  :
+ *
+ * DATE     WHO     DETAIL
+ *
+ *H*/
+
+/*****************************************************************************
+ *                               INCLUDES
+ *****************************************************************************/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "include/testFramework.h"
+#include "include/threadPool.h"
+
+/*****************************************************************************
+ *                               CONSTANTS
+ *****************************************************************************/
+
+// pool size if the number of processors is unknown
+static const int g_fallbackSize = 4;
+
+/*****************************************************************************
+ *                               TYPES
+ *****************************************************************************/
+
+// a job of a tpRun caller, lives on the caller's stack
+typedef struct _tpJob {
+  tpTask task;
+  void *args;
+  int part_count;
+  int next_part;       // first unclaimed part
+  int done_parts;      // parts that returned
+  struct _tpJob *next; // next job in the queue
+} tpJob;
+
+/*****************************************************************************
+ *                               GLOBALS
+ *****************************************************************************/
+
+// held for reading by tpRun and tpGetSize, for writing by tpInit and
+// tpShutdown, so the pool is not restarted under a running job
+static pthread_rwlock_t g_poolLock = PTHREAD_RWLOCK_INITIALIZER;
+
+// guards everything below, workers wait on g_wake, callers on g_finished
+static pthread_mutex_t g_stateLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_wake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t g_finished = PTHREAD_COND_INITIALIZER;
+
+static pthread_t *g_workers = NULL;
+static int g_workerCount = 0;
+static int g_started = 0;
+static int g_stop = 0;
+
+// jobs with unclaimed parts, oldest first
+static tpJob *g_jobs = NULL;
+static tpJob *g_lastJob = NULL;
+
+// 1 while the thread runs a part, nested jobs then run inline
+static __thread int t_inPart = 0;
+
+/*****************************************************************************
+ *                           PRIVATE FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * @brief removes a job from the queue, called with g_stateLock held
+ *
+ * @param job queued job
+ */
+static void tp_unlink(tpJob *job) {
+  tpJob *previous = NULL;
+  tpJob *current = g_jobs;
+  while (current != job) {
+    previous = current;
+    current = current->next;
+  }
+  if (previous == NULL) {
+    g_jobs = job->next;
+  } else {
+    previous->next = job->next;
+  }
+  if (g_lastJob == job) {
+    g_lastJob = previous;
+  }
+  job->next = NULL;
+}
+
+/**
+ * @brief claims and runs parts of job until none are left, the claim of the
+ * last part takes the job out of the queue. Called with g_stateLock held and
+ * returns with it held; job is not touched once its last part is done, its
+ * caller may return then.
+ *
+ * @param job job to help with
+ */
+static void tp_run_parts(tpJob *job) {
+  tpTask task = job->task;
+  void *args = job->args;
+  int part_count = job->part_count;
+  while (job->next_part < part_count) {
+    int part = job->next_part++;
+    if (job->next_part == part_count) {
+      tp_unlink(job);
+    }
+    pthread_mutex_unlock(&g_stateLock);
+    t_inPart = 1;
+    task(args, part, part_count);
+    t_inPart = 0;
+    pthread_mutex_lock(&g_stateLock);
+    if (++job->done_parts == part_count) {
+      pthread_cond_broadcast(&g_finished);
+      return;
+    }
+  }
+}
+
+/**
+ * @brief worker thread, helps with the oldest queued job until the pool stops
+ *
+ * @param args unused
+ * @return void* always NULL
+ */
+static void *tp_worker(void *args) {
+  (void)args;
+  pthread_mutex_lock(&g_stateLock);
+  while (1) {
+    while (!g_stop && g_jobs == NULL) {
+      pthread_cond_wait(&g_wake, &g_stateLock);
+    }
+    if (g_stop) {
+      break;
+    }
+    tp_run_parts(g_jobs);
+  }
+  pthread_mutex_unlock(&g_stateLock);
+  return NULL;
+}
+
+/**
+ * @brief number of online processors, the default pool size
+ *
+ * @return int default pool size
+ */
+static int tp_default_size(void) {
+#ifdef _SC_NPROCESSORS_ONLN
+  long processors = sysconf(_SC_NPROCESSORS_ONLN);
+  if (processors > 0) {
+    return processors;
+  }
+#endif
+  return g_fallbackSize;
+}
+
+/**
+ * @brief starts the workers of a pool of thread_count threads, called with
+ * g_poolLock held for writing on a stopped pool
+ *
+ * @param thread_count pool size including the calling thread
+ * @return int 0, -1 if not every worker could be started
+ */
+static int tp_start(int thread_count) {
+  g_workerCount = 0;
+  g_started = 1;
+  g_stop = 0;
+  if (thread_count <= 1) {
+    return 0;
+  }
+  g_workers = malloc(sizeof(pthread_t) * (thread_count - 1));
+  if (g_workers == NULL) {
+    // printf("Not enough memory for thread creation\n");
+    return -1;
+  }
+  for (int i = 0; i < thread_count - 1; i++) {
+    if (pthread_create(&g_workers[i], NULL, &tp_worker, NULL) != 0) {
+      return -1; // the pool keeps the workers started so far
+    }
+    g_workerCount++;
+  }
+  return 0;
+}
+
+/**
+ * @brief stops and joins the workers, called with g_poolLock held for
+ * writing
+ */
+static void tp_stop(void) {
+  pthread_mutex_lock(&g_stateLock);
+  g_stop = 1;
+  pthread_cond_broadcast(&g_wake);
+  pthread_mutex_unlock(&g_stateLock);
+  for (int i = 0; i < g_workerCount; i++) {
+    pthread_join(g_workers[i], NULL);
+  }
+  free(g_workers);
+  g_workers = NULL;
+  g_workerCount = 0;
+  g_started = 0;
+  g_stop = 0;
+}
+
+/*****************************************************************************
+ *                           PUBLIC FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * @brief (re)starts the pool with thread_count threads, including the thread
+ * calling tpRun; waits for the running jobs
+ *
+ * @param thread_count pool size, 0 for the default size (online processors)
+ * @return int 0, -1 on an invalid size or if not every worker could be
+ * started (the pool then runs with fewer threads)
+ */
+int tpInit(int thread_count) {
+  if (thread_count < 0 || t_inPart) {
+    return -1;
+  }
+  if (thread_count == 0) {
+    thread_count = tp_default_size();
+  }
+  pthread_rwlock_wrlock(&g_poolLock);
+  if (g_started) {
+    tp_stop();
+  }
+  int ret = tp_start(thread_count);
+  pthread_rwlock_unlock(&g_poolLock);
+  return ret;
+}
+
+/**
+ * @brief stops the pool and releases its threads; waits for the running jobs.
+ * The next tpRun starts a pool of the default size again.
+ */
+void tpShutdown(void) {
+  if (t_inPart) {
+    return;
+  }
+  pthread_rwlock_wrlock(&g_poolLock);
+  if (g_started) {
+    tp_stop();
+  }
+  pthread_rwlock_unlock(&g_poolLock);
+}
+
+/**
+ * @brief threads of the running pool, including the calling thread
+ *
+ * @return int pool size, 0 if the pool is not started
+ */
+int tpGetSize(void) {
+  pthread_rwlock_rdlock(&g_poolLock);
+  int size = g_started ? g_workerCount + 1 : 0;
+  pthread_rwlock_unlock(&g_poolLock);
+  return size;
+}
+
+/**
+ * @brief runs task(args, part, part_count) for every part in
+ * [0, part_count) on the pool and the calling thread and returns when all
+ * parts are done. Jobs of concurrent callers are queued and share the
+ * workers, each caller works on its own job too.
+ *
+ * @param task function run once per part
+ * @param args shared argument of all parts
+ * @param part_count amount of parts
+ * @return int 0, -1 on an invalid part count
+ */
+int tpRun(tpTask task, void *args, int part_count) {
+  if (part_count <= 0 || task == NULL) {
+    return -1;
+  }
+  if (t_inPart || part_count == 1) {
+    for (int part = 0; part < part_count; part++) {
+      task(args, part, part_count);
+    }
+    return 0;
+  }
+  pthread_rwlock_rdlock(&g_poolLock);
+  while (!g_started) {
+    pthread_rwlock_unlock(&g_poolLock);
+    pthread_rwlock_wrlock(&g_poolLock);
+    if (!g_started) {
+      tp_start(tp_default_size());
+    }
+    pthread_rwlock_unlock(&g_poolLock);
+    pthread_rwlock_rdlock(&g_poolLock);
+  }
+  tpJob job = {task, args, part_count, 0, 0, NULL};
+  pthread_mutex_lock(&g_stateLock);
+  if (g_lastJob == NULL) {
+    g_jobs = &job;
+  } else {
+    g_lastJob->next = &job;
+  }
+  g_lastJob = &job;
+  pthread_cond_broadcast(&g_wake);
+  tp_run_parts(&job);
+  while (job.done_parts < part_count) {
+    pthread_cond_wait(&g_finished, &g_stateLock);
+  }
+  pthread_mutex_unlock(&g_stateLock);
+  pthread_rwlock_unlock(&g_poolLock);
+  return 0;
+}
+
+/**
+ * @brief sets up a range of count indices shared by parts parts
+ *
+ * @param range range to set up
+ * @param count indices [0, count)
+ * @param parts parts claiming from the range
+ */
+void tpRangeInit(tpRange *range, int count, int parts) {
+  range->next = 0;
+  range->count = count > 0 ? count : 0;
+  range->parts = parts > 0 ? parts : 1;
+}
+
+/**
+ * @brief claims the next chunk [begin, end) of the range; safe to call from
+ * all parts at once. A chunk is the unclaimed rest divided by twice the parts
+ * (at least 1), so the chunks start large and shrink to single indices at the
+ * end, where a long index would otherwise leave the other parts idle.
+ *
+ * @param range shared range
+ * @param begin first claimed index
+ * @param end index after the last claimed one
+ * @return int 1 if a chunk was claimed, 0 if the range is exhausted
+ */
+int tpRangeClaim(tpRange *range, int *begin, int *end) {
+  int next = __atomic_load_n(&range->next, __ATOMIC_RELAXED);
+  while (next < range->count) {
+    int chunk = (range->count - next) / (2 * range->parts);
+    if (chunk < 1) {
+      chunk = 1;
+    }
+    if (__atomic_compare_exchange_n(&range->next, &next, next + chunk, 1,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+      *begin = next;
+      *end = next + chunk;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/*****************************************************************************
+ *                                TESTS
+ *****************************************************************************/
+#ifdef UNIT_TEST
+
+typedef struct {
+  int marks[64];
+  int nested[64];
+} test_tpArgs;
+
+static void test_tpNested(void *args, int part, int part_count) {
+  ((int *)args)[part] = part_count;
+}
+
+static void test_tpTask(void *args, int part, int part_count) {
+  test_tpArgs *test = (test_tpArgs *)args;
+  __atomic_fetch_add(&test->marks[part], 1, __ATOMIC_RELAXED);
+  if (part == 0) {
+    tpRun(test_tpNested, test->nested, 3);
+  }
+}
+
+typedef struct {
+  test_tpArgs parts;
+  int *started;   // flags of both callers
+  int caller;     // index of this caller's flag
+  int overlapped; // 1 if the other job ran meanwhile
+} test_tpCallerArgs;
+
+static void test_tpMeetTask(void *args, int part, int part_count) {
+  test_tpCallerArgs *test = (test_tpCallerArgs *)args;
+  __atomic_fetch_add(&test->parts.marks[part], 1, __ATOMIC_RELAXED);
+  if (part != 0) {
+    return;
+  }
+  __atomic_store_n(&test->started[test->caller], 1, __ATOMIC_RELEASE);
+  // waits up to 2 s for part 0 of the other caller's job
+  struct timespec pause = {0, 1000000};
+  for (int i = 0; i < 2000; i++) {
+    if (__atomic_load_n(&test->started[1 - test->caller], __ATOMIC_ACQUIRE)) {
+      test->overlapped = 1;
+      return;
+    }
+    nanosleep(&pause, NULL);
+  }
+}
+
+static void *test_tpCaller(void *args) {
+  test_tpCallerArgs *test = (test_tpCallerArgs *)args;
+  for (int i = 0; i < 64; i++) {
+    test->parts.marks[i] = 0;
+  }
+  tpRun(test_tpMeetTask, test, 37);
+  return NULL;
+}
+
+// jobs of two callers have to run at the same time, even on a pool without
+// workers, where every caller runs its own parts
+static void test_tp_concurrent(void) {
+  int sizes[2] = {1, 4};
+  for (int s = 0; s < 2; s++) {
+    static int started[2];
+    static test_tpCallerArgs callers[2];
+    pthread_t threads[2];
+    tpInit(sizes[s]);
+    started[0] = 0;
+    started[1] = 0;
+    for (int c = 0; c < 2; c++) {
+      callers[c].started = started;
+      callers[c].caller = c;
+      callers[c].overlapped = 0;
+      pthread_create(&threads[c], NULL, &test_tpCaller, &callers[c]);
+    }
+    for (int c = 0; c < 2; c++) {
+      pthread_join(threads[c], NULL);
+      assert_int_equals(callers[c].overlapped, 1,
+                        "Error: jobs of concurrent callers should overlap");
+      for (int i = 0; i < 64; i++) {
+        assert_int_equals(callers[c].parts.marks[i], i < 37,
+                          "Error: every part should run once");
+      }
+    }
+  }
+}
+
+void test_tpRun(void) {
+  printf("Testing tpRun in threadPool.c\n");
+  static test_tpArgs test;
+  int sizes[3] = {1, 3, 8};
+  for (int s = 0; s < 3; s++) {
+    assert_int_equals(tpInit(sizes[s]), 0, "Error: should start");
+    assert_int_equals(tpGetSize(), sizes[s], "Error: wrong pool size");
+    for (int part_count = 1; part_count <= 64; part_count *= 4) {
+      for (int i = 0; i < 64; i++) {
+        test.marks[i] = 0;
+        test.nested[i] = 0;
+      }
+      assert_int_equals(tpRun(test_tpTask, &test, part_count), 0,
+                        "Error: should execute");
+      for (int i = 0; i < 64; i++) {
+        assert_int_equals(test.marks[i], i < part_count,
+                          "Error: every part should run once");
+      }
+      assert_int_equals(test.nested[2], 3, "Error: nested job should run");
+    }
+  }
+  tpShutdown();
+  assert_int_equals(tpGetSize(), 0, "Error: pool should be stopped");
+  assert_int_equals(tpRun(test_tpTask, &test, 5), 0, "Error: should restart");
+  assert_int_equals(tpGetSize() > 0, 1, "Error: default pool should start");
+  assert_int_equals(tpRun(test_tpTask, &test, 0), -1, "Error: should abort");
+  assert_int_equals(tpInit(-1), -1, "Error: should abort");
+  test_tp_concurrent();
+  printf("...done\n");
+}
+
+typedef struct {
+  tpRange range;
+  int marks[1000];
+  int chunks;
+} test_tpRangeArgs;
+
+static void test_tpRangeTask(void *args, int part, int part_count) {
+  test_tpRangeArgs *test = (test_tpRangeArgs *)args;
+  int begin = 0;
+  int end = 0;
+  while (tpRangeClaim(&test->range, &begin, &end)) {
+    __atomic_fetch_add(&test->chunks, 1, __ATOMIC_RELAXED);
+    for (int i = begin; i < end; i++) {
+      __atomic_fetch_add(&test->marks[i], 1, __ATOMIC_RELAXED);
+    }
+  }
+}
+
+void test_tpRangeClaim(void) {
+  printf("Testing tpRangeClaim in threadPool.c\n");
+  static test_tpRangeArgs test;
+  int counts[4] = {0, 1, 7, 1000};
+  assert_int_equals(tpInit(4), 0, "Error: should start");
+  for (int c = 0; c < 4; c++) {
+    for (int parts = 1; parts <= 16; parts *= 4) {
+      for (int i = 0; i < 1000; i++) {
+        test.marks[i] = 0;
+      }
+      test.chunks = 0;
+      tpRangeInit(&test.range, counts[c], parts);
+      assert_int_equals(tpRun(test_tpRangeTask, &test, parts), 0,
+                        "Error: should execute");
+      for (int i = 0; i < 1000; i++) {
+        assert_int_equals(test.marks[i], i < counts[c],
+                          "Error: every index should be claimed once");
+      }
+      assert_int_equals(test.chunks <= counts[c], 1,
+                        "Error: chunks should not be empty");
+    }
+  }
+  // the first chunk is the rest divided by twice the parts
+  int begin = 0;
+  int end = 0;
+  tpRangeInit(&test.range, 1000, 1);
+  assert_int_equals(tpRangeClaim(&test.range, &begin, &end), 1,
+                    "Error: should claim");
+  assert_int_equals(end - begin, 500, "Error: wrong first chunk");
+  tpRangeInit(&test.range, 1000, 4);
+  tpRangeClaim(&test.range, &begin, &end);
+  assert_int_equals(end - begin, 125, "Error: wrong first chunk");
+  tpRangeInit(&test.range, 3, 4);
+  tpRangeClaim(&test.range, &begin, &end);
+  assert_int_equals(end - begin, 1, "Error: chunks should hold one index");
+  tpShutdown();
+  printf("...done\n");
+}
+#endif
@@ -11,10 +11,22 @@
  *          Utilities to import vector data from .csv and python dataframe.
  *
  * PUBLIC FUNCTIONS :
- * int importVectorTableFromCsv(char *file_path, MATRIXF **vector_list)
+ * int importVectorTableFromCsv(char *file_path, MATRIX **vector_list)
+ * int importVectorTableFromCsvParallel(char *file_path, MATRIX **vector_list,
+ *                                      int thread_count, double *throughput)
+ * int importColumnNamesFromCsv(char *file_path, char ***names, int *count)
+ * void freeMatrix(MATRIX *matrix)
+ * int allocMatrixS(MATRIXS *matrix, int rows, int cols, int dtype,
+ *                  int column_major)
+ * void freeMatrixS(MATRIXS *matrix)
+ * int checkMatrixS(const MATRIXS *matrix)
  *
  * NOTES    :
- *
+ *          The csv import maps the file into memory and runs two passes over
+ *          it on the thread pool, one counting rows and fields and one
+ *          parsing the fields into the columns. Row boundaries are found by
+ *          every part itself, behind the first EOL of its share of the file.
+ *          Fields are parsed by dpParseDouble, independent of the locale.
  *
  * AUTHOR   :       jbrenig           START DATE    : 07 September 2022
  *
@@ -28,118 +40,289 @@
  *                               INCLUDES
  *****************************************************************************/
 
+#include <limits.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
+#include "include/decimalParse.h"
 #include "include/testFramework.h"
+#include "include/threadPool.h"
 #include "include/vectorImports.h"
 
 /*****************************************************************************
  *                           PRIVATE FUNCTIONS
  *****************************************************************************/
 
+// bytes per part of a csv import at least, smaller files are parsed by fewer
+// parts
+#define CSV_MIN_PART_SIZE (1 << 16)
+
+// rows [begin, end) of a csv, counted and parsed by one part of a CSVJOB
+typedef struct _CSVPART {
+  const char *begin; // first row
+  const char *end;   // behind the last row
+  int rows;
+  int cols;      // fields of the longest row
+  int first_row; // row of begin in the matrix
+  int errnum;    // -1 on a field that is not a number
+} CSVPART;
+
+// csv import on the thread pool, one CSVPART per part
+typedef struct _CSVJOB {
+  const char *text; // whole file behind the header
+  size_t size;
+  char separator; // SEMICOLON or KOMMA
+  CSVPART *parts;
+  MATRIX *matrix; // NULL while the rows are counted
+} CSVJOB;
+
 /**
- * @brief Get the Matrix Size From Csv object, last row of csv needs to end with
- * EOL
+ * @brief wall clock for the import throughput; clock() of timeStamps.c adds
+ * up the time of all threads
  *
- * @param file csv to be read and interpreted
- * @param column_size resulting amount of columns
- * @param row_size resulting amount of rows
- * @return int error return code
+ * @return double seconds
  */
-static int getMatrixSizeFromCsv(FILE *file, int *column_size, int *row_size) {
-  *row_size = 0;
-  *column_size = 0;
+static double csv_seconds(void) {
+  struct timespec now;
+#ifdef _WIN32
+  timespec_get(&now, TIME_UTC);
+#else
+  clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief maps a file read only into memory, read in one piece where mmap is
+ * not available
+ *
+ * @param file_path file to be mapped
+ * @param text receives the content, NULL for an empty file
+ * @param size receives the size in bytes
+ * @return int 0, -1 if the file can not be opened or mapped
+ */
+static int csv_map(const char *file_path, char **text, size_t *size) {
+  *text = NULL;
+  *size = 0;
+#ifdef _WIN32
+  FILE *file = fopen(file_path, "rb");
   if (file == NULL) {
-    printf("\tfile passed is null.\n");
     return -1;
   }
-  int next_char;
-  int column_counter = 0;
-  while ((next_char = fgetc(file)) != EOF) {
-    if (next_char == DOT) {
-      printf("\tWrong format, pls use \',\' as decimal point and \';\' as "
-             "seperator\n");
-      return -2;
+  if (fseek(file, 0, SEEK_END) != 0) {
+    fclose(file);
+    return -1;
+  }
+  long length = ftell(file);
+  rewind(file);
+  if (length > 0) {
+    *text = (char *)malloc((size_t)length);
+    if (*text == NULL || fread(*text, 1, (size_t)length, file) !=
+                             (size_t)length) {
+      free(*text);
+      *text = NULL;
+      fclose(file);
+      return -1;
     }
-    if (next_char == SEMICOLON) { // next_char == KOMMA ||
-      column_counter++;
-    } else if (next_char == EOL) {
-      (*row_size)++;
-      column_counter++;
-      if (column_counter > *column_size) {
-        *column_size = column_counter;
-      }
-      column_counter = 0;
+    *size = (size_t)length;
+  }
+  fclose(file);
+#else
+  int file = open(file_path, O_RDONLY);
+  if (file < 0) {
+    return -1;
+  }
+  struct stat status;
+  if (fstat(file, &status) != 0) {
+    close(file);
+    return -1;
+  }
+  if (status.st_size > 0) {
+    void *mapping =
+        mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    if (mapping == MAP_FAILED) {
+      close(file);
+      return -1;
     }
+    // the parts read the file at once, not front to back
+    madvise(mapping, (size_t)status.st_size, MADV_WILLNEED);
+    *text = (char *)mapping;
+    *size = (size_t)status.st_size;
   }
-  rewind(file);
+  close(file);
+#endif
   return 0;
 }
 
 /**
- * @brief (double) fill matrix with data from csv file
+ * @brief releases a file of csv_map
  *
- * @param file containing data to be filled int matrix struct
- * @param matrix destination for data first pointer on columns
- * @param row_count amount of rows in matrix
- * @param column_count amount of columns in matrix
- * @return int error return code
+ * @param text content of csv_map
+ * @param size size of csv_map
  */
-static int fillMatrixFromCsv(FILE *file, double ***matrix, int row_count,
-                             int column_count) {
-  char *line = (char *)malloc(MAX_STRING_SIZE);
-  line[0] = '\0';
-  if (line == NULL) {
-    printf("\tMemory could not be allocated\n");
-    return -1;
+static void csv_unmap(char *text, size_t size) {
+#ifdef _WIN32
+  free(text);
+#else
+  if (text != NULL) {
+    munmap(text, size);
   }
-  if (file == NULL) {
-    printf("\tFile is null\n");
-    return -2;
+#endif
+}
+
+/**
+ * @brief start of the first row at or behind offset, rows start at the
+ * beginning of the text and behind an EOL
+ *
+ * @param text whole file
+ * @param size size of text
+ * @param offset byte offset in text
+ * @return const char* row start, text + size if there is none
+ */
+static const char *csv_row_start(const char *text, size_t size,
+                                 size_t offset) {
+  if (offset == 0 || offset >= size) {
+    return text + (offset == 0 ? 0 : size);
   }
-  if (matrix == NULL) {
-    printf("\tMatrix is null\n");
-    return -3;
+  const char *eol =
+      (const char *)memchr(text + offset - 1, EOL, size - offset + 1);
+  return eol != NULL ? eol + 1 : text + size;
+}
+
+/**
+ * @brief length of the empty rows at the start of a csv, rows holding nothing
+ * but a CR in front of their EOL count as empty
+ *
+ * @param text whole file
+ * @param size size of text
+ * @return size_t bytes of the empty rows including their EOL
+ */
+static size_t csv_empty_rows(const char *text, size_t size) {
+  size_t offset = 0;
+  while (offset < size) {
+    const char *eol = (const char *)memchr(text + offset, EOL, size - offset);
+    size_t length = eol != NULL ? (size_t)(eol - text) - offset : size - offset;
+    if (length > 1 || (length == 1 && text[offset] != '\r') || eol == NULL) {
+      return offset;
+    }
+    offset += length + 1;
   }
-  if (row_count == 0) {
-    printf("\trow_count is 0, no rows to be read\n");
-    return -4;
+  return offset;
+}
+
+/**
+ * @brief separator of a csv, SEMICOLON if the first row holds one (',' or '.'
+ * as decimal point), KOMMA otherwise ('.' as decimal point)
+ *
+ * @param text whole file
+ * @param size size of text
+ * @return char SEMICOLON or KOMMA
+ */
+static char csv_separator(const char *text, size_t size) {
+  const char *eol = (const char *)memchr(text, EOL, size);
+  size_t length = eol != NULL ? (size_t)(eol - text) : size;
+  return memchr(text, SEMICOLON, length) != NULL ? SEMICOLON : KOMMA;
+}
+
+/**
+ * @brief length of the header of a csv, the first row if any of its fields is
+ * not a number (column names)
+ *
+ * @param text whole file
+ * @param size size of text
+ * @param separator SEMICOLON or KOMMA
+ * @return size_t bytes of the header including its EOL, 0 without header
+ */
+static size_t csv_header(const char *text, size_t size, char separator) {
+  const char *eol = (const char *)memchr(text, EOL, size);
+  const char *row_end = eol != NULL ? eol : text + size;
+  for (const char *field = text;;) {
+    const char *next =
+        (const char *)memchr(field, separator, row_end - field);
+    const char *field_end = next != NULL ? next : row_end;
+    double value;
+    if (dpParseDouble(field, field_end, &value) == DP_NOT_A_NUMBER) {
+      return eol != NULL ? (size_t)(eol - text) + 1 : size;
+    }
+    if (next == NULL) {
+      return 0;
+    }
+    field = next + 1;
   }
-  if (column_count == 0) {
-    printf("\tcolumn_count is 0, no columns to be read\n");
-    return -5;
+}
+
+/**
+ * @brief tpTask, finds the rows of its part of the file. Without a matrix it
+ * counts the rows and fields, with one it parses the rows into the columns.
+ *
+ * @param args CSVJOB
+ * @param part part of the file
+ * @param part_count amount of parts
+ */
+static void csv_part(void *args, int part, int part_count) {
+  CSVJOB *job = (CSVJOB *)args;
+  CSVPART *csv = job->parts + part;
+  const char *text = job->text;
+  size_t size = job->size;
+  if (job->matrix == NULL) {
+    csv->begin = csv_row_start(text, size, size / part_count * part);
+    csv->end = part + 1 == part_count
+                   ? text + size
+                   : csv_row_start(text, size, size / part_count * (part + 1));
+    csv->rows = 0;
+    csv->cols = 0;
+    csv->errnum = 0;
+    for (const char *row = csv->begin; row < csv->end; csv->rows++) {
+      const char *eol = (const char *)memchr(row, EOL, csv->end - row);
+      const char *row_end = eol != NULL ? eol : csv->end;
+      int fields = 1;
+      for (; row < row_end; row++) {
+        fields += *row == job->separator;
+      }
+      if (fields > csv->cols) {
+        csv->cols = fields;
+      }
+      row = row_end + 1;
+    }
+    return;
   }
-  int row_counter = 0;
-  int column_counter = 0;
-  char c[1] = {' '};
-  c[0] = (char)fgetc(file);
-  while ((int)c[0] != EOF) {
-    if ((int)c[0] == SEMICOLON) {
-      double parameter = strtod(line, NULL);
-      *(*((*matrix) + column_counter) + row_counter) =
-          parameter; // column and row can not be exclusivly zero -> left
-                     // operand is guaranteed to be valid
-      line[0] = '\0';
-      column_counter++;
-    } else if ((int)c[0] == EOL) {
-      double parameter = strtod(line, NULL);
-      *(*((*matrix) + column_counter) + row_counter) =
-          parameter; // column and row can not be exclusivly zero -> left
-                     // operand is guaranteed to be valid
-      line[0] = '\0';
-      column_counter++;
-      row_counter++;
-      column_counter = 0;
-    } else {
-      strcat(line, c);
+  double **columns = job->matrix->data;
+  int cols = job->matrix->cols;
+  int row_index = csv->first_row;
+  for (const char *row = csv->begin; row < csv->end; row_index++) {
+    const char *eol = (const char *)memchr(row, EOL, csv->end - row);
+    const char *row_end = eol != NULL ? eol : csv->end;
+    int column = 0;
+    for (;;) {
+      const char *separator =
+          (const char *)memchr(row, job->separator, row_end - row);
+      const char *field_end = separator != NULL ? separator : row_end;
+      double value;
+      if (dpParseDouble(row, field_end, &value) == DP_NOT_A_NUMBER) {
+        csv->errnum = -1;
+      }
+      columns[column][row_index] = value;
+      column++;
+      if (separator == NULL) {
+        break;
+      }
+      row = separator + 1;
+    }
+    // missing fields of short rows are empty
+    for (; column < cols; column++) {
+      columns[column][row_index] = 0;
     }
-    c[0] = (char)fgetc(file);
+    row = row_end + 1;
   }
-  rewind(file);
-  free(line);
-  return 0;
 }
 
 /*****************************************************************************
@@ -148,196 +331,395 @@ static int fillMatrixFromCsv(FILE *file, double ***matrix, int row_count,
 
 /**
  * @brief (double) Import data contained in file stored at file_path into matrix
- * struct
+ * struct, on one part per thread of the thread pool
  *
  * @param file_path file origin
  * @param vector_list matrix struct, data destination
- * @return int error return code
+ * @return int error return code, see importVectorTableFromCsvParallel
  */
 int importVectorTableFromCsv(char *file_path, MATRIX **vector_list) {
-  int errnum;
-  FILE *file;
+  int thread_count = tpGetSize();
+  if (thread_count == 0) {
+    tpInit(0);
+    thread_count = tpGetSize();
+  }
+  return importVectorTableFromCsvParallel(file_path, vector_list,
+                                          thread_count > 0 ? thread_count : 1,
+                                          NULL);
+}
+
+/**
+ * @brief (double) Import a csv into matrix struct, either with ';' as
+ * separator and ',' or '.' as decimal point or with ',' as separator and '.'
+ * as decimal point (see csv_separator). Empty rows at the start of the file
+ * and a first row with column names behind them are skipped. The file is
+ * mapped into memory, split into parts at row boundaries and every part is
+ * counted and then parsed straight into the columns on the thread pool
+ * (dpParseDouble). Rows end with EOL, the last one may not. Empty and missing
+ * fields are 0.
+ *
+ * @param file_path file origin
+ * @param vector_list matrix struct, data destination; receives the columns and
+ * lambda, skew and errnum arrays
+ * @param thread_count amount of parts parsing the file, not of threads: the
+ * parts run on the shared thread pool, sized to the online processors unless
+ * tpInit sets it
+ * @param throughput receives the parsed MB (10^6 bytes) per second, may be
+ * NULL
+ * @return int error return code: -1 file_path null, -2 vector_list null, -3
+ * file can not be read, -4 wrong format (a field is not a number), -5 to -8
+ * allocation failed, -9 no rows
+ */
+int importVectorTableFromCsvParallel(char *file_path, MATRIX **vector_list,
+                                     int thread_count, double *throughput) {
   if (file_path == NULL) {
     printf("\tfile_path is null\n");
     return -1;
   }
-  if (*vector_list == NULL) {
+  if (vector_list == NULL || *vector_list == NULL) {
     printf("\tvector_list is null\n");
     return -2;
   }
-  file = fopen(file_path, "r");
-  if (file == NULL) {
+  double start = csv_seconds();
+  char *text;
+  size_t size;
+  if (csv_map(file_path, &text, &size) != 0) {
     printf("\t\"%s\" does not exist in data directory.\n", file_path);
     return -3;
   }
-  errnum =
-      getMatrixSizeFromCsv(file, &(*vector_list)->cols, &(*vector_list)->rows);
-  if (errnum != 0) {
-    printf("\texception while getting dimensions.\n");
-    return -4;
+  MATRIX *matrix = *vector_list;
+  matrix->rows = 0;
+  matrix->cols = 0;
+  matrix->data = NULL;
+  matrix->lambda = NULL;
+  matrix->skew = NULL;
+  matrix->errnum = NULL;
+  if (size == 0) {
+    printf("\tno rows to be read\n");
+    return -9;
   }
-  double **column_addresses = (double **)malloc(
-      sizeof(double *) *
-      (*vector_list)->cols); // cols can not be zero -> see getMatrixSizeFromCsv
-  if (column_addresses == NULL) {
-    printf("\tFailed to allocate memory for column_addresses.\n");
+  int parts = thread_count > 1 ? thread_count * 4 : 1;
+  if ((size_t)parts > size / CSV_MIN_PART_SIZE) {
+    parts = (int)(size / CSV_MIN_PART_SIZE);
+  }
+  if (parts < 1) {
+    parts = 1;
+  }
+  CSVPART *csv = (CSVPART *)calloc(parts, sizeof(CSVPART));
+  if (csv == NULL) {
+    printf("\tFailed to allocate memory for the parts.\n");
+    csv_unmap(text, size);
     return -5;
   }
-  for (int i = 0; i < (*vector_list)->cols; i++) {
-    double *row_info = (double *)malloc(sizeof(double) * (*vector_list)->rows);
-    if (row_info == NULL) {
-      free(column_addresses);
-      printf("\tFailed to allocate memory for row_info.\n");
-      return -6;
+  size_t skipped = csv_empty_rows(text, size);
+  char separator = csv_separator(text + skipped, size - skipped);
+  skipped += csv_header(text + skipped, size - skipped, separator);
+  CSVJOB job = {text + skipped, size - skipped, separator, csv, NULL};
+  tpRun(csv_part, &job, parts);
+  long long rows = 0;
+  for (int i = 0; i < parts; i++) {
+    csv[i].first_row = (int)rows;
+    rows += csv[i].rows;
+    if (csv[i].cols > matrix->cols) {
+      matrix->cols = csv[i].cols;
     }
-    *(column_addresses + i) = row_info;
-  }
-  (*vector_list)->data = column_addresses;
-  double *new_mem = (double *)malloc(sizeof(double) * (*vector_list)->cols);
-  if (new_mem == NULL) {
-    printf("\tFailed to allocate memory for lambda_storage.\n");
-    return -7;
-  }
-  (*vector_list)->lambda = new_mem;
-  new_mem = (double *)malloc(sizeof(double) * (*vector_list)->cols);
-  if (new_mem == NULL) {
-    printf("\tFailed to allocate memory for skew_storage.\n");
-    return -8;
-  }
-  (*vector_list)->skew = new_mem;
-  if (fillMatrixFromCsv(file, &(*vector_list)->data, (*vector_list)->rows,
-                        (*vector_list)->cols) != 0) {
-    printf("\texception while parsing csv file.\n");
+  }
+  if (rows == 0 || rows > INT_MAX) {
+    printf("\t%lld rows can not be read\n", rows);
+    matrix->cols = 0;
+    free(csv);
+    csv_unmap(text, size);
     return -9;
   }
+  matrix->rows = (int)rows;
+  int errnum = 0;
+  matrix->data = (double **)calloc(matrix->cols, sizeof(double *));
+  if (matrix->data == NULL) {
+    printf("\tFailed to allocate memory for column_addresses.\n");
+    errnum = -5;
+  }
+  for (int i = 0; errnum == 0 && i < matrix->cols; i++) {
+    matrix->data[i] = (double *)malloc(sizeof(double) * matrix->rows);
+    if (matrix->data[i] == NULL) {
+      printf("\tFailed to allocate memory for row_info.\n");
+      errnum = -6;
+    }
+  }
+  if (errnum == 0) {
+    matrix->lambda = (double *)calloc(matrix->cols, sizeof(double));
+    if (matrix->lambda == NULL) {
+      printf("\tFailed to allocate memory for lambda_storage.\n");
+      errnum = -7;
+    }
+  }
+  if (errnum == 0) {
+    matrix->skew = (double *)calloc(matrix->cols, sizeof(double));
+    matrix->errnum = (int *)calloc(matrix->cols, sizeof(int));
+    if (matrix->skew == NULL || matrix->errnum == NULL) {
+      printf("\tFailed to allocate memory for skew_storage.\n");
+      errnum = -8;
+    }
+  }
+  if (errnum == 0) {
+    job.matrix = matrix;
+    tpRun(csv_part, &job, parts);
+    for (int i = 0; i < parts; i++) {
+      if (csv[i].errnum != 0) {
+        printf("\tWrong format, a field is not a number, pls use \';\' or "
+               "\',\' as seperator\n");
+        errnum = -4;
+        break;
+      }
+    }
+  }
+  free(csv);
+  csv_unmap(text, size);
+  if (errnum != 0) {
+    freeMatrix(matrix);
+    return errnum;
+  }
+  if (throughput != NULL) {
+    double seconds = csv_seconds() - start;
+    *throughput = seconds > 0 ? (double)size * 1e-6 / seconds : 0;
+  }
   return 0;
 }
 
-/*****************************************************************************
- *                                  TESTS
- *****************************************************************************/
-#ifdef UNIT_TEST
-
-void test_getMatrixSizeFromCsv(void) {
-  printf("Testing getMatrixSizeFromCsv in vectorImports.c\n");
-  int column_size = 0;
-  int row_size = 0;
-  FILE *wrong_file = fopen("./data/wrong.csv", "r");
-  assert_int_equals(getMatrixSizeFromCsv(NULL, &column_size, &row_size), -1,
-                    "Error: file is null but still opened");
-  assert_int_equals(getMatrixSizeFromCsv(wrong_file, &column_size, &row_size),
-                    -2, "Error: wrong format but was read");
-  fclose(wrong_file);
-  FILE *file = fopen("./data/Mappe2.CSV", "r");
-  fpos_t file_pointer;
-  fgetpos(file, &file_pointer);
-  assert_int_equals(getMatrixSizeFromCsv(file, &column_size, &row_size), 0,
-                    "Error: file exists but is null");
-  fpos_t after_pointer;
-  fgetpos(file, &after_pointer);
-  assert_int_equals(column_size, 62,
-                    "Error: column_size is not equal to columns in document");
-  assert_int_equals(row_size, 2000,
-                    "Error: row_size is not equal to rows in document");
-  assert_double_equals((double)after_pointer, (double)file_pointer,
-                       "Error: File pointer is not reset");
-  fclose(file);
-  file = fopen("./data/data1.CSV", "r");
-  getMatrixSizeFromCsv(file, &column_size, &row_size);
-  assert_int_equals(column_size, 1, "Error: column_size should be 1");
-  assert_int_equals(row_size, 4, "Error: row_size should be 4");
-  fclose(file);
-  printf("...done\n");
-}
-
-void test_fillMatrixFromCsv(void) {
-  printf("Testing fillMatrixFromCsv in vectorImports.c\n");
-  MATRIX test;
-  {
-    double **column_addresses = (double **)malloc(sizeof(double **) * 1);
-    if (column_addresses == NULL) {
-      printf("\tFailed to allocate memory for column_addresses.\n");
+/**
+ * @brief column names of a csv, the fields of its header row (see
+ * importVectorTableFromCsvParallel) without blanks and quotes
+ *
+ * @param file_path file origin
+ * @param names receives count names in one allocation, release with free; NULL
+ * if the file has no header
+ * @param count receives the amount of names, 0 without header
+ * @return int error return code: -1 argument null, -3 file can not be read,
+ * -5 allocation failed
+ */
+int importColumnNamesFromCsv(char *file_path, char ***names, int *count) {
+  if (file_path == NULL || names == NULL || count == NULL) {
+    return -1;
+  }
+  *names = NULL;
+  *count = 0;
+  char *text;
+  size_t size;
+  if (csv_map(file_path, &text, &size) != 0) {
+    printf("\t\"%s\" does not exist in data directory.\n", file_path);
+    return -3;
+  }
+  if (size == 0) {
+    return 0;
+  }
+  char separator = csv_separator(text, size);
+  size_t header = csv_header(text, size, separator);
+  int fields = header > 0;
+  for (size_t i = 0; i < header; i++) {
+    fields += text[i] == separator;
+  }
+  if (fields == 0) {
+    csv_unmap(text, size);
+    return 0;
+  }
+  // the pointers, then the names with their terminators in place of the
+  // separators
+  char **block = (char **)malloc(sizeof(char *) * fields + header + 1);
+  if (block == NULL) {
+    printf("\tFailed to allocate memory for the column names.\n");
+    csv_unmap(text, size);
+    return -5;
+  }
+  char *name = (char *)(block + fields);
+  const char *field = text;
+  const char *row_end = text + header;
+  for (int i = 0; i < fields; i++) {
+    const char *next = (const char *)memchr(field, separator, row_end - field);
+    const char *field_end = next != NULL ? next : row_end;
+    while (field < field_end &&
+           (*field == ' ' || *field == '\t' || *field == '"')) {
+      field++;
     }
-    for (int i = 0; i < 1; i++) {
-      double *row_info = (double *)malloc(sizeof(double) * 4);
-      if (row_info == NULL) {
-        printf("\tFailed to allocate memory for row_info.\n");
-      }
-      *(column_addresses + i) = row_info;
+    while (field_end > field &&
+           (field_end[-1] == ' ' || field_end[-1] == '\t' ||
+            field_end[-1] == '\r' || field_end[-1] == EOL ||
+            field_end[-1] == '"')) {
+      field_end--;
     }
-    test.data = column_addresses;
-  }
-  FILE *file = fopen("./data/data1.CSV", "r");
-  assert_int_equals(fillMatrixFromCsv(NULL, &test.data, 1, 1), -2,
-                    "Error: File is null, should be aborted");
-  assert_int_equals(fillMatrixFromCsv(file, NULL, 1, 1), -3,
-                    "Error: matrix is null, should be aborted");
-  assert_int_equals(fillMatrixFromCsv(file, &test.data, 0, 1), -4,
-                    "Error: row_count is 0, should be aborted");
-  assert_int_equals(fillMatrixFromCsv(file, &test.data, 4, 1), 0,
-                    "Error: all parameters are correct, should be executed");
-  fillMatrixFromCsv(file, &test.data, 4, 1);
-  assert_double_equals(*(*(test.data) + 0), (double)-5,
-                       "Error: 1st number in matrix is not as expected");
-  assert_double_equals(*(*(test.data) + 1), (double)-3,
-                       "Error: 2nd number in matrix is not as expected");
-  assert_double_equals(*(*(test.data) + 2), (double)-3,
-                       "Error: 3rd number in matrix is not as expected");
-  assert_double_equals(*(*(test.data) + 3), (double)-2,
-                       "Error: 4th number in matrix is not as expected");
-  printf("...done\n");
-  free(test.data[0]);
-  free(test.data);
+    block[i] = name;
+    memcpy(name, field, field_end - field);
+    name += field_end - field;
+    *name++ = '\0';
+    field = next != NULL ? next + 1 : row_end;
+  }
+  csv_unmap(text, size);
+  *names = block;
+  *count = fields;
+  return 0;
 }
 
-void test_fillMatrixFromCsvf(void) {
-  printf("Testing fillMatrixFromCsvf in vectorImports.c\n");
-  MATRIXF test;
-  {
-    float **column_addresses = (float **)malloc(sizeof(float **) * 1);
-    if (column_addresses == NULL) {
-      printf("\tFailed to allocate memory for column_addresses.\n");
-    }
-    for (int i = 0; i < 1; i++) {
-      float *row_info = (float *)malloc(sizeof(float) * 4);
-      if (row_info == NULL) {
-        printf("\tFailed to allocate memory for row_info.\n");
-      }
-      *(column_addresses + i) = row_info;
+/**
+ * @brief releases the arrays of a matrix of importVectorTableFromCsv(Parallel)
+ * and leaves it empty (0 rows and cols); callers that do not share the C
+ * runtime of the library, e.g. ctypes, release the matrix with it
+ *
+ * @param matrix matrix with cols columns, unallocated arrays are NULL
+ */
+void freeMatrix(MATRIX *matrix) {
+  if (matrix->data != NULL) {
+    for (int i = 0; i < matrix->cols; i++) {
+      free(matrix->data[i]);
     }
-    test.data = column_addresses;
   }
-  FILE *file = fopen("./data/data1.CSV", "r");
+  free(matrix->data);
+  free(matrix->lambda);
+  free(matrix->skew);
+  free(matrix->errnum);
+  matrix->rows = 0;
+  matrix->cols = 0;
+  matrix->data = NULL;
+  matrix->lambda = NULL;
+  matrix->skew = NULL;
+  matrix->errnum = NULL;
+}
 
-  assert_int_equals(fillMatrixFromCsvf(NULL, test.data, 1, 1), -2,
-                    "Error: File is null, should be aborted");
+/**
+ * @brief size of one value of a MATRIXS in bytes
+ *
+ * @param dtype MATRIX_FLOAT64 or MATRIX_FLOAT32
+ * @return int size in bytes, 0 for an unknown dtype
+ */
+static int matrixElementSize(int dtype) {
+  switch (dtype) {
+  case MATRIX_FLOAT64:
+    return sizeof(double);
+  case MATRIX_FLOAT32:
+    return sizeof(float);
+  default:
+    return 0;
+  }
+}
+
+/**
+ * @brief allocates a strided matrix in one buffer aligned to
+ * MATRIX_ALIGNMENT bytes, plus its lambda, skew and errnum arrays
+ *
+ * @param matrix receives the matrix, release with freeMatrixS
+ * @param rows amount of rows
+ * @param cols amount of columns
+ * @param dtype MATRIX_FLOAT64 or MATRIX_FLOAT32
+ * @param column_major 1 for F order (columns contiguous), 0 for C order
+ * @return int error return code
+ */
+int allocMatrixS(MATRIXS *matrix, int rows, int cols, int dtype,
+                 int column_major) {
+  if (matrix == NULL) {
+    return -1;
+  }
+  memset(matrix, 0, sizeof(MATRIXS));
+  int size = matrixElementSize(dtype);
+  if (size == 0) {
+    return -2;
+  }
+  if (rows < 0 || cols < 0) {
+    return -3;
+  }
+  size_t bytes = (size_t)rows * (size_t)cols * size;
+  // round up, aligned allocations hold whole alignment blocks
+  bytes = (bytes + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT * MATRIX_ALIGNMENT;
+  if (bytes == 0) {
+    bytes = MATRIX_ALIGNMENT;
+  }
+#ifdef _WIN32
+  matrix->data = _aligned_malloc(bytes, MATRIX_ALIGNMENT);
+#else
+  if (posix_memalign(&matrix->data, MATRIX_ALIGNMENT, bytes) != 0) {
+    matrix->data = NULL;
+  }
+#endif
+  matrix->lambda = (double *)calloc(cols > 0 ? cols : 1, sizeof(double));
+  matrix->skew = (double *)calloc(cols > 0 ? cols : 1, sizeof(double));
+  matrix->errnum = (int *)calloc(cols > 0 ? cols : 1, sizeof(int));
+  if (matrix->data == NULL || matrix->lambda == NULL || matrix->skew == NULL ||
+      matrix->errnum == NULL) {
+    printf("\tFailed to allocate memory for the matrix.\n");
+    freeMatrixS(matrix);
+    return -4;
+  }
+  matrix->rows = rows;
+  matrix->cols = cols;
+  matrix->dtype = dtype;
+  matrix->row_stride = column_major ? size : (long long)cols * size;
+  matrix->col_stride = column_major ? (long long)rows * size : size;
+  return 0;
+}
 
-  assert_int_equals(fillMatrixFromCsvf(file, NULL, 1, 1), -3,
-                    "Error: matrix is null, should be aborted");
-  assert_int_equals(fillMatrixFromCsvf(file, test.data, 0, 1), -4,
-                    "Error: row_count is 0, should be aborted");
-  assert_int_equals(fillMatrixFromCsvf(file, test.data, 4, 1), 0,
-                    "Error: all parameters are correct, should be executed");
-  fillMatrixFromCsvf(file, test.data, 4, 1);
+/**
+ * @brief releases a matrix of allocMatrixS, not for wrapped buffers
+ *
+ * @param matrix matrix of allocMatrixS
+ */
+void freeMatrixS(MATRIXS *matrix) {
+#ifdef _WIN32
+  _aligned_free(matrix->data);
+#else
+  free(matrix->data);
+#endif
+  free(matrix->lambda);
+  free(matrix->skew);
+  free(matrix->errnum);
+  memset(matrix, 0, sizeof(MATRIXS));
+}
 
-  assert_float_equals(*(*(test.data) + 0), (float)-5,
-                      "Error: 1st number in matrix is not as expected");
-  assert_float_equals(*(*(test.data) + 1), (float)-3,
-                      "Error: 2nd number in matrix is not as expected");
-  assert_float_equals(*(*(test.data) + 2), (float)-3,
-                      "Error: 3rd number in matrix is not as expected");
-  assert_float_equals(*(*(test.data) + 3), (float)-2,
-                      "Error: 4th number in matrix is not as expected");
-  printf("...done\n");
-  free(test.data[0]);
-  free(test.data);
+/**
+ * @brief checks a strided matrix before the ci* entry points use it, e.g. one
+ * wrapping a NumPy buffer
+ *
+ * @param matrix matrix to be checked
+ * @return int 0, -1 on null pointers, -2 on an unknown dtype, -3 on negative
+ * dimensions, -4 if data or a stride is not a multiple of the element size
+ */
+int checkMatrixS(const MATRIXS *matrix) {
+  if (matrix == NULL) {
+    return -1;
+  }
+  int size = matrixElementSize(matrix->dtype);
+  if (size == 0) {
+    return -2;
+  }
+  if (matrix->rows < 0 || matrix->cols < 0) {
+    return -3;
+  }
+  if (matrix->cols == 0) {
+    return 0;
+  }
+  if (matrix->lambda == NULL || matrix->skew == NULL ||
+      matrix->errnum == NULL || (matrix->data == NULL && matrix->rows > 0)) {
+    return -1;
+  }
+  if ((size_t)matrix->data % size != 0 || matrix->row_stride % size != 0 ||
+      matrix->col_stride % size != 0) {
+    return -4;
+  }
+  return 0;
 }
 
+/*****************************************************************************
+ *                                  TESTS
+ *****************************************************************************/
+#ifdef UNIT_TEST
+
 void test_importVectorTableFromCsv(void) {
   printf("Testing importVectorTableFromCsv in vectorImports.c\n");
-  char *file_path = "./data/data2.CSV";
-  char *wrong_file_path = "./data/wrong.csv";
-  MATRIX vector_list;
+  char *file_path = "./import_table.csv";
+  char *wrong_file_path = "./import_wrong.csv";
+  FILE *file = fopen(file_path, "w");
+  fprintf(file, "-5;1,5\n-3;2\n");
+  fclose(file);
+  file = fopen(wrong_file_path, "w");
+  fprintf(file, "1;2\n3;x\n");
+  fclose(file);
+  MATRIX matrix;
+  MATRIX *vector_list = &matrix;
   assert_int_equals(importVectorTableFromCsv(NULL, &vector_list), -1,
                     "Error: file path is null, should abort");
   assert_int_equals(importVectorTableFromCsv(file_path, NULL), -2,
@@ -345,54 +727,162 @@ void test_importVectorTableFromCsv(void) {
   assert_int_equals(importVectorTableFromCsv("test/path.csv", &vector_list), -3,
                     "Error: file does not exist, should abort");
   assert_int_equals(importVectorTableFromCsv(wrong_file_path, &vector_list), -4,
-                    "Error: dimensions would not be determined, should abort");
+                    "Error: field is not a number, should abort");
   assert_int_equals(importVectorTableFromCsv(file_path, &vector_list), 0,
                     "Error: should execute but did not");
-  assert_not_null((void *)vector_list.data,
-                  "Error: No memory allocated for data");
-  for (int i = 0; i < vector_list.cols; i++) {
-    assert_not_null((void *)*(vector_list.data + i),
-                    "Error: no memory allocated for data");
-  }
-  assert_not_null((void *)vector_list.lambda,
+  assert_int_equals(matrix.rows, 2, "Error: rows not as in file");
+  assert_int_equals(matrix.cols, 2, "Error: cols not as in file");
+  assert_not_null((void *)matrix.lambda,
                   "Error: No memory allocated for lambda");
-  assert_not_null((void *)vector_list.skew,
-                  "Error: No memory allocated for skew");
-  char *wrong_file_path2 = "./data/wrong2.csv";
-  assert_int_equals(importVectorTableFromCsv(wrong_file_path2, &vector_list),
+  assert_not_null((void *)matrix.skew, "Error: No memory allocated for skew");
+  assert_double_equals(matrix.data[0][1], -3,
+                       "Error: 2nd number in matrix is not as expected");
+  assert_double_equals(matrix.data[1][0], 1.5,
+                       "Error: 3rd number in matrix is not as expected");
+  freeMatrix(&matrix);
+  file = fopen(wrong_file_path, "w");
+  fclose(file);
+  assert_int_equals(importVectorTableFromCsv(wrong_file_path, &vector_list),
                     -9, "Error: cols and rows are 0, should abort");
+  remove(file_path);
+  remove(wrong_file_path);
   printf("...done\n");
 }
 
-void test_importVectorTableFromCsvf(void) {
-  printf("Testing importVectorTableFromCsvf in vectorImports.c\n");
-  char *file_path = "./data/data2.CSV";
-  char *wrong_file_path = "./data/wrong.csv";
-  MATRIXF vector_list;
-  assert_int_equals(importVectorTableFromCsvf(NULL, &vector_list), -1,
-                    "Error: file path is null, should abort");
-  assert_int_equals(importVectorTableFromCsvf(file_path, NULL), -2,
-                    "Error: vector_list is null, should abort");
-  assert_int_equals(importVectorTableFromCsvf("test/path.csv", &vector_list),
-                    -3, "Error: file does not exist, should abort");
-  assert_int_equals(importVectorTableFromCsvf(wrong_file_path, &vector_list),
-                    -4,
-                    "Error: dimensions would not be determined, should abort");
-  assert_int_equals(importVectorTableFromCsvf(file_path, &vector_list), 0,
-                    "Error: should execute but did not");
-  assert_not_null((void *)vector_list.data,
-                  "Error: No memory allocated for data");
-  for (int i = 0; i < vector_list.cols; i++) {
-    assert_not_null((void *)*(vector_list.data + i),
-                    "Error: no memory allocated for data");
+void test_importVectorTableFromCsvParallel(void) {
+  printf("Testing importVectorTableFromCsvParallel in vectorImports.c\n");
+  // more rows than one part holds, a short row and no EOL behind the last row
+  char *file_path = "./import_parallel.csv";
+  int rows = 20000;
+  FILE *file = fopen(file_path, "w");
+  for (int i = 0; i < rows - 1; i++) {
+    if (i == 7) {
+      fprintf(file, "%d,25\n", i);
+    } else {
+      fprintf(file, "%d,25;-%d;;%d\n", i, i, i % 3);
+    }
   }
-  assert_not_null((void *)vector_list.lambda,
-                  "Error: No memory allocated for lambda");
-  assert_not_null((void *)vector_list.skew,
-                  "Error: No memory allocated for skew");
-  char *wrong_file_path2 = "./data/wrong2.csv";
-  assert_int_equals(importVectorTableFromCsvf(wrong_file_path2, &vector_list),
-                    -9, "Error: cols and rows are 0, should abort");
+  fprintf(file, "1,5;2;3;4");
+  fclose(file);
+  MATRIX matrix;
+  MATRIX *vector_list = &matrix;
+  double throughput = 0;
+  assert_int_equals(
+      importVectorTableFromCsvParallel(file_path, &vector_list, 4, &throughput),
+      0, "Error: should execute but did not");
+  assert_int_equals(matrix.rows, rows, "Error: rows not as in file");
+  assert_int_equals(matrix.cols, 4, "Error: cols not as in file");
+  assert_not_null((void *)matrix.errnum, "Error: no memory for errnum");
+  assert_double_equals(matrix.data[0][12345], 12345.25,
+                       "Error: decimal comma not parsed");
+  assert_double_equals(matrix.data[1][12345], -12345,
+                       "Error: 2nd column not as in file");
+  assert_double_equals(matrix.data[2][12345], 0,
+                       "Error: empty field should be 0");
+  assert_double_equals(matrix.data[3][12345], 0, "Error: 4th column");
+  assert_double_equals(matrix.data[1][7], 0, "Error: missing field");
+  assert_double_equals(matrix.data[0][rows - 1], 1.5, "Error: last row");
+  assert_double_equals(matrix.data[3][rows - 1], 4, "Error: last field");
+  if (throughput <= 0) {
+    printf("Error: throughput not measured\n");
+  }
+  MATRIX serial;
+  vector_list = &serial;
+  assert_int_equals(
+      importVectorTableFromCsvParallel(file_path, &vector_list, 1, NULL), 0,
+      "Error: should execute on one thread");
+  for (int j = 0; j < 4; j++) {
+    if (memcmp(matrix.data[j], serial.data[j], sizeof(double) * rows) != 0) {
+      printf("Error: column %d differs between thread counts\n", j);
+    }
+  }
+  freeMatrix(&matrix);
+  freeMatrix(&serial);
+  // comma separated with column names, as written by pandas
+  file = fopen(file_path, "w");
+  fprintf(file, "label,bm_0,bm_1\r\n1.0,2.49203939993591,-4.357808443200467"
+                "\r\n0.0,1e-3,nan\r\n");
+  fclose(file);
+  vector_list = &matrix;
+  assert_int_equals(
+      importVectorTableFromCsvParallel(file_path, &vector_list, 2, NULL), 0,
+      "Error: csv with header should execute");
+  assert_int_equals(matrix.rows, 2, "Error: header should be skipped");
+  assert_int_equals(matrix.cols, 3, "Error: cols not as in header");
+  assert_double_equals(matrix.data[1][0], 2.49203939993591,
+                       "Error: 17 digits not parsed");
+  assert_double_equals(matrix.data[2][0], -4.357808443200467,
+                       "Error: negative number not parsed");
+  assert_double_equals(matrix.data[1][1], 0.001, "Error: exponent");
+  if (!isnan(matrix.data[2][1])) {
+    printf("Error: nan not parsed\n");
+  }
+  freeMatrix(&matrix);
+  file = fopen(file_path, "w");
+  fprintf(file, "1;2\n3;x\n");
+  fclose(file);
+  assert_int_equals(
+      importVectorTableFromCsvParallel(file_path, &vector_list, 2, NULL), -4,
+      "Error: field is not a number, should abort");
+  assert_int_equals(matrix.rows + matrix.cols, 0,
+                    "Error: failed import should leave the matrix empty");
+  // empty rows in front of the header and of the first row
+  char *leading[2] = {"\n\r\nlabel,bm_0\r\n1.5,2\n3,4\n", "\n\n1;2,5\n3;4\n"};
+  for (int i = 0; i < 2; i++) {
+    file = fopen(file_path, "w");
+    fprintf(file, "%s", leading[i]);
+    fclose(file);
+    assert_int_equals(
+        importVectorTableFromCsvParallel(file_path, &vector_list, 2, NULL), 0,
+        "Error: csv with empty rows in front should execute");
+    assert_int_equals(matrix.rows, 2, "Error: empty rows should be skipped");
+    assert_int_equals(matrix.cols, 2, "Error: separator not detected");
+    assert_double_equals(matrix.data[1][0], i ? 2.5 : 2,
+                         "Error: first row not as in file");
+    freeMatrix(&matrix);
+  }
+  file = fopen(file_path, "w");
+  fprintf(file, "\n\r\n\n");
+  fclose(file);
+  assert_int_equals(
+      importVectorTableFromCsvParallel(file_path, &vector_list, 2, NULL), -9,
+      "Error: only empty rows, should abort");
+  assert_int_equals(matrix.rows + matrix.cols, 0,
+                    "Error: failed import should leave the matrix empty");
+  remove(file_path);
+  printf("...done\n");
+}
+
+void test_allocMatrixS(void) {
+  printf("Testing allocMatrixS in vectorImports.c\n");
+  MATRIXS matrix;
+  assert_int_equals(allocMatrixS(NULL, 4, 3, MATRIX_FLOAT64, 0), -1,
+                    "Error: matrix is null, should abort");
+  assert_int_equals(allocMatrixS(&matrix, 4, 3, 7, 0), -2,
+                    "Error: unknown dtype, should abort");
+  assert_int_equals(allocMatrixS(&matrix, -4, 3, MATRIX_FLOAT64, 0), -3,
+                    "Error: negative rows, should abort");
+  assert_int_equals(allocMatrixS(&matrix, 4, 3, MATRIX_FLOAT64, 0), 0,
+                    "Error: should execute");
+  assert_int_equals((size_t)matrix.data % MATRIX_ALIGNMENT, 0,
+                    "Error: data is not aligned");
+  assert_int_equals(matrix.row_stride, 3 * sizeof(double),
+                    "Error: C order row stride");
+  assert_int_equals(matrix.col_stride, sizeof(double),
+                    "Error: C order column stride");
+  assert_int_equals(checkMatrixS(&matrix), 0, "Error: matrix should be valid");
+  matrix.col_stride = 4;
+  assert_int_equals(checkMatrixS(&matrix), -4,
+                    "Error: misaligned stride, should abort");
+  freeMatrixS(&matrix);
+  assert_int_equals(allocMatrixS(&matrix, 4, 3, MATRIX_FLOAT32, 1), 0,
+                    "Error: should execute");
+  assert_int_equals(matrix.row_stride, sizeof(float),
+                    "Error: F order row stride");
+  assert_int_equals(matrix.col_stride, 4 * sizeof(float),
+                    "Error: F order column stride");
+  freeMatrixS(&matrix);
+  assert_int_equals(checkMatrixS(NULL), -1, "Error: null, should abort");
   printf("...done\n");
 }
 
@@ -13,14 +13,39 @@
  *
  * PUBLIC FUNCTIONS :
  *          void buildBoundaryBox(double lower_lambda, double upper_lambda)
+ *          void buildBoundaryBoxCtx(yjContext *context, double lower_lambda,
+ *                                   double upper_lambda)
  *          int yjCalculation(double y, double lambda, double *result)
+ *          int yjCalculationCtx(const yjContext *context, double y,
+ *                               double lambda, double *result)
+ *          int yjCalculationU(double y, double lambda, double *result)
+ *          int yjValidateColumnCtx(context, vector, rows, lower_lambda,
+ *                                  upper_lambda, safe, bound)
+ *          int yjLogCache(const double *vector, int rows, double *log_cache)
+ *          int yjTransformCached(vector, log_cache, rows, lambda, result)
+ *          void yjMomentsAdd(yjMoments *moments, double value)
+ *          void yjMomentsMerge(yjMoments *moments, const yjMoments *other)
+ *          int yjMomentsCached(vector, log_cache, rows, lambda, scale, moments)
+ *          int yjMomentsCachedBatch(vector, log_cache, rows, lambdas,
+ *                                   lambda_count, scale, moments)
  *          int yjTransformBy(double **vector, double lambda, int rows)
+ *          int yjTransformByCtx(const yjContext *context, double **vector,
+ *                               double lambda, int rows)
+ *          int yjInverseCalculation(double x, double lambda, double *result)
+ *          int yjInverseTransformBy(double **vector, double lambda, int rows)
+ *          float variants of all of the above (suffix f)
+ *          int yjSignedLogSum(vector, log_cache, rows, result)
  *
  * NOTES    :
  *          These functions are used to calculate a new distribution for
  *          a given vector of data.
  *          Given an input value and a lambda value the
  *          Yeo Johnson transformation is applied to said value.
+ *          The *Ctx functions only read the caller owned yjContext and can be
+ *          used from any number of threads at once. The functions without
+ *          context share one process wide boundary box.
+ *          The *U functions skip every check; they are only used on columns
+ *          that yjValidateColumnCtx accepted for the whole lambda interval.
  *
  * AUTHOR   :       jbrenig           START DATE    : 01 September 2022
  *
@@ -43,6 +68,7 @@
 #include "include/errnumCodes.h"
 #include "include/testFramework.h"
 #include "include/yeoJohnson.h"
+#include "include/yjBatch.h"
 
 
 /*****************************************************************************
@@ -51,17 +77,20 @@
 
 static const double g_max_high_double = (double)0x7FFFFFFFFFFFFF;
 static const double g_max_low_double = (double)0x80000000000000;
-// static const double g_max_high_float = (float)0x7FFFFFFF;
-// static const double g_max_low_float = (float)0x80000000;
+static const float g_max_high_float = (float)0x7FFFFFFF;
+static const float g_max_low_float = (float)0x80000000;
+
+// rows per chunk of yjMomentsCachedBatch, values and logarithms of one chunk
+// stay in the L1 cache while every lambda of the batch passes over them
+static const int g_batch_rows = 2048;
 
 /*****************************************************************************
  *                                GLOBALS
  *****************************************************************************/
-// flags if boundary boxes have been set
-static int bB_set = 0;
-// boundary boxes
-static boundaryBox bB_yj1;
-static boundaryBox bB_yj3;
+// process wide context of buildBoundaryBox, yjCalculation and yjTransformBy
+static yjContext g_context;
+// process wide context of the float functions
+static yjContextf g_contextf;
 
 /*****************************************************************************
  *                           PRIVATE FUNCTIONS
@@ -71,17 +100,19 @@ static boundaryBox bB_yj3;
  * @brief (double) first formular of the Yeo Johnson transformation (y>=0,
  * lambda != 0)
  *
+ * @param context boundary boxes of the search
  * @param y value to be transformed
  * @param lambda transformation parameter
  * @param result resulting value after transformation
  * @return int error return code
  */
-static int yjFormular1(double y, double lambda, double *result) {
-  if (!bB_set) {
+static int yjFormular1(const yjContext *context, double y, double lambda,
+                       double *result) {
+  if (!context->set) {
     // printf("\tyjFormular1: boundary box is not set\n");
     return ERR_BB_NOT_SET;
   }
-  if (y > bB_yj1.upper_limit || y < bB_yj1.lower_limit) {
+  if (y > context->yj1.upper_limit || y < context->yj1.lower_limit) {
     // printf("\tyjFormular1: value not inside boundary box\n");
     return ERR_VALUE_NOT_IN_BB;
   }
@@ -111,19 +142,21 @@ static int yjFormular2(double y, double *result) {
  * @brief (double) third formular of the Yeo Johnson transformation (y<0, lambda
  * != 2)
  *
+ * @param context boundary boxes of the search
  * @param y value to be transformed
  * @param lambda transformation parameter
  * @param result resulting value after transformation
  * @return int error return code
  */
-static int yjFormular3(double y, double lambda, double *result) {
-  if (!bB_set) {
+static int yjFormular3(const yjContext *context, double y, double lambda,
+                       double *result) {
+  if (!context->set) {
     // printf("\tyjFormular3: boundary box is not set\n");
     return ERR_BB_NOT_SET;
   }
-  if (y > bB_yj3.upper_limit || y < bB_yj3.lower_limit) {
+  if (y > context->yj3.upper_limit || y < context->yj3.lower_limit) {
     // printf("\tyjFormular3: value not inside boundary box/ y=%f, ul=%f,
-    // ll=%f\n", y, bB_yj3.upper_limit, bB_yj3.lower_limit);
+    // ll=%f\n", y, context->yj3.upper_limit, context->yj3.lower_limit);
     return ERR_VALUE_NOT_IN_BB;
   }
   *result = -(pow(-y + 1, 2 - lambda) - 1) / (2 - lambda);
@@ -148,48 +181,273 @@ static int yjFormular4(double y, double *result) {
   return 0;
 }
 
+/**
+ * @brief (double) first formular without boundary box check, only for values
+ * validated by yjValidateColumnCtx
+ *
+ * @param y value to be transformed
+ * @param lambda transformation parameter
+ * @param result resulting value after transformation
+ * @return int error return code
+ */
+static int yjFormular1U(double y, double lambda, double *result) {
+  *result = (pow(y + 1, lambda) - 1) / lambda;
+  return 0;
+}
+
+/**
+ * @brief (double) second formular without overflow check
+ *
+ * @param y value to be transformed
+ * @param result resulting value after transformation
+ * @return int error return code
+ */
+static int yjFormular2U(double y, double *result) {
+  *result = log(y + 1);
+  return 0;
+}
+
+/**
+ * @brief (double) third formular without boundary box check
+ *
+ * @param y value to be transformed
+ * @param lambda transformation parameter
+ * @param result resulting value after transformation
+ * @return int error return code
+ */
+static int yjFormular3U(double y, double lambda, double *result) {
+  *result = -(pow(-y + 1, 2 - lambda) - 1) / (2 - lambda);
+  return 0;
+}
+
+/**
+ * @brief (double) fourth formular without overflow check
+ *
+ * @param y value to be transformed
+ * @param result resulting value after transformation
+ * @return int error return code
+ */
+static int yjFormular4U(double y, double *result) {
+  *result = -log(-y + 1);
+  return 0;
+}
+
+/**
+ * @brief (float) first formular of the Yeo Johnson transformation (y>=0,
+ * lambda != 0)
+ *
+ * @param context boundary boxes of the search
+ * @param y value to be transformed
+ * @param lambda transformation parameter
+ * @param result resulting value after transformation
+ * @return int error return code
+ */
+static int yjFormular1f(const yjContextf *context, float y, float lambda,
+                        float *result) {
+  if (!context->set) {
+    return ERR_BB_NOT_SET;
+  }
+  if (y > context->yj1.upper_limit || y < context->yj1.lower_limit) {
+    return ERR_VALUE_NOT_IN_BB;
+  }
+  *result = (powf(y + 1, lambda) - 1) / lambda;
+  return 0;
+}
+
+/**
+ * @brief (float) second formular of the Yeo Johnson transformation (y>=0,
+ * lambda == 0)
+ *
+ * @param y value to be transformed
+ * @param result resulting value after transformation
+ * @return int error return code
+ */
+static int yjFormular2f(float y, float *result) {
+  if (y == g_max_high_float) {
+    return ERR_VALUE_OVERFLOW;
+  }
+  *result = logf(y + 1);
+  return 0;
+}
+
+/**
+ * @brief (float) third formular of the Yeo Johnson transformation (y<0, lambda
+ * != 2)
+ *
+ * @param context boundary boxes of the search
+ * @param y value to be transformed
+ * @param lambda transformation parameter
+ * @param result resulting value after transformation
+ * @return int error return code
+ */
+static int yjFormular3f(const yjContextf *context, float y, float lambda,
+                        float *result) {
+  if (!context->set) {
+    return ERR_BB_NOT_SET;
+  }
+  if (y > context->yj3.upper_limit || y < context->yj3.lower_limit) {
+    return ERR_VALUE_NOT_IN_BB;
+  }
+  *result = -(powf(-y + 1, 2 - lambda) - 1) / (2 - lambda);
+  return 0;
+}
+
+/**
+ * @brief (float) fourth formular of the Yeo Johnson transformation
+ * (y<0, lambda == 2)
+ *
+ * @param y value to be transformed
+ * @param result resulting value after transformation
+ * @return int error return code
+ */
+static int yjFormular4f(float y, float *result) {
+  if (y == g_max_low_float) {
+    return ERR_VALUE_OVERFLOW;
+  }
+  *result = -logf(-y + 1);
+  return 0;
+}
+
+/**
+ * @brief (float) first formular without boundary box check, only for values
+ * validated by yjValidateColumnCtxf
+ *
+ * @param y value to be transformed
+ * @param lambda transformation parameter
+ * @param result resulting value after transformation
+ * @return int error return code
+ */
+static int yjFormular1Uf(float y, float lambda, float *result) {
+  *result = (powf(y + 1, lambda) - 1) / lambda;
+  return 0;
+}
+
+/**
+ * @brief (float) second formular without overflow check
+ *
+ * @param y value to be transformed
+ * @param result resulting value after transformation
+ * @return int error return code
+ */
+static int yjFormular2Uf(float y, float *result) {
+  *result = logf(y + 1);
+  return 0;
+}
+
+/**
+ * @brief (float) third formular without boundary box check
+ *
+ * @param y value to be transformed
+ * @param lambda transformation parameter
+ * @param result resulting value after transformation
+ * @return int error return code
+ */
+static int yjFormular3Uf(float y, float lambda, float *result) {
+  *result = -(powf(-y + 1, 2 - lambda) - 1) / (2 - lambda);
+  return 0;
+}
+
+/**
+ * @brief (float) fourth formular without overflow check
+ *
+ * @param y value to be transformed
+ * @param result resulting value after transformation
+ * @return int error return code
+ */
+static int yjFormular4Uf(float y, float *result) {
+  *result = -logf(-y + 1);
+  return 0;
+}
+
+/**
+ * @brief (double) transformation of one value of a validated column from its
+ * cached log1p(|y|), scalar counterpart of the cached vector kernel
+ *
+ * @param y value to be transformed
+ * @param log_a log1p(|y|)
+ * @param lambda transformation parameter
+ * @return double transformed value
+ */
+static double yjCachedValue(double y, double log_a, double lambda) {
+  int positive = y >= 0;
+  double p = positive ? lambda : 2 - lambda;
+  double value = (p == 0) ? log_a : expm1(p * log_a) / p;
+  return positive ? value : -value;
+}
+
+/**
+ * @brief (float) transformation of one value from its cached log1pf(|y|)
+ *
+ * @param y value to be transformed
+ * @param log_a log1pf(|y|)
+ * @param lambda transformation parameter
+ * @return float transformed value
+ */
+static float yjCachedValuef(float y, float log_a, float lambda) {
+  int positive = y >= 0;
+  float p = positive ? lambda : 2 - lambda;
+  float value = (p == 0) ? log_a : expm1f(p * log_a) / p;
+  return positive ? value : -value;
+}
+
 /*****************************************************************************
  *                           PUBLIC FUNCTIONS
  *****************************************************************************/
 
 /**
- * @brief (double) defines the boundaries of any value passed to yjCalculation
+ * @brief (double) defines the boundaries of any value passed to
+ * yjCalculationCtx with this context
  *
+ * @param context context of one search, owned by the caller
  * @param lower_lambda lowest lambda possible for this search
  * @param upper_lambda highest lambda possible for this search
  */
-void buildBoundaryBox(double lower_lambda, double upper_lambda) {
+void buildBoundaryBoxCtx(yjContext *context, double lower_lambda,
+                         double upper_lambda) {
   upper_lambda = (upper_lambda == 0) ? 1.0 : upper_lambda;
   lower_lambda = (lower_lambda == 0) ? -1 : lower_lambda;
-  bB_yj1.upper_limit =
+  context->yj1.upper_limit =
       pow(upper_lambda * g_max_high_double + 1, 1 / upper_lambda) - 1;
-  bB_yj1.lower_limit =
+  context->yj1.lower_limit =
       pow(lower_lambda * g_max_low_double + 1, 1 / lower_lambda) - 1;
 
   upper_lambda = (upper_lambda == 2) ? 3 : upper_lambda;
   lower_lambda = (lower_lambda == 2) ? 1 : lower_lambda;
-  bB_yj3.upper_limit = -(
+  context->yj3.upper_limit = -(
       pow(-g_max_high_double * (2 - upper_lambda) + 1, 1 / (2 - upper_lambda)) -
       1);
-  bB_yj3.lower_limit = -(
+  context->yj3.lower_limit = -(
       pow(-g_max_low_double * (2 - lower_lambda) + 1, 1 / (2 - lower_lambda)) -
       1);
-  bB_set = 1;
+  context->set = 1;
+}
+
+/**
+ * @brief (double) defines the boundaries of any value passed to yjCalculation,
+ * process wide (not reentrant, see buildBoundaryBoxCtx)
+ *
+ * @param lower_lambda lowest lambda possible for this search
+ * @param upper_lambda highest lambda possible for this search
+ */
+void buildBoundaryBox(double lower_lambda, double upper_lambda) {
+  buildBoundaryBoxCtx(&g_context, lower_lambda, upper_lambda);
 }
 
 /**
  * @brief (double) Yeo Johnson transformation decision tree and error handling
  *
+ * @param context boundary boxes of the search
  * @param y value to be transformed
  * @param lambda transformation parameter
  * @param result resulting value after transformation
  * @return int error return code
  */
-int yjCalculation(double y, double lambda, double *result) {
+int yjCalculationCtx(const yjContext *context, double y, double lambda,
+                     double *result) {
   int errnum = 0; // yj calculation error mask
   if (y >= 0) {
     if (lambda != 0) {
-      errnum |= yjFormular1(y, lambda, result);
+      errnum |= yjFormular1(context, y, lambda, result);
       if (errnum != 0) {
         // printf("\texception in yjFormular1\n");
         return ERR_YJ1_ID | errnum;
@@ -203,7 +461,7 @@ int yjCalculation(double y, double lambda, double *result) {
     }
   } else if (y < 0) {
     if (lambda != 2) {
-      errnum |= yjFormular3(y, lambda, result);
+      errnum |= yjFormular3(context, y, lambda, result);
       if (errnum != 0) {
         // printf("\texception in yjFormular3\n");
         return ERR_YJ3_ID | errnum;
@@ -219,19 +477,762 @@ int yjCalculation(double y, double lambda, double *result) {
   return 0;
 }
 
+/**
+ * @brief (double) Yeo Johnson transformation with the process wide boundary
+ * boxes of buildBoundaryBox
+ *
+ * @param y value to be transformed
+ * @param lambda transformation parameter
+ * @param result resulting value after transformation
+ * @return int error return code
+ */
+int yjCalculation(double y, double lambda, double *result) {
+  return yjCalculationCtx(&g_context, y, lambda, result);
+}
+
+/**
+ * @brief (double) Yeo Johnson transformation without any checks, only for
+ * columns accepted by yjValidateColumnCtx
+ *
+ * @param y value to be transformed
+ * @param lambda transformation parameter
+ * @param result resulting value after transformation
+ * @return int error return code
+ */
+int yjCalculationU(double y, double lambda, double *result) {
+  if (y >= 0) {
+    if (lambda != 0) {
+      return yjFormular1U(y, lambda, result);
+    }
+    return yjFormular2U(y, result);
+  }
+  if (lambda != 2) {
+    return yjFormular3U(y, lambda, result);
+  }
+  return yjFormular4U(y, result);
+}
+
+/**
+ * @brief (double) one min/max pass over a column, proves that yjCalculationCtx
+ * accepts every value of it for every lambda and bounds the transformed values
+ * for all lambdas in [lower_lambda, upper_lambda] (the transformation rises
+ * monotonically in y and in lambda)
+ *
+ * @param context boundary boxes of the search
+ * @param vector column to be validated
+ * @param rows amount of values
+ * @param lower_lambda lowest lambda the search may evaluate
+ * @param upper_lambda highest lambda the search may evaluate
+ * @param safe 1 if the unchecked functions may be used on the column
+ * @param bound largest absolute transformed value, valid if safe is 1
+ * @return int error return code
+ */
+int yjValidateColumnCtx(const yjContext *context, const double *vector,
+                        int rows, double lower_lambda, double upper_lambda,
+                        int *safe, double *bound) {
+  *safe = 0;
+  *bound = 0;
+  if (vector == NULL) {
+    return ERR_VECTOR_IS_NULL;
+  }
+  if (!context->set || rows <= 0) {
+    return 0;
+  }
+  double min_pos = DBL_MAX, max_pos = 0;
+  double min_neg = 0, max_neg = -DBL_MAX;
+  int positives = 0, negatives = 0;
+  for (int i = 0; i < rows; i++) {
+    double y = *(vector + i);
+    int positive = y >= 0;
+    int negative = y < 0;
+    positives += positive;
+    negatives += negative;
+    min_pos = (positive && y < min_pos) ? y : min_pos;
+    max_pos = (positive && y > max_pos) ? y : max_pos;
+    min_neg = (negative && y < min_neg) ? y : min_neg;
+    max_neg = (negative && y > max_neg) ? y : max_neg;
+  }
+  if (positives + negatives != rows) {
+    return 0; // NaN is skipped by yjCalculationCtx, keep the checked path
+  }
+  if (positives && (max_pos > context->yj1.upper_limit ||
+                    min_pos < context->yj1.lower_limit ||
+                    max_pos >= g_max_high_double)) {
+    return 0;
+  }
+  if (negatives && (max_neg > context->yj3.upper_limit ||
+                    min_neg < context->yj3.lower_limit)) {
+    return 0;
+  }
+  double highest = 0, lowest = 0;
+  yjCalculationU(positives ? max_pos : max_neg, upper_lambda, &highest);
+  yjCalculationU(negatives ? min_neg : min_pos, lower_lambda, &lowest);
+  highest = fabs(highest) > fabs(lowest) ? fabs(highest) : fabs(lowest);
+  if (!(highest <= DBL_MAX)) {
+    return 0;
+  }
+  *bound = highest;
+  *safe = 1;
+  return 0;
+}
+
+/**
+ * @brief (double) logarithms for yjTransformCached, log1p(|y|) is the only
+ * part of the transformation that does not depend on lambda
+ *
+ * @param vector values of one column
+ * @param rows amount of values
+ * @param log_cache receives log1p(|y|) of every value
+ * @return int error return code
+ */
+int yjLogCache(const double *vector, int rows, double *log_cache) {
+  if (vector == NULL || log_cache == NULL) {
+    return ERR_VECTOR_IS_NULL;
+  }
+  for (int i = 0; i < rows; i++) {
+    *(log_cache + i) = log1p(fabs(*(vector + i)));
+  }
+  return 0;
+}
+
+/**
+ * @brief (double) sum of sign(y) * log1p(|y|) over a column, the log of the
+ * Jacobian of the transformation is (lambda - 1) times this sum
+ *
+ * @param vector values of one column
+ * @param log_cache log1p(|y|) of the column (yjLogCache), or NULL
+ * @param rows amount of values
+ * @param result sum of sign(y) * log1p(|y|)
+ * @return int error return code
+ */
+int yjSignedLogSum(const double *vector, const double *log_cache, int rows,
+                   double *result) {
+  *result = 0;
+  if (vector == NULL) {
+    return ERR_VECTOR_IS_NULL;
+  }
+  for (int i = 0; i < rows; i++) {
+    double log_a =
+        log_cache != NULL ? *(log_cache + i) : log1p(fabs(*(vector + i)));
+    *result += *(vector + i) < 0 ? -log_a : log_a;
+  }
+  return 0;
+}
+
+/**
+ * @brief (double) Yeo Johnson transformation of a column validated by
+ * yjValidateColumnCtx from its cached logarithms, expm1(p * log1p(|y|)) / p
+ * replaces pow(|y| + 1, p); full blocks go through the vector kernel
+ *
+ * @param vector values of one column
+ * @param log_cache logarithms of yjLogCache
+ * @param rows amount of values
+ * @param lambda transformation parameter
+ * @param result receives the transformed values
+ * @return int error return code
+ */
+int yjTransformCached(const double *vector, const double *log_cache, int rows,
+                      double lambda, double *result) {
+  int i = 0;
+  while (i < rows) {
+    i += ybTransformCached(vector + i, log_cache + i, rows - i, lambda,
+                            result + i);
+    int block_end = (i + YB_BLOCK_SIZE < rows) ? i + YB_BLOCK_SIZE : rows;
+    for (; i < block_end; i++) {
+      *(result + i) = yjCachedValue(*(vector + i), *(log_cache + i), lambda);
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief adds one value to streaming moments (Welford/Terriberry update)
+ *
+ * @param moments moments so far
+ * @param value value to be added
+ */
+void yjMomentsAdd(yjMoments *moments, double value) {
+  double count = moments->count + 1;
+  double delta = value - moments->mean;
+  double delta_n = delta / count;
+  double term = delta * delta_n * moments->count;
+  moments->mean += delta_n;
+  moments->m3 += term * delta_n * (count - 2) - 3 * delta_n * moments->m2;
+  moments->m2 += term;
+  moments->count = count;
+}
+
+/**
+ * @brief merges the moments of a second, disjoint set of values into moments
+ * (pairwise formulas of Chan et al. extended to M3 by Terriberry)
+ *
+ * @param moments moments of the first set, receives the moments of both
+ * @param other moments of the second set
+ */
+void yjMomentsMerge(yjMoments *moments, const yjMoments *other) {
+  if (other->count == 0) {
+    return;
+  }
+  if (moments->count == 0) {
+    *moments = *other;
+    return;
+  }
+  double count_a = moments->count;
+  double count_b = other->count;
+  double count = count_a + count_b;
+  double delta = other->mean - moments->mean;
+  double delta_n = delta / count;
+  moments->m3 += other->m3 +
+                 delta * delta_n * delta_n * count_a * count_b *
+                     (count_a - count_b) +
+                 3 * delta_n * (count_a * other->m2 - count_b * moments->m2);
+  moments->m2 += other->m2 + delta * delta_n * count_a * count_b;
+  moments->mean += delta_n * count_b;
+  moments->count = count;
+}
+
+/**
+ * @brief (double) count, mean, M2 and M3 of the Yeo Johnson transformation of
+ * a column validated by yjValidateColumnCtx for several lambdas, in one pass
+ * over the cached logarithms and without storing the transformed values. The
+ * column is swept in chunks of g_batch_rows, every lambda of a batch of up to
+ * YJ_MAX_LAMBDA_BATCH passes over a chunk while it is in cache; full blocks go
+ * through the vector kernel. Every transformed value is multiplied by scale
+ * first, a power of two near 1/bound scales exactly and keeps M3 finite for
+ * every validated column.
+ *
+ * @param vector values of one column
+ * @param log_cache logarithms of yjLogCache
+ * @param rows amount of values
+ * @param lambdas transformation parameters
+ * @param lambda_count amount of lambdas
+ * @param scale factor applied to every transformed value
+ * @param moments receives the moments of the scaled transformed values of
+ * every lambda
+ * @return int error return code
+ */
+int yjMomentsCachedBatch(const double *vector, const double *log_cache,
+                         int rows, const double *lambdas, int lambda_count,
+                         double scale, yjMoments *moments) {
+  if (vector == NULL || log_cache == NULL || lambdas == NULL) {
+    return ERR_VECTOR_IS_NULL;
+  }
+  yjMoments lanes[YJ_MAX_LAMBDA_BATCH][YB_MOMENT_LANES];
+  for (int first = 0; first < lambda_count; first += YJ_MAX_LAMBDA_BATCH) {
+    int count = lambda_count - first < YJ_MAX_LAMBDA_BATCH
+                    ? lambda_count - first
+                    : YJ_MAX_LAMBDA_BATCH;
+    memset(lanes, 0, sizeof(lanes));
+    memset(moments + first, 0, sizeof(yjMoments) * count);
+    for (int chunk = 0; chunk < rows; chunk += g_batch_rows) {
+      int chunk_end = rows - chunk < g_batch_rows ? rows : chunk + g_batch_rows;
+      for (int k = 0; k < count; k++) {
+        double lambda = *(lambdas + first + k);
+        int i = chunk;
+        while (i < chunk_end) {
+          i += ybMomentsCached(vector + i, log_cache + i, chunk_end - i, lambda,
+                               scale, lanes[k]);
+          int block_end =
+              (i + YB_BLOCK_SIZE < chunk_end) ? i + YB_BLOCK_SIZE : chunk_end;
+          for (; i < block_end; i++) {
+            yjMomentsAdd(moments + first + k,
+                         yjCachedValue(*(vector + i), *(log_cache + i),
+                                       lambda) *
+                             scale);
+          }
+        }
+      }
+    }
+    for (int k = 0; k < count; k++) {
+      yjMoments vector_moments;
+      ybMomentsLanes(lanes[k], &vector_moments);
+      yjMomentsMerge(&vector_moments, moments + first + k);
+      *(moments + first + k) = vector_moments;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief (double) moments of the Yeo Johnson transformation of a validated
+ * column for one lambda, see yjMomentsCachedBatch
+ *
+ * @param vector values of one column
+ * @param log_cache logarithms of yjLogCache
+ * @param rows amount of values
+ * @param lambda transformation parameter
+ * @param scale factor applied to every transformed value
+ * @param moments receives the moments of the scaled transformed values
+ * @return int error return code
+ */
+int yjMomentsCached(const double *vector, const double *log_cache, int rows,
+                    double lambda, double scale, yjMoments *moments) {
+  return yjMomentsCachedBatch(vector, log_cache, rows, &lambda, 1, scale,
+                              moments);
+}
+
+/**
+ * @brief (double) Yeo Johnson transformation of a whole vector, uses the
+ * vectorized kernel of yjBatch.c and the checked scalar path for every block
+ * the kernel refuses (same error codes as element wise yjCalculationCtx)
+ *
+ * @param context boundary boxes of the search
+ * @param vector pointer to vector to be transformed in place
+ * @param lambda transformation parameter
+ * @param rows amount of values
+ * @return int error return code
+ */
+int yjTransformByCtx(const yjContext *context, double **vector, double lambda,
+                     int rows) {
+  int i = 0;
+  while (i < rows) {
+    if (context->set) {
+      i += ybTransform(*vector + i, rows - i, lambda, &context->yj1,
+                       &context->yj3);
+    }
+    int block_end = (i + YB_BLOCK_SIZE < rows) ? i + YB_BLOCK_SIZE : rows;
+    for (; i < block_end; i++) {
+      double result = 0;
+      int err_num = yjCalculationCtx(context, *((*vector) + i), lambda, &result);
+      if (err_num != 0) {
+        // printf("\texception in yjTransformBy\n");
+        return ERR_TRANSFORM | err_num;
+      }
+      *((*vector) + i) = result;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief (double) Yeo Johnson transformation of a whole vector with the
+ * process wide boundary boxes of buildBoundaryBox
+ *
+ * @param vector pointer to vector to be transformed in place
+ * @param lambda transformation parameter
+ * @param rows amount of values
+ * @return int error return code
+ */
 int yjTransformBy(double **vector, double lambda, int rows) {
+  return yjTransformByCtx(&g_context, vector, lambda, rows);
+}
+
+/**
+ * @brief (double) inverse of the Yeo Johnson transformation, the value y with
+ * yjCalculation(y, lambda) == x. The transformation keeps the sign, so x >= 0
+ * inverts formular 1 or 2 and x < 0 formular 3 or 4.
+ *
+ * @param x transformed value
+ * @param lambda transformation parameter
+ * @param result receives the original value
+ * @return int error return code, ERR_VALUE_NOT_IN_DOMAIN if no y is
+ * transformed to x with lambda, ERR_VALUE_OVERFLOW if y is not finite
+ */
+int yjInverseCalculation(double x, double lambda, double *result) {
+  int id = 0;
+  double y = 0;
+  if (x >= 0) {
+    if (lambda != 0) {
+      id = ERR_YJ1_ID;
+      double base = lambda * x + 1;
+      if (!(base > 0)) {
+        return ERR_TRANSFORM | id | ERR_VALUE_NOT_IN_DOMAIN;
+      }
+      y = pow(base, 1 / lambda) - 1;
+    } else {
+      id = ERR_YJ2_ID;
+      y = expm1(x);
+    }
+  } else if (x < 0) {
+    if (lambda != 2) {
+      id = ERR_YJ3_ID;
+      double base = 1 - (2 - lambda) * x;
+      if (!(base > 0)) {
+        return ERR_TRANSFORM | id | ERR_VALUE_NOT_IN_DOMAIN;
+      }
+      y = 1 - pow(base, 1 / (2 - lambda));
+    } else {
+      id = ERR_YJ4_ID;
+      y = -expm1(-x);
+    }
+  } else {
+    // NaN
+    return ERR_TRANSFORM | ERR_VALUE_NOT_IN_DOMAIN;
+  }
+  if (!isfinite(y)) {
+    return ERR_TRANSFORM | id | ERR_VALUE_OVERFLOW;
+  }
+  *result = y;
+  return 0;
+}
+
+/**
+ * @brief (double) inverse Yeo Johnson transformation of a whole vector, runs
+ * the vectorized kernel (ybInverseTransform) and falls back to
+ * yjInverseCalculation for blocks the kernel refuses; stops at the first
+ * value without an inverse
+ *
+ * @param vector pointer to vector to be transformed back in place
+ * @param lambda transformation parameter of the forward transformation
+ * @param rows amount of values
+ * @return int error return code
+ */
+int yjInverseTransformBy(double **vector, double lambda, int rows) {
+  int i = 0;
+  while (i < rows) {
+    i += ybInverseTransform(*vector + i, rows - i, lambda);
+    int block_end = (i + YB_BLOCK_SIZE < rows) ? i + YB_BLOCK_SIZE : rows;
+    for (; i < block_end; i++) {
+      int err_num =
+          yjInverseCalculation(*((*vector) + i), lambda, (*vector) + i);
+      if (err_num != 0) {
+        // printf("\texception in yjInverseTransformBy\n");
+        return err_num;
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief (float) defines the boundaries of any value passed to
+ * yjCalculationCtxf with this context
+ *
+ * @param context context of one search, owned by the caller
+ * @param lower_lambda lowest lambda possible for this search
+ * @param upper_lambda highest lambda possible for this search
+ */
+void buildBoundaryBoxCtxf(yjContextf *context, float lower_lambda,
+                          float upper_lambda) {
+  upper_lambda = (upper_lambda == 0) ? 1.0f : upper_lambda;
+  lower_lambda = (lower_lambda == 0) ? -1.0f : lower_lambda;
+  context->yj1.upper_limit =
+      powf(upper_lambda * g_max_high_float + 1, 1 / upper_lambda) - 1;
+  context->yj1.lower_limit =
+      powf(lower_lambda * g_max_low_float + 1, 1 / lower_lambda) - 1;
+
+  upper_lambda = (upper_lambda == 2) ? 3.0f : upper_lambda;
+  lower_lambda = (lower_lambda == 2) ? 1.0f : lower_lambda;
+  context->yj3.upper_limit =
+      -(powf(-g_max_high_float * (2 - upper_lambda) + 1,
+             1 / (2 - upper_lambda)) -
+        1);
+  context->yj3.lower_limit =
+      -(powf(-g_max_low_float * (2 - lower_lambda) + 1,
+             1 / (2 - lower_lambda)) -
+        1);
+  context->set = 1;
+}
+
+/**
+ * @brief (float) defines the boundaries of any value passed to yjCalculationf,
+ * process wide (not reentrant, see buildBoundaryBoxCtxf)
+ *
+ * @param lower_lambda lowest lambda possible for this search
+ * @param upper_lambda highest lambda possible for this search
+ */
+void buildBoundaryBoxf(float lower_lambda, float upper_lambda) {
+  buildBoundaryBoxCtxf(&g_contextf, lower_lambda, upper_lambda);
+}
+
+/**
+ * @brief (float) Yeo Johnson transformation decision tree and error handling
+ *
+ * @param context boundary boxes of the search
+ * @param y value to be transformed
+ * @param lambda transformation parameter
+ * @param result resulting value after transformation
+ * @return int error return code
+ */
+int yjCalculationCtxf(const yjContextf *context, float y, float lambda,
+                      float *result) {
+  int errnum = 0; // yj calculation error mask
+  if (y >= 0) {
+    if (lambda != 0) {
+      errnum |= yjFormular1f(context, y, lambda, result);
+      if (errnum != 0) {
+        return ERR_YJ1_ID | errnum;
+      }
+    } else if (lambda == 0) {
+      errnum |= yjFormular2f(y, result);
+      if (errnum != 0) {
+        return ERR_YJ2_ID | errnum;
+      }
+    }
+  } else if (y < 0) {
+    if (lambda != 2) {
+      errnum |= yjFormular3f(context, y, lambda, result);
+      if (errnum != 0) {
+        return ERR_YJ3_ID | errnum;
+      }
+    } else if (lambda == 2) {
+      errnum |= yjFormular4f(y, result);
+      if (errnum != 0) {
+        return ERR_YJ4_ID | errnum;
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief (float) Yeo Johnson transformation with the process wide boundary
+ * boxes of buildBoundaryBoxf
+ *
+ * @param y value to be transformed
+ * @param lambda transformation parameter
+ * @param result resulting value after transformation
+ * @return int error return code
+ */
+int yjCalculationf(float y, float lambda, float *result) {
+  return yjCalculationCtxf(&g_contextf, y, lambda, result);
+}
+
+/**
+ * @brief (float) Yeo Johnson transformation without any checks, only for
+ * columns accepted by yjValidateColumnCtxf
+ *
+ * @param y value to be transformed
+ * @param lambda transformation parameter
+ * @param result resulting value after transformation
+ * @return int error return code
+ */
+int yjCalculationUf(float y, float lambda, float *result) {
+  if (y >= 0) {
+    if (lambda != 0) {
+      return yjFormular1Uf(y, lambda, result);
+    }
+    return yjFormular2Uf(y, result);
+  }
+  if (lambda != 2) {
+    return yjFormular3Uf(y, lambda, result);
+  }
+  return yjFormular4Uf(y, result);
+}
+
+/**
+ * @brief (float) one min/max pass over a column, see yjValidateColumnCtx
+ *
+ * @param context boundary boxes of the search
+ * @param vector column to be validated
+ * @param rows amount of values
+ * @param lower_lambda lowest lambda the search may evaluate
+ * @param upper_lambda highest lambda the search may evaluate
+ * @param safe 1 if the unchecked functions may be used on the column
+ * @param bound largest absolute transformed value, valid if safe is 1
+ * @return int error return code
+ */
+int yjValidateColumnCtxf(const yjContextf *context, const float *vector,
+                         int rows, float lower_lambda, float upper_lambda,
+                         int *safe, float *bound) {
+  *safe = 0;
+  *bound = 0;
+  if (vector == NULL) {
+    return ERR_VECTOR_IS_NULL;
+  }
+  if (!context->set || rows <= 0) {
+    return 0;
+  }
+  float min_pos = FLT_MAX, max_pos = 0;
+  float min_neg = 0, max_neg = -FLT_MAX;
+  int positives = 0, negatives = 0;
+  for (int i = 0; i < rows; i++) {
+    float y = *(vector + i);
+    int positive = y >= 0;
+    int negative = y < 0;
+    positives += positive;
+    negatives += negative;
+    min_pos = (positive && y < min_pos) ? y : min_pos;
+    max_pos = (positive && y > max_pos) ? y : max_pos;
+    min_neg = (negative && y < min_neg) ? y : min_neg;
+    max_neg = (negative && y > max_neg) ? y : max_neg;
+  }
+  if (positives + negatives != rows) {
+    return 0; // NaN is skipped by yjCalculationCtxf, keep the checked path
+  }
+  if (positives && (max_pos > context->yj1.upper_limit ||
+                    min_pos < context->yj1.lower_limit ||
+                    max_pos >= g_max_high_float)) {
+    return 0;
+  }
+  if (negatives && (max_neg > context->yj3.upper_limit ||
+                    min_neg < context->yj3.lower_limit)) {
+    return 0;
+  }
+  float highest = 0, lowest = 0;
+  yjCalculationUf(positives ? max_pos : max_neg, upper_lambda, &highest);
+  yjCalculationUf(negatives ? min_neg : min_pos, lower_lambda, &lowest);
+  highest = fabsf(highest) > fabsf(lowest) ? fabsf(highest) : fabsf(lowest);
+  if (!(highest <= FLT_MAX)) {
+    return 0;
+  }
+  *bound = highest;
+  *safe = 1;
+  return 0;
+}
+
+/**
+ * @brief (float) logarithms for yjTransformCachedf, see yjLogCache
+ *
+ * @param vector values of one column
+ * @param rows amount of values
+ * @param log_cache receives log1pf(|y|) of every value
+ * @return int error return code
+ */
+int yjLogCachef(const float *vector, int rows, float *log_cache) {
+  if (vector == NULL || log_cache == NULL) {
+    return ERR_VECTOR_IS_NULL;
+  }
   for (int i = 0; i < rows; i++) {
-    double result = 0;
-    int err_num = yjCalculation(*((*vector) + i), lambda, &result);
-    if (err_num != 0) {
-      // printf("\texception in yjTransformBy\n");
-      return ERR_TRANSFORM | err_num;
+    *(log_cache + i) = log1pf(fabsf(*(vector + i)));
+  }
+  return 0;
+}
+
+/**
+ * @brief (float) Yeo Johnson transformation from cached logarithms, see
+ * yjTransformCached
+ *
+ * @param vector values of one column
+ * @param log_cache logarithms of yjLogCachef
+ * @param rows amount of values
+ * @param lambda transformation parameter
+ * @param result receives the transformed values
+ * @return int error return code
+ */
+int yjTransformCachedf(const float *vector, const float *log_cache, int rows,
+                       float lambda, float *result) {
+  int i = 0;
+  while (i < rows) {
+    i += ybTransformCachedf(vector + i, log_cache + i, rows - i, lambda,
+                             result + i);
+    int block_end = (i + YB_BLOCK_SIZEF < rows) ? i + YB_BLOCK_SIZEF : rows;
+    for (; i < block_end; i++) {
+      *(result + i) = yjCachedValuef(*(vector + i), *(log_cache + i), lambda);
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief (float) moments of the transformation from cached logarithms for
+ * several lambdas, accumulated in double, see yjMomentsCachedBatch
+ *
+ * @param vector values of one column
+ * @param log_cache logarithms of yjLogCachef
+ * @param rows amount of values
+ * @param lambdas transformation parameters
+ * @param lambda_count amount of lambdas
+ * @param scale factor applied to every transformed value
+ * @param moments receives the moments of the scaled transformed values of
+ * every lambda
+ * @return int error return code
+ */
+int yjMomentsCachedBatchf(const float *vector, const float *log_cache,
+                          int rows, const float *lambdas, int lambda_count,
+                          double scale, yjMoments *moments) {
+  if (vector == NULL || log_cache == NULL || lambdas == NULL) {
+    return ERR_VECTOR_IS_NULL;
+  }
+  yjMoments lanes[YJ_MAX_LAMBDA_BATCH][YB_MOMENT_LANES];
+  for (int first = 0; first < lambda_count; first += YJ_MAX_LAMBDA_BATCH) {
+    int count = lambda_count - first < YJ_MAX_LAMBDA_BATCH
+                    ? lambda_count - first
+                    : YJ_MAX_LAMBDA_BATCH;
+    memset(lanes, 0, sizeof(lanes));
+    memset(moments + first, 0, sizeof(yjMoments) * count);
+    for (int chunk = 0; chunk < rows; chunk += g_batch_rows) {
+      int chunk_end = rows - chunk < g_batch_rows ? rows : chunk + g_batch_rows;
+      for (int k = 0; k < count; k++) {
+        float lambda = *(lambdas + first + k);
+        int i = chunk;
+        while (i < chunk_end) {
+          i += ybMomentsCachedf(vector + i, log_cache + i, chunk_end - i,
+                                lambda, scale, lanes[k]);
+          int block_end =
+              (i + YB_BLOCK_SIZEF < chunk_end) ? i + YB_BLOCK_SIZEF : chunk_end;
+          for (; i < block_end; i++) {
+            yjMomentsAdd(moments + first + k,
+                         (double)yjCachedValuef(*(vector + i),
+                                                *(log_cache + i), lambda) *
+                             scale);
+          }
+        }
+      }
+    }
+    for (int k = 0; k < count; k++) {
+      yjMoments vector_moments;
+      ybMomentsLanes(lanes[k], &vector_moments);
+      yjMomentsMerge(&vector_moments, moments + first + k);
+      *(moments + first + k) = vector_moments;
     }
-    *((*vector) + i) = result;
   }
   return 0;
 }
 
+/**
+ * @brief (float) moments of the transformation from cached logarithms for one
+ * lambda, see yjMomentsCachedBatchf
+ *
+ * @param vector values of one column
+ * @param log_cache logarithms of yjLogCachef
+ * @param rows amount of values
+ * @param lambda transformation parameter
+ * @param scale factor applied to every transformed value
+ * @param moments receives the moments of the scaled transformed values
+ * @return int error return code
+ */
+int yjMomentsCachedf(const float *vector, const float *log_cache, int rows,
+                     float lambda, double scale, yjMoments *moments) {
+  return yjMomentsCachedBatchf(vector, log_cache, rows, &lambda, 1, scale,
+                               moments);
+}
+
+/**
+ * @brief (float) Yeo Johnson transformation of a whole vector, vectorized like
+ * yjTransformByCtx
+ *
+ * @param context boundary boxes of the search
+ * @param vector pointer to vector to be transformed in place
+ * @param lambda transformation parameter
+ * @param rows amount of values
+ * @return int error return code
+ */
+int yjTransformByCtxf(const yjContextf *context, float **vector, float lambda,
+                      int rows) {
+  int i = 0;
+  while (i < rows) {
+    if (context->set) {
+      i += ybTransformf(*vector + i, rows - i, lambda, &context->yj1,
+                        &context->yj3);
+    }
+    int block_end = (i + YB_BLOCK_SIZEF < rows) ? i + YB_BLOCK_SIZEF : rows;
+    for (; i < block_end; i++) {
+      float result = 0;
+      int err_num =
+          yjCalculationCtxf(context, *((*vector) + i), lambda, &result);
+      if (err_num != 0) {
+        return ERR_TRANSFORM | err_num;
+      }
+      *((*vector) + i) = result;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief (float) Yeo Johnson transformation of a whole vector with the process
+ * wide boundary boxes of buildBoundaryBoxf
+ *
+ * @param vector pointer to vector to be transformed in place
+ * @param lambda transformation parameter
+ * @param rows amount of values
+ * @return int error return code
+ */
+int yjTransformByf(float **vector, float lambda, int rows) {
+  return yjTransformByCtxf(&g_contextf, vector, lambda, rows);
+}
+
 /*****************************************************************************
  *                                  TESTS
  *****************************************************************************/
@@ -239,31 +1240,31 @@ int yjTransformBy(double **vector, double lambda, int rows) {
 #ifdef UNIT_TEST
 
 void test_yj1(void) {
-  bB_set = 0;
+  g_context.set = 0;
   double result;
   // test boundary box flag
   printf("Testing yjFormular1 in yeoJohnson.c\n");
   assert_int_equals(
-      yjFormular1(0, 1, &result), -1,
+      yjFormular1(&g_context, 0, 1, &result), ERR_BB_NOT_SET,
       "Error: Boundary box for yj1 is not set but still executed");
-  bB_set = 1;
-  bB_yj1.lower_limit = -1;
-  bB_yj1.upper_limit = 1;
-  assert_int_equals(yjFormular1(0, 1, &result), 0,
+  g_context.set = 1;
+  g_context.yj1.lower_limit = -1;
+  g_context.yj1.upper_limit = 1;
+  assert_int_equals(yjFormular1(&g_context, 0, 1, &result), 0,
                     "Error: Boundary box for yj1 is set but did not execute");
   // test limit
   assert_int_equals(
-      yjFormular1(-2, 1, &result), -2,
+      yjFormular1(&g_context, -2, 1, &result), ERR_VALUE_NOT_IN_BB,
       "Error: y=-2 is not inside limits [-1;1] but still executed");
   assert_int_equals(
-      yjFormular1(2, 1, &result), -2,
+      yjFormular1(&g_context, 2, 1, &result), ERR_VALUE_NOT_IN_BB,
       "Error: y=2 is not inside limits [-1;1] but still executed");
-  assert_int_equals(yjFormular1(0, 1, &result), 0,
+  assert_int_equals(yjFormular1(&g_context, 0, 1, &result), 0,
                     "Error: y=0 is inside limits [-1;1] but did not execute");
   // test formular
-  bB_yj1.lower_limit = -500;
-  bB_yj1.upper_limit = 500;
-  yjFormular1(100, 2, &result);
+  g_context.yj1.lower_limit = -500;
+  g_context.yj1.upper_limit = 500;
+  yjFormular1(&g_context, 100, 2, &result);
   double expected = (pow(100 + 1, 2) - 1) / 2;
   assert_double_equals(result, expected,
                        "Error: result is not equal to expected");
@@ -271,30 +1272,30 @@ void test_yj1(void) {
 }
 
 void test_yj1f(void) {
-  bBf_set = 0;
+  g_contextf.set = 0;
   float result;
   // test boundary box flag
   printf("Testing yjFormular1f in yeoJohnson.c\n");
-  assert_int_equals(yjFormular1f(0, 1, &result), -1,
+  assert_int_equals(yjFormular1f(&g_contextf, 0, 1, &result), ERR_BB_NOT_SET,
                     "Error: Boundary box is not set but still executed");
-  bBf_set = 1;
-  bBf_yj1.lower_limit = -1;
-  bBf_yj1.upper_limit = 1;
-  assert_int_equals(yjFormular1f(0, 1, &result), 0,
+  g_contextf.set = 1;
+  g_contextf.yj1.lower_limit = -1;
+  g_contextf.yj1.upper_limit = 1;
+  assert_int_equals(yjFormular1f(&g_contextf, 0, 1, &result), 0,
                     "Error: Boundary box is set but did not execute");
   // test limit
   assert_int_equals(
-      yjFormular1f(-2, 1, &result), -2,
+      yjFormular1f(&g_contextf, -2, 1, &result), ERR_VALUE_NOT_IN_BB,
       "Error: y=-2 is not inside limits [-1;1] but still executed");
   assert_int_equals(
-      yjFormular1f(2, 1, &result), -2,
+      yjFormular1f(&g_contextf, 2, 1, &result), ERR_VALUE_NOT_IN_BB,
       "Error: y=2 is not inside limits [-1;1] but still executed");
-  assert_int_equals(yjFormular1f(0, 1, &result), 0,
+  assert_int_equals(yjFormular1f(&g_contextf, 0, 1, &result), 0,
                     "Error: y=0 is inside limits [-1;1] but did not execute");
   // test formular
-  bBf_yj1.lower_limit = -500;
-  bBf_yj1.upper_limit = 500;
-  yjFormular1f(100, 2, &result);
+  g_contextf.yj1.lower_limit = -500;
+  g_contextf.yj1.upper_limit = 500;
+  yjFormular1f(&g_contextf, 100, 2, &result);
   float expected = (powf(100 + 1, 2) - 1) / 2;
   assert_float_equals(result, expected,
                       "Error: result is not equal to expected");
@@ -325,7 +1326,7 @@ void test_yj2(void) {
   double result;
   // test overflow
   printf("Testing yjFormular2 in yeoJohnson.c\n");
-  assert_int_equals(yjFormular2(g_max_high_double, &result), -1,
+  assert_int_equals(yjFormular2(g_max_high_double, &result), ERR_VALUE_OVERFLOW,
                     "Error: y should overflow but still executed");
   // test success
   assert_int_equals(yjFormular2(2, &result), 0,
@@ -342,7 +1343,7 @@ void test_yj2f(void) {
   float result;
   // test overflow
   printf("Testing yjFormular2f in yeoJohnson.c\n");
-  assert_int_equals(yjFormular2f(g_max_high_float, &result), -1,
+  assert_int_equals(yjFormular2f(g_max_high_float, &result), ERR_VALUE_OVERFLOW,
                     "Error: y should overflow but still executed");
   // test success
   assert_int_equals(yjFormular2f(2, &result), 0,
@@ -378,31 +1379,31 @@ void test_yj2Uf(void) {
 }
 
 void test_yj3(void) {
-  bB_set = 0;
+  g_context.set = 0;
   double result;
   // test boundary box flag
   printf("Testing yjFormular3 in yeoJohnson.c\n");
   assert_int_equals(
-      yjFormular3(-1, 1, &result), -1,
+      yjFormular3(&g_context, -1, 1, &result), ERR_BB_NOT_SET,
       "Error: Boundary box for yj3 is not set but still executed");
-  bB_set = 1;
-  bB_yj3.lower_limit = -2;
-  bB_yj3.upper_limit = 2;
-  assert_int_equals(yjFormular3(-1, 1, &result), 0,
+  g_context.set = 1;
+  g_context.yj3.lower_limit = -2;
+  g_context.yj3.upper_limit = 2;
+  assert_int_equals(yjFormular3(&g_context, -1, 1, &result), 0,
                     "Error: Boundary box for yj3 is set but did not execute");
   // test limit
   assert_int_equals(
-      yjFormular3(-3, 1, &result), -2,
+      yjFormular3(&g_context, -3, 1, &result), ERR_VALUE_NOT_IN_BB,
       "Error: y=-3 is not inside limits [-2;2] but still executed");
   assert_int_equals(
-      yjFormular3(3, 1, &result), -2,
+      yjFormular3(&g_context, 3, 1, &result), ERR_VALUE_NOT_IN_BB,
       "Error: y=3 is not inside limits [-2;2] but still executed");
-  assert_int_equals(yjFormular3(-1, 1, &result), 0,
+  assert_int_equals(yjFormular3(&g_context, -1, 1, &result), 0,
                     "Error: y=-1 is inside limits [-2;2] but did not execute");
   // test formular
-  bB_yj3.lower_limit = -500;
-  bB_yj3.upper_limit = 500;
-  yjFormular3(100, 3, &result);
+  g_context.yj3.lower_limit = -500;
+  g_context.yj3.upper_limit = 500;
+  yjFormular3(&g_context, 100, 3, &result);
   double expected = -(pow(-100 + 1, 2 - 3) - 1) / (2 - 3);
   assert_double_equals(result, expected,
                        "Error: result is not equal to expected");
@@ -410,31 +1411,31 @@ void test_yj3(void) {
 }
 
 void test_yj3f(void) {
-  bBf_set = 0;
+  g_contextf.set = 0;
   float result;
   // test boundary box flag
   printf("Testing yjFormular3f in yeoJohnson.c\n");
   assert_int_equals(
-      yjFormular3f(-1, 1, &result), -1,
+      yjFormular3f(&g_contextf, -1, 1, &result), ERR_BB_NOT_SET,
       "Error: Boundary box for yj3f is not set but still executed");
-  bBf_set = 1;
-  bBf_yj3.lower_limit = -2;
-  bBf_yj3.upper_limit = 2;
-  assert_int_equals(yjFormular3f(-1, 1, &result), 0,
+  g_contextf.set = 1;
+  g_contextf.yj3.lower_limit = -2;
+  g_contextf.yj3.upper_limit = 2;
+  assert_int_equals(yjFormular3f(&g_contextf, -1, 1, &result), 0,
                     "Error: Boundary box for yj3f is set but did not execute");
   // test limit
   assert_int_equals(
-      yjFormular3f(-3, 1, &result), -2,
+      yjFormular3f(&g_contextf, -3, 1, &result), ERR_VALUE_NOT_IN_BB,
       "Error: y=-3 is not inside limits [-2;2] but still executed");
   assert_int_equals(
-      yjFormular3f(3, 1, &result), -2,
+      yjFormular3f(&g_contextf, 3, 1, &result), ERR_VALUE_NOT_IN_BB,
       "Error: y=3 is not inside limits [-2;2] but still executed");
-  assert_int_equals(yjFormular3f(-1, 1, &result), 0,
+  assert_int_equals(yjFormular3f(&g_contextf, -1, 1, &result), 0,
                     "Error: y=-1 is inside limits [-2;2] but did not execute");
   // test formular
-  bBf_yj3.lower_limit = -500;
-  bBf_yj3.upper_limit = 500;
-  yjFormular3f(-100, 3, &result);
+  g_contextf.yj3.lower_limit = -500;
+  g_contextf.yj3.upper_limit = 500;
+  yjFormular3f(&g_contextf, -100, 3, &result);
   float expected = -(powf(-(-100) + 1, 2 - 3) - 1) / (2 - 3);
   assert_float_equals(result, expected,
                       "Error: result is not equal to expected");
@@ -465,7 +1466,7 @@ void test_yj4(void) {
   double result;
   // test overflow
   printf("Testing yjFormular4 in yeoJohnson.c\n");
-  assert_int_equals(yjFormular4(g_max_low_double, &result), -1,
+  assert_int_equals(yjFormular4(g_max_low_double, &result), ERR_VALUE_OVERFLOW,
                     "Error: y should overflow but still executed");
   // test success
   assert_int_equals(yjFormular4(2, &result), 0,
@@ -482,7 +1483,7 @@ void test_yj4f(void) {
   float result;
   // test overflow
   printf("Testing yjFormular4f in yeoJohnson.c\n");
-  assert_int_equals(yjFormular4f(g_max_low_float, &result), -1,
+  assert_int_equals(yjFormular4f(g_max_low_float, &result), ERR_VALUE_OVERFLOW,
                     "Error: y should overflow but still executed");
   // test success
   assert_int_equals(yjFormular4f(2, &result), 0,
@@ -520,64 +1521,64 @@ void test_yj4Uf(void) {
 void test_buildBoundaryBox(void) {
   // double
   printf("Testing buildBoundaryBox in yeoJohnson.c\n");
-  assert_int_equals(bB_set, 0,
+  assert_int_equals(g_context.set, 0,
                     "Error: boundary box flag is set 1 but should be 0");
   buildBoundaryBox(0, 0);
-  assert_int_equals(bB_set, 1,
+  assert_int_equals(g_context.set, 1,
                     "Error: boundary box flag is set 0 but should be 1");
   assert_double_equals(
-      bB_yj1.upper_limit, pow(1 * g_max_high_double + 1, 1 / 1) - 1,
-      "Error: bB_yj1.upper_limit is 0 but should be corrected to 1");
+      g_context.yj1.upper_limit, pow(1 * g_max_high_double + 1, 1 / 1) - 1,
+      "Error: g_context.yj1.upper_limit is 0 but should be corrected to 1");
   assert_double_equals(
-      bB_yj1.lower_limit, pow(-1 * g_max_low_double + 1, 1 / -1) - 1,
-      "Error: bB_yj1.lower_limit is 0 but should be corrected to -1");
+      g_context.yj1.lower_limit, pow(-1 * g_max_low_double + 1, 1 / -1) - 1,
+      "Error: g_context.yj1.lower_limit is 0 but should be corrected to -1");
   buildBoundaryBox(2, 2);
   assert_double_equals(
-      bB_yj3.upper_limit,
+      g_context.yj3.upper_limit,
       -(pow(-g_max_high_double * (2 - 3) + 1, 1 / (2 - 3)) - 1),
-      "Error: bB_yj3.upper_limit is 2 but should be corrected to 3");
+      "Error: g_context.yj3.upper_limit is 2 but should be corrected to 3");
   assert_double_equals(
-      bB_yj3.lower_limit,
+      g_context.yj3.lower_limit,
       -(pow(-g_max_low_double * (2 - 1) + 1, 1 / (2 - 1)) - 1),
-      "Error: bB_yj3.upper_limit is 2 but should be corrected to 1");
+      "Error: g_context.yj3.upper_limit is 2 but should be corrected to 1");
   printf("...done\n");
 
   // float
   printf("Testing buildBoundaryBoxf in yeoJohnson.c\n");
-  assert_int_equals(bBf_set, 0,
+  assert_int_equals(g_contextf.set, 0,
                     "Error: boundary box flag is set 1 but should be 0");
   buildBoundaryBoxf(0, 0);
-  assert_int_equals(bBf_set, 1,
+  assert_int_equals(g_contextf.set, 1,
                     "Error: boundary box flag is set 0 but should be 1");
   assert_double_equals(
-      bBf_yj1.upper_limit, powf(1 * g_max_high_float + 1, 1 / 1) - 1,
-      "Error: bBf_yj1.upper_limit is 0 but should be corrected to 1");
+      g_contextf.yj1.upper_limit, powf(1 * g_max_high_float + 1, 1 / 1) - 1,
+      "Error: g_contextf.yj1.upper_limit is 0 but should be corrected to 1");
   assert_double_equals(
-      bBf_yj1.lower_limit, powf(-1 * g_max_low_float + 1, 1 / -1) - 1,
-      "Error: bBf_yj1.lower_limit is 0 but should be corrected to -1");
+      g_contextf.yj1.lower_limit, powf(-1 * g_max_low_float + 1, 1 / -1) - 1,
+      "Error: g_contextf.yj1.lower_limit is 0 but should be corrected to -1");
   buildBoundaryBoxf(2, 2);
   assert_double_equals(
-      bBf_yj3.upper_limit,
+      g_contextf.yj3.upper_limit,
       -(powf(-g_max_high_float * (2 - 3) + 1, 1 / (2 - 3)) - 1),
-      "Error: bBf_yj3.upper_limit is 2 but should be corrected to 3");
+      "Error: g_contextf.yj3.upper_limit is 2 but should be corrected to 3");
   assert_double_equals(
-      bBf_yj3.lower_limit,
+      g_contextf.yj3.lower_limit,
       -(powf(-g_max_low_float * (2 - 1) + 1, 1 / (2 - 1)) - 1),
-      "Error: bBf_yj3.upper_limit is 2 but should be corrected to 1");
+      "Error: g_contextf.yj3.upper_limit is 2 but should be corrected to 1");
   printf("...done\n");
 }
 
 void test_yjCalculation(void) {
   double result;
   printf("Testing yjCalculation in yeoJohnson.c\n");
-  bB_set = 0;
-  assert_int_equals(yjCalculation(0, 1, &result), -1,
+  g_context.set = 0;
+  assert_int_equals(yjCalculation(0, 1, &result), ERR_YJ1_ID | ERR_BB_NOT_SET,
                     "Error: exception in yjFormular1 did not get triggered");
-  assert_int_equals(yjCalculation(g_max_high_double, 0, &result), -1,
+  assert_int_equals(yjCalculation(g_max_high_double, 0, &result), ERR_YJ2_ID | ERR_VALUE_OVERFLOW,
                     "Error: exception in yjFormular2 did not get triggered");
-  assert_int_equals(yjCalculation(-1, 1, &result), -1,
+  assert_int_equals(yjCalculation(-1, 1, &result), ERR_YJ3_ID | ERR_BB_NOT_SET,
                     "Error: exception in yjFormular3 did not get triggered");
-  assert_int_equals(yjCalculation(g_max_low_double, 2, &result), -1,
+  assert_int_equals(yjCalculation(g_max_low_double, 2, &result), ERR_YJ1_ID | ERR_BB_NOT_SET,
                     "Error: exception in yjFormular4 did not get triggered");
   buildBoundaryBox(-2, 2);
   assert_int_equals(yjCalculation(0, 1, &result), 0,
@@ -603,14 +1604,14 @@ void test_yjCalculation(void) {
 void test_yjCalculationf(void) {
   float result;
   printf("Testing yjCalculationf in yeoJohnson.c\n");
-  bBf_set = 0;
-  assert_int_equals(yjCalculationf(0, 1, &result), -1,
+  g_contextf.set = 0;
+  assert_int_equals(yjCalculationf(0, 1, &result), ERR_YJ1_ID | ERR_BB_NOT_SET,
                     "Error: exception in yjFormular1f did not get triggered");
-  assert_int_equals(yjCalculationf(g_max_high_float, 0, &result), -1,
+  assert_int_equals(yjCalculationf(g_max_high_float, 0, &result), ERR_YJ2_ID | ERR_VALUE_OVERFLOW,
                     "Error: exception in yjFormular2f did not get triggered");
-  assert_int_equals(yjCalculationf(-1, 1, &result), -1,
+  assert_int_equals(yjCalculationf(-1, 1, &result), ERR_YJ3_ID | ERR_BB_NOT_SET,
                     "Error: exception in yjFormular3f did not get triggered");
-  assert_int_equals(yjCalculationf(g_max_low_float, 2, &result), -1,
+  assert_int_equals(yjCalculationf(g_max_low_float, 2, &result), ERR_YJ1_ID | ERR_BB_NOT_SET,
                     "Error: exception in yjFormular4f did not get triggered");
   buildBoundaryBoxf(-2, 2);
   assert_int_equals(yjCalculationf(0, 1, &result), 0,
@@ -635,7 +1636,7 @@ void test_yjCalculationf(void) {
 void test_yjCalculationU(void) {
   double result;
   printf("Testing yjCalculationU in yeoJohnson.c\n");
-  bB_set = 0;
+  g_context.set = 0;
   buildBoundaryBox(-2, 2);
   assert_int_equals(yjCalculationU(0, 1, &result), 0,
                     "Error: exception triggered but should not");
@@ -659,7 +1660,7 @@ void test_yjCalculationU(void) {
 void test_yjCalculationUf(void) {
   float result;
   printf("Testing yjCalculationf in yeoJohnson.c\n");
-  bBf_set = 0;
+  g_contextf.set = 0;
   buildBoundaryBoxf(-2, 2);
   assert_int_equals(yjCalculationUf(0, 1, &result), 0,
                     "Error: exception triggered but should not");
@@ -680,4 +1681,198 @@ void test_yjCalculationUf(void) {
   printf("...done\n");
 }
 
-#endif
\ No newline at end of file
+void test_yjCalculationCtx(void) {
+  double result;
+  yjContext narrow;
+  yjContext wide;
+  printf("Testing yjCalculationCtx in yeoJohnson.c\n");
+  narrow.set = 0;
+  assert_int_equals(yjCalculationCtx(&narrow, 0, 1, &result),
+                    ERR_YJ1_ID | ERR_BB_NOT_SET,
+                    "Error: context is not set but still executed");
+  buildBoundaryBoxCtx(&narrow, -0.5, 0.5);
+  buildBoundaryBoxCtx(&wide, -3, 3);
+  assert_int_equals(narrow.set, 1, "Error: context flag should be 1");
+  assert_int_equals(wide.yj1.upper_limit < narrow.yj1.upper_limit, 1,
+                    "Error: wider interval must give a smaller box");
+  // contexts do not influence each other
+  double y = (narrow.yj1.upper_limit + wide.yj1.upper_limit) / 2;
+  assert_int_equals(yjCalculationCtx(&narrow, y, 0.5, &result), 0,
+                    "Error: value is inside narrow box but did not execute");
+  assert_int_equals(yjCalculationCtx(&wide, y, 0.5, &result),
+                    ERR_YJ1_ID | ERR_VALUE_NOT_IN_BB,
+                    "Error: value is outside wide box but still executed");
+  printf("...done\n");
+}
+
+void test_yjInverseCalculation(void) {
+  double result;
+  double lambdas[6] = {-1.5, 0, 0.5, 1, 2, 3.5};
+  double vector[7] = {-50, -2.5, -1e-9, 0, 1e-9, 0.75, 40};
+  printf("Testing yjInverseCalculation in yeoJohnson.c\n");
+  // round trip through all four formulars, lambda 0 and 2 included
+  for (int l = 0; l < 6; l++) {
+    for (int i = 0; i < 7; i++) {
+      double x = 0;
+      yjCalculationU(vector[i], lambdas[l], &x);
+      assert_int_equals(yjInverseCalculation(x, lambdas[l], &result), 0,
+                        "Error: should execute");
+      is_in_bound(result, vector[i], 1e-9 * (1 + fabs(vector[i])),
+                  "Error: inverse does not return the original value");
+    }
+  }
+  // x >= -1 / lambda is beyond every transformed value of lambda < 0
+  assert_int_equals(yjInverseCalculation(2, -0.5, &result),
+                    ERR_TRANSFORM | ERR_YJ1_ID | ERR_VALUE_NOT_IN_DOMAIN,
+                    "Error: value has no inverse but still executed");
+  assert_int_equals(yjInverseCalculation(-1, 3, &result),
+                    ERR_TRANSFORM | ERR_YJ3_ID | ERR_VALUE_NOT_IN_DOMAIN,
+                    "Error: value has no inverse but still executed");
+  assert_int_equals(yjInverseCalculation(800, 0, &result),
+                    ERR_TRANSFORM | ERR_YJ2_ID | ERR_VALUE_OVERFLOW,
+                    "Error: inverse overflows but still executed");
+  printf("...done\n");
+}
+
+void test_yjValidateColumnCtx(void) {
+  yjContext context;
+  int safe;
+  double bound;
+  double result;
+  double vector[4] = {-2, 0, 1, 3};
+  printf("Testing yjValidateColumnCtx in yeoJohnson.c\n");
+  buildBoundaryBoxCtx(&context, -3, 3);
+  assert_int_equals(yjValidateColumnCtx(&context, NULL, 4, -3, 3, &safe, &bound),
+                    ERR_VECTOR_IS_NULL, "Error: vector is null, should abort");
+  assert_int_equals(yjValidateColumnCtx(&context, vector, 4, -3, 3, &safe,
+                                        &bound),
+                    0, "Error: should execute");
+  assert_int_equals(safe, 1, "Error: column should be safe");
+  // |T(-2, -3)| = 48.4 exceeds T(3, 3) = 21
+  yjCalculationU(-2, -3, &result);
+  assert_double_equals(bound, -result, "Error: bound should be |T(min, lower)|");
+  vector[3] = context.yj1.upper_limit * 2;
+  yjValidateColumnCtx(&context, vector, 4, -3, 3, &safe, &bound);
+  assert_int_equals(safe, 0, "Error: value outside of box, should be unsafe");
+  vector[3] = NAN;
+  yjValidateColumnCtx(&context, vector, 4, -3, 3, &safe, &bound);
+  assert_int_equals(safe, 0, "Error: NaN in column, should be unsafe");
+  printf("...done\n");
+}
+
+void test_yjTransformCached(void) {
+  double vector[20];
+  double log_cache[20];
+  double result[20];
+  double expected;
+  printf("Testing yjTransformCached in yeoJohnson.c\n");
+  for (int i = 0; i < 20; i++) {
+    vector[i] = (i % 2 ? -1 : 1) * (i * 0.75);
+  }
+  vector[3] = -1e-12;
+  assert_int_equals(yjLogCache(vector, 20, log_cache), 0,
+                    "Error: should execute");
+  for (double lambda = -1; lambda <= 3; lambda += 0.5) {
+    assert_int_equals(yjTransformCached(vector, log_cache, 20, lambda, result),
+                      0, "Error: should execute");
+    for (int i = 0; i < 20; i++) {
+      yjCalculationU(vector[i], lambda, &expected);
+      is_in_bound(result[i], expected, 1e-12,
+                  "Error: cached result differs from pow result");
+    }
+  }
+  printf("...done\n");
+}
+
+void test_yjMomentsCached(void) {
+  double vector[37];
+  double log_cache[37];
+  double result[37];
+  float vectorf[37];
+  float log_cachef[37];
+  float resultf[37];
+  yjMoments moments;
+  printf("Testing yjMomentsCached in yeoJohnson.c\n");
+  for (int i = 0; i < 37; i++) {
+    vector[i] = (i % 3 ? -1 : 1) * (i * 0.4) + 0.1;
+    vectorf[i] = (float)vector[i];
+  }
+  yjLogCache(vector, 37, log_cache);
+  yjLogCachef(vectorf, 37, log_cachef);
+  for (double lambda = -1; lambda <= 3; lambda += 0.5) {
+    // two pass reference of the same scaled values
+    yjTransformCached(vector, log_cache, 37, lambda, result);
+    double mean = 0, m2 = 0, m3 = 0;
+    for (int i = 0; i < 37; i++) {
+      mean += result[i] * 0.25;
+    }
+    mean /= 37;
+    for (int i = 0; i < 37; i++) {
+      double delta = result[i] * 0.25 - mean;
+      m2 += delta * delta;
+      m3 += delta * delta * delta;
+    }
+    assert_int_equals(
+        yjMomentsCached(vector, log_cache, 37, lambda, 0.25, &moments), 0,
+        "Error: should execute");
+    assert_int_equals((int)moments.count, 37, "Error: wrong count");
+    is_in_bound(moments.mean, mean, 1e-12, "Error: wrong mean");
+    is_in_bound(moments.m2, m2, 1e-12 * m2, "Error: wrong M2");
+    is_in_bound(moments.m3, m3, 1e-12 * (m2 * sqrt(m2) + 1),
+                "Error: wrong M3");
+
+    yjTransformCachedf(vectorf, log_cachef, 37, (float)lambda, resultf);
+    mean = m2 = 0;
+    for (int i = 0; i < 37; i++) {
+      mean += resultf[i];
+    }
+    mean /= 37;
+    for (int i = 0; i < 37; i++) {
+      m2 += (resultf[i] - mean) * (resultf[i] - mean);
+    }
+    assert_int_equals(
+        yjMomentsCachedf(vectorf, log_cachef, 37, (float)lambda, 1, &moments),
+        0, "Error: should execute");
+    is_in_bound(moments.mean, mean, 1e-10, "Error: wrong mean (float)");
+    is_in_bound(moments.m2, m2, 1e-10 * m2, "Error: wrong M2 (float)");
+  }
+  printf("...done\n");
+}
+
+void test_yjMomentsCachedBatch(void) {
+  static double vector[5000];
+  static double log_cache[5000];
+  static double result[5000];
+  double lambdas[20];
+  yjMoments moments[20];
+  printf("Testing yjMomentsCachedBatch in yeoJohnson.c\n");
+  for (int i = 0; i < 5000; i++) {
+    vector[i] = (i % 5 ? -1 : 1) * (i % 11) * 0.3 + 0.05;
+  }
+  for (int k = 0; k < 20; k++) {
+    lambdas[k] = -2 + k * 0.25;
+  }
+  yjLogCache(vector, 5000, log_cache);
+  // more lambdas than one batch and more rows than one chunk
+  assert_int_equals(yjMomentsCachedBatch(vector, log_cache, 5000, lambdas, 20,
+                                         0.5, moments),
+                    0, "Error: should execute");
+  for (int k = 0; k < 20; k++) {
+    yjTransformCached(vector, log_cache, 5000, lambdas[k], result);
+    double mean = 0, m2 = 0;
+    for (int i = 0; i < 5000; i++) {
+      mean += result[i] * 0.5;
+    }
+    mean /= 5000;
+    for (int i = 0; i < 5000; i++) {
+      m2 += (result[i] * 0.5 - mean) * (result[i] * 0.5 - mean);
+    }
+    assert_int_equals((int)moments[k].count, 5000, "Error: wrong count");
+    is_in_bound(moments[k].mean, mean, 1e-12 * (fabs(mean) + 1),
+                "Error: wrong mean");
+    is_in_bound(moments[k].m2, m2, 1e-10 * m2, "Error: wrong M2");
+  }
+  printf("...done\n");
+}
+
+#endif
@@ -0,0 +1,921 @@
+/****************************************************************
+ * Copyright (c) 2023 Jerome Brenig, Sigrun May
+ * Ostfalia Hochschule für angewandte Wissenschaften
+ *
+ * This software is distributed under the terms of the MIT license
+ * which is available at https://opensource.org/licenses/MIT
+ *
+ * FILENAME : yjBatch.c
+ *
+ * DESCRIPTION  :
+ *          Vectorized Yeo Johnson transformation of whole vectors
+ *          (SSE2/AVX2/AVX-512, selected once at load time).
+ *
+ * PUBLIC FUNCTIONS :
+ *          int ybTransform(double *vector, int rows, double lambda,
+ *                          const boundaryBox *yj1, const boundaryBox *yj3)
+ *          int ybTransformf(float *vector, int rows, float lambda,
+ *                           const boundaryBoxf *yj1, const boundaryBoxf *yj3)
+ *          int ybTransformCached(vector, log_cache, rows, lambda, result)
+ *          int ybTransformCachedf(vector, log_cache, rows, lambda, result)
+ *          int ybMomentsCached(vector, log_cache, rows, lambda, scale, lanes)
+ *          int ybMomentsCachedf(vector, log_cache, rows, lambda, scale, lanes)
+ *          void ybMomentsLanes(const yjMoments *lanes, yjMoments *moments)
+ *          int ybInverseTransform(double *vector, int rows, double lambda)
+ *          int ybRowModelInit(model, cols, lambda, mean, sd, errnum)
+ *          void ybRowModelFree(ybRowModel *model)
+ *          int ybTransformRows(model, rows, row_count, row_stride)
+ *          int ybGetInstructionSet(void)
+ *          int ybSetInstructionSet(int isa)
+ *
+ * NOTES    :
+ *          The kernel processes one vector register (2, 4 or 8 values)
+ *          per iteration, the template lives in yjBatchKernel.h. Both
+ *          branches (y>=0 and y<0) are evaluated with masks using a single
+ *          vector log and exp per value. A block containing any value that
+ *          the checked formulars of yeoJohnson.c could reject (outside the
+ *          boundary box, overflow sentinel, NaN/inf) is not touched: the
+ *          kernel stops in front of it and returns the number of values
+ *          transformed, so the caller can run the checked scalar path and
+ *          produce exactly the same error codes as before.
+ *          Results agree with the pow/log scalar path to about 1e-15
+ *          relative to max(|result|, 1) (log1p/exp are the fdlibm
+ *          polynomials).
+ *          The moments kernels fuse the cached transformation with a
+ *          Welford/Terriberry update of mean, M2 and M3 per lane and never
+ *          store the transformed values. The lane state belongs to the
+ *          caller, so a column can be accumulated in chunks (several lambdas
+ *          per chunk) and the lanes are merged once at the end.
+ *          The inverse kernel evaluates expm1(log1p(p * |x|) / p) with the
+ *          same log1p/expm1 polynomials, blocks without an inverse are left
+ *          to yjInverseCalculation.
+ *          The row kernel runs across the features of one row instead, with
+ *          the lambdas, reciprocals and standardization of every feature
+ *          precomputed once (ybRowModel) for online inference.
+ *
+ * AUTHOR   :       agent             START DATE    : 16 October 2026
+ *
+ * CHANGES  :
+ *
+ * DATE     WHO     DETAIL
+ *
+ *H*/
+
+/*****************************************************************************
+ *                               INCLUDES
+ *****************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#endif
+
+#include "include/errnumCodes.h"
+#include "include/testFramework.h"
+#include "include/yeoJohnson.h"
+#include "include/yjBatch.h"
+
+/*****************************************************************************
+ *                               CONSTANTS
+ *****************************************************************************/
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define YB_X86 1
+#endif
+
+// same sentinels as yjFormular2/yjFormular4
+static const double g_max_high_double = (double)0x7FFFFFFFFFFFFF;
+static const double g_max_low_double = (double)0x80000000000000;
+
+// |lambda * log1p(|y|)| above this is left to pow (overflow/underflow)
+static const double g_max_exponent = 700.0;
+
+// fdlibm log coefficients
+static const double g_ln2_hi = 6.93147180369123816490e-01;
+static const double g_ln2_lo = 1.90821492927058770002e-10;
+static const double g_lg1 = 6.666666666666735130e-01;
+static const double g_lg2 = 3.999999999940941908e-01;
+static const double g_lg3 = 2.857142874366239149e-01;
+static const double g_lg4 = 2.222219843214978396e-01;
+static const double g_lg5 = 1.818357216161805012e-01;
+static const double g_lg6 = 1.531383769920937332e-01;
+static const double g_lg7 = 1.479819860511658591e-01;
+
+// fdlibm exp coefficients
+static const double g_inv_ln2 = 1.44269504088896338700e+00;
+static const double g_p1 = 1.66666666666666019037e-01;
+static const double g_p2 = -2.77777777770155933842e-03;
+static const double g_p3 = 6.61375632143793436117e-05;
+static const double g_p4 = -1.65339022054652515390e-06;
+static const double g_p5 = 4.13813679705723846039e-08;
+
+// float kernel: cephes logf/expf coefficients
+static const float g_max_exponentf = 80.0f;
+static const float g_max_high_float = (float)0x7FFFFFFF;
+static const float g_max_low_float = (float)0x80000000;
+static const float g_ln2f_hi = 0.693359375f;
+static const float g_ln2f_lo = -2.12194440e-4f;
+static const float g_logf_p0 = 7.0376836292e-2f;
+static const float g_logf_p1 = -1.1514610310e-1f;
+static const float g_logf_p2 = 1.1676998740e-1f;
+static const float g_logf_p3 = -1.2420140846e-1f;
+static const float g_logf_p4 = 1.4249322787e-1f;
+static const float g_logf_p5 = -1.6668057665e-1f;
+static const float g_logf_p6 = 2.0000714765e-1f;
+static const float g_logf_p7 = -2.4999993993e-1f;
+static const float g_logf_p8 = 3.3333331174e-1f;
+static const float g_expf_p0 = 1.9875691500e-4f;
+static const float g_expf_p1 = 1.3981999507e-3f;
+static const float g_expf_p2 = 8.3334519073e-3f;
+static const float g_expf_p3 = 4.1665795894e-2f;
+static const float g_expf_p4 = 1.6666665459e-1f;
+static const float g_expf_p5 = 5.0000001201e-1f;
+
+/*****************************************************************************
+ *                                 TYPES
+ *****************************************************************************/
+
+// per call constants of the kernel
+typedef struct {
+  double lambda_pos; // exponent for y>=0
+  double lambda_neg; // exponent for y<0
+  double pos_lower;  // boundary box for y>=0
+  double pos_upper;
+  double pos_sentinel; // value rejected for y>=0 (NaN if none)
+  double neg_lower;    // boundary box for y<0
+  double neg_upper;
+  double neg_sentinel; // value rejected for y<0 (NaN if none)
+} ybLimits;
+
+// float counterpart of ybLimits
+typedef struct {
+  float lambda_pos;
+  float lambda_neg;
+  float pos_lower;
+  float pos_upper;
+  float pos_sentinel;
+  float neg_lower;
+  float neg_upper;
+  float neg_sentinel;
+} ybLimitsf;
+
+typedef int (*ybKernel)(double *vector, int rows, const ybLimits *limits);
+typedef int (*ybKernelf)(float *vector, int rows, const ybLimitsf *limits);
+typedef int (*ybCachedKernel)(const double *vector, const double *log_cache,
+                              int rows, double lambda, double *result);
+typedef int (*ybCachedKernelf)(const float *vector, const float *log_cache,
+                               int rows, float lambda, float *result);
+typedef int (*ybMomentsKernel)(const double *vector, const double *log_cache,
+                               int rows, double lambda, double scale,
+                               yjMoments *lanes);
+typedef int (*ybMomentsKernelf)(const float *vector, const float *log_cache,
+                                int rows, float lambda, double scale,
+                                yjMoments *lanes);
+typedef int (*ybInverseKernel)(double *vector, int rows, double lambda);
+typedef int (*ybRowKernel)(double *row, int begin, int cols,
+                           const ybRowModel *model);
+
+/*****************************************************************************
+ *                           PRIVATE FUNCTIONS
+ *****************************************************************************/
+
+// kernel helpers are always inlined, their vector ABI never matters
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+#ifdef YB_X86
+
+#define YB_LANES 2
+#define YB_SUFFIX sse2
+#define YB_TARGET
+#define YB_ANY(mask) _mm_movemask_pd((__m128d)(mask))
+#define YB_ANYF(mask) _mm_movemask_ps((__m128)(mask))
+#include "include/yjBatchKernel.h"
+#undef YB_LANES
+#undef YB_SUFFIX
+#undef YB_TARGET
+#undef YB_ANY
+#undef YB_ANYF
+
+#define YB_LANES 4
+#define YB_SUFFIX avx2
+#define YB_TARGET __attribute__((target("avx2,fma")))
+#define YB_ANY(mask) _mm256_movemask_pd((__m256d)(mask))
+#define YB_ANYF(mask) _mm256_movemask_ps((__m256)(mask))
+#include "include/yjBatchKernel.h"
+#undef YB_LANES
+#undef YB_SUFFIX
+#undef YB_TARGET
+#undef YB_ANY
+#undef YB_ANYF
+
+#define YB_LANES 8
+#define YB_SUFFIX avx512
+#define YB_TARGET __attribute__((target("avx512f")))
+#define YB_ANY(mask) _mm512_test_epi64_mask((__m512i)(mask), (__m512i)(mask))
+#define YB_ANYF(mask) _mm512_test_epi32_mask((__m512i)(mask), (__m512i)(mask))
+#include "include/yjBatchKernel.h"
+#undef YB_LANES
+#undef YB_SUFFIX
+#undef YB_TARGET
+#undef YB_ANY
+#undef YB_ANYF
+
+#else
+
+#define YB_LANES 2
+#define YB_SUFFIX sse2
+#define YB_TARGET
+#define YB_ANY(mask) ((mask)[0] | (mask)[1])
+#define YB_ANYF(mask) ((mask)[0] | (mask)[1] | (mask)[2] | (mask)[3])
+#include "include/yjBatchKernel.h"
+#undef YB_LANES
+#undef YB_SUFFIX
+#undef YB_TARGET
+#undef YB_ANY
+#undef YB_ANYF
+
+#endif
+
+/**
+ * @brief no vector kernel, everything goes through the checked scalar path
+ */
+static int yb_transform_scalar(double *vector, int rows,
+                               const ybLimits *limits) {
+  (void)vector;
+  (void)rows;
+  (void)limits;
+  return 0;
+}
+
+/**
+ * @brief no vector kernel (float)
+ */
+static int yb_transformf_scalar(float *vector, int rows,
+                                const ybLimitsf *limits) {
+  (void)vector;
+  (void)rows;
+  (void)limits;
+  return 0;
+}
+
+/**
+ * @brief no vector kernel for cached logarithms
+ */
+static int yb_transform_cached_scalar(const double *vector,
+                                      const double *log_cache, int rows,
+                                      double lambda, double *result) {
+  (void)vector;
+  (void)log_cache;
+  (void)rows;
+  (void)lambda;
+  (void)result;
+  return 0;
+}
+
+/**
+ * @brief no vector kernel for cached logarithms (float)
+ */
+static int yb_transform_cachedf_scalar(const float *vector,
+                                       const float *log_cache, int rows,
+                                       float lambda, float *result) {
+  (void)vector;
+  (void)log_cache;
+  (void)rows;
+  (void)lambda;
+  (void)result;
+  return 0;
+}
+
+/**
+ * @brief no vector kernel for moments
+ */
+static int yb_moments_cached_scalar(const double *vector,
+                                    const double *log_cache, int rows,
+                                    double lambda, double scale,
+                                    yjMoments *lanes) {
+  (void)vector;
+  (void)log_cache;
+  (void)rows;
+  (void)lambda;
+  (void)scale;
+  (void)lanes;
+  return 0;
+}
+
+/**
+ * @brief no vector kernel for moments (float)
+ */
+static int yb_moments_cachedf_scalar(const float *vector,
+                                     const float *log_cache, int rows,
+                                     float lambda, double scale,
+                                     yjMoments *lanes) {
+  (void)vector;
+  (void)log_cache;
+  (void)rows;
+  (void)lambda;
+  (void)scale;
+  (void)lanes;
+  return 0;
+}
+
+/**
+ * @brief no vector kernel for the inverse transformation
+ */
+static int yb_inverse_transform_scalar(double *vector, int rows,
+                                       double lambda) {
+  (void)vector;
+  (void)rows;
+  (void)lambda;
+  return 0;
+}
+
+/**
+ * @brief no vector kernel for rows
+ */
+static int yb_transform_row_scalar(double *row, int begin, int cols,
+                                   const ybRowModel *model) {
+  (void)row;
+  (void)cols;
+  (void)model;
+  return begin;
+}
+
+/**
+ * @brief (double) checked scalar path of ybTransformRows for feature j, libm
+ * pow and log1p handle NaN, inf and overflow
+ *
+ * @param model per feature constants
+ * @param j index of the feature
+ * @param y value of the feature
+ * @return double transformed and standardized value
+ */
+static double yb_row_value(const ybRowModel *model, int j, double y) {
+  double result = y;
+  if (*(model->lambda_pos + j) != 1) {
+    yjCalculationU(y, *(model->lambda_pos + j), &result);
+  }
+  return (result - *(model->mean + j)) * *(model->inverse_sd + j);
+}
+
+/**
+ * @brief best instruction set supported by the running cpu
+ */
+static int yb_detect_instruction_set(void) {
+#ifdef YB_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return YB_ISA_AVX512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return YB_ISA_AVX2;
+  }
+#endif
+  return YB_ISA_SSE2;
+}
+
+static int g_isa = YB_ISA_SSE2;
+static ybKernel g_kernel = yb_transform_sse2;
+static ybKernelf g_kernelf = yb_transformf_sse2;
+static ybCachedKernel g_cached = yb_transform_cached_sse2;
+static ybCachedKernelf g_cachedf = yb_transform_cachedf_sse2;
+static ybMomentsKernel g_moments = yb_moments_cached_sse2;
+static ybMomentsKernelf g_momentsf = yb_moments_cachedf_sse2;
+static ybInverseKernel g_inverse = yb_inverse_transform_sse2;
+static ybRowKernel g_row = yb_transform_row_sse2;
+static int g_lanes = 2;
+
+/**
+ * @brief selects the kernel once when the library is loaded
+ */
+__attribute__((constructor)) static void yb_init(void) {
+  ybSetInstructionSet(yb_detect_instruction_set());
+}
+
+/*****************************************************************************
+ *                           PUBLIC FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * @brief (double) vectorized Yeo Johnson transformation of the leading part of
+ * a vector, stops in front of the first block that needs the checked path
+ *
+ * @param vector values to be transformed in place
+ * @param rows amount of values
+ * @param lambda transformation parameter
+ * @param yj1 boundary box of yjFormular1
+ * @param yj3 boundary box of yjFormular3
+ * @return int amount of values transformed (at most YB_BLOCK_SIZE short of rows)
+ */
+int ybTransform(double *vector, int rows, double lambda,
+                const boundaryBox *yj1, const boundaryBox *yj3) {
+  ybLimits limits;
+  limits.lambda_pos = lambda;
+  limits.lambda_neg = 2 - lambda;
+  if (lambda != 0) {
+    limits.pos_lower = yj1->lower_limit;
+    limits.pos_upper = yj1->upper_limit;
+    limits.pos_sentinel = NAN;
+  } else {
+    limits.pos_lower = -INFINITY;
+    limits.pos_upper = INFINITY;
+    limits.pos_sentinel = g_max_high_double;
+  }
+  if (lambda != 2) {
+    limits.neg_lower = yj3->lower_limit;
+    limits.neg_upper = yj3->upper_limit;
+    limits.neg_sentinel = NAN;
+  } else {
+    limits.neg_lower = -INFINITY;
+    limits.neg_upper = INFINITY;
+    limits.neg_sentinel = g_max_low_double;
+  }
+  return g_kernel(vector, rows, &limits);
+}
+
+/**
+ * @brief (float) vectorized Yeo Johnson transformation of the leading part of
+ * a vector, stops in front of the first block that needs the checked path
+ *
+ * @param vector values to be transformed in place
+ * @param rows amount of values
+ * @param lambda transformation parameter
+ * @param yj1 boundary box of yjFormular1f
+ * @param yj3 boundary box of yjFormular3f
+ * @return int amount of values transformed (at most YB_BLOCK_SIZEF short of
+ * rows)
+ */
+int ybTransformf(float *vector, int rows, float lambda,
+                 const boundaryBoxf *yj1, const boundaryBoxf *yj3) {
+  ybLimitsf limits;
+  limits.lambda_pos = lambda;
+  limits.lambda_neg = 2 - lambda;
+  if (lambda != 0) {
+    limits.pos_lower = yj1->lower_limit;
+    limits.pos_upper = yj1->upper_limit;
+    limits.pos_sentinel = NAN;
+  } else {
+    limits.pos_lower = -INFINITY;
+    limits.pos_upper = INFINITY;
+    limits.pos_sentinel = g_max_high_float;
+  }
+  if (lambda != 2) {
+    limits.neg_lower = yj3->lower_limit;
+    limits.neg_upper = yj3->upper_limit;
+    limits.neg_sentinel = NAN;
+  } else {
+    limits.neg_lower = -INFINITY;
+    limits.neg_upper = INFINITY;
+    limits.neg_sentinel = g_max_low_float;
+  }
+  return g_kernelf(vector, rows, &limits);
+}
+
+/**
+ * @brief (double) vectorized transformation of a column validated by
+ * yjValidateColumnCtx from its cached log1p(|y|), see yjTransformCached
+ *
+ * @param vector values of the column
+ * @param log_cache log1p(|y|) of every value
+ * @param rows amount of values
+ * @param lambda transformation parameter
+ * @param result receives the transformed values
+ * @return int amount of values transformed (at most YB_BLOCK_SIZE short of rows)
+ */
+int ybTransformCached(const double *vector, const double *log_cache, int rows,
+                      double lambda, double *result) {
+  return g_cached(vector, log_cache, rows, lambda, result);
+}
+
+/**
+ * @brief (float) vectorized transformation from cached logarithms, see
+ * ybTransformCached
+ *
+ * @param vector values of the column
+ * @param log_cache log1pf(|y|) of every value
+ * @param rows amount of values
+ * @param lambda transformation parameter
+ * @param result receives the transformed values
+ * @return int amount of values transformed (at most YB_BLOCK_SIZEF short of
+ * rows)
+ */
+int ybTransformCachedf(const float *vector, const float *log_cache, int rows,
+                       float lambda, float *result) {
+  return g_cachedf(vector, log_cache, rows, lambda, result);
+}
+
+/**
+ * @brief (double) adds the transformed leading part of a column validated by
+ * yjValidateColumnCtx to the moments of the kernel lanes, without storing the
+ * transformed values, see yjMomentsCached
+ *
+ * @param vector values of the column
+ * @param log_cache log1p(|y|) of every value
+ * @param rows amount of values
+ * @param lambda transformation parameter
+ * @param scale factor applied to every transformed value
+ * @param lanes YB_MOMENT_LANES moments, zero before the first call
+ * @return int amount of values accumulated (at most YB_BLOCK_SIZE short of rows)
+ */
+int ybMomentsCached(const double *vector, const double *log_cache, int rows,
+                    double lambda, double scale, yjMoments *lanes) {
+  return g_moments(vector, log_cache, rows, lambda, scale, lanes);
+}
+
+/**
+ * @brief (float) adds the transformation from cached logarithms to the moments
+ * of the kernel lanes, accumulated in double, see ybMomentsCached
+ *
+ * @param vector values of the column
+ * @param log_cache log1pf(|y|) of every value
+ * @param rows amount of values
+ * @param lambda transformation parameter
+ * @param scale factor applied to every transformed value
+ * @param lanes YB_MOMENT_LANES moments, zero before the first call
+ * @return int amount of values accumulated (at most YB_BLOCK_SIZEF short of
+ * rows)
+ */
+int ybMomentsCachedf(const float *vector, const float *log_cache, int rows,
+                     float lambda, double scale, yjMoments *lanes) {
+  return g_momentsf(vector, log_cache, rows, lambda, scale, lanes);
+}
+
+/**
+ * @brief merges the kernel lanes of ybMomentsCached into moments
+ *
+ * @param lanes YB_MOMENT_LANES moments
+ * @param moments receives the moments of all lanes
+ */
+void ybMomentsLanes(const yjMoments *lanes, yjMoments *moments) {
+  memset(moments, 0, sizeof(*moments));
+  for (int lane = 0; lane < 2 * g_lanes; lane++) {
+    yjMomentsMerge(moments, lanes + lane);
+  }
+}
+
+/**
+ * @brief (double) vectorized inverse Yeo Johnson transformation of the leading
+ * part of a vector, stops in front of the first block that needs the checked
+ * path of yjInverseCalculation
+ *
+ * @param vector values to be transformed back in place
+ * @param rows amount of values
+ * @param lambda transformation parameter of the forward transformation
+ * @return int amount of values transformed (at most YB_BLOCK_SIZE short of rows)
+ */
+int ybInverseTransform(double *vector, int rows, double lambda) {
+  return g_inverse(vector, rows, lambda);
+}
+
+/**
+ * @brief precomputes the per feature constants of a fitted transformation for
+ * ybTransformRows, release with ybRowModelFree. Features the fit failed on
+ * (errnum != 0) keep their values and are only standardized.
+ *
+ * @param model receives the constants
+ * @param cols amount of features
+ * @param lambda fitted lambda of every feature
+ * @param mean mean of every transformed feature, NULL to not standardize
+ * @param sd standard deviation of every transformed feature, NULL to not
+ * standardize
+ * @param errnum result of the fit of every feature, or NULL
+ * @return int error return code
+ */
+int ybRowModelInit(ybRowModel *model, int cols, const double *lambda,
+                   const double *mean, const double *sd, const int *errnum) {
+  if (model == NULL) {
+    return ERR_VECTOR_IS_NULL;
+  }
+  memset(model, 0, sizeof(ybRowModel));
+  if (lambda == NULL || cols < 0) {
+    return ERR_VECTOR_IS_NULL;
+  }
+  // six arrays, each starting on a cache line
+  size_t stride = ((size_t)(cols > 0 ? cols : 1) + 7) / 8 * 8;
+  size_t bytes = 6 * stride * sizeof(double);
+#ifdef _WIN32
+  model->buffer = _aligned_malloc(bytes, 64);
+#else
+  if (posix_memalign(&model->buffer, 64, bytes) != 0) {
+    model->buffer = NULL;
+  }
+#endif
+  if (model->buffer == NULL) {
+    return ERR_FAILED_ALLOCATE_MEMORY;
+  }
+  double *arrays = (double *)model->buffer;
+  model->lambda_pos = arrays;
+  model->lambda_neg = arrays + stride;
+  model->inverse_pos = arrays + 2 * stride;
+  model->inverse_neg = arrays + 3 * stride;
+  model->mean = arrays + 4 * stride;
+  model->inverse_sd = arrays + 5 * stride;
+  for (int j = 0; j < cols; j++) {
+    double value = *(lambda + j);
+    if (errnum != NULL && *(errnum + j) != 0) {
+      value = 1; // the transformation with lambda 1 is the identity
+    }
+    *(model->lambda_pos + j) = value;
+    *(model->lambda_neg + j) = 2 - value;
+    *(model->inverse_pos + j) = value != 0 ? 1 / value : 0;
+    *(model->inverse_neg + j) = value != 2 ? 1 / (2 - value) : 0;
+    *(model->mean + j) = mean != NULL ? *(mean + j) : 0;
+    *(model->inverse_sd + j) = sd != NULL ? 1 / *(sd + j) : 1;
+  }
+  model->cols = cols;
+  return 0;
+}
+
+/**
+ * @brief releases the constants of ybRowModelInit
+ *
+ * @param model constants of ybRowModelInit
+ */
+void ybRowModelFree(ybRowModel *model) {
+  if (model == NULL) {
+    return;
+  }
+#ifdef _WIN32
+  _aligned_free(model->buffer);
+#else
+  free(model->buffer);
+#endif
+  memset(model, 0, sizeof(ybRowModel));
+}
+
+/**
+ * @brief (double) transforms and standardizes row_count rows of model->cols
+ * features in place, vectorized across the features; allocates nothing.
+ * Results agree with ciModelTransform to about 1e-12.
+ *
+ * @param model constants of ybRowModelInit
+ * @param rows first value of the first row
+ * @param row_count amount of rows
+ * @param row_stride distance between the first values of two rows in values
+ * @return int error return code, ERR_TRANSFORM | ERR_VALUE_OVERFLOW if any
+ * result is not finite (NaN input, overflow); all features are transformed
+ * regardless
+ */
+int ybTransformRows(const ybRowModel *model, double *rows, int row_count,
+                    long long row_stride) {
+  int cols = model->cols;
+  int finite = 1;
+  for (int r = 0; r < row_count; r++) {
+    double *row = rows + r * row_stride;
+    int j = 0;
+    while (j < cols) {
+      j = g_row(row, j, cols, model);
+      int block_end = (j + YB_BLOCK_SIZE < cols) ? j + YB_BLOCK_SIZE : cols;
+      for (; j < block_end; j++) {
+        *(row + j) = yb_row_value(model, j, *(row + j));
+        finite &= isfinite(*(row + j)) != 0;
+      }
+    }
+  }
+  return finite ? 0 : ERR_TRANSFORM | ERR_VALUE_OVERFLOW;
+}
+
+/**
+ * @brief returns the instruction set used by ybTransform and ybTransformf
+ *
+ * @return int YB_ISA_* identifier
+ */
+int ybGetInstructionSet(void) { return g_isa; }
+
+/**
+ * @brief overrides the instruction set chosen at load time (benchmarks,
+ * tests), falls back to the best supported one if isa is not available
+ *
+ * @param isa YB_ISA_* identifier
+ * @return int instruction set in use afterwards
+ */
+int ybSetInstructionSet(int isa) {
+  int supported = yb_detect_instruction_set();
+  if (isa > supported || isa < YB_ISA_SCALAR) {
+    isa = supported;
+  }
+  switch (isa) {
+  case YB_ISA_SCALAR:
+    g_kernel = yb_transform_scalar;
+    g_kernelf = yb_transformf_scalar;
+    g_cached = yb_transform_cached_scalar;
+    g_cachedf = yb_transform_cachedf_scalar;
+    g_moments = yb_moments_cached_scalar;
+    g_momentsf = yb_moments_cachedf_scalar;
+    g_inverse = yb_inverse_transform_scalar;
+    g_row = yb_transform_row_scalar;
+    g_lanes = 0;
+    break;
+#ifdef YB_X86
+  case YB_ISA_AVX512:
+    g_kernel = yb_transform_avx512;
+    g_kernelf = yb_transformf_avx512;
+    g_cached = yb_transform_cached_avx512;
+    g_cachedf = yb_transform_cachedf_avx512;
+    g_moments = yb_moments_cached_avx512;
+    g_momentsf = yb_moments_cachedf_avx512;
+    g_inverse = yb_inverse_transform_avx512;
+    g_row = yb_transform_row_avx512;
+    g_lanes = 8;
+    break;
+  case YB_ISA_AVX2:
+    g_kernel = yb_transform_avx2;
+    g_kernelf = yb_transformf_avx2;
+    g_cached = yb_transform_cached_avx2;
+    g_cachedf = yb_transform_cachedf_avx2;
+    g_moments = yb_moments_cached_avx2;
+    g_momentsf = yb_moments_cachedf_avx2;
+    g_inverse = yb_inverse_transform_avx2;
+    g_row = yb_transform_row_avx2;
+    g_lanes = 4;
+    break;
+#endif
+  default:
+    isa = YB_ISA_SSE2;
+    g_kernel = yb_transform_sse2;
+    g_kernelf = yb_transformf_sse2;
+    g_cached = yb_transform_cached_sse2;
+    g_cachedf = yb_transform_cachedf_sse2;
+    g_moments = yb_moments_cached_sse2;
+    g_momentsf = yb_moments_cachedf_sse2;
+    g_inverse = yb_inverse_transform_sse2;
+    g_row = yb_transform_row_sse2;
+    g_lanes = 2;
+    break;
+  }
+  g_isa = isa;
+  return g_isa;
+}
+
+/*****************************************************************************
+ *                                  TESTS
+ *****************************************************************************/
+
+#ifdef UNIT_TEST
+
+void test_ybTransform(void) {
+  printf("Testing ybTransform in yjBatch.c\n");
+  double scalar[20];
+  double batch[20];
+  double *scalar_ptr = scalar;
+  double *batch_ptr = batch;
+  boundaryBox box = {1e10, -1e10};
+  int isa = ybGetInstructionSet();
+  buildBoundaryBox(-3, 3);
+  for (int i = 0; i < 20; i++) {
+    scalar[i] = (i % 2 ? -1 : 1) * (i * 0.75);
+    batch[i] = scalar[i];
+  }
+  ybSetInstructionSet(YB_ISA_SCALAR);
+  assert_int_equals(ybTransform(scalar, 20, 0.5, &box, &box), 0,
+                    "Error: scalar kernel should not transform anything");
+  yjTransformBy(&scalar_ptr, 0.5, 20);
+  ybSetInstructionSet(isa);
+  assert_int_equals(yjTransformBy(&batch_ptr, 0.5, 20), 0,
+                    "Error: should execute");
+  for (int i = 0; i < 20; i++) {
+    is_in_bound(batch[i], scalar[i], 1e-12,
+                "Error: vector result differs from scalar result");
+  }
+  // value outside of the boundary box -> same error as the scalar path
+  for (int i = 0; i < 20; i++) {
+    scalar[i] = i;
+    batch[i] = i;
+  }
+  scalar[13] = batch[13] = 1e300;
+  ybSetInstructionSet(YB_ISA_SCALAR);
+  int expected = yjTransformBy(&scalar_ptr, 3, 20);
+  ybSetInstructionSet(isa);
+  assert_int_equals(yjTransformBy(&batch_ptr, 3, 20), expected,
+                    "Error: error code differs from scalar path");
+  printf("...done\n");
+}
+
+void test_ybTransformf(void) {
+  printf("Testing ybTransformf in yjBatch.c\n");
+  float scalar[40];
+  float batch[40];
+  float *scalar_ptr = scalar;
+  float *batch_ptr = batch;
+  int isa = ybGetInstructionSet();
+  buildBoundaryBoxf(-3, 3);
+  for (int i = 0; i < 40; i++) {
+    scalar[i] = (i % 2 ? -1 : 1) * (i * 0.375f);
+    batch[i] = scalar[i];
+  }
+  ybSetInstructionSet(YB_ISA_SCALAR);
+  yjTransformByf(&scalar_ptr, 0.5f, 40);
+  ybSetInstructionSet(isa);
+  assert_int_equals(yjTransformByf(&batch_ptr, 0.5f, 40), 0,
+                    "Error: should execute");
+  for (int i = 0; i < 40; i++) {
+    is_in_bound(batch[i], scalar[i], 1e-4,
+                "Error: vector result differs from scalar result");
+  }
+  printf("...done\n");
+}
+
+void test_ybTransformRows(void) {
+  printf("Testing ybTransformRows in yjBatch.c\n");
+  double lambda[37];
+  double mean[37];
+  double sd[37];
+  int errnum[37];
+  double rows[2][40];
+  double batch[2][40];
+  ybRowModel model;
+  int isa = ybGetInstructionSet();
+  for (int j = 0; j < 37; j++) {
+    // both logarithm branches (0, 2) and a failed feature included
+    lambda[j] = j % 9 == 0 ? 0 : j % 9 == 1 ? 2 : -1.5 + 0.25 * (j % 9);
+    mean[j] = 0.1 * j;
+    sd[j] = 1 + 0.05 * j;
+    errnum[j] = j == 7 ? ERR_LAMBDA_SEARCH : 0;
+    for (int r = 0; r < 2; r++) {
+      rows[r][j] = (j % 2 ? -1 : 1) * (0.3 * j + r) * (r ? 1 : 0.01);
+    }
+  }
+  assert_int_equals(ybRowModelInit(&model, 37, lambda, mean, sd, errnum), 0,
+                    "Error: should execute");
+  for (int set = YB_ISA_SCALAR; set <= isa; set++) {
+    ybSetInstructionSet(set);
+    memcpy(batch, rows, sizeof(rows));
+    assert_int_equals(ybTransformRows(&model, batch[0], 2, 40), 0,
+                      "Error: should execute");
+    for (int r = 0; r < 2; r++) {
+      for (int j = 0; j < 37; j++) {
+        double expected = rows[r][j];
+        if (errnum[j] == 0) {
+          yjCalculationU(rows[r][j], lambda[j], &expected);
+        }
+        expected = (expected - mean[j]) / sd[j];
+        is_in_bound(batch[r][j], expected, 1e-13 * (1 + fabs(expected)),
+                    "Error: row result differs from scalar result");
+      }
+      assert_double_equals(batch[r][37], rows[r][37],
+                           "Error: value behind the row was written");
+    }
+  }
+  ybSetInstructionSet(isa);
+  // a NaN feature is reported, the others are transformed
+  memcpy(batch, rows, sizeof(rows));
+  batch[0][20] = NAN;
+  assert_int_equals(ybTransformRows(&model, batch[0], 1, 40),
+                    ERR_TRANSFORM | ERR_VALUE_OVERFLOW,
+                    "Error: NaN feature should be reported");
+  is_in_bound(batch[0][21], (rows[0][21] - mean[21]) / sd[21], 1,
+              "Error: features next to NaN should be transformed");
+  ybRowModelFree(&model);
+  printf("...done\n");
+}
+
+void test_ybInverseTransform(void) {
+  printf("Testing ybInverseTransform in yjBatch.c\n");
+  double lambdas[8] = {-2, -0.5, 0, 0.5, 1, 2, 2.5, 4};
+  double original[43];
+  double expected[43];
+  double batch[43];
+  double *expected_ptr = expected;
+  double *batch_ptr = batch;
+  int isa = ybGetInstructionSet();
+  for (int l = 0; l < 8; l++) {
+    for (int i = 0; i < 43; i++) {
+      original[i] = (i % 2 ? -1 : 1) * (0.37 * i) * (i % 3 ? 1 : 1e-6);
+      yjCalculationU(original[i], lambdas[l], &batch[i]);
+      expected[i] = batch[i];
+    }
+    ybSetInstructionSet(YB_ISA_SCALAR);
+    assert_int_equals(ybInverseTransform(expected, 43, lambdas[l]), 0,
+                      "Error: scalar kernel should not transform anything");
+    assert_int_equals(yjInverseTransformBy(&expected_ptr, lambdas[l], 43), 0,
+                      "Error: should execute");
+    ybSetInstructionSet(isa);
+    assert_int_equals(yjInverseTransformBy(&batch_ptr, lambdas[l], 43), 0,
+                      "Error: should execute");
+    for (int i = 0; i < 43; i++) {
+      // all four branches round trip, lambda 0 and 2 included
+      is_in_bound(batch[i], original[i], 1e-12 * (1 + fabs(original[i])),
+                  "Error: round trip does not return the original value");
+      is_in_bound(batch[i], expected[i], 1e-13 * (1 + fabs(expected[i])),
+                  "Error: vector result differs from scalar result");
+    }
+  }
+  // values without an inverse -> same error as the scalar path
+  for (int i = 0; i < 43; i++) {
+    expected[i] = batch[i] = 0.1 * i;
+  }
+  expected[30] = batch[30] = 5; // >= -1 / lambda
+  ybSetInstructionSet(YB_ISA_SCALAR);
+  int err_num = yjInverseTransformBy(&expected_ptr, -0.5, 43);
+  ybSetInstructionSet(isa);
+  assert_int_equals(yjInverseTransformBy(&batch_ptr, -0.5, 43), err_num,
+                    "Error: error code differs from scalar path");
+  assert_int_equals(err_num,
+                    ERR_TRANSFORM | ERR_YJ1_ID | ERR_VALUE_NOT_IN_DOMAIN,
+                    "Error: value has no inverse but still executed");
+  printf("...done\n");
+}
+
+#endif
@@ -0,0 +1,448 @@
+/****************************************************************
+ * Copyright (c) 2023 Jerome Brenig, Sigrun May
+ * Ostfalia Hochschule für angewandte Wissenschaften
+ *
+ * This software is distributed under the terms of the MIT license
+ * which is available at https://opensource.org/licenses/MIT
+ *
+ * FILENAME : yjStream.c
+ *
+ * DESCRIPTION  :
+ *          Out of core Yeo Johnson transformation of matrices larger than
+ *          the memory, streamed through in blocks of columns.
+ *
+ * PUBLIC FUNCTIONS :
+ *          int ysStreamOperation(interval_start, interval_end, precision,
+ *                                input_path, output_path, standardize,
+ *                                memory_budget, thread_count)
+ *
+ * NOTES    :
+ *          The input is mapped with mfOpen (matrix file, .npy or .npz) and
+ *          never read as a whole. The columns are copied block by block into
+ *          one of two buffers that share the memory budget, searched and
+ *          transformed there by ciParallelOperationS and written to the
+ *          output matrix file by mfWriteColumns, which appends the lambdas,
+ *          skews and error codes once the last block is done. While the
+ *          thread pool works on a block, a reader thread copies the next one
+ *          into the other buffer, so reading the file overlaps with the
+ *          search. The pages of a block are dropped from the mapping after
+ *          the copy (mfDiscard), they stay in the page cache of the system
+ *          only as long as it has room for them.
+ *          Column major inputs (matrix files, Fortran order .npy) are read
+ *          sequentially. Every block of a row major input touches all pages
+ *          of the file, convert large row major files into a matrix file
+ *          first (mfWrite / mfConvertCsv).
+ *          Results are the same as of ciParallelOperationS on the whole
+ *          matrix, each column is searched and standardized on its own.
+ *
+ * AUTHOR   :       agent             START DATE    : 16 October 2026
+ *
+ * CHANGES  :
+ *
+ * DATE     WHO     DETAIL
+ *
+ *H*/
+
+/*****************************************************************************
+ *                               INCLUDES
+ *****************************************************************************/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+#include "include/comInterface.h"
+#include "include/matrixFile.h"
+#include "include/testFramework.h"
+#include "include/yjStream.h"
+
+// bytes of a row major input read between two mfDiscard calls
+#define YS_DISCARD_SIZE (1 << 20)
+
+/*****************************************************************************
+ *                            PRIVATE STRUCTURES
+ *****************************************************************************/
+
+// state of a ysStreamOperation, the column source of mfWriteColumns
+typedef struct _YSSTREAM {
+  MATRIXFILE input;  // mapped input, never written
+  int size;          // bytes of one value
+  int block_cols;    // columns of a full block
+  int blocks;        // blocks of the matrix
+  void *buffers[2];  // block k lives in buffers[k % 2]
+  int block;         // block being written, -1 before the first
+  int read_block;    // block of the reader thread
+  int reading;       // 1 while the reader thread runs
+  pthread_t reader;
+  double *lambda; // results of all columns, not in the mapping, whose pages
+  double *skew;   // are dropped
+  int *errnum;
+  double interval_start;
+  double interval_end;
+  int precision;
+  BOOL standardize;
+  int thread_count;
+  int ret; // 0, or -4 if the operation failed on a block
+} YSSTREAM;
+
+/*****************************************************************************
+ *                           PRIVATE FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * @brief checks if two paths name the same file, also through different
+ * spellings or links of its path
+ *
+ * @param first_path path of an existing file
+ * @param second_path path to compare, may not exist
+ * @return int 1 if both name the same file, 0 if not
+ */
+static int ys_same_file(const char *first_path, const char *second_path) {
+  if (strcmp(first_path, second_path) == 0) {
+    return 1;
+  }
+#ifdef _WIN32
+  char first[_MAX_PATH];
+  char second[_MAX_PATH];
+  return _fullpath(first, first_path, _MAX_PATH) != NULL &&
+         _fullpath(second, second_path, _MAX_PATH) != NULL &&
+         _stricmp(first, second) == 0;
+#else
+  struct stat first;
+  struct stat second;
+  return stat(first_path, &first) == 0 && stat(second_path, &second) == 0 &&
+         first.st_dev == second.st_dev && first.st_ino == second.st_ino;
+#endif
+}
+
+/**
+ * @brief copies block into its buffer, column major, and drops its pages
+ * from the mapping
+ *
+ * @param stream stream
+ * @param block block to be read
+ */
+static void ys_read(YSSTREAM *stream, int block) {
+  const MATRIXS *input = &stream->input.matrix;
+  int first = block * stream->block_cols;
+  int count = input->cols - first < stream->block_cols ? input->cols - first
+                                                       : stream->block_cols;
+  int rows = input->rows;
+  int size = stream->size;
+  char *buffer = (char *)stream->buffers[block % 2];
+  const char *begin = (const char *)input->data + first * input->col_stride;
+  if (input->row_stride == size) {
+    for (int col = 0; col < count; col++) {
+      const char *column = begin + col * input->col_stride;
+      memcpy(buffer + (size_t)col * rows * size, column, (size_t)rows * size);
+      mfDiscard(&stream->input, column, (size_t)rows * size);
+    }
+    return;
+  }
+  // row major: along the rows, every row contributes count values; the rows
+  // read so far are dropped every YS_DISCARD_SIZE bytes
+  const char *kept = begin;
+  for (int row = 0; row < rows; row++) {
+    const char *value = begin + row * input->row_stride;
+    for (int col = 0; col < count; col++) {
+      memcpy(buffer + ((size_t)col * rows + row) * size,
+             value + col * input->col_stride, size);
+    }
+    const char *end = value + (count - 1) * input->col_stride + size;
+    if (end - kept >= YS_DISCARD_SIZE || row == rows - 1) {
+      mfDiscard(&stream->input, kept, (size_t)(end - kept));
+      kept = end;
+    }
+  }
+}
+
+/**
+ * @brief reader thread of a stream
+ *
+ * @param args YSSTREAM
+ * @return void* NULL
+ */
+static void *ys_reader(void *args) {
+  YSSTREAM *stream = (YSSTREAM *)args;
+  ys_read(stream, stream->read_block);
+  return NULL;
+}
+
+/**
+ * @brief starts reading block on the reader thread, reads it right away if
+ * no thread can be started
+ *
+ * @param stream stream without a running reader
+ * @param block block to be read, nothing happens behind the last one
+ */
+static void ys_start_read(YSSTREAM *stream, int block) {
+  if (block >= stream->blocks) {
+    return;
+  }
+  stream->read_block = block;
+  stream->reading =
+      pthread_create(&stream->reader, NULL, &ys_reader, stream) == 0;
+  if (!stream->reading) {
+    ys_read(stream, block);
+  }
+}
+
+/**
+ * @brief waits for the reader thread
+ *
+ * @param stream stream
+ */
+static void ys_wait_read(YSSTREAM *stream) {
+  if (stream->reading) {
+    pthread_join(stream->reader, NULL);
+    stream->reading = 0;
+  }
+}
+
+/**
+ * @brief transforms block in its buffer with ciParallelOperationS
+ *
+ * @param stream stream
+ * @param block block that was read
+ * @return int 0, -4 if the operation failed
+ */
+static int ys_transform(YSSTREAM *stream, int block) {
+  MATRIXS *input = &stream->input.matrix;
+  int first = block * stream->block_cols;
+  MATRIXS matrix;
+  matrix.rows = input->rows;
+  matrix.cols = input->cols - first < stream->block_cols ? input->cols - first
+                                                         : stream->block_cols;
+  matrix.data = stream->buffers[block % 2];
+  matrix.row_stride = stream->size;
+  matrix.col_stride = (long long)input->rows * stream->size;
+  matrix.dtype = input->dtype;
+  matrix.lambda = stream->lambda + first;
+  matrix.skew = stream->skew + first;
+  matrix.errnum = stream->errnum + first;
+  return ciParallelOperationS(stream->interval_start, stream->interval_end,
+                              stream->precision, &matrix, stream->standardize,
+                              0, stream->thread_count) != 0
+             ? -4
+             : 0;
+}
+
+/**
+ * @brief mfColumn of a stream: on the first column of a block it waits for
+ * the block, starts reading the next one into the other buffer and
+ * transforms the block
+ */
+static const void *ys_column(void *source, int col, void *buffer) {
+  YSSTREAM *stream = (YSSTREAM *)source;
+  int block = col / stream->block_cols;
+  if (block != stream->block) {
+    ys_wait_read(stream);
+    stream->block = block;
+    // the other buffer held the previous block, which is written by now
+    ys_start_read(stream, block + 1);
+    if (ys_transform(stream, block) != 0) {
+      stream->ret = -4;
+    }
+  }
+  return (const char *)stream->buffers[block % 2] +
+         (size_t)(col - block * stream->block_cols) *
+             stream->input.matrix.rows * stream->size;
+}
+
+/*****************************************************************************
+ *                           PUBLIC FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * @brief ciParallelOperationS on a matrix that does not fit into the memory:
+ * streams the columns of a matrix file, .npy or .npz file (see mfOpen) block
+ * by block through a memory budget and writes the transformed matrix with
+ * lambdas, skews, error codes and column names to a matrix file
+ *
+ * @param interval_start start of interval
+ * @param interval_end end of interval
+ * @param precision scanning precision
+ * @param input_path matrix file, .npy or .npz file, not changed
+ * @param output_path matrix file to write, not the file of input_path
+ * @param standardize bool if standardization is wished
+ * @param memory_budget bytes of the two block buffers, at least two columns
+ * (YS_DEFAULT_BUDGET); the searches need a few columns per thread on top
+ * @param thread_count count of parts claiming the columns of a block, not of
+ * threads: the parts run on the shared thread pool, sized to the online
+ * processors unless tpInit sets it
+ * @return int error return code: -1 invalid argument or memory_budget below
+ * two columns, -2 input can not be opened, -3 allocation failed, -4
+ * operation failed, -5 output can not be written
+ */
+int ysStreamOperation(double interval_start, double interval_end,
+                      int precision, const char *input_path,
+                      const char *output_path, BOOL standardize,
+                      size_t memory_budget, int thread_count) {
+  if (input_path == NULL || output_path == NULL ||
+      ys_same_file(input_path, output_path)) {
+    return -1;
+  }
+  YSSTREAM stream;
+  memset(&stream, 0, sizeof(YSSTREAM));
+  if (mfOpen(&stream.input, input_path, MF_READ) != 0) {
+    return -2;
+  }
+  MATRIXS *input = &stream.input.matrix;
+  stream.size = input->dtype == MATRIX_FLOAT32 ? sizeof(float) : sizeof(double);
+  size_t column_size = (size_t)input->rows * stream.size;
+  size_t block_cols = column_size > 0 ? memory_budget / 2 / column_size
+                                      : (size_t)input->cols;
+  if (block_cols == 0) {
+    printf("\tA memory budget of %zu bytes is below two columns.\n",
+           memory_budget);
+    mfClose(&stream.input);
+    return -1;
+  }
+  stream.block_cols = block_cols < (size_t)input->cols ? (int)block_cols
+                      : input->cols > 0                ? input->cols
+                                                       : 1;
+  stream.blocks = (input->cols + stream.block_cols - 1) / stream.block_cols;
+  stream.block = -1;
+  stream.interval_start = interval_start;
+  stream.interval_end = interval_end;
+  stream.precision = precision;
+  stream.standardize = standardize;
+  stream.thread_count = thread_count;
+  for (int i = 0; i < 2; i++) {
+    stream.buffers[i] = malloc(
+        stream.block_cols * column_size > 0 ? stream.block_cols * column_size
+                                            : 1);
+  }
+  size_t cols = input->cols > 0 ? (size_t)input->cols : 1;
+  stream.lambda = (double *)calloc(cols, sizeof(double));
+  stream.skew = (double *)calloc(cols, sizeof(double));
+  stream.errnum = (int *)calloc(cols, sizeof(int));
+  int ret = 0;
+  if (stream.buffers[0] == NULL || stream.buffers[1] == NULL ||
+      stream.lambda == NULL || stream.skew == NULL || stream.errnum == NULL) {
+    printf("\tFailed to allocate memory for the blocks.\n");
+    ret = -3;
+  }
+
+  if (ret == 0) {
+    ys_start_read(&stream, 0);
+    int sections = MF_RESULTS | (stream.input.names != NULL ? MF_NAMES : 0);
+    ret = mfWriteColumns(output_path, input->rows, input->cols, input->dtype,
+                         ys_column, &stream, stream.input.names, sections,
+                         stream.lambda, stream.skew, stream.errnum);
+    // the writer stops early on errors, the reader may still run then
+    ys_wait_read(&stream);
+    ret = ret == -3 ? -3 : ret != 0 ? -5 : stream.ret;
+    if (ret != 0) {
+      remove(output_path);
+    }
+  }
+  free(stream.buffers[0]);
+  free(stream.buffers[1]);
+  free(stream.lambda);
+  free(stream.skew);
+  free(stream.errnum);
+  mfClose(&stream.input);
+  return ret;
+}
+
+/*****************************************************************************
+ *                                TESTS
+ *****************************************************************************/
+#ifdef UNIT_TEST
+
+void test_ysStreamOperation(void) {
+  printf("Testing ysStreamOperation in yjStream.c\n");
+  char *input_path = "./stream_input.yjm";
+  char *npy_path = "./stream_input.npy";
+  char *output_path = "./stream_output.yjm";
+  int rows = 1000;
+  int cols = 7;
+  MATRIXS matrix;
+  MATRIXS expected;
+  allocMatrixS(&matrix, rows, cols, MATRIX_FLOAT64, 0);
+  allocMatrixS(&expected, rows, cols, MATRIX_FLOAT64, 1);
+  for (int row = 0; row < rows; row++) {
+    for (int col = 0; col < cols; col++) {
+      double value = ((row * 37 + col * 11) % 101) / 10.0 + 0.1;
+      value = value * value * (col + 1) - col;
+      ((double *)matrix.data)[row * cols + col] = value;
+      ((double *)expected.data)[col * rows + row] = value;
+    }
+  }
+  char *names[] = {"bm_0", "bm_1", "bm_2", "bm_3", "bm_4", "bm_5", "bm_6"};
+  mfWrite(input_path, &matrix, names, MF_NAMES);
+  ciParallelOperationS(-3, 3, 14, &expected, 1, 0, 1);
+
+  size_t two_columns = 2 * (size_t)rows * sizeof(double);
+  assert_int_equals(ysStreamOperation(-3, 3, 14, NULL, output_path, 1,
+                                      two_columns, 1),
+                    -1, "Error: input path is null, should abort");
+  assert_int_equals(ysStreamOperation(-3, 3, 14, input_path, input_path, 1,
+                                      two_columns, 1),
+                    -1, "Error: output replaces the input, should abort");
+  assert_int_equals(ysStreamOperation(-3, 3, 14, input_path,
+                                      "././stream_input.yjm", 1, two_columns,
+                                      1),
+                    -1, "Error: output path names the input, should abort");
+  assert_int_equals(ysStreamOperation(-3, 3, 14, "./no_such_file.yjm",
+                                      output_path, 1, two_columns, 1),
+                    -2, "Error: input does not exist, should abort");
+  assert_int_equals(ysStreamOperation(-3, 3, 14, input_path, output_path, 1,
+                                      two_columns - 1, 1),
+                    -1, "Error: budget below two columns, should abort");
+
+  // blocks of 2 columns from a column major matrix file, of 3 columns from
+  // a row major .npy file with the same values
+  FILE *npy = fopen(npy_path, "wb");
+  char header[118];
+  int length = snprintf(header, sizeof(header),
+                        "{'descr': '<f8', 'fortran_order': False, "
+                        "'shape': (%d, %d), }",
+                        rows, cols);
+  memset(header + length, ' ', sizeof(header) - 1 - length);
+  header[sizeof(header) - 1] = '\n';
+  unsigned char prefix[10] = {0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0,
+                              sizeof(header), 0};
+  fwrite(prefix, 1, sizeof(prefix), npy);
+  fwrite(header, 1, sizeof(header), npy);
+  fwrite(matrix.data, sizeof(double), (size_t)rows * cols, npy);
+  fclose(npy);
+  const char *inputs[] = {input_path, npy_path};
+  size_t budgets[] = {two_columns, 3 * two_columns};
+  for (int i = 0; i < 2; i++) {
+    assert_int_equals(ysStreamOperation(-3, 3, 14, inputs[i], output_path, 1,
+                                        budgets[i], 2),
+                      0, "Error: should execute");
+    MATRIXFILE file;
+    assert_int_equals(mfOpen(&file, output_path, MF_READ), 0,
+                      "Error: output should open");
+    assert_int_equals(file.results_in_file, 1, "Error: no result sections");
+    assert_int_equals(memcmp(file.matrix.data, expected.data,
+                             (size_t)rows * cols * sizeof(double)),
+                      0, "Error: values differ from ciParallelOperationS");
+    assert_int_equals(memcmp(file.matrix.lambda, expected.lambda,
+                             cols * sizeof(double)),
+                      0, "Error: lambdas differ from ciParallelOperationS");
+    assert_int_equals(file.matrix.errnum[cols - 1], expected.errnum[cols - 1],
+                      "Error: error code of the last column");
+    assert_int_equals(file.names != NULL, i == 0,
+                      "Error: names of the input");
+    if (file.names != NULL) {
+      assert_int_equals(strcmp(file.names[cols - 1], "bm_6"), 0,
+                        "Error: last name");
+    }
+    mfClose(&file);
+  }
+  freeMatrixS(&matrix);
+  freeMatrixS(&expected);
+  remove(input_path);
+  remove(npy_path);
+  remove(output_path);
+  printf("...done\n");
+}
+#endif